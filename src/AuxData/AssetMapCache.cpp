@@ -0,0 +1,105 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AssetMapCache.h"
+
+#include <string>
+
+#include "boost/bind.hpp"
+
+#include "AuxDataIndex.h"
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    AssetMapCache::AssetMapCache() :
+          numberOfParses_(0)
+    {
+    }
+
+    AssetMapCache::~AssetMapCache()
+    {
+    }
+
+    AssetFileInfoMapPtr AssetMapCache::Find(const std::string &iDirectory)
+    {
+        uint64_t fileSize = 0;
+        int64_t modificationTime = 0;
+
+        // A missing ASSETMAP.xml is not cached. CPLParser::ParseAssetMap logs it and returns an empty map.
+        //
+        if (!AuxDataIndex::GetFileIdentity(CPLParser::GetAssetMapPath(iDirectory), fileSize, modificationTime))
+            return CPLParser::ParseAssetMap(iDirectory);
+
+        {
+            boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+            std::map<std::string, Entry>::iterator iter = entries_.find(iDirectory);
+            if (iter != entries_.end())
+            {
+                if (iter->second.fileSize_ == fileSize && iter->second.modificationTime_ == modificationTime)
+                    return iter->second.assetMap_;
+
+                SMPTE_SYNC_LOG << "AssetMapCache::Find - " << CPLParser::GetAssetMapPath(iDirectory) << " changed since it was parsed";
+                entries_.erase(iter);
+            }
+        }
+
+        return parses_.Do(iDirectory, boost::bind(&AssetMapCache::Parse, this, iDirectory, fileSize, modificationTime));
+    }
+
+    AssetFileInfoMapPtr AssetMapCache::Parse(const std::string &iDirectory, uint64_t iFileSize, int64_t iModificationTime)
+    {
+        AssetFileInfoMapPtr assetMap = CPLParser::ParseAssetMap(iDirectory);
+
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        Entry &entry = entries_[iDirectory];
+        entry.fileSize_ = iFileSize;
+        entry.modificationTime_ = iModificationTime;
+        entry.assetMap_ = assetMap;
+
+        numberOfParses_++;
+
+        return assetMap;
+    }
+
+    void AssetMapCache::Clear(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        entries_.clear();
+    }
+
+    uint64_t AssetMapCache::GetNumberOfParses(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        return numberOfParses_;
+    }
+
+}  // namespace SMPTE_SYNC
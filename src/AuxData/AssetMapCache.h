@@ -0,0 +1,116 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef ASSETMAPCACHE_H
+#define ASSETMAPCACHE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "boost/thread/mutex.hpp"
+
+#include "CPLParser.h"
+#include "SingleFlight.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief AssetMapCache keeps the parsed ASSETMAP.xml of each package directory.
+     * The CPLs of a package share one parse of its ASSETMAP.xml. A directory whose ASSETMAP.xml changed size or
+     * modification time since it was parsed is parsed again. Concurrent requests for the same directory share one parse.
+     * The cache is threadsafe.
+     *
+     */
+
+    class AssetMapCache
+    {
+    public:
+
+        /// Constructor
+        AssetMapCache();
+
+        /// Destructor
+        ~AssetMapCache();
+
+        /**
+         *
+         * Returns the assets of the ASSETMAP.xml in a directory, parsing it if needed
+         *
+         * @param iDirectory is the directory containing the ASSETMAP.xml, ending with a /
+         * @return AssetFileInfoMapPtr to the assets. Empty map if the file could not be read.
+         *
+         */
+        AssetFileInfoMapPtr Find(const std::string &iDirectory);
+
+        /// Drops all parsed ASSETMAP.xml files
+        void Clear(void);
+
+        /// Returns the number of ASSETMAP.xml files parsed since the cache was created
+        uint64_t GetNumberOfParses(void);
+
+    private:
+
+        /**
+         *
+         * @brief Entry is a parsed ASSETMAP.xml and the identity of the file it was parsed from
+         *
+         */
+        struct Entry
+        {
+            /// Size of the ASSETMAP.xml when it was parsed
+            uint64_t            fileSize_;
+
+            /// Modification time of the ASSETMAP.xml in nanoseconds when it was parsed
+            int64_t             modificationTime_;
+
+            /// The parsed assets
+            AssetFileInfoMapPtr assetMap_;
+        };
+
+        /// Runs once per directory being parsed on behalf of Find
+        AssetFileInfoMapPtr Parse(const std::string &iDirectory, uint64_t iFileSize, int64_t iModificationTime);
+
+        /// Protects entries_ and numberOfParses_
+        boost::mutex    cacheMutex_;
+
+        /// Parsed ASSETMAP.xml files keyed by directory
+        std::map<std::string, Entry> entries_;
+
+        /// Number of ASSETMAP.xml files parsed
+        uint64_t        numberOfParses_;
+
+        /// Parses in flight keyed by directory
+        SingleFlight<std::string, AssetFileInfoMapPtr> parses_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // ASSETMAPCACHE_H
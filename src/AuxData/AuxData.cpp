@@ -178,6 +178,7 @@ namespace SMPTE_SYNC
     , sourceDataItem_(nullptr)
     , sourceCryptographicContextLength_(0)
     , sourceCryptographicContext_(nullptr)
+    , buffer_()
     {
         packKey_.data_[0] = 0x06;
         packKey_.data_[1] = 0x0E;
@@ -199,6 +200,14 @@ namespace SMPTE_SYNC
     
     AuxDataBlock::AuxDataBlock(const AuxDataBlock& other)
     {
+        *this = other;
+    }
+
+    AuxDataBlock& AuxDataBlock::operator=(const AuxDataBlock& other)
+    {
+        if (this == &other)
+            return *this;
+
         packKey_ = other.packKey_;
         length_ = other.length_;
         
@@ -207,19 +216,21 @@ namespace SMPTE_SYNC
         editUnitRateDenominator_ = other.editUnitRateDenominator_;
         sourceDataEssenceCodingUL_ = other.sourceDataEssenceCodingUL_;
 
+        // Share the payload rather than copying it
+        //
         sourceDataItemLength_ = other.sourceDataItemLength_;
-        sourceDataItem_ = new uint8_t[sourceDataItemLength_];
-        memcpy(sourceDataItem_, other.sourceDataItem_ ,sourceDataItemLength_);
+        sourceDataItem_ = other.sourceDataItem_;
         
         sourceCryptographicContextLength_ = other.sourceCryptographicContextLength_;
-        sourceCryptographicContext_ = new uint8_t[sourceCryptographicContextLength_];
-        memcpy(sourceCryptographicContext_, other.sourceCryptographicContext_ ,sourceCryptographicContextLength_);
+        sourceCryptographicContext_ = other.sourceCryptographicContext_;
+
+        buffer_ = other.buffer_;
+
+        return *this;
     }
 
     AuxDataBlock::~AuxDataBlock()
     {
-        delete [] sourceCryptographicContext_;
-        delete [] sourceDataItem_;
     }
 
     bool AuxDataBlock::read(uint8_t **iBuffer)
@@ -234,19 +245,15 @@ namespace SMPTE_SYNC
 
         Read(iBuffer, sourceDataEssenceCodingUL_);
 
+        // Reference the payloads in place
+        //
         Read(iBuffer, sourceDataItemLength_);
-        if (sourceDataItemLength_ > 0)
-        {
-            sourceDataItem_ = new uint8_t[sourceDataItemLength_];
-            ReadBuf(iBuffer, sourceDataItem_, sourceDataItemLength_);
-        }
+        sourceDataItem_ = sourceDataItemLength_ > 0 ? *iBuffer : nullptr;
+        *iBuffer += sourceDataItemLength_;
         
         Read(iBuffer, sourceCryptographicContextLength_);
-        if (sourceCryptographicContextLength_ > 0)
-        {
-            sourceCryptographicContext_ = new uint8_t[sourceCryptographicContextLength_];
-            ReadBuf(iBuffer, sourceCryptographicContext_, sourceCryptographicContextLength_);
-        }
+        sourceCryptographicContext_ = sourceCryptographicContextLength_ > 0 ? *iBuffer : nullptr;
+        *iBuffer += sourceCryptographicContextLength_;
         
         return true;
     }
@@ -36,10 +36,16 @@
 #include <cstdlib>
 #include <string.h>
 #include <string>
+#include <vector>
 #include <algorithm>
 
+#include "boost/shared_ptr.hpp"
+
 namespace SMPTE_SYNC
 {
+    /// Buffer holding received bytes. Shared by every AuxDataBlock that references a slice of it.
+    typedef boost::shared_ptr<std::vector<uint8_t> > AuxDataBufferPtr;
+
     /**
      * @brief PackKey struct implements data sent via HTTP as part of the AuxDataBlockTransferHeader and AuxDataBlock data structures
      * Defined in the SMPTE ST 430-10:2010 D-Cinema Operations — Auxiliary Content Synchronization Protocol
@@ -231,6 +237,9 @@ namespace SMPTE_SYNC
      * Defined in the SMPTE ST 430-10:2010 D-Cinema Operations — Auxiliary Content Synchronization Protocol
      * The AuxDataBlock is the payload is sent with head HTTP request.
      *
+     * The AuxDataBlock does not own sourceDataItem_ or sourceCryptographicContext_. They point into the bytes
+     * the block was read from, which buffer_ keeps alive, or into memory the caller keeps alive while writing.
+     *
      */
 
     class AuxDataBlock
@@ -240,8 +249,11 @@ namespace SMPTE_SYNC
         /// Constructor
         AuxDataBlock();
 
-        /// Copy Constructor
+        /// Copy Constructor. The copy references the same payload as other.
         AuxDataBlock(const AuxDataBlock& other);
+
+        /// Assignment operator. References the same payload as other and drops the previous one.
+        AuxDataBlock& operator=(const AuxDataBlock& other);
         
         /// Destructor
         ~AuxDataBlock();
@@ -257,7 +269,9 @@ namespace SMPTE_SYNC
         
         /**
          *
-         * Reads or deserializes a byte stream into a AuxDataBlock C++ object
+         * Reads or deserializes a byte stream into a AuxDataBlock C++ object.
+         * sourceDataItem_ and sourceCryptographicContext_ point into the byte stream rather than copying it,
+         * so the caller keeps the stream alive, typically by setting buffer_ to the buffer holding it.
          *
          * @param iBuffer is the buffer being read. Note that this pointer is moved as it is read
          * @return true/false if the buffer has been properly read
@@ -296,7 +310,7 @@ namespace SMPTE_SYNC
         /// Stores Length in bytes of the Source Data Item element
         uint64_t        sourceDataItemLength_;
 
-        /// Stores Data Item of the source Aux Data Track File
+        /// Stores Data Item of the source Aux Data Track File. Not owned by the AuxDataBlock.
         uint8_t         *sourceDataItem_;
 
         /// Stores Length in bytes of the Cryptographic Context Set
@@ -304,6 +318,9 @@ namespace SMPTE_SYNC
 
         /// Stores Cryptographic Context Set, if any, associated with the Elements of the Data Item contained in Source Data Item element
         uint8_t         *sourceCryptographicContext_;
+
+        /// Keeps the received bytes that sourceDataItem_ and sourceCryptographicContext_ point into alive. Empty if the caller owns them.
+        AuxDataBufferPtr buffer_;
     };
 
 }  // namespace SMPTE_SYNC
@@ -0,0 +1,191 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataBlockCache.h"
+
+#include <string>
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    AuxDataBlockCache::AuxDataBlockCache(uint64_t iMaxSizeInBytes) :
+          sizeInBytes_(0)
+        , maxSizeInBytes_(iMaxSizeInBytes)
+        , hits_(0)
+        , misses_(0)
+    {
+        SMPTE_SYNC_LOG << "AuxDataBlockCache::AuxDataBlockCache maxSizeInBytes_ = " << maxSizeInBytes_;
+    }
+
+    AuxDataBlockCache::~AuxDataBlockCache()
+    {
+        this->Clear();
+    }
+
+    bool AuxDataBlockCache::Get(const std::string &iCodingUL, int32_t iEditUnit, AuxDataBlockBytesPtr &oBlock)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        std::map<Key, LRUList::iterator>::iterator iter = index_.find(Key(iCodingUL, iEditUnit));
+        if (iter == index_.end())
+        {
+            misses_++;
+            return false;
+        }
+
+        // Move to the front of the list. splice keeps the iterator in index_ valid.
+        //
+        lru_.splice(lru_.begin(), lru_, iter->second);
+        oBlock = iter->second->second;
+
+        hits_++;
+        return true;
+    }
+
+    bool AuxDataBlockCache::Contains(const std::string &iCodingUL, int32_t iEditUnit)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        return index_.find(Key(iCodingUL, iEditUnit)) != index_.end();
+    }
+
+    bool AuxDataBlockCache::Peek(const std::string &iCodingUL, int32_t iEditUnit, AuxDataBlockBytesPtr &oBlock)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        std::map<Key, LRUList::iterator>::iterator iter = index_.find(Key(iCodingUL, iEditUnit));
+        if (iter == index_.end())
+            return false;
+
+        oBlock = iter->second->second;
+        return true;
+    }
+
+    bool AuxDataBlockCache::Put(const std::string &iCodingUL, int32_t iEditUnit, const AuxDataBlockBytesPtr &iBlock, bool iEvict)
+    {
+        if (!iBlock)
+            return false;
+
+        uint64_t blockSize = iBlock->size();
+
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        Key key(iCodingUL, iEditUnit);
+
+        std::map<Key, LRUList::iterator>::iterator iter = index_.find(key);
+        if (iter != index_.end())
+        {
+            lru_.splice(lru_.begin(), lru_, iter->second);
+            return true;
+        }
+
+        if (blockSize > maxSizeInBytes_)
+            return false;
+
+        if (sizeInBytes_ + blockSize > maxSizeInBytes_)
+        {
+            if (!iEvict)
+                return false;
+
+            this->EvictLocked(maxSizeInBytes_ - blockSize);
+        }
+
+        lru_.push_front(std::make_pair(key, iBlock));
+        index_[key] = lru_.begin();
+        sizeInBytes_ += blockSize;
+
+        return true;
+    }
+
+    bool AuxDataBlockCache::Erase(const std::string &iCodingUL, int32_t iEditUnit, const AuxDataBlockBytesPtr &iBlock)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        std::map<Key, LRUList::iterator>::iterator iter = index_.find(Key(iCodingUL, iEditUnit));
+        if (iter == index_.end() || iter->second->second != iBlock)
+            return false;
+
+        sizeInBytes_ -= iBlock->size();
+        lru_.erase(iter->second);
+        index_.erase(iter);
+
+        return true;
+    }
+
+    void AuxDataBlockCache::EvictLocked(uint64_t iMaxSizeInBytes)
+    {
+        while (sizeInBytes_ > iMaxSizeInBytes && !lru_.empty())
+        {
+            sizeInBytes_ -= lru_.back().second->size();
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+    }
+
+    void AuxDataBlockCache::Clear(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        lru_.clear();
+        index_.clear();
+        sizeInBytes_ = 0;
+    }
+
+    void AuxDataBlockCache::SetMaxSizeInBytes(uint64_t iMaxSizeInBytes)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        maxSizeInBytes_ = iMaxSizeInBytes;
+        this->EvictLocked(maxSizeInBytes_);
+    }
+
+    uint64_t AuxDataBlockCache::GetMaxSizeInBytes(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        return maxSizeInBytes_;
+    }
+
+    void AuxDataBlockCache::GetStatistics(AuxDataCacheStatistics &oStatistics)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+        oStatistics.hits_ = hits_;
+        oStatistics.misses_ = misses_;
+        oStatistics.sizeInBytes_ = sizeInBytes_;
+        oStatistics.maxSizeInBytes_ = maxSizeInBytes_;
+        oStatistics.numberOfBlocks_ = lru_.size();
+    }
+
+    void AuxDataBlockCache::ResetStatistics(void)
+    {
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+}  // namespace SMPTE_SYNC
@@ -0,0 +1,209 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATABLOCKCACHE_H
+#define AUXDATABLOCKCACHE_H
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/atomic.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "DataTypes.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief AuxDataBlockBytesPtr is a boost::shared_ptr to a serialized AuxDataBlock as it is sent to the SS_Client.
+     * The bytes are never modified once cached so they can be shared by any number of readers.
+     *
+     */
+    typedef SharedContentPtr AuxDataBlockBytesPtr;
+
+    /**
+     *
+     * @brief AuxDataCacheStatistics is a snapshot of the counters of the AuxDataBlockCache and the read-ahead feeding it
+     *
+     */
+    typedef struct AuxDataCacheStatistics
+    {
+        /// Constructor
+        AuxDataCacheStatistics() :
+              hits_(0)
+            , misses_(0)
+            , readAheadWindows_(0)
+            , readAheadBlocks_(0)
+            , coalescedReads_(0)
+            , sizeInBytes_(0)
+            , maxSizeInBytes_(0)
+            , numberOfBlocks_(0)
+        {
+        }
+
+        /// Number of blocks served from the cache
+        uint64_t    hits_;
+
+        /// Number of blocks that had to be read from disk
+        uint64_t    misses_;
+
+        /// Number of windows loaded ahead of a request
+        uint64_t    readAheadWindows_;
+
+        /// Number of blocks loaded ahead of a request
+        uint64_t    readAheadBlocks_;
+
+        /// Number of reads that shared the result of an identical read already in flight
+        uint64_t    coalescedReads_;
+
+        /// Number of bytes currently cached
+        uint64_t    sizeInBytes_;
+
+        /// Maximum number of bytes the cache holds
+        uint64_t    maxSizeInBytes_;
+
+        /// Number of blocks currently cached
+        uint64_t    numberOfBlocks_;
+    } AuxDataCacheStatistics;
+
+    /**
+     *
+     * @brief AuxDataBlockCache keeps serialized AuxDataBlock objects in memory keyed by coding UL and edit unit.
+     * The cache is bounded by the number of bytes it holds. When it is full the least recently used blocks are evicted.
+     * Threadsafe.
+     *
+     */
+
+    class AuxDataBlockCache
+    {
+    public:
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iMaxSizeInBytes is the maximum number of bytes of serialized blocks held by the cache
+         *
+         */
+        AuxDataBlockCache(uint64_t iMaxSizeInBytes);
+
+        /// Destructor
+        ~AuxDataBlockCache();
+
+        /**
+         *
+         * Looks up a block and marks it as most recently used. Counts a hit or a miss.
+         *
+         * @param iCodingUL is the coding UL of the block
+         * @param iEditUnit is the edit unit of the block on the Show timeline
+         * @param oBlock is the cached block if found
+         * @return bool true/false if the block was found
+         *
+         */
+        bool Get(const std::string &iCodingUL, int32_t iEditUnit, AuxDataBlockBytesPtr &oBlock);
+
+        /// Returns true if the block is cached. Does not count a hit or a miss or change the eviction order.
+        bool Contains(const std::string &iCodingUL, int32_t iEditUnit);
+
+        /// Looks up a block like Get but does not count a hit or a miss or change the eviction order
+        bool Peek(const std::string &iCodingUL, int32_t iEditUnit, AuxDataBlockBytesPtr &oBlock);
+
+        /**
+         *
+         * Adds a block to the cache.
+         *
+         * @param iCodingUL is the coding UL of the block
+         * @param iEditUnit is the edit unit of the block on the Show timeline
+         * @param iBlock is the serialized block
+         * @param iEvict is true to evict least recently used blocks to make room. When false the block is only added if it fits.
+         * @return bool true/false if the block is in the cache
+         *
+         */
+        bool Put(const std::string &iCodingUL, int32_t iEditUnit, const AuxDataBlockBytesPtr &iBlock, bool iEvict);
+
+        /// Removes the block cached for iCodingUL and iEditUnit if it is iBlock. Returns true if it was removed.
+        bool Erase(const std::string &iCodingUL, int32_t iEditUnit, const AuxDataBlockBytesPtr &iBlock);
+
+        /// Removes all blocks. Statistics are kept.
+        void Clear(void);
+
+        /// Sets the maximum number of bytes held by the cache. Evicts blocks if needed.
+        void SetMaxSizeInBytes(uint64_t iMaxSizeInBytes);
+
+        /// Gets the maximum number of bytes held by the cache
+        uint64_t GetMaxSizeInBytes(void);
+
+        /// Fills in the cache fields of oStatistics
+        void GetStatistics(AuxDataCacheStatistics &oStatistics);
+
+        /// Resets the hit and miss counters
+        void ResetStatistics(void);
+
+    private:
+
+        /// Key of a cached block
+        typedef std::pair<std::string, int32_t> Key;
+
+        /// Blocks ordered from most to least recently used
+        typedef std::list<std::pair<Key, AuxDataBlockBytesPtr> > LRUList;
+
+        /// Evicts least recently used blocks until the cache holds no more than iMaxSizeInBytes. Requires cacheMutex_ to be held.
+        void EvictLocked(uint64_t iMaxSizeInBytes);
+
+        /// Protects lru_, index_, sizeInBytes_ and maxSizeInBytes_
+        boost::mutex                        cacheMutex_;
+
+        /// The cached blocks, most recently used first
+        LRUList                             lru_;
+
+        /// Finds a cached block in lru_
+        std::map<Key, LRUList::iterator>    index_;
+
+        /// Number of bytes currently cached
+        uint64_t                            sizeInBytes_;
+
+        /// Maximum number of bytes cached
+        uint64_t                            maxSizeInBytes_;
+
+        /// Number of blocks found by Get
+        boost::atomic<uint64_t>             hits_;
+
+        /// Number of blocks not found by Get
+        boost::atomic<uint64_t>             misses_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATABLOCKCACHE_H
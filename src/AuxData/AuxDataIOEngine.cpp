@@ -0,0 +1,125 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataIOEngine.h"
+
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "IoUringAuxDataIOEngine.h"
+#include "Logger.h"
+#include "ThreadPoolAuxDataIOEngine.h"
+
+namespace SMPTE_SYNC
+{
+    AuxDataFile::AuxDataFile(int iFileDescriptor) :
+          fd_(iFileDescriptor)
+    {
+    }
+
+    AuxDataFile::~AuxDataFile()
+    {
+#if !defined(_WIN32)
+        if (fd_ >= 0)
+            ::close(fd_);
+#endif
+    }
+
+    int AuxDataFile::GetFileDescriptor(void) const
+    {
+        return fd_;
+    }
+
+    AuxDataIOEngine* AuxDataIOEngine::Create(int32_t iQueueDepth, int32_t iNumberOfThreads)
+    {
+#if defined(SMPTE_SYNC_USE_IO_URING)
+        IoUringAuxDataIOEngine *ioUringEngine = new IoUringAuxDataIOEngine;
+
+        if (ioUringEngine->Open(iQueueDepth))
+        {
+            SMPTE_SYNC_LOG << "AuxDataIOEngine::Create - using io_uring iQueueDepth = " << iQueueDepth;
+            return ioUringEngine;
+        }
+
+        SMPTE_SYNC_LOG << "AuxDataIOEngine::Create - io_uring is unavailable, using a thread pool";
+        delete ioUringEngine;
+#endif
+
+#if !defined(_WIN32)
+        return new ThreadPoolAuxDataIOEngine(iNumberOfThreads);
+#else
+        SMPTE_SYNC_LOG << "AuxDataIOEngine::Create - not supported on this platform";
+        return nullptr;
+#endif
+    }
+
+    AuxDataIOEngine::AuxDataIOEngine()
+    {
+    }
+
+    AuxDataIOEngine::~AuxDataIOEngine()
+    {
+    }
+
+    void AuxDataIOEngine::CloseFiles(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(filesMutex_);
+        files_.clear();
+    }
+
+    AuxDataFilePtr AuxDataIOEngine::AcquireFile(const std::string &iPath)
+    {
+        boost::mutex::scoped_lock scoped_lock(filesMutex_);
+
+        std::map<std::string, AuxDataFilePtr>::iterator iter = files_.find(iPath);
+        if (iter != files_.end())
+            return iter->second;
+
+#if !defined(_WIN32)
+        int fd = ::open(iPath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            SMPTE_SYNC_LOG << "AuxDataIOEngine::AcquireFile - Failed to open iPath = " << iPath;
+            return AuxDataFilePtr();
+        }
+
+        AuxDataFilePtr file(new AuxDataFile(fd));
+        files_[iPath] = file;
+
+        return file;
+#else
+        return AuxDataFilePtr();
+#endif
+    }
+
+}  // namespace SMPTE_SYNC
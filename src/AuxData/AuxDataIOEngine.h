@@ -0,0 +1,174 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATAIOENGINE_H
+#define AUXDATAIOENGINE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+
+namespace SMPTE_SYNC
+{
+    /// Buffer filled by an AuxDataIOEngine read
+    typedef boost::shared_ptr<std::vector<uint8_t> > AuxDataReadBufferPtr;
+
+    /**
+     *
+     * @brief Callback run when an AuxDataIOEngine read completes.
+     * iSuccess is false if the file could not be opened or read. The buffer holds the bytes read, which can be fewer than requested at the end of the file.
+     * Runs on a thread of the engine and must not block.
+     *
+     */
+    typedef boost::function<void(bool iSuccess, const AuxDataReadBufferPtr &iBuffer)> AuxDataReadCallback;
+
+    /**
+     *
+     * @brief AuxDataFile is a file descriptor opened read only by an AuxDataIOEngine.
+     * Reads in flight hold a reference so the descriptor stays open until they complete.
+     *
+     */
+    class AuxDataFile
+    {
+    public:
+
+        /// Constructor. Takes ownership of iFileDescriptor.
+        AuxDataFile(int iFileDescriptor);
+
+        /// Destructor. Closes the file descriptor.
+        ~AuxDataFile();
+
+        /// Returns the file descriptor
+        int GetFileDescriptor(void) const;
+
+    private:
+
+        /// The open file descriptor
+        int     fd_;
+    };
+
+    /// Reference to an AuxDataFile
+    typedef boost::shared_ptr<AuxDataFile> AuxDataFilePtr;
+
+    /**
+     *
+     * @brief AuxDataIOEngine reads byte ranges of aux data track files asynchronously.
+     * Many reads, across many track files, can be queued at once and complete in any order on the threads of the engine.
+     * Implemented by ThreadPoolAuxDataIOEngine and, on Linux when built with SMPTE_SYNC_USE_IO_URING, IoUringAuxDataIOEngine.
+     * Engines are threadsafe.
+     *
+     */
+
+    class AuxDataIOEngine
+    {
+    public:
+
+        /**
+         *
+         * Creates the best engine available.
+         * Uses io_uring if it was enabled in the build and the kernel allows it, otherwise a thread pool.
+         *
+         * @param iQueueDepth is the maximum number of reads submitted to the disk at once
+         * @param iNumberOfThreads is the number of threads of the thread pool fallback
+         * @return AuxDataIOEngine* owned by the caller, nullptr if no engine is available on this platform
+         *
+         */
+        static AuxDataIOEngine* Create(int32_t iQueueDepth, int32_t iNumberOfThreads);
+
+        /// Destructor
+        virtual ~AuxDataIOEngine();
+
+        /**
+         *
+         * Queues a read of iLength bytes at iOffset of the file at iPath.
+         * iCallback is always run once unless the engine is stopped first.
+         *
+         * @param iPath is the path to the track file
+         * @param iOffset is the offset of the first byte to read
+         * @param iLength is the number of bytes to read
+         * @param iCallback is run when the read completes
+         * @return bool true if the read was queued. iCallback is not run when false is returned.
+         *
+         */
+        virtual bool Read(const std::string &iPath
+                          , uint64_t iOffset
+                          , uint32_t iLength
+                          , const AuxDataReadCallback &iCallback) = 0;
+
+        /**
+         *
+         * Stops the engine. Queued reads are discarded.
+         * Waits for the callbacks already running to return.
+         *
+         */
+        virtual void Stop(void) = 0;
+
+        /// Returns the name of the engine used for logging
+        virtual std::string GetName(void) = 0;
+
+        /**
+         *
+         * Closes the file descriptors kept open by the engine.
+         * Descriptors used by reads in flight are closed once the reads complete.
+         *
+         */
+        void CloseFiles(void);
+
+    protected:
+
+        /// Constructor
+        AuxDataIOEngine();
+
+        /**
+         *
+         * Returns the open file for iPath, opening it if needed.
+         *
+         * @param iPath is the path to the track file
+         * @return AuxDataFilePtr to the open file, empty if it could not be opened
+         *
+         */
+        AuxDataFilePtr AcquireFile(const std::string &iPath);
+
+    private:
+
+        /// Protects files_
+        boost::mutex    filesMutex_;
+
+        /// Open files keyed by path
+        std::map<std::string, AuxDataFilePtr> files_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATAIOENGINE_H
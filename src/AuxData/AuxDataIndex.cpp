@@ -0,0 +1,216 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataIndex.h"
+
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "boost/thread/thread.hpp"
+
+#include "Logger.h"
+#include "MappedFile.h"
+
+namespace SMPTE_SYNC
+{
+    // Sidecar file layout. All fields are in host byte order.
+    // The sidecar is a cache for the host that wrote it and is not meant to be copied between hosts.
+    //
+    static const char sIndexMagic[8] = { 'S', 'S', 'A', 'U', 'X', 'I', 'D', 'X' };
+    static const uint32_t sIndexVersion = 1;
+
+    typedef struct IndexHeader
+    {
+        char        magic_[8];
+        uint32_t    version_;
+        uint32_t    numberOfEntries_;
+        uint64_t    fileSize_;
+        int64_t     modificationTime_;
+        uint8_t     assetId_[16];
+    } IndexHeader;
+
+    AuxDataIndex::AuxDataIndex() :
+          fileSize_(0)
+        , modificationTime_(0)
+        , mappedFile_(nullptr)
+        , entries_(nullptr)
+        , numberOfEntries_(0)
+    {
+    }
+
+    AuxDataIndex::~AuxDataIndex()
+    {
+        delete mappedFile_;
+    }
+
+    void AuxDataIndex::Assign(const std::vector<AuxDataIndexEntry> &iEntries
+                              , uint64_t iFileSize
+                              , int64_t iModificationTime
+                              , const UUID &iAssetId)
+    {
+        delete mappedFile_;
+        mappedFile_ = nullptr;
+
+        storage_ = iEntries;
+        entries_ = storage_.empty() ? nullptr : storage_.data();
+        numberOfEntries_ = static_cast<int32_t>(storage_.size());
+
+        fileSize_ = iFileSize;
+        modificationTime_ = iModificationTime;
+        assetId_ = iAssetId;
+    }
+
+    bool AuxDataIndex::Load(const std::string &iSidecarPath)
+    {
+        MappedFile *mappedFile = new MappedFile;
+
+        if (!mappedFile->Open(iSidecarPath) || mappedFile->GetSize() < sizeof(IndexHeader))
+        {
+            delete mappedFile;
+            return false;
+        }
+
+        IndexHeader header;
+        memcpy(&header, mappedFile->GetData(), sizeof(header));
+
+        if (memcmp(header.magic_, sIndexMagic, sizeof(sIndexMagic)) != 0
+            || header.version_ != sIndexVersion
+            || mappedFile->GetSize() != sizeof(IndexHeader) + static_cast<uint64_t>(header.numberOfEntries_) * sizeof(AuxDataIndexEntry))
+        {
+            SMPTE_SYNC_LOG << "AuxDataIndex::Load - invalid sidecar " << iSidecarPath;
+            delete mappedFile;
+            return false;
+        }
+
+        delete mappedFile_;
+        mappedFile_ = mappedFile;
+
+        storage_.clear();
+        entries_ = reinterpret_cast<const AuxDataIndexEntry*>(mappedFile_->GetData() + sizeof(IndexHeader));
+        numberOfEntries_ = static_cast<int32_t>(header.numberOfEntries_);
+
+        fileSize_ = header.fileSize_;
+        modificationTime_ = header.modificationTime_;
+        assetId_ = UUID(header.assetId_);
+
+        return true;
+    }
+
+    bool AuxDataIndex::Save(const std::string &iSidecarPath) const
+    {
+        IndexHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic_, sIndexMagic, sizeof(sIndexMagic));
+        header.version_ = sIndexVersion;
+        header.numberOfEntries_ = static_cast<uint32_t>(numberOfEntries_);
+        header.fileSize_ = fileSize_;
+        header.modificationTime_ = modificationTime_;
+        memcpy(header.assetId_, assetId_.data(), UUID::sizeInBytes_);
+
+        std::string temporaryPath = GetTemporaryPath(iSidecarPath);
+
+        {
+            std::ofstream file(temporaryPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!file)
+                return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            if (numberOfEntries_ > 0)
+                file.write(reinterpret_cast<const char*>(entries_), numberOfEntries_ * sizeof(AuxDataIndexEntry));
+
+            if (!file)
+            {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(temporaryPath.c_str(), iSidecarPath.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool AuxDataIndex::Matches(uint64_t iFileSize, int64_t iModificationTime, const UUID &iAssetId) const
+    {
+        return fileSize_ == iFileSize
+            && modificationTime_ == iModificationTime
+            && assetId_ == iAssetId;
+    }
+
+    int32_t AuxDataIndex::GetNumberOfEntries(void) const
+    {
+        return numberOfEntries_;
+    }
+
+    const AuxDataIndexEntry* AuxDataIndex::GetEntries(void) const
+    {
+        return entries_;
+    }
+
+    bool AuxDataIndex::GetFileIdentity(const std::string &iPath, uint64_t &oFileSize, int64_t &oModificationTime)
+    {
+        struct stat fileStat;
+
+        if (::stat(iPath.c_str(), &fileStat) != 0)
+            return false;
+
+        oFileSize = static_cast<uint64_t>(fileStat.st_size);
+        oModificationTime = static_cast<int64_t>(fileStat.st_mtime) * 1000000000;
+
+#if defined(__linux__)
+        oModificationTime += fileStat.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+        oModificationTime += fileStat.st_mtimespec.tv_nsec;
+#endif
+
+        return true;
+    }
+
+    std::string AuxDataIndex::GetTemporaryPath(const std::string &iPath)
+    {
+        std::ostringstream path;
+        path << iPath << ".tmp." << ::getpid() << "." << boost::this_thread::get_id();
+
+        return path.str();
+    }
+
+}  // namespace SMPTE_SYNC
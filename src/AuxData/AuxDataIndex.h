@@ -0,0 +1,192 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATAINDEX_H
+#define AUXDATAINDEX_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+#include "UUID.h"
+
+namespace SMPTE_SYNC
+{
+    class MappedFile;
+
+    /**
+     *
+     * @brief AuxDataIndexEntry is the location of one edit unit in an aux data track file
+     *
+     */
+    typedef struct AuxDataIndexEntry
+    {
+        /// Offset of the KLV in the file
+        uint64_t    offset_;
+
+        /// Length of the key, length and value
+        uint32_t    klvLength_;
+
+        /// Keeps entries 8 byte aligned in the sidecar file
+        uint32_t    reserved_;
+    } AuxDataIndexEntry;
+
+    /**
+     *
+     * @brief AuxDataIndex is the flat edit unit to (offset, KLV length) table of an aux data track file.
+     * It identifies the track file it was built from by size, modification time and asset UUID
+     * so a stale index is never used for a modified or replaced file.
+     * An index loaded from a sidecar file is memory mapped and used in place.
+     * An AuxDataIndex is immutable once built or loaded and can be shared between threads.
+     *
+     */
+
+    class AuxDataIndex
+    {
+    public:
+
+        /// Constructor
+        AuxDataIndex();
+
+        /// Destructor
+        ~AuxDataIndex();
+
+        /**
+         *
+         * Initializes the index from a table built by parsing the track file
+         *
+         * @param iEntries is the location of each edit unit
+         * @param iFileSize is the size of the track file
+         * @param iModificationTime is the modification time of the track file in nanoseconds
+         * @param iAssetId is the UUID of the track file asset
+         *
+         */
+        void Assign(const std::vector<AuxDataIndexEntry> &iEntries
+                    , uint64_t iFileSize
+                    , int64_t iModificationTime
+                    , const UUID &iAssetId);
+
+        /**
+         *
+         * Maps a sidecar file written by Save
+         *
+         * @param iSidecarPath is the path to the sidecar file
+         * @return bool true/false if the file was mapped and is a valid index
+         *
+         */
+        bool Load(const std::string &iSidecarPath);
+
+        /**
+         *
+         * Writes the index to a sidecar file.
+         * The file is written under a temporary name and renamed so readers never map a partial index.
+         *
+         * @param iSidecarPath is the path to the sidecar file
+         * @return bool true/false if the file was written
+         *
+         */
+        bool Save(const std::string &iSidecarPath) const;
+
+        /**
+         *
+         * Checks the index was built from a track file with this identity
+         *
+         * @param iFileSize is the current size of the track file
+         * @param iModificationTime is the current modification time of the track file in nanoseconds
+         * @param iAssetId is the UUID of the track file asset
+         * @return bool true if the index describes the track file
+         *
+         */
+        bool Matches(uint64_t iFileSize, int64_t iModificationTime, const UUID &iAssetId) const;
+
+        /// Returns the number of edit units in the index
+        int32_t GetNumberOfEntries(void) const;
+
+        /// Returns the flat table of entries. Entry n is edit unit n of the track file.
+        const AuxDataIndexEntry* GetEntries(void) const;
+
+        /**
+         *
+         * Reads the size and modification time of a file
+         *
+         * @param iPath is the path to the file
+         * @param oFileSize is the size of the file
+         * @param oModificationTime is the modification time of the file in nanoseconds
+         * @return bool true/false if the file exists
+         *
+         */
+        static bool GetFileIdentity(const std::string &iPath, uint64_t &oFileSize, int64_t &oModificationTime);
+
+        /**
+         *
+         * Builds the path of the temporary file written before it is renamed to iPath.
+         * Includes the process and thread id so concurrent writers of the same file never share a temporary file.
+         *
+         * @param iPath is the path of the file being written
+         * @return std::string path next to iPath
+         *
+         */
+        static std::string GetTemporaryPath(const std::string &iPath);
+
+    private:
+
+        /// Not copyable
+        AuxDataIndex(const AuxDataIndex&);
+        AuxDataIndex& operator=(const AuxDataIndex&);
+
+        /// Size of the track file
+        uint64_t            fileSize_;
+
+        /// Modification time of the track file in nanoseconds
+        int64_t             modificationTime_;
+
+        /// UUID of the track file asset
+        UUID                assetId_;
+
+        /// Entries built in memory by Assign
+        std::vector<AuxDataIndexEntry> storage_;
+
+        /// Sidecar mapped by Load
+        MappedFile          *mappedFile_;
+
+        /// Points into storage_ or mappedFile_
+        const AuxDataIndexEntry *entries_;
+
+        /// Number of entries
+        int32_t             numberOfEntries_;
+    };
+
+    /// Reference to an immutable AuxDataIndex shared by the AuxDataParser objects of a track file
+    typedef boost::shared_ptr<const AuxDataIndex> AuxDataIndexPtr;
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATAINDEX_H
@@ -0,0 +1,150 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataIndexCache.h"
+
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    AuxDataIndexCache::AuxDataIndexCache()
+    {
+    }
+
+    AuxDataIndexCache::~AuxDataIndexCache()
+    {
+    }
+
+    AuxDataIndexPtr AuxDataIndexCache::Find(const std::string &iPath, const UUID &iAssetId)
+    {
+        uint64_t fileSize = 0;
+        int64_t modificationTime = 0;
+
+        if (!AuxDataIndex::GetFileIdentity(iPath, fileSize, modificationTime))
+            return AuxDataIndexPtr();
+
+        std::string sidecarPath;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+            std::map<std::string, AuxDataIndexPtr>::iterator iter = indexes_.find(iPath);
+            if (iter != indexes_.end())
+            {
+                if (iter->second->Matches(fileSize, modificationTime, iAssetId))
+                    return iter->second;
+
+                SMPTE_SYNC_LOG << "AuxDataIndexCache::Find - " << iPath << " changed since it was indexed";
+                indexes_.erase(iter);
+            }
+
+            if (directory_.empty())
+                return AuxDataIndexPtr();
+
+            sidecarPath = this->BuildSidecarPath(iPath);
+        }
+
+        // Map the sidecar without holding the lock
+        //
+        AuxDataIndex *index = new AuxDataIndex;
+
+        if (!index->Load(sidecarPath) || !index->Matches(fileSize, modificationTime, iAssetId))
+        {
+            delete index;
+            return AuxDataIndexPtr();
+        }
+
+        AuxDataIndexPtr indexPtr(index);
+
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        indexes_[iPath] = indexPtr;
+
+        return indexPtr;
+    }
+
+    void AuxDataIndexCache::Store(const std::string &iPath, const AuxDataIndexPtr &iIndex)
+    {
+        std::string sidecarPath;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+
+            indexes_[iPath] = iIndex;
+
+            if (directory_.empty())
+                return;
+
+            sidecarPath = this->BuildSidecarPath(iPath);
+        }
+
+        if (!iIndex->Save(sidecarPath))
+        {
+            SMPTE_SYNC_LOG << "AuxDataIndexCache::Store - unable to write " << sidecarPath;
+        }
+    }
+
+    void AuxDataIndexCache::Clear(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        indexes_.clear();
+    }
+
+    void AuxDataIndexCache::SetDirectory(const std::string &iDirectory)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        directory_ = iDirectory;
+    }
+
+    std::string AuxDataIndexCache::GetDirectory(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(cacheMutex_);
+        return directory_;
+    }
+
+    std::string AuxDataIndexCache::BuildSidecarPath(const std::string &iPath)
+    {
+        // Named after a hash of the track file path. The asset UUID is checked when the sidecar is loaded.
+        //
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << static_cast<uint64_t>(std::hash<std::string>()(iPath)) << ".auxidx";
+
+        std::string path = directory_;
+
+        if (path[path.size() - 1] != '/')
+            path += "/";
+
+        return path + name.str();
+    }
+
+}  // namespace SMPTE_SYNC
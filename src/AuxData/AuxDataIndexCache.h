@@ -0,0 +1,111 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATAINDEXCACHE_H
+#define AUXDATAINDEXCACHE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "boost/thread/mutex.hpp"
+
+#include "AuxDataIndex.h"
+#include "UUID.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief AuxDataIndexCache keeps the AuxDataIndex of each aux data track file opened by the process.
+     * Optionally each index is also persisted as a sidecar file in a directory so it survives restarts.
+     * Reopening a track file with a valid index skips parsing the MXF header and index table.
+     * Every index is validated against the size, modification time and asset UUID of the track file before it is used.
+     * The cache is threadsafe.
+     *
+     */
+
+    class AuxDataIndexCache
+    {
+    public:
+
+        /// Constructor
+        AuxDataIndexCache();
+
+        /// Destructor
+        ~AuxDataIndexCache();
+
+        /**
+         *
+         * Returns the index of a track file if the cache or its sidecar has a valid one
+         *
+         * @param iPath is the path to the track file
+         * @param iAssetId is the UUID of the track file asset
+         * @return AuxDataIndexPtr to the index, empty if there is no valid index
+         *
+         */
+        AuxDataIndexPtr Find(const std::string &iPath, const UUID &iAssetId);
+
+        /**
+         *
+         * Adds the index of a track file and writes its sidecar if a directory is set
+         *
+         * @param iPath is the path to the track file
+         * @param iIndex is the index built from the track file
+         *
+         */
+        void Store(const std::string &iPath, const AuxDataIndexPtr &iIndex);
+
+        /// Drops the indexes kept in memory. Sidecar files are kept.
+        void Clear(void);
+
+        /// Sets the directory sidecar files are read from and written to. An empty string keeps indexes in memory only.
+        void SetDirectory(const std::string &iDirectory);
+
+        /// Gets the directory of the sidecar files
+        std::string GetDirectory(void);
+
+    private:
+
+        /// Builds the path to the sidecar of a track file. Requires cacheMutex_ to be held.
+        std::string BuildSidecarPath(const std::string &iPath);
+
+        /// Protects indexes_ and directory_
+        boost::mutex    cacheMutex_;
+
+        /// Indexes keyed by track file path
+        std::map<std::string, AuxDataIndexPtr> indexes_;
+
+        /// Directory of the sidecar files
+        std::string     directory_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATAINDEXCACHE_H
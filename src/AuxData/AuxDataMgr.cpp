@@ -36,47 +36,485 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+
+#include "boost/thread/thread.hpp"
 
 #include "Logger.h"
 
 namespace SMPTE_SYNC
 {
-    AuxDataMgr::AuxDataMgr()
+    // Number of AuxDataBlock objects in each slab.
+    // Roughly ten seconds of edit units at 24 fps, the default amount requested by the SS_Client
+    //
+    static const size_t sDataItemsPerSlab = 256;
+
+    // Number of times a busy slot is checked before the waiting thread yields.
+    // A slot is only busy for the few instructions it takes to swap or copy its AuxDataBlock
+    //
+    static const uint32_t sSpinsBeforeYield = 64;
+
+    // Waits a little longer for a busy slot with every attempt.
+    // Spins at first, then yields so a thread changing the slot that was preempted can finish
+    //
+    static void BackOff(uint32_t &ioAttempts)
+    {
+        if (++ioAttempts > sSpinsBeforeYield)
+            boost::this_thread::yield();
+    }
+
+    const uint32_t AuxDataMgr::defaultCapacity_;
+    const int64_t AuxDataMgr::sEmptySlot;
+    const int64_t AuxDataMgr::sBusySlot;
+
+    AuxDataMgr::AuxDataMgr(uint32_t iCapacity, uint64_t iMaxBufferedBytes)
+        : capacity_(iCapacity > 0 ? iCapacity : 1)
+        , slots_(nullptr)
+        , maxBufferedBytes_(iMaxBufferedBytes)
+        , bufferedBytes_(0)
+        , receiveBufferBytes_(0)
+        , numberOfReceiveBuffers_(0)
+        , peakBufferedBytes_(0)
+        , numberOfBlocks_(0)
+        , addedBytes_(0)
+        , addedBlocks_(0)
+        , evictedBlocks_(0)
+        , rejectedBlocks_(0)
+        , playhead_(0)
     {
         SMPTE_SYNC_LOG << "AuxDataMgr::AuxDataMgr\n";
-        auxDataQueue_ = new DataQueue(0);
+        slots_ = new Slot[capacity_];
     }
     
     AuxDataMgr::~AuxDataMgr()
     {
         SMPTE_SYNC_LOG << "AuxDataMgr::~AuxDataMgr\n";
 
-        AuxDataBlock *auxData = nullptr;
-        while (auxDataQueue_->pop(auxData))
+        this->Clear();
+        
+        delete [] slots_;
+
+        // Any AuxDataBlock still held by a consumer is freed with its slab
+        //
+        size_t heldDataItems = slabs_.size() * sDataItemsPerSlab - freeDataItems_.size();
+        if (heldDataItems > 0)
         {
-            delete auxData;
-            auxData = nullptr;
+            SMPTE_SYNC_LOG << "AuxDataMgr::~AuxDataMgr " << heldDataItems << " AuxDataBlock objects were not released";
         }
-        
-        delete auxDataQueue_;
+
+        for (size_t i = 0; i < slabs_.size(); i++)
+            delete [] slabs_[i];
+    }
+
+    AuxDataBlock* AuxDataMgr::NewDataItem(void)
+    {
+        AuxDataBlockStorage *storage = nullptr;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(slabMutex_);
+
+            if (freeDataItems_.empty())
+            {
+                AuxDataBlockStorage *slab = new AuxDataBlockStorage[sDataItemsPerSlab];
+                slabs_.push_back(slab);
+
+                freeDataItems_.reserve(slabs_.size() * sDataItemsPerSlab);
+                for (size_t i = sDataItemsPerSlab; i > 0; i--)
+                    freeDataItems_.push_back(&slab[i - 1]);
+            }
+
+            storage = freeDataItems_.back();
+            freeDataItems_.pop_back();
+        }
+
+        return new (storage) AuxDataBlock();
+    }
+
+    void AuxDataMgr::ReleaseDataItem(AuxDataBlock* iItem)
+    {
+        if (iItem == nullptr)
+            return;
+
+        // Drop the reference to the received bytes outside of the lock
+        //
+        iItem->~AuxDataBlock();
+
+        boost::mutex::scoped_lock scoped_lock(slabMutex_);
+        freeDataItems_.push_back(reinterpret_cast<AuxDataBlockStorage*>(iItem));
+    }
+
+    size_t AuxDataMgr::GetNumberOfSlabs(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(slabMutex_);
+        return slabs_.size();
+    }
+
+    uint32_t AuxDataMgr::GetCapacity(void) const
+    {
+        return capacity_;
+    }
+
+    AuxDataMgr::Slot& AuxDataMgr::GetSlot(uint32_t iEditUnit)
+    {
+        return slots_[iEditUnit % capacity_];
+    }
+
+    void AuxDataMgr::SetMaxBufferedBytes(uint64_t iMaxBufferedBytes)
+    {
+        maxBufferedBytes_ = iMaxBufferedBytes;
+    }
+
+    uint64_t AuxDataMgr::GetMaxBufferedBytes(void) const
+    {
+        return maxBufferedBytes_;
+    }
+
+    uint64_t AuxDataMgr::GetBufferedBytes(void) const
+    {
+        return bufferedBytes_;
+    }
+
+    void AuxDataMgr::SetPlayhead(uint32_t iEditUnit)
+    {
+        playhead_ = iEditUnit;
+    }
+
+    AuxDataMgr::ReceiveBufferCharge::ReceiveBufferCharge(AuxDataMgr *iAuxDataMgr, const AuxDataBufferPtr &iBuffer)
+        : auxDataMgr_(iAuxDataMgr)
+        , buffer_(iBuffer)
+        , bytes_(iBuffer->size())
+    {
+        auxDataMgr_->receiveBufferBytes_ += bytes_;
+        auxDataMgr_->numberOfReceiveBuffers_++;
+    }
+
+    AuxDataMgr::ReceiveBufferCharge::~ReceiveBufferCharge()
+    {
+        auxDataMgr_->receiveBufferBytes_ -= bytes_;
+        auxDataMgr_->numberOfReceiveBuffers_--;
+        auxDataMgr_->bufferedBytes_ -= bytes_;
+    }
+
+    AuxDataBufferPtr AuxDataMgr::ChargeBuffer(const AuxDataBufferPtr &iBuffer)
+    {
+        if (!iBuffer || !this->Reserve(iBuffer->size()))
+            return AuxDataBufferPtr();
+
+        // The returned pointer shares ownership of the charge and points at the buffer itself
+        //
+        boost::shared_ptr<ReceiveBufferCharge> charge(new ReceiveBufferCharge(this, iBuffer));
+        return AuxDataBufferPtr(charge, iBuffer.get());
+    }
+
+    uint64_t AuxDataMgr::GetChargedBytes(const AuxDataBlock *iItem)
+    {
+        if (iItem->buffer_)
+            return 0;
+
+        return static_cast<uint64_t>(iItem->GetSizeInBytes());
+    }
+
+    void AuxDataMgr::Discard(AuxDataBlock *iItem)
+    {
+        if (iItem == nullptr)
+            return;
+
+        bufferedBytes_ -= GetChargedBytes(iItem);
+        numberOfBlocks_--;
+
+        this->ReleaseDataItem(iItem);
+    }
+
+    int64_t AuxDataMgr::AcquireSlot(Slot &ioSlot)
+    {
+        uint32_t attempts = 0;
+
+        for (;;)
+        {
+            int64_t editUnit = ioSlot.editUnit_.load();
+            if (editUnit != sBusySlot && ioSlot.editUnit_.compare_exchange_weak(editUnit, sBusySlot))
+                return editUnit;
+
+            BackOff(attempts);
+        }
+    }
+
+    void AuxDataMgr::PublishSlot(Slot &ioSlot, int64_t iEditUnit)
+    {
+        ioSlot.editUnit_.store(ioSlot.block_ != nullptr ? iEditUnit : sEmptySlot);
+    }
+
+    int64_t AuxDataMgr::LoadSlot(Slot &ioSlot)
+    {
+        uint32_t attempts = 0;
+
+        int64_t editUnit = ioSlot.editUnit_.load();
+        while (editUnit == sBusySlot)
+        {
+            BackOff(attempts);
+            editUnit = ioSlot.editUnit_.load();
+        }
+
+        return editUnit;
+    }
+
+    bool AuxDataMgr::ReleaseSlot(Slot &ioSlot, uint64_t iStartEditUnit, uint64_t iEndEditUnit)
+    {
+        // An empty slot holds no AuxDataBlock, so there is nothing to reclaim
+        //
+        int64_t editUnit = this->LoadSlot(ioSlot);
+        if (editUnit < 0 || static_cast<uint64_t>(editUnit) < iStartEditUnit || static_cast<uint64_t>(editUnit) >= iEndEditUnit)
+            return false;
+
+        // Check again now that no other thread can change the slot
+        //
+        editUnit = this->AcquireSlot(ioSlot);
+
+        AuxDataBlock *item = nullptr;
+        if (editUnit >= 0 && static_cast<uint64_t>(editUnit) >= iStartEditUnit && static_cast<uint64_t>(editUnit) < iEndEditUnit)
+        {
+            item = ioSlot.block_;
+            ioSlot.block_ = nullptr;
+        }
+
+        this->PublishSlot(ioSlot, editUnit);
+
+        this->Discard(item);
+
+        return item != nullptr;
+    }
+
+    bool AuxDataMgr::TryReserve(uint64_t iBytes)
+    {
+        uint64_t maxBufferedBytes = maxBufferedBytes_;
+        uint64_t bufferedBytes = bufferedBytes_;
+
+        do
+        {
+            if (maxBufferedBytes > 0 && bufferedBytes + iBytes > maxBufferedBytes)
+                return false;
+        }
+        while (!bufferedBytes_.compare_exchange_weak(bufferedBytes, bufferedBytes + iBytes));
+
+        bufferedBytes += iBytes;
+
+        uint64_t peak = peakBufferedBytes_;
+        while (bufferedBytes > peak && !peakBufferedBytes_.compare_exchange_weak(peak, bufferedBytes))
+        {
+        }
+
+        return true;
     }
 
-    AuxDataBlock* AuxDataMgr::GetNextDataItem(void)
+    bool AuxDataMgr::Reserve(uint64_t iBytes)
     {
-        AuxDataBlock* item = nullptr;
+        if (this->TryReserve(iBytes))
+            return true;
+
+        evictedBlocks_ += this->EvictBefore(playhead_);
 
-        auxDataQueue_->pop(item);
+        if (this->TryReserve(iBytes))
+            return true;
 
-        return item;
+        rejectedBlocks_++;
+        return false;
     }
 
     bool AuxDataMgr::AddDataItem(AuxDataBlock* iItem)
     {
-        bool success = true;
-        
-        success = auxDataQueue_->push(iItem);
-        
-        return success;
+        if (iItem == nullptr)
+            return false;
+
+        uint64_t size = static_cast<uint64_t>(iItem->GetSizeInBytes());
+
+        addedBytes_ += size;
+        addedBlocks_++;
+
+        // Reserve the bytes before storing so concurrent producers cannot overshoot the budget together
+        //
+        if (!this->Reserve(GetChargedBytes(iItem)))
+        {
+            this->ReleaseDataItem(iItem);
+            return false;
+        }
+
+        numberOfBlocks_++;
+
+        Slot &slot = this->GetSlot(iItem->editUnitIndex_);
+
+        this->AcquireSlot(slot);
+
+        AuxDataBlock *previous = slot.block_;
+        slot.block_ = iItem;
+
+        this->PublishSlot(slot, iItem->editUnitIndex_);
+
+        this->Discard(previous);
+
+        return true;
+    }
+
+    bool AuxDataMgr::GetDataItem(uint32_t iEditUnit, AuxDataBlock &oItem)
+    {
+        Slot &slot = this->GetSlot(iEditUnit);
+
+        if (this->LoadSlot(slot) != static_cast<int64_t>(iEditUnit))
+            return false;
+
+        // Hold the slot so the AuxDataBlock cannot be released while it is copied
+        //
+        int64_t editUnit = this->AcquireSlot(slot);
+
+        bool found = editUnit == static_cast<int64_t>(iEditUnit);
+        if (found)
+            oItem = *slot.block_;
+
+        this->PublishSlot(slot, editUnit);
+
+        return found;
+    }
+
+    uint32_t AuxDataMgr::Invalidate(uint32_t iStartEditUnit, uint32_t iCount)
+    {
+        uint32_t released = 0;
+        uint64_t end = static_cast<uint64_t>(iStartEditUnit) + iCount;
+
+        // Every slot is visited at most once however long the range is
+        //
+        uint32_t count = std::min(iCount, capacity_);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (this->ReleaseSlot(this->GetSlot(iStartEditUnit + i), iStartEditUnit, end))
+                released++;
+        }
+
+        return released;
+    }
+
+    uint32_t AuxDataMgr::EvictBefore(uint32_t iEditUnit)
+    {
+        uint32_t released = 0;
+
+        for (uint32_t i = 0; i < capacity_ && iEditUnit > 0; i++)
+        {
+            if (this->ReleaseSlot(slots_[i], 0, iEditUnit))
+                released++;
+        }
+
+        return released;
+    }
+
+    uint32_t AuxDataMgr::CountBefore(uint32_t iEditUnit)
+    {
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < capacity_; i++)
+        {
+            int64_t editUnit = this->LoadSlot(slots_[i]);
+            if (editUnit >= 0 && editUnit < static_cast<int64_t>(iEditUnit))
+                count++;
+        }
+
+        return count;
+    }
+
+    uint32_t AuxDataMgr::InvalidateOutside(uint32_t iStartEditUnit, uint32_t iCount)
+    {
+        uint32_t released = 0;
+        uint64_t end = static_cast<uint64_t>(iStartEditUnit) + iCount;
+
+        for (uint32_t i = 0; i < capacity_; i++)
+        {
+            if (this->ReleaseSlot(slots_[i], 0, iStartEditUnit)
+                || this->ReleaseSlot(slots_[i], end, UINT64_MAX))
+                released++;
+        }
+
+        return released;
+    }
+
+    void AuxDataMgr::Clear(void)
+    {
+        for (uint32_t i = 0; i < capacity_; i++)
+        {
+            this->AcquireSlot(slots_[i]);
+
+            AuxDataBlock *item = slots_[i].block_;
+            slots_[i].block_ = nullptr;
+
+            this->PublishSlot(slots_[i], sEmptySlot);
+
+            this->Discard(item);
+        }
+    }
+
+    uint32_t AuxDataMgr::CountBuffered(uint32_t iEditUnit, uint32_t iMaxCount)
+    {
+        uint32_t count = 0;
+        uint32_t maxCount = std::min(iMaxCount, capacity_);
+
+        while (count < maxCount
+               && this->LoadSlot(this->GetSlot(iEditUnit + count)) == static_cast<int64_t>(iEditUnit) + count)
+        {
+            count++;
+        }
+
+        return count;
+    }
+
+    uint32_t AuxDataMgr::GetBufferedCount(uint32_t iEditUnit)
+    {
+        return this->CountBuffered(iEditUnit, capacity_);
+    }
+
+    bool AuxDataMgr::IsBelowLowWaterMark(uint32_t iEditUnit, uint32_t iLowWaterMark)
+    {
+        return this->CountBuffered(iEditUnit, iLowWaterMark) < iLowWaterMark;
+    }
+
+    uint32_t AuxDataMgr::GetEditUnitsWithinBudget(uint32_t iStartEditUnit, uint32_t iCount)
+    {
+        uint32_t count = iCount;
+
+        // Edit units past the capacity ahead of the playhead would replace edit units not played yet
+        //
+        uint64_t end = static_cast<uint64_t>(playhead_) + capacity_;
+        if (iStartEditUnit >= end)
+            return 0;
+
+        count = static_cast<uint32_t>(std::min<uint64_t>(count, end - iStartEditUnit));
+
+        uint64_t maxBufferedBytes = maxBufferedBytes_;
+        uint64_t addedBlocks = addedBlocks_;
+        if (maxBufferedBytes == 0 || addedBlocks == 0 || count == 0)
+            return count;
+
+        // Estimate the bytes of the request from the edit units received so far
+        //
+        uint64_t bytesPerEditUnit = std::max<uint64_t>(addedBytes_ / addedBlocks, 1);
+
+        // The edit units behind the playhead are evicted once the response needs their room
+        //
+        uint64_t bufferedBytes = bufferedBytes_;
+        uint64_t evictableBytes = std::min<uint64_t>(bufferedBytes, this->CountBefore(playhead_) * bytesPerEditUnit);
+        uint64_t usedBytes = bufferedBytes - evictableBytes;
+        uint64_t availableBytes = usedBytes < maxBufferedBytes ? maxBufferedBytes - usedBytes : 0;
+
+        return static_cast<uint32_t>(std::min<uint64_t>(count, availableBytes / bytesPerEditUnit));
+    }
+
+    void AuxDataMgr::GetMemoryStatistics(AuxDataMemoryStatistics &oStatistics)
+    {
+        oStatistics.bufferedBytes_ = bufferedBytes_;
+        oStatistics.peakBufferedBytes_ = peakBufferedBytes_;
+        oStatistics.maxBufferedBytes_ = maxBufferedBytes_;
+        oStatistics.numberOfBlocks_ = numberOfBlocks_;
+        oStatistics.capacity_ = capacity_;
+        oStatistics.slabBytes_ = this->GetNumberOfSlabs() * sDataItemsPerSlab * sizeof(AuxDataBlockStorage);
+        oStatistics.receiveBufferBytes_ = receiveBufferBytes_;
+        oStatistics.numberOfReceiveBuffers_ = numberOfReceiveBuffers_;
+        oStatistics.evictedBlocks_ = evictedBlocks_;
+        oStatistics.rejectedBlocks_ = rejectedBlocks_;
     }
 
 }  // namespace SMPTE_SYNC
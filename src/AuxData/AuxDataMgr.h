@@ -34,8 +34,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
+#include <type_traits>
 
-#include "boost/lockfree/queue.hpp"
+#include "boost/atomic.hpp"
+#include "boost/thread/mutex.hpp"
 
 #include "DataTypes.h"
 #include "AuxData.h"
@@ -43,45 +46,423 @@
 namespace SMPTE_SYNC
 {
     /**
-     * @brief AuxDataMgr class implements a threadsafe queue for storing in coming AuxDataBlock pointers.
+     * @brief AuxDataMemoryStatistics is a snapshot of the memory gauges of the AuxDataMgr
+     *
+     */
+    typedef struct AuxDataMemoryStatistics
+    {
+        /// Constructor
+        AuxDataMemoryStatistics() :
+              bufferedBytes_(0)
+            , peakBufferedBytes_(0)
+            , maxBufferedBytes_(0)
+            , numberOfBlocks_(0)
+            , capacity_(0)
+            , slabBytes_(0)
+            , receiveBufferBytes_(0)
+            , numberOfReceiveBuffers_(0)
+            , evictedBlocks_(0)
+            , rejectedBlocks_(0)
+        {
+        }
+
+        /// Number of bytes charged to the byte budget: the receive buffers and the AuxDataBlock objects not referencing one
+        uint64_t    bufferedBytes_;
+
+        /// Highest bufferedBytes_ seen
+        uint64_t    peakBufferedBytes_;
+
+        /// Byte budget of the ring, 0 if unlimited
+        uint64_t    maxBufferedBytes_;
+
+        /// Number of AuxDataBlock objects in the ring
+        uint64_t    numberOfBlocks_;
+
+        /// Number of edit units the ring holds
+        uint64_t    capacity_;
+
+        /// Number of bytes allocated for the slabs of AuxDataBlock objects
+        uint64_t    slabBytes_;
+
+        /// Number of bytes of the receive buffers referenced by AuxDataBlock objects. Included in bufferedBytes_.
+        uint64_t    receiveBufferBytes_;
+
+        /// Number of receive buffers referenced by AuxDataBlock objects
+        uint64_t    numberOfReceiveBuffers_;
+
+        /// Number of AuxDataBlock objects behind the playhead evicted to stay within the byte budget
+        uint64_t    evictedBlocks_;
+
+        /// Number of AuxDataBlock objects and receive buffers rejected because the byte budget was reached
+        uint64_t    rejectedBlocks_;
+    } AuxDataMemoryStatistics;
+
+    /**
+     * @brief AuxDataMgr class implements a threadsafe ring for storing in coming AuxDataBlock pointers.
      * The AuxDataMgr is used on the client side or processor (rather than server side) to store data until
      * the sync signal is received and can be used to validate the AuxDataBlock and the syncSignal objects.
      *
+     * The ring has a fixed number of slots and is indexed by edit unit (editUnitIndex_ modulo the capacity),
+     * so looking up an edit unit takes constant time wherever the playhead jumps. An AuxDataBlock stays in
+     * its slot after it has been looked up until a later edit unit mapping to the same slot replaces it or
+     * its range is invalidated, so a backward seek within the capacity does not need to fetch it again.
+     * Each slot is published through a single atomic edit unit that is briefly marked busy while the slot changes,
+     * so the edit unit and the AuxDataBlock of a slot always agree. Any number of threads can add, look up or invalidate.
+     * Marking a slot busy makes it a per-slot spinlock, so the ring is not lock-free: a thread reaching a busy slot
+     * spins and then yields until the thread changing it is done. Threads working on different slots never wait
+     * for each other, and a slot is only held for the few instructions it takes to swap or copy its AuxDataBlock.
+     *
+     * Besides the capacity in edit units the ring can be limited to a number of bytes. An AuxDataBlock whose payload
+     * lives in a receive buffer is charged through ChargeBuffer, once per buffer for as long as any AuxDataBlock references it.
+     * Any other AuxDataBlock is charged its own size. The bytes are reserved before they are stored, so concurrent producers
+     * never overshoot the budget together. Once the budget is reached the edit units behind the playhead are evicted first
+     * and what still does not fit is rejected, which gives a hard ceiling on the buffered aux data.
+     * The fetcher sizes its requests with GetEditUnitsWithinBudget.
+     *
+     * The AuxDataBlock objects are carved out of slabs owned by the AuxDataMgr rather than allocated one by one.
+     * The producer gets them with NewDataItem and the AuxDataMgr releases them once they leave the ring.
+     *
      */
     class AuxDataMgr
     {
     public:
 
-        /// Constructor
-        AuxDataMgr();
+        /// Default number of edit units held by the ring. About 40 seconds at 24 fps.
+        static const uint32_t defaultCapacity_ = 1024;
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iCapacity is the number of edit units the ring holds
+         * @param iMaxBufferedBytes is the number of bytes of AuxDataBlock objects the ring holds. 0 for no byte budget.
+         *
+         */
+        explicit AuxDataMgr(uint32_t iCapacity = defaultCapacity_, uint64_t iMaxBufferedBytes = 0);
 
         /// Destructor
         ~AuxDataMgr();
 
         /**
          *
-         * Returns the a pointer to the AuxDataBlock that was just dequeued.
-         * The caller is expected to delete the AuxDataBlock.
+         * Returns an empty AuxDataBlock from the slabs of the AuxDataMgr. A new slab is allocated if all are in use.
+         * The AuxDataBlock is expected to be added with AddDataItem or released with ReleaseDataItem.
          *
          * @return AuxDataBlock pointer
          *
          */
-        AuxDataBlock* GetNextDataItem(void);
-        
+        AuxDataBlock* NewDataItem(void);
+
+        /**
+         *
+         * Returns an AuxDataBlock to the slabs of the AuxDataMgr. Drops its reference to the received bytes.
+         *
+         * @param iItem is a AuxDataBlock pointer from NewDataItem that has not been added. Can be nullptr.
+         *
+         */
+        void ReleaseDataItem(AuxDataBlock* iItem);
+
+        /// Gets the number of slabs allocated for AuxDataBlock objects
+        size_t GetNumberOfSlabs(void);
+
+        /// Gets the number of edit units the ring holds
+        uint32_t GetCapacity(void) const;
+
+        /// Sets the byte budget of the ring. 0 for no byte budget. Takes effect with the next AddDataItem.
+        void SetMaxBufferedBytes(uint64_t iMaxBufferedBytes);
+
+        /// Gets the byte budget of the ring. 0 if there is no byte budget.
+        uint64_t GetMaxBufferedBytes(void) const;
+
+        /// Gets the number of bytes charged to the byte budget
+        uint64_t GetBufferedBytes(void) const;
+
+        /**
+         *
+         * Charges a receive buffer to the byte budget before the first AuxDataBlock referencing it is added.
+         * The edit units behind the playhead are evicted if the buffer does not fit otherwise.
+         * The charge is released once the returned pointer and every copy of it are gone, so the AuxDataBlock
+         * objects given it as their buffer_ keep it charged for exactly as long as they keep the bytes alive.
+         * The AuxDataMgr must outlive the returned pointer.
+         *
+         * @param iBuffer is the receive buffer
+         * @return a pointer to the same bytes that holds the charge, empty if the buffer does not fit in the byte budget
+         *
+         */
+        AuxDataBufferPtr ChargeBuffer(const AuxDataBufferPtr &iBuffer);
+
+        /**
+         *
+         * Sets the edit unit being played. Edit units before it are the first to be evicted when the byte budget is reached.
+         *
+         * @param iEditUnit is the current edit unit of the playhead
+         *
+         */
+        void SetPlayhead(uint32_t iEditUnit);
+
         /**
          *
-         * Enqueues a pointer to the AuxDataBlock that was just received from the HTTP call requesting data.
+         * Stores the AuxDataBlock that was just received from the HTTP call requesting data in the slot of its edit unit.
+         * The AuxDataBlock previously in the slot is released.
+         * An AuxDataBlock with a buffer_ is already charged through ChargeBuffer. Any other is charged its size,
+         * and if that would exceed the byte budget the edit units behind the playhead are evicted.
+         * If it still does not fit it is rejected and released.
          *
-         * @param iItem is a AuxDataBlock pointer to an object received and created by the SS_Client
-         * @return true/false if the AuxDataBlock has been enqueued. This should not fail under normal circumstances.
+         * @param iItem is a AuxDataBlock pointer from NewDataItem received by the SS_Client. Owned by the AuxDataMgr from now on.
+         * @return true/false if the AuxDataBlock has been stored. False if it did not fit in the byte budget.
          *
          */
         bool AddDataItem(AuxDataBlock* iItem);
-        
+
+        /**
+         *
+         * Looks up the AuxDataBlock of an edit unit. The AuxDataBlock stays in the ring.
+         *
+         * @param iEditUnit is the edit unit to look up
+         * @param oItem is set to a copy of the AuxDataBlock. The copy shares the payload rather than copying it.
+         * @return true/false if the AuxDataBlock of iEditUnit is in the ring
+         *
+         */
+        bool GetDataItem(uint32_t iEditUnit, AuxDataBlock &oItem);
+
+        /**
+         *
+         * Releases the AuxDataBlock objects of a range of edit units, such as after a seek away from them.
+         *
+         * @param iStartEditUnit is the first edit unit of the range
+         * @param iCount is the number of edit units in the range
+         * @return the number of AuxDataBlock objects released
+         *
+         */
+        uint32_t Invalidate(uint32_t iStartEditUnit, uint32_t iCount);
+
+        /**
+         *
+         * Releases the AuxDataBlock objects of every edit unit outside a range, such as after a seek into it.
+         *
+         * @param iStartEditUnit is the first edit unit of the range to keep
+         * @param iCount is the number of edit units in the range to keep
+         * @return the number of AuxDataBlock objects released
+         *
+         */
+        uint32_t InvalidateOutside(uint32_t iStartEditUnit, uint32_t iCount);
+
+        /// Releases every AuxDataBlock in the ring
+        void Clear(void);
+
+        /**
+         *
+         * Counts the edit units from iEditUnit onwards that are in the ring without a gap.
+         * This is the headroom the prefetcher has before the playhead at iEditUnit runs out of data.
+         *
+         * @param iEditUnit is the first edit unit, typically the playhead
+         * @return the number of consecutive edit units in the ring, at most the capacity
+         *
+         */
+        uint32_t GetBufferedCount(uint32_t iEditUnit);
+
+        /**
+         *
+         * Returns true if fewer than iLowWaterMark consecutive edit units from iEditUnit are in the ring.
+         * Stops counting at iLowWaterMark so the query is cheap when the ring is well stocked.
+         *
+         * @param iEditUnit is the first edit unit, typically the playhead
+         * @param iLowWaterMark is the number of edit units below which more data should be fetched
+         * @return true/false if the buffered edit units are below iLowWaterMark
+         *
+         */
+        bool IsBelowLowWaterMark(uint32_t iEditUnit, uint32_t iLowWaterMark);
+
+        /**
+         *
+         * Releases the AuxDataBlock objects of the edit units before iEditUnit.
+         *
+         * @param iEditUnit is the first edit unit to keep
+         * @return the number of AuxDataBlock objects released
+         *
+         */
+        uint32_t EvictBefore(uint32_t iEditUnit);
+
+        /**
+         *
+         * Clips the number of edit units a request starting at iStartEditUnit should ask for so the response
+         * fits in the ring. The capacity is counted from the playhead and the byte budget is estimated from the
+         * average size of the AuxDataBlock objects received so far. The edit units behind the playhead count as
+         * room since they are evicted once the response needs it. Does not change the ring.
+         *
+         * @param iStartEditUnit is the first edit unit of the request
+         * @param iCount is the number of edit units the request would like
+         * @return the number of edit units that fit, 0 if the request should wait for the playhead to move on
+         *
+         */
+        uint32_t GetEditUnitsWithinBudget(uint32_t iStartEditUnit, uint32_t iCount);
+
+        /// Fills in oStatistics with the current memory gauges
+        void GetMemoryStatistics(AuxDataMemoryStatistics &oStatistics);
+
     private:
-        typedef boost::lockfree::queue<AuxDataBlock*, boost::lockfree::fixed_sized<false>> DataQueue;
 
-        DataQueue *auxDataQueue_;
+        /// Storage for one AuxDataBlock in a slab
+        typedef std::aligned_storage<sizeof(AuxDataBlock), alignof(AuxDataBlock)>::type AuxDataBlockStorage;
+
+        /**
+         * @brief Slot of the ring.
+         * editUnit_ publishes the slot. Whoever swaps it to sBusySlot may change block_ until it stores the new edit unit.
+         * Outside of that editUnit_ is sEmptySlot exactly when block_ is nullptr.
+         *
+         */
+        struct Slot
+        {
+            Slot() : block_(nullptr), editUnit_(sEmptySlot) {}
+
+            /// The AuxDataBlock in the slot, nullptr if empty. Only accessed while editUnit_ is sBusySlot.
+            AuxDataBlock                    *block_;
+
+            /// Edit unit of block_, sEmptySlot if empty, sBusySlot while the slot is being changed
+            boost::atomic<int64_t>          editUnit_;
+        };
+
+        /// Marks an empty Slot
+        static const int64_t sEmptySlot = -1;
+
+        /// Marks a Slot being changed
+        static const int64_t sBusySlot = -2;
+
+        /// Gets the Slot of an edit unit
+        Slot& GetSlot(uint32_t iEditUnit);
+
+        /**
+         *
+         * Marks a Slot busy, spinning and then yielding while another thread is changing it.
+         *
+         * @param ioSlot is the Slot
+         * @return the edit unit of the Slot before it was marked busy
+         *
+         */
+        int64_t AcquireSlot(Slot &ioSlot);
+
+        /// Publishes the edit unit of ioSlot after AcquireSlot, sEmptySlot if block_ is nullptr
+        void PublishSlot(Slot &ioSlot, int64_t iEditUnit);
+
+        /// Gets the edit unit of a Slot, spinning and then yielding while another thread is changing it
+        int64_t LoadSlot(Slot &ioSlot);
+
+        /**
+         *
+         * Counts the edit units from iEditUnit onwards that are in the ring without a gap.
+         *
+         * @param iEditUnit is the first edit unit
+         * @param iMaxCount stops counting once reached
+         * @return the number of consecutive edit units in the ring, at most iMaxCount
+         *
+         */
+        uint32_t CountBuffered(uint32_t iEditUnit, uint32_t iMaxCount);
+
+        /**
+         *
+         * Releases the AuxDataBlock in a Slot if its edit unit is in a range.
+         *
+         * @param ioSlot is the Slot
+         * @param iStartEditUnit is the first edit unit of the range
+         * @param iEndEditUnit is the edit unit after the range
+         * @return true/false if an AuxDataBlock was released
+         *
+         */
+        bool ReleaseSlot(Slot &ioSlot, uint64_t iStartEditUnit, uint64_t iEndEditUnit);
+
+        /// Releases an AuxDataBlock that has left the ring and takes its bytes off bufferedBytes_
+        void Discard(AuxDataBlock *iItem);
+
+        /// Gets the bytes an AuxDataBlock is charged. 0 if it references a receive buffer charged through ChargeBuffer.
+        static uint64_t GetChargedBytes(const AuxDataBlock *iItem);
+
+        /// Counts the AuxDataBlock objects in the ring before iEditUnit
+        uint32_t CountBefore(uint32_t iEditUnit);
+
+        /**
+         *
+         * Adds iBytes to bufferedBytes_ if that stays within the byte budget.
+         * The check and the addition are a single compare and swap, so concurrent callers cannot overshoot together.
+         *
+         * @param iBytes is the number of bytes needed
+         * @return true/false if iBytes bytes have been reserved
+         *
+         */
+        bool TryReserve(uint64_t iBytes);
+
+        /**
+         *
+         * Reserves iBytes of the byte budget, evicting the edit units behind the playhead if they do not fit otherwise.
+         *
+         * @param iBytes is the number of bytes needed
+         * @return true/false if iBytes bytes have been reserved
+         *
+         */
+        bool Reserve(uint64_t iBytes);
+
+        /// Keeps a receive buffer charged to the byte budget until the last pointer from ChargeBuffer is gone
+        struct ReceiveBufferCharge
+        {
+            ReceiveBufferCharge(AuxDataMgr *iAuxDataMgr, const AuxDataBufferPtr &iBuffer);
+            ~ReceiveBufferCharge();
+
+            /// The AuxDataMgr the buffer is charged to
+            AuxDataMgr          *auxDataMgr_;
+
+            /// The receive buffer
+            AuxDataBufferPtr    buffer_;
+
+            /// Number of bytes charged
+            uint64_t            bytes_;
+        };
+
+        /// Number of slots in the ring
+        const uint32_t capacity_;
+
+        /// The ring. Allocated once in the constructor.
+        Slot *slots_;
+
+        /// Guards slabs_ and freeDataItems_. NewDataItem and ReleaseDataItem run on different threads.
+        boost::mutex slabMutex_;
+
+        /// Slabs of AuxDataBlock storage. Freed in the destructor.
+        std::vector<AuxDataBlockStorage*> slabs_;
+
+        /// Storage in slabs_ not holding an AuxDataBlock
+        std::vector<AuxDataBlockStorage*> freeDataItems_;
+
+        /// Byte budget of the ring, 0 if unlimited
+        boost::atomic<uint64_t> maxBufferedBytes_;
+
+        /// Number of bytes charged to the byte budget
+        boost::atomic<uint64_t> bufferedBytes_;
+
+        /// Number of bytes of the charged receive buffers
+        boost::atomic<uint64_t> receiveBufferBytes_;
+
+        /// Number of charged receive buffers
+        boost::atomic<uint64_t> numberOfReceiveBuffers_;
+
+        /// Highest bufferedBytes_ seen
+        boost::atomic<uint64_t> peakBufferedBytes_;
+
+        /// Number of AuxDataBlock objects in the ring
+        boost::atomic<uint64_t> numberOfBlocks_;
+
+        /// Number of bytes of every AuxDataBlock added. Used with addedBlocks_ to estimate the bytes of an edit unit.
+        boost::atomic<uint64_t> addedBytes_;
+
+        /// Number of AuxDataBlock objects added
+        boost::atomic<uint64_t> addedBlocks_;
+
+        /// Number of AuxDataBlock objects evicted from behind the playhead
+        boost::atomic<uint64_t> evictedBlocks_;
+
+        /// Number of AuxDataBlock objects rejected by the byte budget
+        boost::atomic<uint64_t> rejectedBlocks_;
+
+        /// Edit unit being played
+        boost::atomic<uint32_t> playhead_;
     };
 
 }  // namespace SMPTE_SYNC
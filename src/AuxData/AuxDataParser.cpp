@@ -29,12 +29,17 @@
 
 #include "AuxDataParser.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
+#include "AuxDataIndexCache.h"
 #include "Logger.h"
+#include "MappedFile.h"
 
 #ifdef USE_ASDCP
 #include "AS_DCP.h"
@@ -45,10 +50,18 @@ namespace SMPTE_SYNC
 {
     AuxDataParser::AuxDataParser(int32_t iStartFrame
                                  , int32_t iEndFrame
-                                 , const std::string &iAuxDataFilePath) :
+                                 , const std::string &iAuxDataFilePath
+                                 , bool iUseMappedFile
+                                 , AuxDataIndexCache *iIndexCache
+                                 , const UUID &iAssetId) :
           path_(iAuxDataFilePath)
         , startFrame_(iStartFrame)
         , endFrame_(iEndFrame)
+        , useMappedFile_(iUseMappedFile)
+        , mappedFile_(nullptr)
+        , indexCache_(iIndexCache)
+        , assetId_(iAssetId)
+        , mxfReaderOpen_(false)
     {
         SMPTE_SYNC_LOG << "AuxDataParser::AuxDataParser";
         SMPTE_SYNC_LOG << "iAuxDataFilePath = " << iAuxDataFilePath;
@@ -58,6 +71,7 @@ namespace SMPTE_SYNC
     {
         SMPTE_SYNC_LOG << "AuxDataParser::~AuxDataParser";
 
+        delete mappedFile_;
     }
 
     int32_t AuxDataParser::GetStartFrame(void)
@@ -74,29 +88,142 @@ namespace SMPTE_SYNC
     {
         bool success = true;
 
+        // With a valid index the MXF header and index table do not need to be parsed
+        //
+        if (indexCache_ != nullptr)
+            index_ = indexCache_->Find(path_, assetId_);
+
 #ifdef USE_ASDCP
-        if (!ASDCP_SUCCESS(r.OpenRead(path_)))
-            return false;
+        if (!index_)
+        {
+            if (!ASDCP_SUCCESS(r.OpenRead(path_)))
+                return false;
+
+            mxfReaderOpen_ = true;
+        }
             
         if (!ASDCP_SUCCESS(f.OpenRead(path_)))
             return false;
 #endif
 
+        // asdcplib or the index is still used to find the items.
+        // When the track file can be mapped, the items themselves are served from the mapping.
+        //
+        if (useMappedFile_)
+        {
+            mappedFile_ = new MappedFile;
+
+            if (mappedFile_->Open(path_))
+            {
+                mappedFile_->AdviseSequential();
+            }
+            else
+            {
+                SMPTE_SYNC_LOG << "AuxDataParser::Open - unable to map " << path_ << ", reading through the file reader";
+
+                delete mappedFile_;
+                mappedFile_ = nullptr;
+            }
+        }
+
+        if (!index_ && indexCache_ != nullptr)
+            this->BuildIndex();
+
         return success;
     }
 
+    void AuxDataParser::BuildIndex(void)
+    {
+        uint64_t fileSize = 0;
+        int64_t modificationTime = 0;
+
+        if (!AuxDataIndex::GetFileIdentity(path_, fileSize, modificationTime))
+            return;
+
+#ifdef USE_ASDCP
+        ASDCP::DCData::DCDataDescriptor descriptor;
+        if (ASDCP_FAILURE(r.FillDCDataDescriptor(descriptor)))
+            return;
+
+        std::vector<AuxDataIndexEntry> entries;
+        entries.reserve(descriptor.ContainerDuration);
+
+        std::vector<byte_t> peekBuf(klvPeekSize_);
+
+        for (ui32_t i = 0; i < descriptor.ContainerDuration; i++)
+        {
+            Kumu::fpos_t fileOffset;
+            i8_t temporalOffset;
+            i8_t keyFrameOffset;
+
+            if (ASDCP_FAILURE(r.LocateFrame(i, fileOffset, temporalOffset, keyFrameOffset)))
+                return;
+
+            /* the K and L give the length of the whole KLV */
+
+            const uint8_t *klv = nullptr;
+            uint64_t klvSize = 0;
+
+            if (mappedFile_ != nullptr)
+            {
+                if (static_cast<uint64_t>(fileOffset) >= mappedFile_->GetSize())
+                    return;
+
+                klv = mappedFile_->GetData() + fileOffset;
+                klvSize = mappedFile_->GetSize() - fileOffset;
+            }
+            else
+            {
+                ui32_t readSz = 0;
+
+                f.Seek(fileOffset);
+                if (ASDCP_FAILURE(f.Read(peekBuf.data(), klvPeekSize_, &readSz)))
+                    return;
+
+                klv = peekBuf.data();
+                klvSize = readSz;
+            }
+
+            AuxDataIndexEntry entry;
+            entry.offset_ = static_cast<uint64_t>(fileOffset);
+            entry.reserved_ = 0;
+
+            if (!ParseKLVLength(klv, klvSize, entry.klvLength_))
+            {
+                SMPTE_SYNC_LOG << "AuxDataParser::BuildIndex - Failed to parse item = " << i << " of " << path_;
+                return;
+            }
+
+            entries.push_back(entry);
+        }
+
+        AuxDataIndex *index = new AuxDataIndex;
+        index->Assign(entries, fileSize, modificationTime, assetId_);
+
+        index_.reset(index);
+        indexCache_->Store(path_, index_);
+
+        SMPTE_SYNC_LOG << "AuxDataParser::BuildIndex - indexed " << entries.size() << " items of " << path_;
+#endif
+    }
+
     bool AuxDataParser::Close(void)
     {
         bool closedFileReader = true;
         bool closedMXFReader = true;
         
 #ifdef USE_ASDCP
-        if (!ASDCP_SUCCESS(r.Close()))
+        if (mxfReaderOpen_ && !ASDCP_SUCCESS(r.Close()))
             closedFileReader = false;
+
+        mxfReaderOpen_ = false;
         
         if (!ASDCP_SUCCESS(f.Close()))
             closedMXFReader = false;
 #endif
+
+        delete mappedFile_;
+        mappedFile_ = nullptr;
         
         return closedFileReader && closedMXFReader;
     }
@@ -105,105 +232,315 @@ namespace SMPTE_SYNC
                                     , uint8_t **oDataItem
                                     , uint32_t &oDataItemSize)
     {
-        bool success = true;
+        uint8_t *klvBuffer = nullptr;
+        uint32_t klvLength = 0;
+
+        int32_t itemsRead = this->GetDataItems(iItemNumber, 1,
+                                               [&klvBuffer, &klvLength](int32_t, const uint8_t *iDataItem, uint32_t iDataItemSize)
+                                               {
+                                                   klvBuffer = new uint8_t[iDataItemSize];
+                                                   memcpy(klvBuffer, iDataItem, iDataItemSize);
+                                                   klvLength = iDataItemSize;
+                                                   return true;
+                                               });
+
+        if (itemsRead != 1)
+            return false;
+
+        *oDataItem = klvBuffer;
+        oDataItemSize = klvLength;
+
+        return true;
+    }
+
+    int32_t AuxDataParser::GetDataItems(int32_t iFirstItemNumber
+                                        , int32_t iCount
+                                        , const DataItemSink &iSink)
+    {
+        DataItemOffsets offsets;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(readMutex_);
+
+            if (!this->LocateDataItemsLocked(iFirstItemNumber, iCount, offsets))
+                return 0;
+
+            if (mappedFile_ == nullptr)
+                return this->ReadDataItems(iFirstItemNumber, offsets, iSink);
+        }
+
+        /* the mapping is read only so mapped items need no lock */
+
+        return this->SplitMappedDataItems(iFirstItemNumber, offsets, iSink);
+    }
+
+    bool AuxDataParser::LocateDataItems(int32_t iFirstItemNumber
+                                        , int32_t iCount
+                                        , DataItemOffsets &oOffsets)
+    {
+        boost::mutex::scoped_lock scoped_lock(readMutex_);
+
+        return this->LocateDataItemsLocked(iFirstItemNumber, iCount, oOffsets);
+    }
+
+    const std::string& AuxDataParser::GetPath(void) const
+    {
+        return path_;
+    }
+
+    bool AuxDataParser::LocateDataItemsLocked(int32_t iFirstItemNumber
+                                              , int32_t iCount
+                                              , DataItemOffsets &oOffsets)
+    {
+        oOffsets.clear();
 
         // The MXF file indexes frames from 0
         // Since the MXF is placed on a timeline based on startFrame_ and endFrame_
         // We need to offset to the index used by the MXF file
         //
-        iItemNumber -= startFrame_;
+        int32_t firstItem = iFirstItemNumber - startFrame_;
 
-        if (iItemNumber < 0)
+        if (firstItem < 0 || iCount <= 0)
             return false;
-        
-#ifdef USE_ASDCP
-        Kumu::fpos_t fileOffset;
-        
-        i8_t temporalOffset;
-        i8_t keyFrameOffset;
 
-        if (ASDCP_SUCCESS(r.LocateFrame(iItemNumber, fileOffset, temporalOffset, keyFrameOffset)))
+        if (index_)
         {
-            /* seek to the edit unit offset */
-            f.Seek(fileOffset);
-            
-            /* temporary buffer to store the K and L of the KLV */
-            
-            const ui32_t READ_BUF_SZ = 32;
-            byte_t readBuf[READ_BUF_SZ];
-            
-            /* read the K and L */
-            
-            ui32_t readSz;
-            
-            ASDCP::Result_t result = f.Read(readBuf, READ_BUF_SZ, &readSz);
-            
-            if (ASDCP_FAILURE(result))
-            {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read iItemNumber = " << iItemNumber;
-                return false;
-            }
-            
-            /* did we read enough for at least one K and L */
-            
-            if (readSz < (ASDCP::SMPTE_UL_LENGTH + 1))
-            {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read EOF before K and L iItemNumber = " << iItemNumber;
-                return false;
-            }
-            
-            /* confirm the K looks like a SMPTE UL */
-            
-            if (memcmp(readBuf, ASDCP::SMPTE_UL_START, 4) != 0)
+            /* the index is a flat table. the range is a slice of it */
+
+            int32_t lastItem = std::min(firstItem + iCount, index_->GetNumberOfEntries());
+            const AuxDataIndexEntry *entries = index_->GetEntries();
+
+            for (int32_t item = firstItem; item < lastItem; item++)
             {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read K is not a SMPTE UL iItemNumber = " << iItemNumber;
-                return false;
+                if (!oOffsets.empty() && entries[item].offset_ <= oOffsets.back())
+                    break;
+
+                oOffsets.push_back(entries[item].offset_);
             }
-            
-            /* read the length of V */
-            
-            ui64_t valueLength;
-            
-            if (!Kumu::read_BER(readBuf + ASDCP::SMPTE_UL_LENGTH, &valueLength))
+        }
+#ifdef USE_ASDCP
+        else
+        {
+            /* resolve the offsets of the whole range from the index table */
+
+            oOffsets.reserve(iCount);
+
+            for (int32_t i = 0; i < iCount; i++)
             {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read Bad BER length iItemNumber = " << iItemNumber;
-                return false;
+                Kumu::fpos_t fileOffset;
+                i8_t temporalOffset;
+                i8_t keyFrameOffset;
+
+                if (ASDCP_FAILURE(r.LocateFrame(firstItem + i, fileOffset, temporalOffset, keyFrameOffset)))
+                    break;
+
+                /* a single sequential read needs the items in file order */
+
+                if (!oOffsets.empty() && static_cast<uint64_t>(fileOffset) <= oOffsets.back())
+                    break;
+
+                oOffsets.push_back(static_cast<uint64_t>(fileOffset));
             }
-            
-            /* total KLV length */
-            
-            ui32_t klvLength = static_cast<ui32_t>(ASDCP::SMPTE_UL_LENGTH + Kumu::BER_length(readBuf + ASDCP::SMPTE_UL_LENGTH) + valueLength);
-            
-            uint8_t *klvBuffer = new uint8_t[klvLength];
-            
-            f.Seek(fileOffset);
-            
-            result = f.Read(klvBuffer, klvLength, &readSz);
+        }
+#endif
+
+        if (oOffsets.empty())
+        {
+            SMPTE_SYNC_LOG << "AuxDataParser::LocateDataItems Failed to locate iFirstItemNumber = " << iFirstItemNumber;
+            return false;
+        }
+
+        return true;
+    }
 
-            if (klvLength != readSz)
+    int32_t AuxDataParser::ReadDataItems(int32_t iFirstItemNumber
+                                         , const DataItemOffsets &iOffsets
+                                         , const DataItemSink &iSink)
+    {
+#ifdef USE_ASDCP
+        /* read from the first item through the K and L of the last item */
+
+        uint64_t baseOffset = iOffsets.front();
+        uint64_t lastItemPosition = iOffsets.back() - baseOffset;
+        uint64_t readSize = lastItemPosition + klvPeekSize_;
+
+        /* the index knows the length of the last item. read the whole range at once */
+
+        if (index_)
+        {
+            int32_t lastItem = iFirstItemNumber - startFrame_ + static_cast<int32_t>(iOffsets.size()) - 1;
+            readSize = lastItemPosition + index_->GetEntries()[lastItem].klvLength_;
+        }
+
+        std::vector<byte_t> readBuf(static_cast<size_t>(readSize));
+
+        ui32_t readSz = 0;
+
+        f.Seek(static_cast<Kumu::fpos_t>(baseOffset));
+        ASDCP::Result_t result = f.Read(readBuf.data(), static_cast<ui32_t>(readBuf.size()), &readSz);
+
+        if (ASDCP_FAILURE(result) || readSz <= lastItemPosition)
+        {
+            SMPTE_SYNC_LOG << "AuxDataParser::ReadDataItems Failed to read iFirstItemNumber = " << iFirstItemNumber;
+            return 0;
+        }
+
+        readBuf.resize(readSz);
+
+        /* the last item usually extends past what we read. read the rest of it */
+
+        uint64_t totalSize = 0;
+        if (!GetDataItemsSize(iOffsets, readBuf.data(), readBuf.size(), totalSize))
+        {
+            SMPTE_SYNC_LOG << "AuxDataParser::ReadDataItems Failed to parse last item iFirstItemNumber = " << iFirstItemNumber;
+            return 0;
+        }
+
+        if (totalSize > readBuf.size())
+        {
+            size_t alreadyRead = readBuf.size();
+            ui32_t remaining = static_cast<ui32_t>(totalSize - alreadyRead);
+
+            readBuf.resize(static_cast<size_t>(totalSize));
+
+            result = f.Read(readBuf.data() + alreadyRead, remaining, &readSz);
+
+            if (ASDCP_FAILURE(result) || readSz != remaining)
             {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read klvLength != readSz iItemNumber = "
-                << iItemNumber
-                << " klvLength = " << klvLength
+                SMPTE_SYNC_LOG << "AuxDataParser::ReadDataItems Failed to read klvLength != readSz iFirstItemNumber = "
+                << iFirstItemNumber
+                << " remaining = " << remaining
                 << " readSz = " << readSz;
                 
-                return false;
+                return 0;
             }
+        }
 
-            if (ASDCP_FAILURE(result))
+        return SplitDataItems(iFirstItemNumber, iOffsets, baseOffset, readBuf.data(), readBuf.size(), iSink);
+#else
+        return 0;
+#endif
+    }
+
+    int32_t AuxDataParser::SplitMappedDataItems(int32_t iFirstItemNumber
+                                                , const DataItemOffsets &iOffsets
+                                                , const DataItemSink &iSink)
+    {
+        int32_t itemsDelivered = SplitDataItems(iFirstItemNumber, iOffsets, 0, mappedFile_->GetData(), mappedFile_->GetSize(), iSink);
+
+        /* the next request usually continues where this one ended. start paging it in. */
+
+        if (itemsDelivered > 0)
+        {
+            /* the next window starts after the last KLV delivered and is about as long as this one */
+
+            uint64_t lastPosition = iOffsets[itemsDelivered - 1];
+            uint32_t lastKLVLength = 0;
+
+            if (ParseKLVLength(mappedFile_->GetData() + lastPosition, mappedFile_->GetSize() - lastPosition, lastKLVLength))
             {
-                SMPTE_SYNC_LOG << "AuxDataParser::GetDataItem Failed to read iItemNumber = " << iItemNumber;
-                return false;
+                uint64_t nextWindowStart = lastPosition + lastKLVLength;
+                uint64_t nextWindowEnd = nextWindowStart + (nextWindowStart - iOffsets.front());
+
+                mappedFile_->AdviseWillNeed(nextWindowStart, nextWindowEnd - nextWindowStart);
             }
-            
-            *oDataItem = klvBuffer;
-            oDataItemSize = klvLength;
         }
-        else
-            success = false;
-#endif 
+
+        return itemsDelivered;
+    }
+
+    bool AuxDataParser::GetDataItemsSize(const DataItemOffsets &iOffsets
+                                         , const uint8_t *iBuffer
+                                         , uint64_t iBufferSize
+                                         , uint64_t &oSize)
+    {
+        if (iOffsets.empty())
+            return false;
+
+        uint64_t lastItemPosition = iOffsets.back() - iOffsets.front();
+        uint32_t lastKLVLength = 0;
+
+        if (lastItemPosition >= iBufferSize
+            || !ParseKLVLength(iBuffer + lastItemPosition, iBufferSize - lastItemPosition, lastKLVLength))
+            return false;
+
+        oSize = lastItemPosition + lastKLVLength;
+
+        return true;
+    }
+
+    int32_t AuxDataParser::SplitDataItems(int32_t iFirstItemNumber
+                                          , const DataItemOffsets &iOffsets
+                                          , uint64_t iBufferOffset
+                                          , const uint8_t *iBuffer
+                                          , uint64_t iBufferSize
+                                          , const DataItemSink &iSink)
+    {
+        int32_t itemsDelivered = 0;
+
+        for (size_t i = 0; i < iOffsets.size(); i++)
+        {
+            uint64_t position = iOffsets[i] - iBufferOffset;
+            uint32_t klvLength = 0;
+
+            if (iOffsets[i] < iBufferOffset
+                || position >= iBufferSize
+                || !ParseKLVLength(iBuffer + position, iBufferSize - position, klvLength)
+                || position + klvLength > iBufferSize)
+            {
+                SMPTE_SYNC_LOG << "AuxDataParser::SplitDataItems Failed to read item = " << iFirstItemNumber + static_cast<int32_t>(i);
+                break;
+            }
+
+            if (!iSink(iFirstItemNumber + static_cast<int32_t>(i), iBuffer + position, klvLength))
+                break;
+
+            itemsDelivered++;
+        }
+
+        return itemsDelivered;
+    }
+
+    bool AuxDataParser::ParseKLVLength(const uint8_t *iBuffer, uint64_t iBufferSize, uint32_t &oKLVLength)
+    {
+#ifdef USE_ASDCP
+        /* did we read enough for at least one K and L */
         
-        return success;
+        if (iBufferSize < (ASDCP::SMPTE_UL_LENGTH + 1))
+            return false;
+        
+        /* confirm the K looks like a SMPTE UL */
+        
+        if (memcmp(iBuffer, ASDCP::SMPTE_UL_START, 4) != 0)
+            return false;
+        
+        /* a long form BER length is up to 9 bytes. make sure all of it is in the buffer before reading it */
+        
+        ui32_t berLength = Kumu::BER_length(iBuffer + ASDCP::SMPTE_UL_LENGTH);
+        
+        if (berLength == 0 || iBufferSize < ASDCP::SMPTE_UL_LENGTH + berLength)
+            return false;
+        
+        /* read the length of V */
+        
+        ui64_t valueLength;
+        
+        if (!Kumu::read_BER(iBuffer + ASDCP::SMPTE_UL_LENGTH, &valueLength))
+            return false;
+        
+        /* total KLV length, which has to fit in 32 bits */
+        
+        uint64_t headerLength = ASDCP::SMPTE_UL_LENGTH + berLength;
+        
+        if (valueLength > UINT32_MAX - headerLength)
+            return false;
+        
+        oKLVLength = static_cast<uint32_t>(headerLength + valueLength);
+
+        return true;
+#else
+        return false;
+#endif
     }
 
 }  // namespace SMPTE_SYNC
@@ -35,8 +35,15 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
+
+#include "boost/function.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "AuxDataIndex.h"
+#include "AuxDataSource.h"
+#include "UUID.h"
 
-/// TODO: Further abstract ASDCP from this layer by creating an abstract interface and force the client to provide the implementation.
 #define USE_ASDCP
 
 #ifdef USE_ASDCP
@@ -45,13 +52,23 @@
 
 namespace SMPTE_SYNC
 {
+    class MappedFile;
+    class AuxDataIndexCache;
+
+    /// Increasing file offsets of consecutive data items in a track file
+    typedef std::vector<uint64_t> DataItemOffsets;
 
     /**
-     * @brief AuxDataParser class implements a wrapper for the ASDCP MXF file reading.
+     * @brief AuxDataParser class implements the AuxDataSource interface as a wrapper for the ASDCP MXF file reading.
+     * GetDataItem is threadsafe. Reads are serialized by readMutex_ as the underlying file readers share a file position.
+     * Optionally the track file is memory mapped. asdcplib then only parses the header and index table
+     * and items are served from the mapping, which needs no lock and is shared with every other reader of the file.
+     * With an AuxDataIndexCache the edit unit offsets are kept in an AuxDataIndex. Reopening a track file with a valid index
+     * skips parsing the MXF header and index table, and range lookups are a slice of a flat table.
      *
      */
 
-    class AuxDataParser
+    class AuxDataParser : public AuxDataSource
     {
     public:
 
@@ -62,11 +79,17 @@ namespace SMPTE_SYNC
          * @param iStartFrame is starting frame to read from the MXF
          * @param iEndFrame is ending frame to read from the MXF
          * @param iAuxDataFilePath is the path to the MXF aux data file to be read
+         * @param iUseMappedFile maps the track file on Open. Falls back to the file reader if it can not be mapped.
+         * @param iIndexCache provides and stores the AuxDataIndex of the track file. nullptr to always parse the MXF index table.
+         * @param iAssetId is the UUID of the track file asset used to validate the index. The nil UUID if unknown.
          *
          */
         AuxDataParser(int32_t iStartFrame
                       , int32_t iEndFrame
-                      , const std::string &iAuxDataFilePath);
+                      , const std::string &iAuxDataFilePath
+                      , bool iUseMappedFile = false
+                      , AuxDataIndexCache *iIndexCache = nullptr
+                      , const UUID &iAssetId = UUID());
         
         /// Destructor
         virtual ~AuxDataParser();
@@ -78,16 +101,17 @@ namespace SMPTE_SYNC
          * @return bool if the file opened properly
          *
          */
-        bool Open(void);
+        virtual bool Open(void);
 
         /**
          *
          * Closes the file at the iAuxDataFilePath (path_)
+         * Unmaps the track file. Must not be called while GetDataItems is delivering items.
          *
          * @return bool if the file closed properly
          *
          */
-        bool Close(void);
+        virtual bool Close(void);
 
         /**
          *
@@ -96,7 +120,7 @@ namespace SMPTE_SYNC
          * @return int32_t representing the start frame
          *
          */
-        int32_t GetStartFrame(void);
+        virtual int32_t GetStartFrame(void);
 
         /**
          *
@@ -105,7 +129,7 @@ namespace SMPTE_SYNC
          * @return int32_t representing the end frame
          *
          */
-        int32_t GetEndFrame(void);
+        virtual int32_t GetEndFrame(void);
         
         /**
          *
@@ -119,12 +143,143 @@ namespace SMPTE_SYNC
          * @return bool represents the success of reading the data
          *
          */
-        bool GetDataItem(int32_t iItemNumber
-                         , uint8_t **oDataItem
-                         , uint32_t &oDataItemSize);
+        virtual bool GetDataItem(int32_t iItemNumber
+                                 , uint8_t **oDataItem
+                                 , uint32_t &oDataItemSize);
+
+        /**
+         *
+         * Reads a range of consecutive data items.
+         * The offsets of the range are resolved from the index table and the items are read with a single sequential read,
+         * then split into KLVs in memory. Items are handed to iSink in order.
+         *
+         * @param iFirstItemNumber is the first requested item number
+         * @param iCount is the number of requested items
+         * @param iSink receives each item. Returning false stops delivery.
+         *
+         * @return int32_t number of items delivered to iSink
+         *
+         */
+        virtual int32_t GetDataItems(int32_t iFirstItemNumber
+                                     , int32_t iCount
+                                     , const DataItemSink &iSink);
+
+        /**
+         *
+         * Resolves the file offsets of a range of consecutive data items from the index table without reading them.
+         * Allows the items to be read by other means, for example an AuxDataIOEngine, and split with SplitDataItems.
+         *
+         * @param iFirstItemNumber is the first requested item number
+         * @param iCount is the number of requested items
+         * @param oOffsets receives the offsets. May hold fewer than iCount offsets.
+         *
+         * @return bool true/false if at least the first item was located
+         *
+         */
+        bool LocateDataItems(int32_t iFirstItemNumber
+                             , int32_t iCount
+                             , DataItemOffsets &oOffsets);
+
+        /// Returns the path to the MXF aux data file
+        const std::string& GetPath(void) const;
+
+        /**
+         *
+         * Computes the number of bytes from the first item at iOffsets through the end of the last one.
+         * iBuffer must hold the file from the first offset through at least klvPeekSize_ bytes of the last item.
+         *
+         * @param iOffsets are the offsets of the items
+         * @param iBuffer is the file read from the first offset
+         * @param iBufferSize is the number of valid bytes at iBuffer
+         * @param oSize is the number of bytes spanned by the items
+         *
+         * @return bool true/false if the last item could be parsed
+         *
+         */
+        static bool GetDataItemsSize(const DataItemOffsets &iOffsets
+                                     , const uint8_t *iBuffer
+                                     , uint64_t iBufferSize
+                                     , uint64_t &oSize);
+
+        /**
+         *
+         * Splits the KLVs at iOffsets out of a buffer holding part of the track file and hands them to iSink.
+         *
+         * @param iFirstItemNumber is the item number of the first offset
+         * @param iOffsets are the file offsets of the items
+         * @param iBufferOffset is the file offset of iBuffer
+         * @param iBuffer holds the file from iBufferOffset
+         * @param iBufferSize is the number of valid bytes at iBuffer
+         * @param iSink receives each item
+         *
+         * @return int32_t number of items delivered to iSink
+         *
+         */
+        static int32_t SplitDataItems(int32_t iFirstItemNumber
+                                      , const DataItemOffsets &iOffsets
+                                      , uint64_t iBufferOffset
+                                      , const uint8_t *iBuffer
+                                      , uint64_t iBufferSize
+                                      , const DataItemSink &iSink);
+
+        /**
+         *
+         * Checks the buffer starts with a SMPTE UL and computes the length of the whole KLV from its BER length.
+         *
+         * @param iBuffer is the start of the KLV
+         * @param iBufferSize is the number of valid bytes at iBuffer
+         * @param oKLVLength is the length of the key, length and value
+         *
+         * @return bool true/false if the K and the whole BER length are within iBufferSize and the KLV length fits in 32 bits
+         *
+         */
+        static bool ParseKLVLength(const uint8_t *iBuffer, uint64_t iBufferSize, uint32_t &oKLVLength);
+
+        /// Number of bytes read past the start of the last item of a range so its K and L can be parsed
+        static const uint32_t klvPeekSize_ = 32;
         
     private:
 
+        /// Builds index_ from the MXF index table and adds it to indexCache_. Called by Open.
+        void BuildIndex(void);
+
+        /// Implements LocateDataItems. Requires readMutex_ to be held.
+        bool LocateDataItemsLocked(int32_t iFirstItemNumber
+                                   , int32_t iCount
+                                   , DataItemOffsets &oOffsets);
+
+        /**
+         *
+         * Reads the items at iOffsets with a single sequential read through the file reader and hands them to iSink.
+         * Requires readMutex_ to be held.
+         *
+         * @param iFirstItemNumber is the item number of the first offset
+         * @param iOffsets are the increasing file offsets of the items
+         * @param iSink receives each item
+         *
+         * @return int32_t number of items delivered to iSink
+         *
+         */
+        int32_t ReadDataItems(int32_t iFirstItemNumber
+                              , const DataItemOffsets &iOffsets
+                              , const DataItemSink &iSink);
+
+        /**
+         *
+         * Hands the items at iOffsets to iSink as pointers into mappedFile_ and
+         * hints that the range following them will be read next.
+         *
+         * @param iFirstItemNumber is the item number of the first offset
+         * @param iOffsets are the increasing file offsets of the items
+         * @param iSink receives each item
+         *
+         * @return int32_t number of items delivered to iSink
+         *
+         */
+        int32_t SplitMappedDataItems(int32_t iFirstItemNumber
+                                     , const DataItemOffsets &iOffsets
+                                     , const DataItemSink &iSink);
+
         /// The path to the MXF file being parsed
         std::string     path_;
         
@@ -133,6 +288,27 @@ namespace SMPTE_SYNC
 
         /// The end frame being requested
         int32_t         endFrame_;
+
+        /// Serializes the seek and read calls made by GetDataItem
+        boost::mutex    readMutex_;
+
+        /// Map the track file on Open
+        bool            useMappedFile_;
+
+        /// The mapped track file. nullptr when reading through the file reader.
+        MappedFile      *mappedFile_;
+
+        /// Provides and stores the index of the track file. Not owned.
+        AuxDataIndexCache *indexCache_;
+
+        /// Offsets and lengths of the items. Empty until built or found in indexCache_.
+        AuxDataIndexPtr index_;
+
+        /// UUID of the track file asset
+        UUID            assetId_;
+
+        /// Set when r was opened. Not needed when a valid index was found.
+        bool            mxfReaderOpen_;
         
 #ifdef USE_ASDCP
         /// AS-DCP file reader
@@ -0,0 +1,284 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataParserPool.h"
+
+#include <string>
+
+#include "AuxDataParser.h"
+#include "Logger.h"
+#include "MemoryAuxDataSource.h"
+
+namespace SMPTE_SYNC
+{
+    AuxDataParserPool::AuxDataParserPool(int32_t iMaxOpenParsers) :
+          preloadedSizeInBytes_(0)
+        , maxOpenParsers_(iMaxOpenParsers > 0 ? iMaxOpenParsers : 1)
+        , useCounter_(0)
+        , useMappedFiles_(true)
+        , epoch_(0)
+    {
+        SMPTE_SYNC_LOG << "AuxDataParserPool::AuxDataParserPool maxOpenParsers_ = " << maxOpenParsers_;
+    }
+
+    AuxDataParserPool::~AuxDataParserPool()
+    {
+        SMPTE_SYNC_LOG << "AuxDataParserPool::~AuxDataParserPool";
+
+        this->Clear();
+    }
+
+    std::string AuxDataParserPool::BuildKey(const std::string &iAuxDataFilePath, int32_t iStartFrame)
+    {
+        return iAuxDataFilePath + "#" + std::to_string(iStartFrame);
+    }
+
+    AuxDataSourcePtr AuxDataParserPool::Acquire(const std::string &iAuxDataFilePath
+                                                , int32_t iStartFrame
+                                                , int32_t iEndFrame
+                                                , const UUID &iAssetId)
+    {
+        std::string key = BuildKey(iAuxDataFilePath, iStartFrame);
+        bool useMappedFile = false;
+        uint64_t epoch = 0;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(poolMutex_);
+
+            useMappedFile = useMappedFiles_;
+            epoch = epoch_;
+
+            std::map<std::string, AuxDataSourcePtr>::iterator preloaded = preloaded_.find(key);
+            if (preloaded != preloaded_.end())
+                return preloaded->second;
+
+            std::map<std::string, PoolEntry>::iterator iter = pool_.find(key);
+            if (iter != pool_.end())
+            {
+                iter->second.lastUsed_ = ++useCounter_;
+                return iter->second.parser_;
+            }
+        }
+
+        // Open the track file without holding the pool lock so
+        // clients reading other track files are not blocked by the open
+        //
+        AuxDataSourcePtr parser(new AuxDataParser(iStartFrame, iEndFrame, iAuxDataFilePath, useMappedFile, &indexCache_, iAssetId));
+
+        if (!parser->Open())
+        {
+            SMPTE_SYNC_LOG << "AuxDataParserPool::Acquire - Failed to open iAuxDataFilePath = " << iAuxDataFilePath;
+            return AuxDataSourcePtr();
+        }
+
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+
+        // The pool was cleared while we were opening the track file.
+        // Hand the parser to this client only rather than keeping it for the next Show.
+        //
+        if (epoch != epoch_)
+            return parser;
+
+        // Another thread may have opened the same track file while we were opening it.
+        // Keep the one already in the pool and let ours close when it goes out of scope.
+        //
+        std::map<std::string, PoolEntry>::iterator iter = pool_.find(key);
+        if (iter != pool_.end())
+        {
+            iter->second.lastUsed_ = ++useCounter_;
+            return iter->second.parser_;
+        }
+
+        PoolEntry entry;
+        entry.parser_ = parser;
+        entry.lastUsed_ = ++useCounter_;
+        pool_[key] = entry;
+
+        this->EvictLocked();
+
+        return parser;
+    }
+
+    void AuxDataParserPool::EvictLocked(void)
+    {
+        while (static_cast<int32_t>(pool_.size()) > maxOpenParsers_)
+        {
+            std::map<std::string, PoolEntry>::iterator oldest = pool_.begin();
+            for (std::map<std::string, PoolEntry>::iterator iter = pool_.begin(); iter != pool_.end(); iter++)
+            {
+                if (iter->second.lastUsed_ < oldest->second.lastUsed_)
+                    oldest = iter;
+            }
+
+            SMPTE_SYNC_LOG << "AuxDataParserPool::EvictLocked - evicting " << oldest->first;
+            pool_.erase(oldest);
+        }
+    }
+
+    uint64_t AuxDataParserPool::Preload(const std::string &iAuxDataFilePath
+                                        , int32_t iStartFrame
+                                        , int32_t iEndFrame
+                                        , const UUID &iAssetId
+                                        , uint64_t iMaxSizeInBytes)
+    {
+        // The track file size is a close upper bound of the size of its items
+        //
+        uint64_t fileSize = 0;
+        int64_t modificationTime = 0;
+
+        if (!AuxDataIndex::GetFileIdentity(iAuxDataFilePath, fileSize, modificationTime) || fileSize > iMaxSizeInBytes)
+            return 0;
+
+        bool useMappedFile = false;
+        uint64_t epoch = 0;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(poolMutex_);
+
+            useMappedFile = useMappedFiles_;
+            epoch = epoch_;
+        }
+
+        AuxDataParser parser(iStartFrame, iEndFrame, iAuxDataFilePath, useMappedFile, &indexCache_, iAssetId);
+
+        if (!parser.Open())
+        {
+            SMPTE_SYNC_LOG << "AuxDataParserPool::Preload - Failed to open iAuxDataFilePath = " << iAuxDataFilePath;
+            return 0;
+        }
+
+        MemoryAuxDataSource *source = new MemoryAuxDataSource(iStartFrame);
+        bool loaded = source->Load(parser, fileSize);
+
+        parser.Close();
+
+        if (!loaded)
+        {
+            SMPTE_SYNC_LOG << "AuxDataParserPool::Preload - Failed to load iAuxDataFilePath = " << iAuxDataFilePath;
+            delete source;
+            return 0;
+        }
+
+        uint64_t sizeInBytes = source->GetSizeInBytes();
+
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+
+        // The pool was cleared while the track file was loading. It belongs to a Show that is gone.
+        //
+        if (epoch != epoch_)
+        {
+            SMPTE_SYNC_LOG << "AuxDataParserPool::Preload - Pool cleared while loading iAuxDataFilePath = " << iAuxDataFilePath;
+            delete source;
+            return 0;
+        }
+
+        std::string key = BuildKey(iAuxDataFilePath, iStartFrame);
+
+        if (preloaded_.find(key) == preloaded_.end())
+        {
+            preloaded_[key] = AuxDataSourcePtr(source);
+            preloadedSizeInBytes_ += sizeInBytes;
+        }
+        else
+        {
+            delete source;
+            sizeInBytes = 0;
+        }
+
+        // The parser of the track is no longer needed
+        //
+        pool_.erase(key);
+
+        return sizeInBytes;
+    }
+
+    uint64_t AuxDataParserPool::GetPreloadedSizeInBytes(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        return preloadedSizeInBytes_;
+    }
+
+    int32_t AuxDataParserPool::GetNumberOfPreloadedTracks(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        return static_cast<int32_t>(preloaded_.size());
+    }
+
+    void AuxDataParserPool::Clear(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        pool_.clear();
+        preloaded_.clear();
+        preloadedSizeInBytes_ = 0;
+        epoch_++;
+    }
+
+    void AuxDataParserPool::SetMaxOpenParsers(int32_t iMaxOpenParsers)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+
+        maxOpenParsers_ = iMaxOpenParsers > 0 ? iMaxOpenParsers : 1;
+        this->EvictLocked();
+    }
+
+    int32_t AuxDataParserPool::GetMaxOpenParsers(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        return maxOpenParsers_;
+    }
+
+    int32_t AuxDataParserPool::GetNumberOfOpenParsers(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        return static_cast<int32_t>(pool_.size());
+    }
+
+    void AuxDataParserPool::SetUseMappedFiles(bool iUseMappedFiles)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        useMappedFiles_ = iUseMappedFiles;
+    }
+
+    bool AuxDataParserPool::GetUseMappedFiles(void)
+    {
+        boost::mutex::scoped_lock scoped_lock(poolMutex_);
+        return useMappedFiles_;
+    }
+
+    void AuxDataParserPool::SetIndexDirectory(const std::string &iDirectory)
+    {
+        indexCache_.SetDirectory(iDirectory);
+    }
+
+    std::string AuxDataParserPool::GetIndexDirectory(void)
+    {
+        return indexCache_.GetDirectory();
+    }
+
+}  // namespace SMPTE_SYNC
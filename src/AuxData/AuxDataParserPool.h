@@ -0,0 +1,196 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATAPARSERPOOL_H
+#define AUXDATAPARSERPOOL_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "AuxDataIndexCache.h"
+#include "AuxDataSource.h"
+#include "UUID.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief AuxDataParserPool keeps a bounded set of open AuxDataParser objects keyed by track file.
+     * Clients reading different reels each get their own parser instead of closing and reopening a single shared one.
+     * The pool is threadsafe. Each AuxDataParser serializes its own reads so multiple connection handlers can share a parser.
+     * When the pool is full the least recently used parser is evicted.
+     * The pool keeps the AuxDataIndex of every track file it opens so reopening an evicted track file is cheap.
+     * Track files can also be preloaded into a MemoryAuxDataSource. Preloaded tracks are handed out instead of a parser and are never evicted.
+     *
+     */
+
+    class AuxDataParserPool
+    {
+    public:
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iMaxOpenParsers is the maximum number of AuxDataParser objects kept open by the pool
+         *
+         */
+        AuxDataParserPool(int32_t iMaxOpenParsers);
+
+        /// Destructor
+        ~AuxDataParserPool();
+
+        /**
+         *
+         * Returns an open AuxDataSource for the track file placed at iStartFrame on the Show timeline.
+         * Returns the preloaded track if there is one, otherwise opens and adds a new AuxDataParser if the pool does not have one yet.
+         *
+         * @param iAuxDataFilePath is the path to the MXF aux data file
+         * @param iStartFrame is the first frame of the track file on the Show timeline
+         * @param iEndFrame is the last frame of the track file on the Show timeline
+         * @param iAssetId is the UUID of the track file asset
+         * @return AuxDataSourcePtr to an open AuxDataSource, empty if the track file could not be opened
+         *
+         */
+        AuxDataSourcePtr Acquire(const std::string &iAuxDataFilePath
+                                 , int32_t iStartFrame
+                                 , int32_t iEndFrame
+                                 , const UUID &iAssetId);
+
+        /**
+         *
+         * Loads a whole track file into memory if it fits.
+         *
+         * @param iAuxDataFilePath is the path to the MXF aux data file
+         * @param iStartFrame is the first frame of the track file on the Show timeline
+         * @param iEndFrame is the last frame of the track file on the Show timeline
+         * @param iAssetId is the UUID of the track file asset
+         * @param iMaxSizeInBytes is the memory available for the track
+         * @return uint64_t bytes used by the preloaded track. 0 if the track does not fit or could not be read.
+         *
+         */
+        uint64_t Preload(const std::string &iAuxDataFilePath
+                         , int32_t iStartFrame
+                         , int32_t iEndFrame
+                         , const UUID &iAssetId
+                         , uint64_t iMaxSizeInBytes);
+
+        /// Gets the number of bytes used by preloaded tracks
+        uint64_t GetPreloadedSizeInBytes(void);
+
+        /// Gets the number of preloaded tracks
+        int32_t GetNumberOfPreloadedTracks(void);
+
+        /**
+         *
+         * Removes all AuxDataParser objects and preloaded tracks from the pool.
+         * Parsers still held by a client are closed once the client releases them.
+         * A Preload or Acquire already opening a track file does not add it to the pool afterwards.
+         *
+         */
+        void Clear(void);
+
+        /// Sets the maximum number of open AuxDataParser objects. Evicts parsers if needed.
+        void SetMaxOpenParsers(int32_t iMaxOpenParsers);
+
+        /// Gets the maximum number of open AuxDataParser objects
+        int32_t GetMaxOpenParsers(void);
+
+        /// Gets the current number of open AuxDataParser objects in the pool
+        int32_t GetNumberOfOpenParsers(void);
+
+        /// Sets if track files opened from now on are memory mapped. Parsers already in the pool are not affected.
+        void SetUseMappedFiles(bool iUseMappedFiles);
+
+        /// Gets if track files are memory mapped
+        bool GetUseMappedFiles(void);
+
+        /// Sets the directory the index sidecar files are kept in. An empty string keeps indexes in memory only.
+        void SetIndexDirectory(const std::string &iDirectory);
+
+        /// Gets the directory the index sidecar files are kept in
+        std::string GetIndexDirectory(void);
+
+    private:
+
+        /**
+         *
+         * @brief PoolEntry stores a pooled AuxDataParser and when it was last used
+         *
+         */
+        typedef struct PoolEntry
+        {
+            /// The pooled parser
+            AuxDataSourcePtr    parser_;
+
+            /// Value of useCounter_ the last time the parser was acquired
+            uint64_t            lastUsed_;
+        } PoolEntry;
+
+        /// Builds the key of a track file. The same track file can appear more than once on the Show timeline.
+        static std::string BuildKey(const std::string &iAuxDataFilePath, int32_t iStartFrame);
+
+        /// Evicts the least recently used parsers until there are no more than maxOpenParsers_. Requires poolMutex_ to be held.
+        void EvictLocked(void);
+
+        /// Protects pool_, preloaded_, preloadedSizeInBytes_, maxOpenParsers_, useCounter_, useMappedFiles_ and epoch_
+        boost::mutex                        poolMutex_;
+
+        /// The open parsers keyed by track file
+        std::map<std::string, PoolEntry>    pool_;
+
+        /// The preloaded tracks keyed by track file
+        std::map<std::string, AuxDataSourcePtr> preloaded_;
+
+        /// Bytes used by preloaded_
+        uint64_t                            preloadedSizeInBytes_;
+
+        /// The maximum number of open parsers
+        int32_t                             maxOpenParsers_;
+
+        /// Monotonic counter used to find the least recently used parser
+        uint64_t                            useCounter_;
+
+        /// Open new parsers with a memory mapped track file
+        bool                                useMappedFiles_;
+
+        /// Bumped by Clear. A track file opened while it changed belongs to the Show that was cleared and is not pooled.
+        uint64_t                            epoch_;
+
+        /// Indexes of the track files. Outlives the parsers so evicted track files reopen quickly.
+        AuxDataIndexCache                   indexCache_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATAPARSERPOOL_H
@@ -0,0 +1,132 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATASOURCE_H
+#define AUXDATASOURCE_H
+
+#include <stdint.h>
+
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief Callback receiving each data item read by AuxDataSource::GetDataItems.
+     * iDataItem points into a buffer owned by the source and is only valid during the call.
+     * Depending on the source it can point straight into a mapped track file or a preloaded arena, so the sink reads it without a copy.
+     * Returns false to stop receiving items.
+     *
+     */
+    typedef boost::function<bool(int32_t iItemNumber, const uint8_t *iDataItem, uint32_t iDataItemSize)> DataItemSink;
+
+    /**
+     *
+     * @brief AuxDataSource is the interface the ShowManager reads the data items of one aux data track through.
+     * Items are numbered on the Show timeline from GetStartFrame to GetEndFrame.
+     * Implemented by AuxDataParser, which reads MXF files with asdcplib, and MemoryAuxDataSource, which serves a track preloaded into memory.
+     * Implementations must be threadsafe once opened.
+     *
+     */
+
+    class AuxDataSource
+    {
+    public:
+
+        /// Destructor
+        virtual ~AuxDataSource() {}
+
+        /**
+         *
+         * Prepares the source for reading
+         *
+         * @return bool if the source opened properly
+         *
+         */
+        virtual bool Open(void) = 0;
+
+        /**
+         *
+         * Releases the resources used for reading
+         *
+         * @return bool if the source closed properly
+         *
+         */
+        virtual bool Close(void) = 0;
+
+        /// Returns the first frame of the track on the Show timeline
+        virtual int32_t GetStartFrame(void) = 0;
+
+        /// Returns the last frame of the track on the Show timeline
+        virtual int32_t GetEndFrame(void) = 0;
+
+        /**
+         *
+         * Attempts to copy the data requested data item number into a buffer.
+         * Allocates memory for the oDataItem. Client must deallocate any memory allocated.
+         *
+         * @param iItemNumber is the requested item number
+         * @param oDataItem is a pointer to a buffer with upon return will contain the data item information
+         * @param oDataItemSize is the size of the data that was allocated
+         * 
+         * @return bool represents the success of reading the data
+         *
+         */
+        virtual bool GetDataItem(int32_t iItemNumber
+                                 , uint8_t **oDataItem
+                                 , uint32_t &oDataItemSize) = 0;
+
+        /**
+         *
+         * Reads a range of consecutive data items and hands them to iSink in order.
+         *
+         * @param iFirstItemNumber is the first requested item number
+         * @param iCount is the number of requested items
+         * @param iSink receives each item. Returning false stops delivery.
+         *
+         * @return int32_t number of items delivered to iSink
+         *
+         */
+        virtual int32_t GetDataItems(int32_t iFirstItemNumber
+                                     , int32_t iCount
+                                     , const DataItemSink &iSink) = 0;
+    };
+
+    /**
+     *
+     * @brief AuxDataSourcePtr is a boost::shared_ptr to an AuxDataSource handed out by the AuxDataParserPool.
+     * A source that is evicted from the pool stays open until the last client releases it.
+     *
+     */
+    typedef boost::shared_ptr<AuxDataSource> AuxDataSourcePtr;
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATASOURCE_H
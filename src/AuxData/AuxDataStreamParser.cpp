@@ -0,0 +1,343 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "AuxDataStreamParser.h"
+
+#include <assert.h>
+#include <cstring>
+#include <algorithm>
+
+#include "Logger.h"
+#include "AuxDataMgr.h"
+#include "SerializationUtils.h"
+
+namespace SMPTE_SYNC
+{
+    // Size of the PackKey and BER5 length that start the header and every AuxDataBlock
+    //
+    static const size_t sKeyAndLengthSize = 16 + 5;
+
+    // Size of the fixed fields of an AuxDataBlock following its PackKey and BER5 length.
+    // editUnitIndex_, the edit rate, sourceDataEssenceCodingUL_ and the two 8 byte lengths
+    //
+    static const size_t sFixedBlockSize = 4 + 4 + 4 + 16 + 8 + 8;
+
+    // Size of each receive buffer. Larger if a single AuxDataBlock needs more.
+    //
+    static const size_t sReceiveBufferSize = 64 * 1024;
+
+    // Largest AuxDataBlock accepted, including its PackKey and BER5 length.
+    // Bounds the receive buffer a corrupt length on the wire can make us allocate.
+    //
+    static const size_t sMaxBlockSize = 64 * 1024 * 1024;
+
+    AuxDataStreamParser::AuxDataStreamParser(AuxDataMgr *iAuxDataMgr)
+        : auxDataMgr_(iAuxDataMgr)
+        , state_(eState_Header)
+        , header_()
+        , blockPackKey_(AuxDataBlock().packKey_)
+        , blockCount_(0)
+        , lastEditUnitIndex_(0)
+        , buffer_()
+        , bufferCharge_()
+        , parsed_(0)
+        , filled_(0)
+    {
+    }
+
+    AuxDataStreamParser::~AuxDataStreamParser()
+    {
+    }
+
+    void AuxDataStreamParser::Reset(void)
+    {
+        state_ = eState_Header;
+        header_ = AuxDataBlockTransferHeader();
+        blockCount_ = 0;
+        lastEditUnitIndex_ = 0;
+
+        // Keep the receive buffer for the next response unless queued blocks still reference it
+        //
+        if (buffer_ && !buffer_.unique())
+            buffer_.reset();
+
+        parsed_ = 0;
+        filled_ = 0;
+    }
+
+    uint8_t* AuxDataStreamParser::PrepareReceive(size_t &oSize)
+    {
+        size_t pending = filled_ - parsed_;
+        size_t needed = this->GetBytesNeeded();
+
+        if (!buffer_ || buffer_->size() - parsed_ < needed)
+        {
+            if (buffer_ && buffer_.unique() && buffer_->size() >= needed)
+            {
+                // Nothing references the decoded bytes. Reuse the buffer.
+                //
+                memmove(buffer_->data(), buffer_->data() + parsed_, pending);
+            }
+            else
+            {
+                // Queued blocks keep the current buffer alive for as long as they need it
+                //
+                // Stay within the byte budget so the buffer can be charged to it
+                //
+                size_t size = std::max(std::min(sReceiveBufferSize, this->GetMaxBlockSize()), needed);
+
+                AuxDataBufferPtr buffer(new std::vector<uint8_t>(size));
+                if (pending > 0)
+                    memcpy(buffer->data(), buffer_->data() + parsed_, pending);
+
+                buffer_ = buffer;
+            }
+
+            parsed_ = 0;
+            filled_ = pending;
+        }
+
+        oSize = buffer_->size() - filled_;
+        return buffer_->data() + filled_;
+    }
+
+    bool AuxDataStreamParser::CommitReceive(size_t iSize)
+    {
+        assert(buffer_ && filled_ + iSize <= buffer_->size());
+
+        filled_ += iSize;
+
+        this->Parse();
+
+        return state_ != eState_Error;
+    }
+
+    bool AuxDataStreamParser::Append(const uint8_t *iData, size_t iSize)
+    {
+        // Neither state consumes further bytes
+        //
+        while (iSize > 0 && state_ != eState_Error && state_ != eState_Full)
+        {
+            size_t size = 0;
+            uint8_t *buffer = this->PrepareReceive(size);
+
+            size = std::min(size, iSize);
+            memcpy(buffer, iData, size);
+
+            iData += size;
+            iSize -= size;
+
+            this->CommitReceive(size);
+        }
+
+        return state_ != eState_Error;
+    }
+
+    size_t AuxDataStreamParser::GetBytesNeeded(void) const
+    {
+        size_t pending = filled_ - parsed_;
+
+        if (state_ == eState_Header)
+            return static_cast<size_t>(header_.GetSizeInBytes());
+
+        if (state_ != eState_Blocks || pending < sKeyAndLengthSize)
+            return sKeyAndLengthSize;
+
+        // Parse has already checked the length of the incomplete block
+        //
+        int32_t length = 0;
+        uint8_t *buffer = buffer_->data() + parsed_ + sizeof(blockPackKey_.data_);
+        ReadBER5(&buffer, length);
+
+        return sKeyAndLengthSize + static_cast<size_t>(length);
+    }
+
+    void AuxDataStreamParser::Parse(void)
+    {
+        if (state_ == eState_Header)
+        {
+            size_t headerSize = static_cast<size_t>(header_.GetSizeInBytes());
+            if (filled_ - parsed_ < headerSize)
+                return;
+
+            // header_ still holds the default PackKey until it has been read
+            //
+            if (memcmp(buffer_->data() + parsed_, header_.packKey_.data_, sizeof(header_.packKey_.data_)) != 0)
+            {
+                SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - Invalid AuxDataBlockTransferHeader PackKey";
+                state_ = eState_Error;
+                return;
+            }
+
+            uint8_t *buffer = buffer_->data() + parsed_;
+            header_.read(&buffer);
+
+            parsed_ += headerSize;
+            state_ = eState_Blocks;
+        }
+
+        while (state_ == eState_Blocks && filled_ - parsed_ >= sKeyAndLengthSize)
+        {
+            uint8_t *block = buffer_->data() + parsed_;
+
+            if (memcmp(block, blockPackKey_.data_, sizeof(blockPackKey_.data_)) != 0)
+            {
+                SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - Invalid AuxDataBlock PackKey after " << blockCount_ << " blocks";
+                state_ = eState_Error;
+                break;
+            }
+
+            int32_t length = 0;
+            uint8_t *buffer = block + sizeof(blockPackKey_.data_);
+            ReadBER5(&buffer, length);
+
+            if (length < static_cast<int32_t>(sFixedBlockSize)
+                || sKeyAndLengthSize + static_cast<size_t>(length) > this->GetMaxBlockSize())
+            {
+                SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - Invalid AuxDataBlock length " << length;
+                state_ = eState_Error;
+                break;
+            }
+
+            // Wait for the rest of the block
+            //
+            size_t blockSize = sKeyAndLengthSize + static_cast<size_t>(length);
+            if (filled_ - parsed_ < blockSize)
+                break;
+
+            if (!this->IsValidBlock(block, length))
+            {
+                SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - Inconsistent AuxDataBlock lengths after " << blockCount_ << " blocks";
+                state_ = eState_Error;
+                break;
+            }
+
+            // The receive buffer is charged to the byte budget with the first block referencing it
+            // and stays charged until the last one is released
+            //
+            AuxDataBufferPtr charge = bufferCharge_.lock();
+            if (charge.get() != buffer_.get())
+            {
+                charge = auxDataMgr_->ChargeBuffer(buffer_);
+                if (!charge)
+                {
+                    SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - AuxDataMgr is full, stopping after " << blockCount_ << " blocks";
+                    state_ = eState_Full;
+                    break;
+                }
+
+                bufferCharge_ = charge;
+            }
+
+            // The block references its payload in the receive buffer
+            //
+            AuxDataBlock *item = auxDataMgr_->NewDataItem();
+            buffer = block;
+            item->read(&buffer);
+            item->buffer_ = charge;
+
+            uint32_t editUnitIndex = item->editUnitIndex_;
+
+            if (!auxDataMgr_->AddDataItem(item))
+            {
+                SMPTE_SYNC_LOG << "AuxDataStreamParser::Parse - AuxDataMgr is full, stopping at edit unit " << editUnitIndex;
+                state_ = eState_Full;
+                break;
+            }
+
+            lastEditUnitIndex_ = editUnitIndex;
+            blockCount_++;
+
+            parsed_ += blockSize;
+        }
+    }
+
+    size_t AuxDataStreamParser::GetMaxBlockSize(void) const
+    {
+        // A block larger than the byte budget of the AuxDataMgr could never be stored
+        //
+        uint64_t maxBufferedBytes = auxDataMgr_->GetMaxBufferedBytes();
+        if (maxBufferedBytes > 0 && maxBufferedBytes < sMaxBlockSize)
+            return static_cast<size_t>(maxBufferedBytes);
+
+        return sMaxBlockSize;
+    }
+
+    bool AuxDataStreamParser::IsValidBlock(const uint8_t *iData, int32_t iLength) const
+    {
+        uint64_t length = static_cast<uint64_t>(iLength);
+
+        // sourceDataItemLength_ follows the edit unit index, the edit rate and the coding UL
+        //
+        uint8_t *buffer = const_cast<uint8_t*>(iData) + sKeyAndLengthSize + 4 + 4 + 4 + 16;
+
+        uint64_t dataItemLength = 0;
+        Read(&buffer, dataItemLength);
+        if (dataItemLength > length - sFixedBlockSize)
+            return false;
+
+        buffer += dataItemLength;
+
+        uint64_t cryptographicContextLength = 0;
+        Read(&buffer, cryptographicContextLength);
+
+        return cryptographicContextLength == length - sFixedBlockSize - dataItemLength;
+    }
+
+    AuxDataStreamParser::State AuxDataStreamParser::GetState(void) const
+    {
+        return state_;
+    }
+
+    bool AuxDataStreamParser::HasHeader(void) const
+    {
+        return state_ == eState_Blocks || state_ == eState_Full;
+    }
+
+    const AuxDataBlockTransferHeader& AuxDataStreamParser::GetHeader(void) const
+    {
+        return header_;
+    }
+
+    uint32_t AuxDataStreamParser::GetBlockCount(void) const
+    {
+        return blockCount_;
+    }
+
+    uint32_t AuxDataStreamParser::GetLastEditUnitIndex(void) const
+    {
+        return lastEditUnitIndex_;
+    }
+
+    size_t AuxDataStreamParser::GetPendingBytes(void) const
+    {
+        return filled_ - parsed_;
+    }
+
+}  // namespace SMPTE_SYNC
@@ -0,0 +1,192 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef AUXDATASTREAMPARSER_H
+#define AUXDATASTREAMPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "boost/weak_ptr.hpp"
+
+#include "AuxData.h"
+
+namespace SMPTE_SYNC
+{
+    class AuxDataMgr;
+
+    /**
+     * @brief AuxDataStreamParser class incrementally decodes the payload of an aux data GET response.
+     * The payload is a AuxDataBlockTransferHeader followed by AuxDataBlock items. The socket reads straight into
+     * the receive buffer of the parser (PrepareReceive / CommitReceive) and each AuxDataBlock is queued on the
+     * AuxDataMgr as soon as all of its bytes have been received, so edit units near the playhead are available
+     * before the response completes.
+     *
+     * Queued AuxDataBlock objects reference their payload in the receive buffer rather than copying it.
+     * A receive buffer is freed once the parser has moved on and every AuxDataBlock referencing it has been released.
+     * Only the bytes of a block that straddles the end of a receive buffer are moved, once, into a buffer large
+     * enough to hold the whole block. The rest of the block is received in place.
+     *
+     */
+    class AuxDataStreamParser
+    {
+    public:
+
+        /// The state of the parser within a response
+        typedef enum
+        {
+            eState_Header,      ///< Waiting for the AuxDataBlockTransferHeader
+            eState_Blocks,      ///< Waiting for the next AuxDataBlock
+            eState_Full,        ///< The AuxDataMgr rejected an AuxDataBlock or its receive buffer because its byte budget is reached. No further bytes are consumed.
+            eState_Error        ///< The payload is malformed. No further bytes are consumed.
+        } State;
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iAuxDataMgr is AuxDataMgr that is used to queue each decoded AuxDataBlock
+         *
+         */
+        explicit AuxDataStreamParser(AuxDataMgr *iAuxDataMgr);
+
+        /// Destructor
+        ~AuxDataStreamParser();
+
+        /// Prepares the parser for a new response
+        void Reset(void);
+
+        /**
+         *
+         * Gets the space the next socket read should be written to.
+         * The space is always large enough to complete the item currently being received.
+         *
+         * @param oSize is the number of bytes that can be written
+         * @return the start of the space
+         *
+         */
+        uint8_t* PrepareReceive(size_t &oSize);
+
+        /**
+         *
+         * Decodes as many complete items as are available after iSize bytes have been written to PrepareReceive.
+         *
+         * @param iSize is the number of bytes written
+         * @return true/false if the payload received so far is well formed
+         *
+         */
+        bool CommitReceive(size_t iSize);
+
+        /**
+         *
+         * Copies and decodes bytes that were received outside of PrepareReceive, such as the content
+         * read along with the HTTP headers.
+         *
+         * @param iData is the start of the bytes
+         * @param iSize is the number of bytes
+         * @return true/false if the payload received so far is well formed
+         *
+         */
+        bool Append(const uint8_t *iData, size_t iSize);
+
+        /// Gets the current state of the parser
+        State GetState(void) const;
+
+        /// Returns true once the AuxDataBlockTransferHeader has been decoded and no malformed data has been found
+        bool HasHeader(void) const;
+
+        /// Gets the AuxDataBlockTransferHeader of the response. Only valid once HasHeader returns true.
+        const AuxDataBlockTransferHeader& GetHeader(void) const;
+
+        /// Gets the number of AuxDataBlock items queued on the AuxDataMgr for the current response
+        uint32_t GetBlockCount(void) const;
+
+        /// Gets the edit unit index of the last AuxDataBlock queued. Only valid if GetBlockCount is greater than 0.
+        uint32_t GetLastEditUnitIndex(void) const;
+
+        /// Gets the number of received bytes of an incomplete header or AuxDataBlock
+        size_t GetPendingBytes(void) const;
+
+    private:
+
+        /// Decodes the complete items between parsed_ and filled_ in buffer_
+        void Parse(void);
+
+        /// Gets the number of bytes from parsed_ needed to complete the item currently being received
+        size_t GetBytesNeeded(void) const;
+
+        /**
+         *
+         * Checks that the lengths stored in a complete AuxDataBlock add up to the length of the block
+         * such that AuxDataBlock::read stays within the received bytes.
+         *
+         * @param iData is the start of the AuxDataBlock
+         * @param iLength is the length of the AuxDataBlock following its PackKey and BER5 length
+         * @return true/false if the AuxDataBlock is well formed
+         *
+         */
+        bool IsValidBlock(const uint8_t *iData, int32_t iLength) const;
+
+        /// Gets the size of the largest AuxDataBlock accepted, bounded by the byte budget of the auxDataMgr_. A larger BER5 length is malformed.
+        size_t GetMaxBlockSize(void) const;
+
+        /// Queue receiving the decoded AuxDataBlock items
+        AuxDataMgr                  *auxDataMgr_;
+
+        /// Current state of the parser
+        State                       state_;
+
+        /// Header of the current response
+        AuxDataBlockTransferHeader  header_;
+
+        /// PackKey expected at the start of each AuxDataBlock
+        PackKey                     blockPackKey_;
+
+        /// Number of AuxDataBlock items queued for the current response
+        uint32_t                    blockCount_;
+
+        /// Edit unit index of the last AuxDataBlock queued for the current response
+        uint32_t                    lastEditUnitIndex_;
+
+        /// The receive buffer. Shared with every queued AuxDataBlock that references it.
+        AuxDataBufferPtr            buffer_;
+
+        /// The charge of buffer_ to the byte budget of the auxDataMgr_. Expires with the last AuxDataBlock referencing it.
+        boost::weak_ptr<std::vector<uint8_t> > bufferCharge_;
+
+        /// Offset in buffer_ of the first byte not decoded yet
+        size_t                      parsed_;
+
+        /// Offset in buffer_ of the end of the received bytes
+        size_t                      filled_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // AUXDATASTREAMPARSER_H
@@ -41,6 +41,7 @@
 
 #include "tinyxml.h"
 
+#include "AssetMapCache.h"
 #include "Logger.h"
 #include "Show.h"
 #include "Utils.h"
@@ -79,8 +80,9 @@ namespace SMPTE_SYNC
 
 #define STRINGS_EQUAL 0
     
-    CPLParser::CPLParser(const std::string &iPath) :
-        pathToCurrentCPL_(iPath)
+    CPLParser::CPLParser(const std::string &iPath, AssetMapCache *iAssetMapCache) :
+          pathToCurrentCPL_(iPath)
+        , assetMapCache_(iAssetMapCache)
     {
         SMPTE_SYNC_LOG << "CPLParser::CPLParser";
     }
@@ -129,9 +131,6 @@ namespace SMPTE_SYNC
     {
         SMPTE_SYNC_LOG << "CPLParser::ParseCPL pathToCurrentCPL_ = " << pathToCurrentCPL_ << "\n";
         
-        if (this->IsFileCPL() == false)
-            return nullptr;
-        
         std::ifstream inputStream(pathToCurrentCPL_, std::ifstream::in);
 
         if (!inputStream.good())
@@ -152,9 +151,15 @@ namespace SMPTE_SYNC
         
         delete [] buf;
         
-        this->ParseAssetMap();
-
         TiXmlHandle cplXMLDocHandle( &cplXMLDoc );
+
+        // The file is read once. Check it is a CPL the same way IsFileCPL does.
+        //
+        if (cplXMLDocHandle.FirstChild(SMPTE_SYNC_COMPOSITIONPLAYLIST).ToElement() == nullptr)
+            return nullptr;
+
+        this->LoadAssetMap();
+
         TiXmlElement* reelList = cplXMLDocHandle.FirstChild(SMPTE_SYNC_COMPOSITIONPLAYLIST).FirstChild(SMPTE_SYNC_REELLIST).ToElement();
 
         CPL *cpl = nullptr;
@@ -174,7 +179,7 @@ namespace SMPTE_SYNC
                 // Strip off the urn:uuid:
                 //
                 idStr = idStr.substr(idStr.rfind(":") + 1, idStr.length());
-                StringToUUID(idStr, cpl->id_);
+                UUID::FromString(idStr, cpl->id_);
             }
 
             this->MapReels(reelList, cpl);
@@ -209,7 +214,7 @@ namespace SMPTE_SYNC
                     // Strip off the urn:uuid:
                     //
                     idStr = idStr.substr(idStr.rfind(":") + 1, idStr.length());
-                    StringToUUID(idStr, reel->id_);
+                    UUID::FromString(idStr, reel->id_);
                 }
 
                 iCPL->reels_.push_back(reel);
@@ -266,7 +271,7 @@ namespace SMPTE_SYNC
                 // Strip off the urn:uuid:
                 //
                 idStr = idStr.substr(idStr.rfind(":") + 1, idStr.length());
-                StringToUUID(idStr, asset->id_);
+                UUID::FromString(idStr, asset->id_);
 
                 this->UpdateAssetPathInfo(asset);
             }
@@ -332,31 +337,51 @@ namespace SMPTE_SYNC
         SMPTE_SYNC_LOG << "CPLParser::UpdateAssetPathInfo";
         assert(iAsset != nullptr);
 
-        for (std::vector<AssetFileInfo>::iterator iter = assetMap_.begin(); iter != assetMap_.end(); iter++)
-        {
-            if (IsEqual(iAsset->id_, iter->id_))
-            {
-                if ( iter->chunkList_.size() > 0)
-                {
-                    iAsset->path_ = iter->chunkList_[0].path_;
-                    iAsset->volumeIndex_ = iter->chunkList_[0].volumeIndex_;
-                    iAsset->offset_ = iter->chunkList_[0].offset_;
-                    iAsset->length_ = iter->chunkList_[0].length_;
+        if (!assetMap_)
+            return false;
 
-                    return true;
-                }
-            }
-        }
-        
-        return false;
+        AssetFileInfoMap::const_iterator iter = assetMap_->find(iAsset->id_);
+
+        if (iter == assetMap_->end() || iter->second.chunkList_.size() == 0)
+            return false;
+
+        iAsset->path_ = iter->second.chunkList_[0].path_;
+        iAsset->volumeIndex_ = iter->second.chunkList_[0].volumeIndex_;
+        iAsset->offset_ = iter->second.chunkList_[0].offset_;
+        iAsset->length_ = iter->second.chunkList_[0].length_;
+
+        return true;
+    }
+
+    std::string CPLParser::GetAssetMapPath(const std::string &iDirectory)
+    {
+        return iDirectory + sAssetMapFileName;
     }
 
-    void CPLParser::ParseAssetMap(void)
+    std::string CPLParser::GetPackageDirectory(const std::string &iCPLPath)
+    {
+        return iCPLPath.substr(0, iCPLPath.rfind("/") + 1);
+    }
+
+    void CPLParser::LoadAssetMap(void)
+    {
+        std::string pathToCPLDirectory = GetPackageDirectory(pathToCurrentCPL_);
+
+        if (assetMapCache_ != nullptr)
+            assetMap_ = assetMapCache_->Find(pathToCPLDirectory);
+        else
+            assetMap_ = ParseAssetMap(pathToCPLDirectory);
+    }
+
+    AssetFileInfoMapPtr CPLParser::ParseAssetMap(const std::string &iDirectory)
     {
         SMPTE_SYNC_LOG << "CPLParser::ParseAssetMap";
 
-        std::string pathToCPLDirectory = pathToCurrentCPL_.substr(0, pathToCurrentCPL_.rfind("/") + 1);
-        std::string filename = pathToCPLDirectory + sAssetMapFileName;
+        AssetFileInfoMap *assetMap = new AssetFileInfoMap;
+        AssetFileInfoMapPtr assetMapPtr(assetMap);
+
+        std::string pathToCPLDirectory = iDirectory;
+        std::string filename = GetAssetMapPath(pathToCPLDirectory);
 
         SMPTE_SYNC_LOG << "Using asset map: " << filename;
 
@@ -365,7 +390,7 @@ namespace SMPTE_SYNC
         if (!inputStream.good())
         {
             SMPTE_SYNC_LOG << "Input file cannot be read. Wrong filename?" << std::endl;
-            return;
+            return assetMapPtr;
         }
         
         inputStream.seekg(0, std::ios::end);
@@ -402,7 +427,7 @@ namespace SMPTE_SYNC
                         // Strip off the urn:uuid:
                         //
                         idStr = idStr.substr(idStr.rfind(":") + 1, idStr.length());
-                        StringToUUID(idStr, fileInfo.id_);
+                        UUID::FromString(idStr, fileInfo.id_);
                         
                         TiXmlElement *chunkElement = handle.FirstChild(SMPTE_SYNC_CHUNKLIST).FirstChild(SMPTE_SYNC_CHUNK).ToElement();
                         if (chunkElement)
@@ -445,10 +470,19 @@ namespace SMPTE_SYNC
                             fileInfo.chunkList_.push_back(chunk);
                         }
                     }
-                    assetMap_.push_back(fileInfo);
+                    // The first entry of an asset with a chunk is used, as when the assets were searched in file order
+                    //
+                    AssetFileInfoMap::iterator iter = assetMap->find(fileInfo.id_);
+
+                    if (iter == assetMap->end())
+                        assetMap->insert(std::make_pair(fileInfo.id_, fileInfo));
+                    else if (iter->second.chunkList_.size() == 0)
+                        iter->second = fileInfo;
                 }
             }
         }
+
+        return assetMapPtr;
     }
     
 }  // namespace SMPTE_SYNC
@@ -38,6 +38,9 @@
 #include <vector>
 #include "tinyxml.h"
 
+#include "boost/shared_ptr.hpp"
+#include "boost/unordered_map.hpp"
+
 #include "DataTypes.h"
 
 namespace SMPTE_SYNC
@@ -46,6 +49,7 @@ namespace SMPTE_SYNC
     class CPL;
     class Reel;
     class Asset;
+    class AssetMapCache;
     
     /**
      * @brief Chunk represents the file information that is stored in a ASSETMAP.xml in the DCP
@@ -114,8 +118,19 @@ namespace SMPTE_SYNC
         std::vector<Chunk> chunkList_;
     };
     
+    /**
+     * @brief AssetFileInfoMap holds the assets of an ASSETMAP.xml keyed by asset UUID
+     *
+     */
+    typedef boost::unordered_map<UUID, AssetFileInfo> AssetFileInfoMap;
+
+    /// Parsed ASSETMAP.xml shared by the CPLParser objects of a package
+    typedef boost::shared_ptr<const AssetFileInfoMap> AssetFileInfoMapPtr;
+
     /**
      * @brief CPLParser parses a specific CPL and assocaited ASSETMAP.xml file.
+     * With an AssetMapCache the ASSETMAP.xml is parsed once per package and shared by all of its CPLs.
+     * Separate CPLParser objects can parse concurrently.
      *
      */
 
@@ -129,9 +144,10 @@ namespace SMPTE_SYNC
          * Parses a CPL.
          *
          * @param iPath is the path to the CPL to be parsed
+         * @param iAssetMapCache is the cache the ASSETMAP.xml next to the CPL is read from. nullptr parses it for this CPLParser only.
          *
          */
-        CPLParser(const std::string &iPath);
+        CPLParser(const std::string &iPath, AssetMapCache *iAssetMapCache = nullptr);
         
         /// Destructor
         virtual ~CPLParser();
@@ -157,14 +173,30 @@ namespace SMPTE_SYNC
          */
         bool IsFileCPL(void);
 
+        /**
+         *
+         * Parses an ASSETMAP.xml file.
+         *
+         * @param iDirectory is the directory containing the ASSETMAP.xml, ending with a /
+         * @return AssetFileInfoMapPtr to the assets found. Empty map if the file could not be read.
+         *
+         */
+        static AssetFileInfoMapPtr ParseAssetMap(const std::string &iDirectory);
+
+        /// Returns the path of the ASSETMAP.xml in a directory ending with a /
+        static std::string GetAssetMapPath(const std::string &iDirectory);
+
+        /// Returns the directory of a CPL ending with a /. This is the directory of its ASSETMAP.xml.
+        static std::string GetPackageDirectory(const std::string &iCPLPath);
+
     private:
 
         /**
          *
-         * Parses the ASSETMAP.xml file associated with the CPL.
+         * Reads the ASSETMAP.xml file associated with the CPL from the assetMapCache_ or parses it.
          *
          */
-        void ParseAssetMap(void);
+        void LoadAssetMap(void);
 
         /**
          *
@@ -198,8 +230,11 @@ namespace SMPTE_SYNC
         /// The path to the CPL XML file to be parsed
         std::string  pathToCurrentCPL_;
         
-        // Vector of all asset information found. Contains information from the ASSETMAP.xml file
-        std::vector<AssetFileInfo> assetMap_;
+        /// Cache of ASSETMAP.xml files shared with other CPLParser objects. May be nullptr.
+        AssetMapCache *assetMapCache_;
+
+        // All asset information found. Contains information from the ASSETMAP.xml file
+        AssetFileInfoMapPtr assetMap_;
     };
 
 }  // namespace SMPTE_SYNC
@@ -0,0 +1,425 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "CompiledShow.h"
+
+#include <string.h>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "AuxDataIndex.h"
+#include "CPLParser.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "Show.h"
+
+namespace SMPTE_SYNC
+{
+    // Compiled show file layout. All fields are in host byte order.
+    // Header, source files, CPLs, Reels, Assets and then the strings they reference.
+    // Like the index sidecars it is a cache for the host that wrote it.
+    //
+    static const char sCompiledShowMagic[8] = { 'S', 'S', 'S', 'H', 'O', 'W', 'C', '1' };
+    static const uint32_t sCompiledShowVersion = 1;
+
+    typedef struct CompiledShowHeader
+    {
+        char        magic_[8];
+        uint32_t    version_;
+        uint32_t    numberOfSourceFiles_;
+        uint32_t    numberOfCPLs_;
+        uint32_t    numberOfReels_;
+        uint32_t    numberOfAssets_;
+        uint32_t    stringTableSize_;
+    } CompiledShowHeader;
+
+    typedef struct SourceFileRecord
+    {
+        uint64_t    fileSize_;
+        int64_t     modificationTime_;
+        uint32_t    pathOffset_;
+        uint32_t    pathLength_;
+    } SourceFileRecord;
+
+    typedef struct CPLRecord
+    {
+        uint8_t     id_[16];
+        uint32_t    firstReel_;
+        uint32_t    numberOfReels_;
+    } CPLRecord;
+
+    typedef struct ReelRecord
+    {
+        uint8_t     id_[16];
+        uint32_t    firstAsset_;
+        uint32_t    numberOfAssets_;
+    } ReelRecord;
+
+    typedef struct AssetRecord
+    {
+        uint8_t     id_[16];
+        int32_t     type_;
+        int32_t     editRateNumerator_;
+        int32_t     editRateDenominator_;
+        int32_t     frameRateNumerator_;
+        int32_t     frameRateDenominator_;
+        int32_t     intrinsicDuration_;
+        int32_t     entryPoint_;
+        int32_t     duration_;
+        int32_t     volumeIndex_;
+        int32_t     offset_;
+        int32_t     length_;
+        uint32_t    dataEssenceCodingULOffset_;
+        uint32_t    dataEssenceCodingULLength_;
+        uint32_t    pathOffset_;
+        uint32_t    pathLength_;
+        uint32_t    reserved_;
+    } AssetRecord;
+
+    // Appends a string to the string table and returns its offset
+    //
+    static uint32_t AddString(std::vector<char> &ioStrings, const std::string &iString)
+    {
+        uint32_t offset = static_cast<uint32_t>(ioStrings.size());
+        ioStrings.insert(ioStrings.end(), iString.begin(), iString.end());
+        return offset;
+    }
+
+    // Reads a string from the string table. Fails if it is outside of the table.
+    //
+    static bool GetString(const char *iStrings, uint32_t iStringTableSize, uint32_t iOffset, uint32_t iLength, std::string &oString)
+    {
+        if (iOffset > iStringTableSize || iLength > iStringTableSize - iOffset)
+            return false;
+
+        oString.assign(iStrings + iOffset, iLength);
+        return true;
+    }
+
+    std::string CompiledShow::BuildPath(const std::string &iDirectory, const CPLFileList &iCPLList)
+    {
+        std::string cplPaths;
+
+        for (CPLFileList::const_iterator iter = iCPLList.begin(); iter != iCPLList.end(); iter++)
+            cplPaths += *iter + "\n";
+
+        // Named after a hash of the CPL paths. The paths themselves are checked when the file is loaded.
+        //
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << static_cast<uint64_t>(std::hash<std::string>()(cplPaths)) << ".show";
+
+        std::string path = iDirectory;
+
+        if (path[path.size() - 1] != '/')
+            path += "/";
+
+        return path + name.str();
+    }
+
+    bool CompiledShow::GetSourceFiles(const CPLFileList &iCPLList, SourceFileList &oSourceFiles)
+    {
+        oSourceFiles.clear();
+
+        std::vector<std::string> paths(iCPLList.begin(), iCPLList.end());
+        std::set<std::string> packageDirectories;
+
+        for (CPLFileList::const_iterator iter = iCPLList.begin(); iter != iCPLList.end(); iter++)
+        {
+            std::string packageDirectory = CPLParser::GetPackageDirectory(*iter);
+
+            if (packageDirectories.insert(packageDirectory).second)
+                paths.push_back(CPLParser::GetAssetMapPath(packageDirectory));
+        }
+
+        for (std::vector<std::string>::iterator iter = paths.begin(); iter != paths.end(); iter++)
+        {
+            SourceFile sourceFile;
+            sourceFile.path_ = *iter;
+
+            if (!AuxDataIndex::GetFileIdentity(sourceFile.path_, sourceFile.fileSize_, sourceFile.modificationTime_))
+                return false;
+
+            oSourceFiles.push_back(sourceFile);
+        }
+
+        return true;
+    }
+
+    bool CompiledShow::Save(const std::string &iPath, const SourceFileList &iSourceFiles, const std::vector<CPL*> &iCPLs)
+    {
+        std::vector<SourceFileRecord> sourceFileRecords;
+        std::vector<CPLRecord> cplRecords;
+        std::vector<ReelRecord> reelRecords;
+        std::vector<AssetRecord> assetRecords;
+        std::vector<char> strings;
+
+        for (SourceFileList::const_iterator iter = iSourceFiles.begin(); iter != iSourceFiles.end(); iter++)
+        {
+            SourceFileRecord record;
+            memset(&record, 0, sizeof(record));
+            record.fileSize_ = iter->fileSize_;
+            record.modificationTime_ = iter->modificationTime_;
+            record.pathOffset_ = AddString(strings, iter->path_);
+            record.pathLength_ = static_cast<uint32_t>(iter->path_.size());
+
+            sourceFileRecords.push_back(record);
+        }
+
+        for (std::vector<CPL*>::const_iterator cplIter = iCPLs.begin(); cplIter != iCPLs.end(); cplIter++)
+        {
+            CPLRecord cplRecord;
+            memset(&cplRecord, 0, sizeof(cplRecord));
+            memcpy(cplRecord.id_, (*cplIter)->id_.data(), UUID::sizeInBytes_);
+            cplRecord.firstReel_ = static_cast<uint32_t>(reelRecords.size());
+            cplRecord.numberOfReels_ = static_cast<uint32_t>((*cplIter)->reels_.size());
+
+            cplRecords.push_back(cplRecord);
+
+            for (std::vector<Reel*>::iterator reelIter = (*cplIter)->reels_.begin(); reelIter != (*cplIter)->reels_.end(); reelIter++)
+            {
+                ReelRecord reelRecord;
+                memset(&reelRecord, 0, sizeof(reelRecord));
+                memcpy(reelRecord.id_, (*reelIter)->id_.data(), UUID::sizeInBytes_);
+                reelRecord.firstAsset_ = static_cast<uint32_t>(assetRecords.size());
+                reelRecord.numberOfAssets_ = static_cast<uint32_t>((*reelIter)->assets_.size());
+
+                reelRecords.push_back(reelRecord);
+
+                for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
+                {
+                    Asset *asset = *assetIter;
+
+                    AssetRecord assetRecord;
+                    memset(&assetRecord, 0, sizeof(assetRecord));
+                    memcpy(assetRecord.id_, asset->id_.data(), UUID::sizeInBytes_);
+                    assetRecord.type_ = asset->type_;
+                    assetRecord.editRateNumerator_ = asset->editRateNumerator_;
+                    assetRecord.editRateDenominator_ = asset->editRateDenominator_;
+                    assetRecord.frameRateNumerator_ = asset->frameRateNumerator_;
+                    assetRecord.frameRateDenominator_ = asset->frameRateDenominator_;
+                    assetRecord.intrinsicDuration_ = asset->intrinsicDuration_;
+                    assetRecord.entryPoint_ = asset->entryPoint_;
+                    assetRecord.duration_ = asset->duration_;
+                    assetRecord.volumeIndex_ = asset->volumeIndex_;
+                    assetRecord.offset_ = asset->offset_;
+                    assetRecord.length_ = asset->length_;
+                    assetRecord.dataEssenceCodingULOffset_ = AddString(strings, asset->dataEssenceCodingUL_);
+                    assetRecord.dataEssenceCodingULLength_ = static_cast<uint32_t>(asset->dataEssenceCodingUL_.size());
+                    assetRecord.pathOffset_ = AddString(strings, asset->path_);
+                    assetRecord.pathLength_ = static_cast<uint32_t>(asset->path_.size());
+
+                    assetRecords.push_back(assetRecord);
+                }
+            }
+        }
+
+        CompiledShowHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic_, sCompiledShowMagic, sizeof(sCompiledShowMagic));
+        header.version_ = sCompiledShowVersion;
+        header.numberOfSourceFiles_ = static_cast<uint32_t>(sourceFileRecords.size());
+        header.numberOfCPLs_ = static_cast<uint32_t>(cplRecords.size());
+        header.numberOfReels_ = static_cast<uint32_t>(reelRecords.size());
+        header.numberOfAssets_ = static_cast<uint32_t>(assetRecords.size());
+        header.stringTableSize_ = static_cast<uint32_t>(strings.size());
+
+        std::string temporaryPath = AuxDataIndex::GetTemporaryPath(iPath);
+
+        {
+            std::ofstream file(temporaryPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!file)
+                return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(sourceFileRecords.data()), sourceFileRecords.size() * sizeof(SourceFileRecord));
+            file.write(reinterpret_cast<const char*>(cplRecords.data()), cplRecords.size() * sizeof(CPLRecord));
+            file.write(reinterpret_cast<const char*>(reelRecords.data()), reelRecords.size() * sizeof(ReelRecord));
+            file.write(reinterpret_cast<const char*>(assetRecords.data()), assetRecords.size() * sizeof(AssetRecord));
+            file.write(strings.data(), strings.size());
+
+            if (!file)
+            {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(temporaryPath.c_str(), iPath.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool CompiledShow::Load(const std::string &iPath, const SourceFileList &iSourceFiles, std::vector<CPL*> &oCPLs)
+    {
+        oCPLs.clear();
+
+        MappedFile mappedFile;
+
+        if (!mappedFile.Open(iPath) || mappedFile.GetSize() < sizeof(CompiledShowHeader))
+            return false;
+
+        const uint8_t *data = mappedFile.GetData();
+
+        CompiledShowHeader header;
+        memcpy(&header, data, sizeof(header));
+
+        uint64_t expectedSize = sizeof(CompiledShowHeader)
+                              + static_cast<uint64_t>(header.numberOfSourceFiles_) * sizeof(SourceFileRecord)
+                              + static_cast<uint64_t>(header.numberOfCPLs_) * sizeof(CPLRecord)
+                              + static_cast<uint64_t>(header.numberOfReels_) * sizeof(ReelRecord)
+                              + static_cast<uint64_t>(header.numberOfAssets_) * sizeof(AssetRecord)
+                              + header.stringTableSize_;
+
+        if (memcmp(header.magic_, sCompiledShowMagic, sizeof(sCompiledShowMagic)) != 0
+            || header.version_ != sCompiledShowVersion
+            || mappedFile.GetSize() != expectedSize)
+        {
+            SMPTE_SYNC_LOG << "CompiledShow::Load - invalid compiled show " << iPath;
+            return false;
+        }
+
+        const SourceFileRecord *sourceFileRecords = reinterpret_cast<const SourceFileRecord*>(data + sizeof(CompiledShowHeader));
+        const CPLRecord *cplRecords = reinterpret_cast<const CPLRecord*>(sourceFileRecords + header.numberOfSourceFiles_);
+        const ReelRecord *reelRecords = reinterpret_cast<const ReelRecord*>(cplRecords + header.numberOfCPLs_);
+        const AssetRecord *assetRecords = reinterpret_cast<const AssetRecord*>(reelRecords + header.numberOfReels_);
+        const char *strings = reinterpret_cast<const char*>(assetRecords + header.numberOfAssets_);
+
+        // Compiled from exactly the same, unchanged files
+        //
+        if (header.numberOfSourceFiles_ != iSourceFiles.size())
+            return false;
+
+        for (uint32_t index = 0; index < header.numberOfSourceFiles_; index++)
+        {
+            const SourceFileRecord &record = sourceFileRecords[index];
+            std::string path;
+
+            if (!GetString(strings, header.stringTableSize_, record.pathOffset_, record.pathLength_, path)
+                || path != iSourceFiles[index].path_
+                || record.fileSize_ != iSourceFiles[index].fileSize_
+                || record.modificationTime_ != iSourceFiles[index].modificationTime_)
+            {
+                SMPTE_SYNC_LOG << "CompiledShow::Load - " << iSourceFiles[index].path_ << " changed since the show was compiled";
+                return false;
+            }
+        }
+
+        bool success = true;
+
+        for (uint32_t cplIndex = 0; cplIndex < header.numberOfCPLs_ && success; cplIndex++)
+        {
+            const CPLRecord &cplRecord = cplRecords[cplIndex];
+
+            CPL *cpl = new CPL;
+            oCPLs.push_back(cpl);
+
+            cpl->id_ = UUID(cplRecord.id_);
+
+            if (cplRecord.firstReel_ > header.numberOfReels_ || cplRecord.numberOfReels_ > header.numberOfReels_ - cplRecord.firstReel_)
+            {
+                success = false;
+                break;
+            }
+
+            for (uint32_t reelIndex = cplRecord.firstReel_; reelIndex < cplRecord.firstReel_ + cplRecord.numberOfReels_ && success; reelIndex++)
+            {
+                const ReelRecord &reelRecord = reelRecords[reelIndex];
+
+                Reel *reel = new Reel;
+                cpl->reels_.push_back(reel);
+
+                reel->id_ = UUID(reelRecord.id_);
+
+                if (reelRecord.firstAsset_ > header.numberOfAssets_ || reelRecord.numberOfAssets_ > header.numberOfAssets_ - reelRecord.firstAsset_)
+                {
+                    success = false;
+                    break;
+                }
+
+                for (uint32_t assetIndex = reelRecord.firstAsset_; assetIndex < reelRecord.firstAsset_ + reelRecord.numberOfAssets_; assetIndex++)
+                {
+                    const AssetRecord &assetRecord = assetRecords[assetIndex];
+
+                    Asset *asset = new Asset;
+                    reel->assets_.push_back(asset);
+
+                    asset->id_ = UUID(assetRecord.id_);
+                    asset->type_ = static_cast<Asset::AssetType>(assetRecord.type_);
+                    asset->editRateNumerator_ = assetRecord.editRateNumerator_;
+                    asset->editRateDenominator_ = assetRecord.editRateDenominator_;
+                    asset->frameRateNumerator_ = assetRecord.frameRateNumerator_;
+                    asset->frameRateDenominator_ = assetRecord.frameRateDenominator_;
+                    asset->intrinsicDuration_ = assetRecord.intrinsicDuration_;
+                    asset->entryPoint_ = assetRecord.entryPoint_;
+                    asset->duration_ = assetRecord.duration_;
+                    asset->volumeIndex_ = assetRecord.volumeIndex_;
+                    asset->offset_ = assetRecord.offset_;
+                    asset->length_ = assetRecord.length_;
+
+                    // Show divides frame counts by the whole edit rate of every asset
+                    //
+                    if (assetRecord.type_ < Asset::eAssetType_Unknown
+                        || assetRecord.type_ > Asset::eAssetType_AuxData
+                        || assetRecord.editRateDenominator_ <= 0
+                        || assetRecord.editRateNumerator_ < assetRecord.editRateDenominator_
+                        || !GetString(strings, header.stringTableSize_, assetRecord.dataEssenceCodingULOffset_, assetRecord.dataEssenceCodingULLength_, asset->dataEssenceCodingUL_)
+                        || !GetString(strings, header.stringTableSize_, assetRecord.pathOffset_, assetRecord.pathLength_, asset->path_))
+                    {
+                        success = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!success)
+        {
+            SMPTE_SYNC_LOG << "CompiledShow::Load - invalid compiled show " << iPath;
+
+            for (std::vector<CPL*>::iterator iter = oCPLs.begin(); iter != oCPLs.end(); iter++)
+                delete *iter;
+
+            oCPLs.clear();
+        }
+
+        return success;
+    }
+
+}  // namespace SMPTE_SYNC
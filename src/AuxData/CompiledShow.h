@@ -0,0 +1,127 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef COMPILEDSHOW_H
+#define COMPILEDSHOW_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "DataTypes.h"
+
+namespace SMPTE_SYNC
+{
+    class CPL;
+
+    /**
+     *
+     * @brief CompiledShow reads and writes the CPLs of a Show as a flat binary file so a restart does not parse any XML.
+     * The file holds tables of the CPLs, Reels and Assets of the timeline with their UUIDs, edit rates, durations and paths,
+     * along with the size and modification time of every CPL and ASSETMAP.xml they were parsed from.
+     * It is only used while all of those files are unchanged. The offset index of each aux data track file is kept
+     * separately by the AuxDataIndexCache.
+     *
+     */
+
+    class CompiledShow
+    {
+    public:
+
+        /**
+         *
+         * @brief SourceFile identifies a CPL or ASSETMAP.xml a Show was compiled from
+         *
+         */
+        typedef struct SourceFile
+        {
+            /// Path to the file
+            std::string path_;
+
+            /// Size of the file
+            uint64_t    fileSize_;
+
+            /// Modification time of the file in nanoseconds
+            int64_t     modificationTime_;
+        } SourceFile;
+
+        /// The CPLs of a Show in timeline order followed by the ASSETMAP.xml of each package
+        typedef std::vector<SourceFile> SourceFileList;
+
+        /**
+         *
+         * Returns the path of the compiled show for a list of CPLs
+         *
+         * @param iDirectory is the directory compiled shows are kept in
+         * @param iCPLList is the list of CPLs of the Show
+         * @return std::string path named after a hash of the CPL paths
+         *
+         */
+        static std::string BuildPath(const std::string &iDirectory, const CPLFileList &iCPLList);
+
+        /**
+         *
+         * Reads the identity of the files a list of CPLs is parsed from.
+         * Done before parsing so a file modified while it is parsed invalidates the compiled show.
+         *
+         * @param iCPLList is the list of CPLs of the Show
+         * @param oSourceFiles is filled with the CPLs and then the ASSETMAP.xml of each package
+         * @return bool true/false if every file exists
+         *
+         */
+        static bool GetSourceFiles(const CPLFileList &iCPLList, SourceFileList &oSourceFiles);
+
+        /**
+         *
+         * Writes the compiled show. The file is replaced atomically.
+         *
+         * @param iPath is the path of the compiled show
+         * @param iSourceFiles are the files the CPLs were parsed from
+         * @param iCPLs are the parsed CPLs in timeline order
+         * @return bool true/false if the file was written
+         *
+         */
+        static bool Save(const std::string &iPath, const SourceFileList &iSourceFiles, const std::vector<CPL*> &iCPLs);
+
+        /**
+         *
+         * Memory maps a compiled show and creates its CPLs if it was compiled from exactly iSourceFiles
+         *
+         * @param iPath is the path of the compiled show
+         * @param iSourceFiles are the current identities of the files of the Show
+         * @param oCPLs is filled with new CPL objects in timeline order. The caller owns them.
+         * @return bool true/false if the compiled show is valid and oCPLs was filled
+         *
+         */
+        static bool Load(const std::string &iPath, const SourceFileList &iSourceFiles, std::vector<CPL*> &oCPLs);
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // COMPILEDSHOW_H
@@ -0,0 +1,491 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "IoUringAuxDataIOEngine.h"
+
+#if defined(SMPTE_SYNC_USE_IO_URING)
+
+#include <errno.h>
+#include <string.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/bind.hpp"
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    // user_data of the no-op submitted by Stop to wake the completion thread
+    //
+    static const uint64_t sWakeUserData = 0;
+
+    static int io_uring_setup(unsigned iEntries, struct io_uring_params *ioParams)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, iEntries, ioParams));
+    }
+
+    static int io_uring_enter(int iRingFd, unsigned iToSubmit, unsigned iMinComplete, unsigned iFlags)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, iRingFd, iToSubmit, iMinComplete, iFlags, nullptr, 0));
+    }
+
+    IoUringAuxDataIOEngine::IoUringAuxDataIOEngine() :
+          ringFd_(-1)
+        , sqRing_(MAP_FAILED)
+        , sqRingSize_(0)
+        , cqRing_(MAP_FAILED)
+        , cqRingSize_(0)
+        , sqes_(nullptr)
+        , sqesSize_(0)
+        , sqHead_(nullptr)
+        , sqTail_(nullptr)
+        , sqMask_(nullptr)
+        , sqArray_(nullptr)
+        , cqHead_(nullptr)
+        , cqTail_(nullptr)
+        , cqMask_(nullptr)
+        , cqes_(nullptr)
+        , queueDepth_(0)
+        , inFlight_(0)
+        , unsubmitted_(0)
+        , stopping_(false)
+        , failed_(false)
+        , completionThread_(nullptr)
+    {
+    }
+
+    IoUringAuxDataIOEngine::~IoUringAuxDataIOEngine()
+    {
+        this->Stop();
+        this->Close();
+    }
+
+    bool IoUringAuxDataIOEngine::Open(int32_t iQueueDepth)
+    {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+
+        ringFd_ = io_uring_setup(static_cast<unsigned>(iQueueDepth > 0 ? iQueueDepth : 1), &params);
+        if (ringFd_ < 0)
+        {
+            SMPTE_SYNC_LOG << "IoUringAuxDataIOEngine::Open - io_uring_setup failed errno = " << errno;
+            return false;
+        }
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+        {
+            sqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+            cqRingSize_ = sqRingSize_;
+        }
+
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED)
+        {
+            this->Close();
+            return false;
+        }
+
+        if (singleMap)
+        {
+            cqRing_ = sqRing_;
+        }
+        else
+        {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED)
+            {
+                this->Close();
+                return false;
+            }
+        }
+
+        sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void *sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            this->Close();
+            return false;
+        }
+
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+        uint8_t *sq = static_cast<uint8_t*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        uint8_t *cq = static_cast<uint8_t*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // Leave a submission queue entry for the no-op submitted by Stop.
+        // The completion queue is twice the size of the submission queue so it can not overflow.
+        //
+        queueDepth_ = std::min(iQueueDepth, static_cast<int32_t>(params.sq_entries) - 1);
+        if (queueDepth_ < 1)
+        {
+            this->Close();
+            return false;
+        }
+
+        completionThread_ = new boost::thread(boost::bind(&IoUringAuxDataIOEngine::RunCompletions, this));
+
+        return true;
+    }
+
+    void IoUringAuxDataIOEngine::Close(void)
+    {
+        if (sqes_ != nullptr)
+            ::munmap(sqes_, sqesSize_);
+
+        if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_)
+            ::munmap(cqRing_, cqRingSize_);
+
+        if (sqRing_ != MAP_FAILED)
+            ::munmap(sqRing_, sqRingSize_);
+
+        if (ringFd_ >= 0)
+            ::close(ringFd_);
+
+        sqes_ = nullptr;
+        cqRing_ = MAP_FAILED;
+        sqRing_ = MAP_FAILED;
+        ringFd_ = -1;
+    }
+
+    bool IoUringAuxDataIOEngine::Read(const std::string &iPath
+                                      , uint64_t iOffset
+                                      , uint32_t iLength
+                                      , const AuxDataReadCallback &iCallback)
+    {
+        AuxDataFilePtr file = this->AcquireFile(iPath);
+        if (!file)
+            return false;
+
+        ReadRequest *request = new ReadRequest;
+        request->file_ = file;
+        request->offset_ = iOffset;
+        request->length_ = iLength;
+        request->bytesRead_ = 0;
+        request->buffer_.reset(new std::vector<uint8_t>(iLength));
+        request->callback_ = iCallback;
+
+        boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+        if (stopping_ || failed_ || completionThread_ == nullptr)
+        {
+            delete request;
+            return false;
+        }
+
+        queued_.push_back(request);
+        this->SubmitLocked();
+
+        return true;
+    }
+
+    void IoUringAuxDataIOEngine::Stop(void)
+    {
+        std::deque<ReadRequest*> discarded;
+
+        {
+            boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+            if (stopping_ || completionThread_ == nullptr)
+                return;
+
+            stopping_ = true;
+
+            // The reads that have not been submitted yet are never read.
+            // Their callbacks still run so the callers can release what they hold for them.
+            //
+            discarded.swap(queued_);
+
+            // Wake the completion thread so it notices we are stopping
+            //
+            if (!failed_)
+            {
+                this->PushLocked(IORING_OP_NOP, nullptr);
+                this->SubmitLocked();
+            }
+        }
+
+        this->FailReads(discarded);
+
+        completionThread_->join();
+        delete completionThread_;
+        completionThread_ = nullptr;
+    }
+
+    void IoUringAuxDataIOEngine::FailReads(std::deque<ReadRequest*> &ioRequests)
+    {
+        for (std::deque<ReadRequest*>::iterator iter = ioRequests.begin(); iter != ioRequests.end(); iter++)
+        {
+            ReadRequest *request = *iter;
+
+            request->buffer_->resize(request->bytesRead_);
+            request->callback_(false, request->buffer_);
+
+            delete request;
+        }
+
+        ioRequests.clear();
+    }
+
+    std::string IoUringAuxDataIOEngine::GetName(void)
+    {
+        return "io_uring";
+    }
+
+    void IoUringAuxDataIOEngine::PushLocked(uint8_t iOpcode, ReadRequest *iRequest)
+    {
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+
+        struct io_uring_sqe *sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+
+        sqe->opcode = iOpcode;
+        sqe->fd = -1;
+        sqe->user_data = sWakeUserData;
+
+        if (iRequest != nullptr)
+        {
+            iRequest->iov_.iov_base = iRequest->buffer_->data() + iRequest->bytesRead_;
+            iRequest->iov_.iov_len = iRequest->length_ - iRequest->bytesRead_;
+
+            sqe->fd = iRequest->file_->GetFileDescriptor();
+            sqe->off = iRequest->offset_ + iRequest->bytesRead_;
+            sqe->addr = reinterpret_cast<uint64_t>(&iRequest->iov_);
+            sqe->len = 1;
+            sqe->user_data = reinterpret_cast<uint64_t>(iRequest);
+        }
+
+        sqArray_[index] = index;
+
+        // Publish the entry before the kernel can see the new tail
+        //
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        unsubmitted_++;
+    }
+
+    void IoUringAuxDataIOEngine::SubmitLocked(void)
+    {
+        while (!queued_.empty() && inFlight_ < queueDepth_)
+        {
+            this->PushLocked(IORING_OP_READV, queued_.front());
+            queued_.pop_front();
+            inFlight_++;
+        }
+
+        while (unsubmitted_ > 0)
+        {
+            int result = io_uring_enter(ringFd_, static_cast<unsigned>(unsubmitted_), 0, 0);
+
+            if (result < 0 && errno == EINTR)
+                continue;
+
+            // The kernel is short of resources. The entries stay in the submission queue
+            // and RunCompletions submits them once completions have been reaped.
+            //
+            if (result <= 0)
+            {
+                if (result < 0 && errno != EAGAIN && errno != EBUSY)
+                {
+                    SMPTE_SYNC_LOG << "IoUringAuxDataIOEngine::SubmitLocked - io_uring_enter failed errno = " << errno;
+                }
+
+                break;
+            }
+
+            unsubmitted_ -= result;
+        }
+    }
+
+    void IoUringAuxDataIOEngine::RunCompletions(void)
+    {
+        bool woken = false;
+
+        for (;;)
+        {
+            unsigned toSubmit = 0;
+
+            {
+                boost::mutex::scoped_lock scoped_lock(submitMutex_);
+                toSubmit = static_cast<unsigned>(unsubmitted_);
+            }
+
+            // Submit what the kernel had no room for earlier in the same call that waits,
+            // otherwise it would wait for the next Read while we wait for its completions
+            //
+            int result = io_uring_enter(ringFd_, toSubmit, 1, IORING_ENTER_GETEVENTS);
+            int error = result < 0 ? errno : 0;
+
+            if (result > 0)
+            {
+                boost::mutex::scoped_lock scoped_lock(submitMutex_);
+                unsubmitted_ -= result;
+            }
+
+            if (error != 0 && error != EINTR && error != EAGAIN && error != EBUSY)
+            {
+                // The ring itself is broken. Nothing queued will ever be read.
+                //
+                std::deque<ReadRequest*> discarded;
+
+                {
+                    boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+                    SMPTE_SYNC_LOG << "IoUringAuxDataIOEngine::RunCompletions - io_uring_enter failed errno = " << error
+                    << ", giving up on " << inFlight_ << " reads in flight";
+
+                    failed_ = true;
+                    discarded.swap(queued_);
+                }
+
+                this->FailReads(discarded);
+                break;
+            }
+
+            /* reap everything that completed */
+
+            std::vector<std::pair<ReadRequest*, int32_t> > completions;
+
+            unsigned head = *cqHead_;
+            unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+            while (head != tail)
+            {
+                struct io_uring_cqe *cqe = &cqes_[head & *cqMask_];
+
+                if (cqe->user_data == sWakeUserData)
+                    woken = true;
+                else
+                    completions.push_back(std::make_pair(reinterpret_cast<ReadRequest*>(cqe->user_data), cqe->res));
+
+                head++;
+            }
+
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+            // The kernel is short of resources and nothing completed that would free them.
+            // Give it a moment rather than asking again straight away.
+            //
+            if (completions.empty() && !woken && (error == EAGAIN || error == EBUSY))
+            {
+                boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            }
+
+            /* run the callbacks without holding the lock */
+
+            std::vector<ReadRequest*> resubmits;
+
+            for (size_t i = 0; i < completions.size(); i++)
+            {
+                if (this->CompleteRead(completions[i].first, completions[i].second))
+                    resubmits.push_back(completions[i].first);
+            }
+
+            boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+            inFlight_ -= static_cast<int32_t>(completions.size());
+
+            // Resubmit the remainder of short reads ahead of new reads
+            //
+            queued_.insert(queued_.begin(), resubmits.begin(), resubmits.end());
+
+            this->SubmitLocked();
+
+            if (woken && inFlight_ == 0 && queued_.empty())
+                break;
+        }
+    }
+
+    bool IoUringAuxDataIOEngine::CompleteRead(ReadRequest *iRequest, int32_t iResult)
+    {
+        bool success = true;
+
+        if (iResult > 0)
+        {
+            iRequest->bytesRead_ += static_cast<uint32_t>(iResult);
+
+            if (iRequest->bytesRead_ < iRequest->length_)
+            {
+                boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+                if (!stopping_)
+                    return true;
+
+                success = false;
+            }
+        }
+        else if (iResult == -EINTR || iResult == -EAGAIN)
+        {
+            boost::mutex::scoped_lock scoped_lock(submitMutex_);
+
+            if (!stopping_)
+                return true;
+
+            success = false;
+        }
+        else if (iResult < 0)
+        {
+            SMPTE_SYNC_LOG << "IoUringAuxDataIOEngine::CompleteRead - read failed errno = " << -iResult;
+            success = false;
+        }
+
+        // A result of 0 is the end of the file. Hand out what was read.
+        //
+        iRequest->buffer_->resize(iRequest->bytesRead_);
+        iRequest->callback_(success, iRequest->buffer_);
+
+        delete iRequest;
+
+        return false;
+    }
+
+}  // namespace SMPTE_SYNC
+
+#endif // SMPTE_SYNC_USE_IO_URING
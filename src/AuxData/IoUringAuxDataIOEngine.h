@@ -0,0 +1,209 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef IOURINGAUXDATAIOENGINE_H
+#define IOURINGAUXDATAIOENGINE_H
+
+#if defined(SMPTE_SYNC_USE_IO_URING)
+
+#include <stdint.h>
+#include <sys/uio.h>
+#include <deque>
+#include <string>
+
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "AuxDataIOEngine.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief IoUringAuxDataIOEngine queues reads of all track files in a single io_uring.
+     * Up to the queue depth reads are in flight at once without a thread per read.
+     * Completions are reaped and callbacks run on a single completion thread.
+     * Talks to the kernel with the raw io_uring system calls so there is no dependency on liburing.
+     *
+     */
+
+    class IoUringAuxDataIOEngine : public AuxDataIOEngine
+    {
+    public:
+
+        /// Constructor
+        IoUringAuxDataIOEngine();
+
+        /// Destructor. Calls Stop and releases the ring.
+        virtual ~IoUringAuxDataIOEngine();
+
+        /**
+         *
+         * Sets up the ring and starts the completion thread.
+         *
+         * @param iQueueDepth is the maximum number of reads submitted to the kernel at once
+         * @return bool false if the kernel does not support io_uring or does not allow it
+         *
+         */
+        bool Open(int32_t iQueueDepth);
+
+        /// See AuxDataIOEngine::Read
+        virtual bool Read(const std::string &iPath
+                          , uint64_t iOffset
+                          , uint32_t iLength
+                          , const AuxDataReadCallback &iCallback);
+
+        /// See AuxDataIOEngine::Stop. The queued reads are not discarded silently, their callbacks run with iSuccess false.
+        virtual void Stop(void);
+
+        /// See AuxDataIOEngine::GetName
+        virtual std::string GetName(void);
+
+    private:
+
+        /**
+         *
+         * @brief ReadRequest is one read queued or in flight. Its address is the user data of the submission.
+         *
+         */
+        typedef struct ReadRequest
+        {
+            /// File being read
+            AuxDataFilePtr      file_;
+
+            /// Offset of the first byte to read
+            uint64_t            offset_;
+
+            /// Number of bytes to read
+            uint32_t            length_;
+
+            /// Number of bytes read so far. Short reads are resubmitted for the remainder.
+            uint32_t            bytesRead_;
+
+            /// Buffer being read into
+            AuxDataReadBufferPtr buffer_;
+
+            /// Describes the remainder of buffer_ to the kernel
+            struct iovec        iov_;
+
+            /// Run when the read completes
+            AuxDataReadCallback callback_;
+        } ReadRequest;
+
+        /// Moves queued requests into the submission queue up to queueDepth_ and submits them. Requires submitMutex_ to be held.
+        void SubmitLocked(void);
+
+        /// Pushes one entry into the submission queue. Requires submitMutex_ to be held.
+        void PushLocked(uint8_t iOpcode, ReadRequest *iRequest);
+
+        /**
+         *
+         * Runs on completionThread_. Reaps completions until Stop is called and all reads have completed.
+         * Entries left in the submission queue when the kernel was short of resources are submitted
+         * by the same system call that waits for completions.
+         * Exits early if the ring fails with an error other than a lack of resources.
+         *
+         */
+        void RunCompletions(void);
+
+        /// Handles the completion of iRequest. Returns true if the request was resubmitted.
+        bool CompleteRead(ReadRequest *iRequest, int32_t iResult);
+
+        /// Runs the callbacks of requests that will never be read with iSuccess false and deletes them. Requires submitMutex_ not to be held.
+        void FailReads(std::deque<ReadRequest*> &ioRequests);
+
+        /// Unmaps the rings and closes the ring file descriptor
+        void Close(void);
+
+        /// File descriptor of the ring
+        int             ringFd_;
+
+        /// Mapped submission queue ring
+        void            *sqRing_;
+
+        /// Size of the submission queue ring mapping
+        size_t          sqRingSize_;
+
+        /// Mapped completion queue ring. Same as sqRing_ on kernels with IORING_FEAT_SINGLE_MMAP.
+        void            *cqRing_;
+
+        /// Size of the completion queue ring mapping
+        size_t          cqRingSize_;
+
+        /// Mapped submission queue entries
+        io_uring_sqe    *sqes_;
+
+        /// Size of the submission queue entries mapping
+        size_t          sqesSize_;
+
+        /// Submission queue head, tail, mask and index array inside sqRing_
+        unsigned        *sqHead_;
+        unsigned        *sqTail_;
+        unsigned        *sqMask_;
+        unsigned        *sqArray_;
+
+        /// Completion queue head, tail and mask and entries inside cqRing_
+        unsigned        *cqHead_;
+        unsigned        *cqTail_;
+        unsigned        *cqMask_;
+        io_uring_cqe    *cqes_;
+
+        /// Maximum number of reads in flight
+        int32_t         queueDepth_;
+
+        /// Protects the submission queue, queued_, inFlight_, unsubmitted_, stopping_ and failed_
+        boost::mutex    submitMutex_;
+
+        /// Requests waiting for room in the submission queue
+        std::deque<ReadRequest*> queued_;
+
+        /// Number of reads pushed into the submission queue that have not completed
+        int32_t         inFlight_;
+
+        /// Number of entries pushed into the submission queue that the kernel has not consumed yet
+        int32_t         unsubmitted_;
+
+        /// Set once Stop has been called
+        bool            stopping_;
+
+        /// Set once the ring has failed and completionThread_ has exited
+        bool            failed_;
+
+        /// Reaps completions and runs the callbacks
+        boost::thread   *completionThread_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // SMPTE_SYNC_USE_IO_URING
+
+#endif // IOURINGAUXDATAIOENGINE_H
@@ -0,0 +1,173 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "MemoryAuxDataSource.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    // Number of items copied from the source track per read when loading
+    //
+    static const int32_t sLoadBatchItems = 240;
+
+    MemoryAuxDataSource::MemoryAuxDataSource(int32_t iStartFrame) :
+          startFrame_(iStartFrame)
+    {
+    }
+
+    MemoryAuxDataSource::~MemoryAuxDataSource()
+    {
+    }
+
+    bool MemoryAuxDataSource::Load(AuxDataSource &ioSource, uint64_t iSizeHint)
+    {
+        arena_.clear();
+        entries_.clear();
+
+        startFrame_ = ioSource.GetStartFrame();
+
+        int32_t numberOfItems = ioSource.GetEndFrame() - ioSource.GetStartFrame() + 1;
+        if (numberOfItems <= 0)
+            return false;
+
+        arena_.reserve(static_cast<size_t>(iSizeHint));
+        entries_.reserve(numberOfItems);
+
+        for (int32_t frame = ioSource.GetStartFrame(); frame <= ioSource.GetEndFrame(); )
+        {
+            int32_t count = std::min(sLoadBatchItems, ioSource.GetEndFrame() - frame + 1);
+
+            int32_t itemsRead = ioSource.GetDataItems(frame, count,
+                [this](int32_t, const uint8_t *iDataItem, uint32_t iDataItemSize)
+                {
+                    this->AddDataItem(iDataItem, iDataItemSize);
+                    return true;
+                });
+
+            if (itemsRead != count)
+            {
+                SMPTE_SYNC_LOG << "MemoryAuxDataSource::Load - Failed to read frame = " << frame + itemsRead;
+                return false;
+            }
+
+            frame += count;
+        }
+
+        // Give back what the size hint over-estimated when it is worth a copy
+        //
+        if (arena_.capacity() - arena_.size() > arena_.size() / 8)
+            arena_.shrink_to_fit();
+
+        return true;
+    }
+
+    void MemoryAuxDataSource::AddDataItem(const uint8_t *iDataItem, uint32_t iDataItemSize)
+    {
+        AuxDataIndexEntry entry;
+        entry.offset_ = arena_.size();
+        entry.klvLength_ = iDataItemSize;
+        entry.reserved_ = 0;
+
+        arena_.insert(arena_.end(), iDataItem, iDataItem + iDataItemSize);
+        entries_.push_back(entry);
+    }
+
+    uint64_t MemoryAuxDataSource::GetSizeInBytes(void)
+    {
+        return arena_.capacity() + entries_.capacity() * sizeof(AuxDataIndexEntry);
+    }
+
+    bool MemoryAuxDataSource::Open(void)
+    {
+        return true;
+    }
+
+    bool MemoryAuxDataSource::Close(void)
+    {
+        return true;
+    }
+
+    int32_t MemoryAuxDataSource::GetStartFrame(void)
+    {
+        return startFrame_;
+    }
+
+    int32_t MemoryAuxDataSource::GetEndFrame(void)
+    {
+        return startFrame_ + static_cast<int32_t>(entries_.size()) - 1;
+    }
+
+    bool MemoryAuxDataSource::GetDataItem(int32_t iItemNumber
+                                          , uint8_t **oDataItem
+                                          , uint32_t &oDataItemSize)
+    {
+        int32_t item = iItemNumber - startFrame_;
+
+        if (item < 0 || item >= static_cast<int32_t>(entries_.size()))
+            return false;
+
+        const AuxDataIndexEntry &entry = entries_[item];
+
+        *oDataItem = new uint8_t[entry.klvLength_];
+        memcpy(*oDataItem, arena_.data() + entry.offset_, entry.klvLength_);
+        oDataItemSize = entry.klvLength_;
+
+        return true;
+    }
+
+    int32_t MemoryAuxDataSource::GetDataItems(int32_t iFirstItemNumber
+                                              , int32_t iCount
+                                              , const DataItemSink &iSink)
+    {
+        int32_t firstItem = iFirstItemNumber - startFrame_;
+
+        if (firstItem < 0 || iCount <= 0)
+            return 0;
+
+        int32_t lastItem = std::min(firstItem + iCount, static_cast<int32_t>(entries_.size()));
+        int32_t itemsDelivered = 0;
+
+        for (int32_t item = firstItem; item < lastItem; item++)
+        {
+            const AuxDataIndexEntry &entry = entries_[item];
+
+            if (!iSink(startFrame_ + item, arena_.data() + entry.offset_, entry.klvLength_))
+                break;
+
+            itemsDelivered++;
+        }
+
+        return itemsDelivered;
+    }
+
+}  // namespace SMPTE_SYNC
@@ -0,0 +1,126 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef MEMORYAUXDATASOURCE_H
+#define MEMORYAUXDATASOURCE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "AuxDataIndex.h"
+#include "AuxDataSource.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief MemoryAuxDataSource serves an aux data track preloaded into one contiguous arena with an offset table.
+     * Reads are pointer arithmetic into the arena with no I/O and no lock.
+     * Filled once with Load from another AuxDataSource, or item by item with AddDataItem, for example by benchmarks that run without MXF files.
+     * Threadsafe once filled. Must not be filled while it is being read.
+     *
+     */
+
+    class MemoryAuxDataSource : public AuxDataSource
+    {
+    public:
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iStartFrame is the first frame of the track on the Show timeline
+         *
+         */
+        MemoryAuxDataSource(int32_t iStartFrame);
+
+        /// Destructor
+        virtual ~MemoryAuxDataSource();
+
+        /**
+         *
+         * Copies every item of a track into the arena
+         *
+         * @param ioSource is the open source of the track
+         * @param iSizeHint is the expected size of the track in bytes used to allocate the arena once. 0 if unknown.
+         * @return bool true/false if every item from ioSource->GetStartFrame to ioSource->GetEndFrame was loaded
+         *
+         */
+        bool Load(AuxDataSource &ioSource, uint64_t iSizeHint);
+
+        /**
+         *
+         * Appends the next item of the track to the arena
+         *
+         * @param iDataItem is the KLV of the item
+         * @param iDataItemSize is the size of the KLV
+         *
+         */
+        void AddDataItem(const uint8_t *iDataItem, uint32_t iDataItemSize);
+
+        /// Returns the number of bytes held by the arena and offset table
+        uint64_t GetSizeInBytes(void);
+
+        /// See AuxDataSource::Open. Nothing to open.
+        virtual bool Open(void);
+
+        /// See AuxDataSource::Close. The arena is kept until the source is destroyed.
+        virtual bool Close(void);
+
+        /// See AuxDataSource::GetStartFrame
+        virtual int32_t GetStartFrame(void);
+
+        /// See AuxDataSource::GetEndFrame. GetStartFrame - 1 while empty.
+        virtual int32_t GetEndFrame(void);
+
+        /// See AuxDataSource::GetDataItem
+        virtual bool GetDataItem(int32_t iItemNumber
+                                 , uint8_t **oDataItem
+                                 , uint32_t &oDataItemSize);
+
+        /// See AuxDataSource::GetDataItems. iDataItem points into the arena.
+        virtual int32_t GetDataItems(int32_t iFirstItemNumber
+                                     , int32_t iCount
+                                     , const DataItemSink &iSink);
+
+    private:
+
+        /// First frame of the track on the Show timeline
+        int32_t         startFrame_;
+
+        /// All items of the track back to back
+        std::vector<uint8_t> arena_;
+
+        /// Offset into arena_ and length of each item. Entry n is frame startFrame_ + n.
+        std::vector<AuxDataIndexEntry> entries_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // MEMORYAUXDATASOURCE_H
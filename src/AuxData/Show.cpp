@@ -47,6 +47,46 @@
 
 namespace SMPTE_SYNC
 {
+    // Finds the interval containing iFrame in a table sorted by frame with no overlapping intervals.
+    // The interval found last and the one after it are checked first so sequential lookups do not search.
+    //
+    template <class Interval>
+    static const Interval *FindInterval(const std::vector<Interval> &iIntervals, boost::atomic<size_t> &ioCursor, int32_t iFrame)
+    {
+        size_t cursor = ioCursor.load(boost::memory_order_relaxed);
+
+        for (size_t index = cursor; index < cursor + 2 && index < iIntervals.size(); index++)
+        {
+            if (iIntervals[index].startFrame_ <= iFrame && iFrame <= iIntervals[index].endFrame_)
+            {
+                if (index != cursor)
+                    ioCursor.store(index, boost::memory_order_relaxed);
+
+                return &iIntervals[index];
+            }
+        }
+
+        // First interval starting after iFrame. The one before it is the only one that can contain iFrame.
+        //
+        typename std::vector<Interval>::const_iterator iter = std::upper_bound(iIntervals.begin(), iIntervals.end(), iFrame,
+            [](int32_t iFrame, const Interval &iInterval)
+            {
+                return iFrame < iInterval.startFrame_;
+            });
+
+        if (iter == iIntervals.begin())
+            return nullptr;
+
+        iter--;
+
+        if (iter->endFrame_ < iFrame)
+            return nullptr;
+
+        ioCursor.store(static_cast<size_t>(iter - iIntervals.begin()), boost::memory_order_relaxed);
+
+        return &*iter;
+    }
+
     Asset::Asset() :
           type_(eAssetType_Unknown)
         , editRateNumerator_(0)
@@ -63,8 +103,6 @@ namespace SMPTE_SYNC
         , length_(0)
     {
         SMPTE_SYNC_LOG << "Asset::Asset";
-
-        Initialize(id_);
     }
     
     Asset::~Asset()
@@ -87,10 +125,10 @@ namespace SMPTE_SYNC
         return endFrame;
     }
 
-    std::string UUIDTypeToString(UUID uuid)
+    std::string UUIDTypeToString(const UUID &uuid)
     {
         std::string uuid_str;
-        boost::algorithm::hex(uuid, uuid + sizeof(UUID), std::back_inserter(uuid_str));
+        boost::algorithm::hex(uuid.begin(), uuid.end(), std::back_inserter(uuid_str));
         return uuid_str;
     }
 
@@ -145,8 +183,6 @@ namespace SMPTE_SYNC
     Reel::Reel()
     {
         SMPTE_SYNC_LOG << "Reel::Reel";
-
-        Initialize(id_);
     }
     
     Reel::~Reel()
@@ -159,11 +195,22 @@ namespace SMPTE_SYNC
         }
     }
 
+    Reel *Reel::Clone(void) const
+    {
+        Reel *reel = new Reel;
+        reel->id_ = id_;
+
+        for (std::vector<Asset*>::const_iterator iter = assets_.begin(); iter != assets_.end(); iter++)
+        {
+            reel->assets_.push_back(new Asset(**iter));
+        }
+
+        return reel;
+    }
+
     CPL::CPL()
     {
         SMPTE_SYNC_LOG << "CPL::CPL";
-
-        Initialize(id_);
     }
 
     CPL::~CPL()
@@ -176,11 +223,28 @@ namespace SMPTE_SYNC
         }
     }
 
+    CPL *CPL::Clone(void) const
+    {
+        CPL *cpl = new CPL;
+        cpl->id_ = id_;
+
+        for (std::vector<Reel*>::const_iterator iter = reels_.begin(); iter != reels_.end(); iter++)
+        {
+            cpl->reels_.push_back((*iter)->Clone());
+        }
+
+        return cpl;
+    }
+
     Show::Show(int32_t iSampleRate) :
-          sampleRate_(iSampleRate)
+          frameInfoRunCursor_(0)
+        , sampleRate_(iSampleRate)
         , numberOfFrames_(0)
     {
         SMPTE_SYNC_LOG << "Show::Show";
+
+        for (int32_t type = 0; type < numberOfAssetTypes_; type++)
+            assetCursors_[type] = 0;
     }
     
     Show::~Show()
@@ -229,11 +293,133 @@ namespace SMPTE_SYNC
             }
         }
 
+        this->AddCPLToIntervals(iCPL);
+
         timeline_.push_back(iCPL);
         
         return success;
     }
 
+    void Show::AddCPLToIntervals(CPL *iCPL)
+    {
+        for (std::vector<Reel*>::iterator reelIter = iCPL->reels_.begin(); reelIter != iCPL->reels_.end(); reelIter++)
+        {
+            Asset *picture = nullptr;
+            Asset *sound = nullptr;
+            Asset *auxData = nullptr;
+
+            for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
+            {
+                Asset *asset = *assetIter;
+
+                if (asset->duration_ <= 0 || asset->type_ < 0 || asset->type_ >= numberOfAssetTypes_)
+                    continue;
+
+                AddAssetInterval(assetIntervals_[asset->type_], asset);
+
+                // Each aux data track is also found by its coding UL, whatever other aux data its Reel carries
+                //
+                if (asset->type_ == Asset::eAssetType_AuxData)
+                {
+                    boost::shared_ptr<AuxDataTrack> &auxDataTrack = auxDataTracks_[asset->dataEssenceCodingUL_];
+
+                    if (!auxDataTrack)
+                    {
+                        auxDataTrack.reset(new AuxDataTrack);
+                        auxDataTrack->cursor_ = 0;
+                    }
+
+                    AddAssetInterval(auxDataTrack->intervals_, asset);
+                }
+
+                // The sound and aux data reported with a frame are those following the main picture in its Reel
+                //
+                if (asset->type_ == Asset::eAssetType_MainPicture && picture == nullptr)
+                    picture = asset;
+                else if (asset->type_ == Asset::eAssetType_MainSound && picture != nullptr)
+                    sound = asset;
+                else if (asset->type_ == Asset::eAssetType_AuxData && picture != nullptr)
+                    auxData = asset;
+            }
+
+            if (picture == nullptr)
+                continue;
+
+            FrameInfoRun run;
+            run.startFrame_ = picture->GetStartFrame();
+            run.endFrame_ = picture->GetEndFrame();
+            run.hasSound_ = sound != nullptr;
+
+            if (!frameInfoRuns_.empty())
+                run.startFrame_ = std::max(run.startFrame_, frameInfoRuns_.back().endFrame_ + 1);
+
+            if (run.startFrame_ > run.endFrame_)
+                continue;
+
+            // There is always a main picture
+            // set the currentFrameDuration_ based on the main picture
+            //
+            FrameInfo &frameInfo = run.frameInfo_;
+
+            frameInfo.currentFrameDuration_ =  sampleRate_ / (picture->editRateNumerator_ / picture->editRateDenominator_);
+            frameInfo.primaryPictureTrackFileEditUnitIndex_ = run.startFrame_;
+            frameInfo.primaryPictureTrackFileUUID_ = picture->id_;
+            frameInfo.editUnitRateNumerator_ = picture->editRateNumerator_;
+            frameInfo.editUnitRateDenominator_ = picture->editRateDenominator_;
+
+            if (sound != nullptr)
+            {
+                frameInfo.primarySoundTrackFileEditUnitIndex_ = run.startFrame_;
+                frameInfo.primarySoundTrackFileUUID_ = sound->id_;
+
+                // Get the CPL id from the CPL of the Reel
+                //
+                frameInfo.compositionPlaylistUUID_ = iCPL->id_;
+            }
+
+            if (auxData != nullptr)
+                frameInfo.dataEssenceCodingUL_ = auxData->dataEssenceCodingUL_;
+
+            frameInfoRuns_.push_back(run);
+        }
+    }
+
+    void Show::AddAssetInterval(std::vector<AssetInterval> &ioIntervals, Asset *iAsset)
+    {
+        // An Asset running into the frames of the Asset before it is only found
+        // at the frames after it, as it is when walking the timeline
+        //
+        AssetInterval assetInterval = { iAsset->GetStartFrame(), iAsset->GetEndFrame(), iAsset };
+
+        if (!ioIntervals.empty())
+            assetInterval.startFrame_ = std::max(assetInterval.startFrame_, ioIntervals.back().endFrame_ + 1);
+
+        if (assetInterval.startFrame_ <= assetInterval.endFrame_)
+            ioIntervals.push_back(assetInterval);
+    }
+
+    Asset *Show::FindAuxDataAsset(const std::string &iCodingUL, int32_t iFrame)
+    {
+        AuxDataTrackMap::iterator iter = auxDataTracks_.find(iCodingUL);
+
+        if (iter == auxDataTracks_.end())
+            return nullptr;
+
+        const AssetInterval *interval = FindInterval(iter->second->intervals_, iter->second->cursor_, iFrame);
+
+        return interval != nullptr ? interval->asset_ : nullptr;
+    }
+
+    Asset *Show::FindAsset(int32_t iFrame, Asset::AssetType iType)
+    {
+        if (iType < 0 || iType >= numberOfAssetTypes_)
+            return nullptr;
+
+        const AssetInterval *interval = FindInterval(assetIntervals_[iType], assetCursors_[iType], iFrame);
+
+        return interval != nullptr ? interval->asset_ : nullptr;
+    }
+
     bool Show::GetAssetRangeForFrame(  int32_t iFrame
                                        , Asset::AssetType iType
                                        , int32_t &oStartFrame
@@ -241,33 +427,106 @@ namespace SMPTE_SYNC
     {
         oStartFrame = 0;
         oEndFrame = 0;
+
+        Asset *asset = this->FindAsset(iFrame, iType);
         
-        for (std::vector<CPL*>::iterator cplIter = timeline_.begin(); cplIter != timeline_.end(); cplIter++)
+        if (asset == nullptr)
+            return false;
+
+        oStartFrame = asset->GetStartFrame();
+        oEndFrame = asset->GetEndFrame();
+
+        return true;
+    }
+
+    std::string Show::GetDataFilePath(int32_t iFrame, Asset::AssetType iType)
+    {
+        std::string path = "";
+
+        Asset *asset = this->FindAsset(iFrame, iType);
+
+        if (asset != nullptr)
+            path = asset->path_;
+        
+        return path;
+    }
+    
+    bool Show::GetAssetId(int32_t iFrame, Asset::AssetType iType, UUID &oAssetId)
+    {
+        Asset *asset = this->FindAsset(iFrame, iType);
+
+        if (asset != nullptr)
         {
-            for (std::vector<Reel*>::iterator reelIter = (*cplIter)->reels_.begin(); reelIter != (*cplIter)->reels_.end(); reelIter++)
-            {
-                for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
-                {
-                    if ((*assetIter)->type_ == iType)
-                    {
-                        if ((*assetIter)->GetStartFrame() <= iFrame && iFrame <= (*assetIter)->GetEndFrame())
-                        {
-                            oStartFrame = (*assetIter)->GetStartFrame();
-                            oEndFrame = (*assetIter)->GetEndFrame();
-                            
-                            return true;
-                        }
-                    }
-                }
-            }
+            oAssetId = asset->id_;
+            return true;
         }
+        
+        oAssetId.Clear();
 
         return false;
     }
+    
+    bool Show::GetAuxDataRangeForFrame(  const std::string &iCodingUL
+                                       , int32_t iFrame
+                                       , int32_t &oStartFrame
+                                       , int32_t &oEndFrame)
+    {
+        oStartFrame = 0;
+        oEndFrame = 0;
 
-    std::string Show::GetDataFilePath(int32_t iFrame, Asset::AssetType iType)
+        Asset *asset = this->FindAuxDataAsset(iCodingUL, iFrame);
+
+        if (asset == nullptr)
+            return false;
+
+        oStartFrame = asset->GetStartFrame();
+        oEndFrame = asset->GetEndFrame();
+
+        return true;
+    }
+
+    std::string Show::GetAuxDataFilePath(const std::string &iCodingUL, int32_t iFrame)
     {
         std::string path = "";
+
+        Asset *asset = this->FindAuxDataAsset(iCodingUL, iFrame);
+
+        if (asset != nullptr)
+            path = asset->path_;
+
+        return path;
+    }
+
+    bool Show::GetAuxDataAssetId(const std::string &iCodingUL, int32_t iFrame, UUID &oAssetId)
+    {
+        Asset *asset = this->FindAuxDataAsset(iCodingUL, iFrame);
+
+        if (asset != nullptr)
+        {
+            oAssetId = asset->id_;
+            return true;
+        }
+
+        oAssetId.Clear();
+
+        return false;
+    }
+
+    std::vector<std::string> Show::GetAuxDataCodingULs(void)
+    {
+        std::vector<std::string> codingULs;
+
+        for (AuxDataTrackMap::iterator iter = auxDataTracks_.begin(); iter != auxDataTracks_.end(); iter++)
+            codingULs.push_back(iter->first);
+
+        std::sort(codingULs.begin(), codingULs.end());
+
+        return codingULs;
+    }
+
+    std::vector<Asset*> Show::GetAssets(Asset::AssetType iType)
+    {
+        std::vector<Asset*> assets;
         
         for (std::vector<CPL*>::iterator cplIter = timeline_.begin(); cplIter != timeline_.end(); cplIter++)
         {
@@ -276,18 +535,17 @@ namespace SMPTE_SYNC
                 for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
                 {
                     if ((*assetIter)->type_ == iType)
-                    {
-                        if ((*assetIter)->GetStartFrame() <= iFrame && iFrame <= (*assetIter)->GetEndFrame())
-                        {
-                            path = (*assetIter)->path_;
-                            return path;
-                        }
-                    }
+                        assets.push_back(*assetIter);
                 }
             }
         }
         
-        return path;
+        return assets;
+    }
+
+    const std::vector<CPL*> &Show::GetCPLs(void) const
+    {
+        return timeline_;
     }
     
     int32_t Show::GetLongestFrameLength(void)
@@ -316,55 +574,44 @@ namespace SMPTE_SYNC
 
     bool Show::GetAssetFrameInfo(int32_t iFrame, FrameInfo &oFrameInfo)
     {
-        bool foundFrame = false;
-        
-        oFrameInfo.Reset();
-        
-        for (std::vector<CPL*>::iterator cplIter = timeline_.begin(); cplIter != timeline_.end(); cplIter++)
+        const FrameInfoRun *run = FindInterval(frameInfoRuns_, frameInfoRunCursor_, iFrame);
+
+        if (run == nullptr)
         {
-            for (std::vector<Reel*>::iterator reelIter = (*cplIter)->reels_.begin(); reelIter != (*cplIter)->reels_.end(); reelIter++)
-            {
-                for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
-                {
-                    // There is always a main picture
-                    // set the currentFrameDuration_ based on the main picture
-                    //
-                    if ((*assetIter)->type_ == Asset::eAssetType_MainPicture)
-                    {
-                        if ((*assetIter)->GetStartFrame() <= iFrame && iFrame <= (*assetIter)->GetEndFrame())
-                        {
-                            foundFrame = true;
-                            
-                            oFrameInfo.currentFrameDuration_ =  sampleRate_ / ((*assetIter)->editRateNumerator_ / (*assetIter)->editRateDenominator_);
-                            oFrameInfo.primaryPictureTrackFileEditUnitIndex_ = iFrame;
-                            Copy((*assetIter)->id_, oFrameInfo.primaryPictureTrackFileUUID_);
-                            oFrameInfo.editUnitRateNumerator_ = (*assetIter)->editRateNumerator_;
-                            oFrameInfo.editUnitRateDenominator_ = (*assetIter)->editRateDenominator_;
-                        }
-                    }
-                    
-                    if (foundFrame && (*assetIter)->type_ == Asset::eAssetType_MainSound)
-                    {
-                        oFrameInfo.primarySoundTrackFileEditUnitIndex_ = iFrame;
-                        Copy((*assetIter)->id_, oFrameInfo.primarySoundTrackFileUUID_);
-                        
-                        // Get the CPL id from the CPL iterator
-                        //
-                        Copy((*cplIter)->id_, oFrameInfo.compositionPlaylistUUID_);
-                    }
+            oFrameInfo.Reset();
+            return false;
+        }
 
-                    if (foundFrame && (*assetIter)->type_ == Asset::eAssetType_AuxData)
-                    {
-                        oFrameInfo.dataEssenceCodingUL_ = (*assetIter)->dataEssenceCodingUL_;
-                    }
-                }
+        run->GetFrameInfo(iFrame, oFrameInfo);
 
-                if (foundFrame)
-                    return foundFrame;
-            }
+        return true;
+    }
+
+    int32_t Show::GetAssetFrameInfoRange(int32_t iStart, int32_t iCount, FrameInfo *oFrameInfo)
+    {
+        int32_t count = 0;
+
+        while (count < iCount)
+        {
+            int32_t frame = iStart + count;
+
+            const FrameInfoRun *run = FindInterval(frameInfoRuns_, frameInfoRunCursor_, frame);
+
+            if (run == nullptr)
+                break;
+
+            int32_t endFrame = std::min(run->endFrame_, iStart + iCount - 1);
+
+            for (; frame <= endFrame; frame++, count++)
+                run->GetFrameInfo(frame, oFrameInfo[count]);
         }
-        
-        return foundFrame;
+
+        return count;
+    }
+
+    void Show::GetFrameInfoRuns(FrameInfoRunList &oRuns)
+    {
+        oRuns = frameInfoRuns_;
     }
 
 }  // namespace SMPTE_SYNC
@@ -36,6 +36,10 @@
 #include <string>
 #include <vector>
 
+#include "boost/atomic.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/unordered_map.hpp"
+
 #include "DataTypes.h"
 #include "UUID.h"
 
@@ -161,6 +165,9 @@ namespace SMPTE_SYNC
 
         /// Destructor
         ~Reel();
+
+        /// Returns a deep copy of the Reel and its Assets owned by the caller
+        Reel *Clone(void) const;
         
         /// The UUID of the Reel
         UUID                id_;
@@ -184,6 +191,9 @@ namespace SMPTE_SYNC
 
         /// Destructor
         ~CPL();
+
+        /// Returns a deep copy of the CPL, its Reels and their Assets owned by the caller. Used to build a new Show from an existing one.
+        CPL *Clone(void) const;
         
         /// The UUID of the CPL
         UUID                id_;
@@ -195,6 +205,10 @@ namespace SMPTE_SYNC
     /**
      *
      * @brief Show represents media to be played out on the timeline. It is composed of a series of one or more CPLs
+     * Frame lookups use flat tables of frame intervals built as CPLs are added. Each table is sorted by frame,
+     * searched with a binary search and remembers the last interval found so sequential lookups are O(1).
+     * Aux data also has one table per coding UL so each aux data track of a Reel is found on its own.
+     * Lookups are threadsafe. Adding a CPL is not and must not run concurrently with lookups.
      *
      */
 
@@ -249,6 +263,74 @@ namespace SMPTE_SYNC
          *
          */
         std::string GetDataFilePath(int32_t iFrame, Asset::AssetType iType);
+
+        /**
+         *
+         * Finds the UUID of the specific Asset for a specific frame on the timeline.
+         *
+         * @param iFrame is requested frame on the Show timeline
+         * @param iType is requested AssetType type
+         * @param oAssetId is the UUID of the Asset for the iFrame
+         * @return bool true/false if the requested iFrame and Asset were found
+         *
+         */
+        bool GetAssetId(int32_t iFrame, Asset::AssetType iType, UUID &oAssetId);
+
+        /**
+         *
+         * Computes the start and end frames of the aux data Asset with a coding UL for a specific frame on the timeline.
+         * A Reel can carry several aux data Assets, one per coding UL. Each coding UL has its own table of frames.
+         *
+         * @param iCodingUL is the data essence coding UL of the requested aux data
+         * @param iFrame is requested frame on the Show timeline
+         * @param oStartFrame is, if found, the start frame of the Asset in Show timeline
+         * @param oEndFrame is, if found, the end frame of the Asset in Show timeline
+         * @return bool true/false if the requested iFrame has aux data with iCodingUL
+         *
+         */
+        bool GetAuxDataRangeForFrame(  const std::string &iCodingUL
+                                     , int32_t iFrame
+                                     , int32_t &oStartFrame
+                                     , int32_t &oEndFrame);
+
+        /**
+         *
+         * Finds the path to the aux data track file with a coding UL for a specific frame on the timeline
+         *
+         * @param iCodingUL is the data essence coding UL of the requested aux data
+         * @param iFrame is requested frame on the Show timeline
+         * @return std::string to the file. This is an empty string if the iFrame has no aux data with iCodingUL
+         *
+         */
+        std::string GetAuxDataFilePath(const std::string &iCodingUL, int32_t iFrame);
+
+        /**
+         *
+         * Finds the UUID of the aux data Asset with a coding UL for a specific frame on the timeline
+         *
+         * @param iCodingUL is the data essence coding UL of the requested aux data
+         * @param iFrame is requested frame on the Show timeline
+         * @param oAssetId is the UUID of the Asset for the iFrame
+         * @return bool true/false if the requested iFrame has aux data with iCodingUL
+         *
+         */
+        bool GetAuxDataAssetId(const std::string &iCodingUL, int32_t iFrame, UUID &oAssetId);
+
+        /// Returns the coding UL of every aux data track in the Show
+        std::vector<std::string> GetAuxDataCodingULs(void);
+
+        /**
+         *
+         * Returns the Assets of a type in timeline order.
+         *
+         * @param iType is requested AssetType type
+         * @return std::vector<Asset*> of the Assets. The Assets are owned by the Show.
+         *
+         */
+        std::vector<Asset*> GetAssets(Asset::AssetType iType);
+
+        /// Returns the CPLs of the Show in timeline order. The CPLs are owned by the Show.
+        const std::vector<CPL*> &GetCPLs(void) const;
         
         /**
          *
@@ -282,6 +364,28 @@ namespace SMPTE_SYNC
          */
         bool GetAssetFrameInfo(int32_t iFrame, FrameInfo &oFrameInfo);
 
+        /**
+         *
+         * Returns the FrameInfo of consecutive frames in the Show.
+         * Equivalent to calling GetAssetFrameInfo for each frame, but only looks up the Assets once per reel.
+         *
+         * @param iStart is the first requested frame on the Show timeline
+         * @param iCount is the number of requested frames
+         * @param oFrameInfo is an array of at least iCount FrameInfo filled in frame order
+         * @return int32_t number of frames filled. Stops at the first frame not found.
+         *
+         */
+        int32_t GetAssetFrameInfoRange(int32_t iStart, int32_t iCount, FrameInfo *oFrameInfo);
+
+        /**
+         *
+         * Returns the runs of frames that play the same track files, in timeline order
+         *
+         * @param oRuns is replaced with the FrameInfoRun of each main picture Asset in the Show
+         *
+         */
+        void GetFrameInfoRuns(FrameInfoRunList &oRuns);
+
         /**
          *
          * The client to the Show adds a CPL object to the end of the Show timeline
@@ -293,6 +397,97 @@ namespace SMPTE_SYNC
         bool AddCPLToEndOfTimeline(CPL *iCPL);
         
     private:
+
+        /**
+         *
+         * @brief AssetInterval is the range of frames on the Show timeline an Asset is found at
+         *
+         */
+        struct AssetInterval
+        {
+            /// First frame on the Show timeline this Asset is found at
+            int32_t     startFrame_;
+
+            /// Last frame on the Show timeline this Asset is found at
+            int32_t     endFrame_;
+
+            /// The Asset. Owned by its Reel.
+            Asset       *asset_;
+        };
+
+        /// Number of AssetType values. Each has its own table of AssetInterval.
+        static const int32_t numberOfAssetTypes_ = Asset::eAssetType_AuxData + 1;
+
+        /**
+         *
+         * @brief AuxDataTrack is the table of frames of the aux data Assets sharing a coding UL
+         *
+         */
+        struct AuxDataTrack
+        {
+            /// Sorted by frame and not overlapping
+            std::vector<AssetInterval>  intervals_;
+
+            /// Index of the last interval found in intervals_
+            boost::atomic<size_t>       cursor_;
+        };
+
+        /// AuxDataTrack of each coding UL
+        typedef boost::unordered_map<std::string, boost::shared_ptr<AuxDataTrack> > AuxDataTrackMap;
+
+        /**
+         *
+         * Adds an Asset to the end of a table of frames.
+         * An Asset running into the frames of the Asset before it is only found at the frames after it.
+         *
+         */
+        static void AddAssetInterval(std::vector<AssetInterval> &ioIntervals, Asset *iAsset);
+
+        /**
+         *
+         * Adds the Assets of a CPL to the frame interval tables. Called by AddCPLToEndOfTimeline once the startFrame_ of each Asset is set.
+         *
+         * @param iCPL is the CPL being added to the end of the Show timeline
+         *
+         */
+        void AddCPLToIntervals(CPL *iCPL);
+
+        /**
+         *
+         * Finds the first Asset of a type in timeline order found at a frame on the Show timeline
+         *
+         * @param iFrame is requested frame on the Show timeline
+         * @param iType is requested AssetType type
+         * @return Asset* for the iFrame. nullptr if none was found.
+         *
+         */
+        Asset *FindAsset(int32_t iFrame, Asset::AssetType iType);
+
+        /**
+         *
+         * Finds the aux data Asset with a coding UL found at a frame on the Show timeline
+         *
+         * @param iCodingUL is the data essence coding UL of the requested aux data
+         * @param iFrame is requested frame on the Show timeline
+         * @return Asset* for the iFrame. nullptr if none was found.
+         *
+         */
+        Asset *FindAuxDataAsset(const std::string &iCodingUL, int32_t iFrame);
+
+        /// Tables of the frames each Asset is found at, indexed by AssetType. Sorted by frame and not overlapping.
+        std::vector<AssetInterval> assetIntervals_[numberOfAssetTypes_];
+
+        /// Index of the last interval found in each of the assetIntervals_
+        boost::atomic<size_t> assetCursors_[numberOfAssetTypes_];
+
+        /// Tables of the frames each aux data Asset is found at, keyed by coding UL
+        AuxDataTrackMap auxDataTracks_;
+
+        /// FrameInfo of the frames each main picture Asset covers with the other Assets of its Reel. Sorted by frame and not overlapping.
+        FrameInfoRunList frameInfoRuns_;
+
+        /// Index of the last run found in frameInfoRuns_
+        boost::atomic<size_t> frameInfoRunCursor_;
         
         /// Vector of CPL pointers that represent the Show timeline. The CPL objects are listed in the order they should appear during playback
         std::vector<CPL*> timeline_;
@@ -30,40 +30,269 @@
 #include "ShowManager.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <utility>
 #include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
+#include "boost/bind.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+#include "AssetMapCache.h"
+#include "CompiledShow.h"
 #include "CPLParser.h"
+#include "AuxDataIOEngine.h"
 #include "AuxDataParser.h"
 #include "Logger.h"
+#include "WorkerPool.h"
 #include "Utils.h"
 #include "Show.h"
 
 namespace SMPTE_SYNC
 {
     
+    // Number of aux data track files kept open by default.
+    // Enough for several clients reading different reels at the same time.
+    //
+    static const int32_t sDefaultMaxOpenAuxDataParsers = 16;
+
+    // Bytes of serialized aux data kept in memory by default.
+    // Holds several windows of typical subtitle or immersive audio aux data.
+    //
+    static const uint64_t sDefaultAuxDataBlockCacheSizeInBytes = 64 * 1024 * 1024;
+
+    // Number of windows loaded ahead of each request by default
+    //
+    static const int32_t sDefaultReadAheadWindows = 1;
+
+    // Number of frames read from disk at a time when streaming.
+    // Approximately 1 second at 24 fps.
+    //
+    static const int32_t sStreamBatchFrames = 24;
+
+    // Maximum number of read-ahead reads queued to the disk at once
+    //
+    static const int32_t sAuxDataIOQueueDepth = 64;
+
+    // Number of threads reading ahead when io_uring is not available
+    //
+    static const int32_t sAuxDataIOThreads = 4;
+
+    // Bytes of aux data track files preloaded into memory at Load by default.
+    // Typical subtitle and immersive audio aux data tracks of a whole show fit.
+    //
+    static const uint64_t sDefaultAuxDataPreloadMaxSizeInBytes = 256 * 1024 * 1024;
+
+    // Maximum number of threads parsing CPLs at Load
+    //
+    static const int32_t sMaxCPLParserThreads = 8;
+
+    // Seconds at the start of each reel read into memory at Load by default.
+    // Covers the ACS buffering at the start of the Show and at each reel change.
+    //
+    static const int32_t sDefaultWarmUpSeconds = 10;
+
+    // Index passed to EditTimeline to append. Resolved to the number of CPLs once the edit is serialized.
+    //
+    static const int32_t sAppendIndex = -1;
+
+    /**
+     *
+     * @brief ReadAheadWindow tracks the asynchronous reads of one window being read ahead.
+     * The window stays in readAheadPending_ until all of its reads have completed.
+     *
+     */
+    struct ShowManager::ReadAheadWindow
+    {
+        /// Coding UL of the window
+        std::string             codingUL_;
+
+        /// First frame of the window
+        int32_t                 start_;
+
+        /// The Show the window was scheduled for. Its frames are serialized from it.
+        ShowPtr                 show_;
+
+        /// showGeneration_ when the window was scheduled
+        uint32_t                showGeneration_;
+
+        /// True for the windows queued by WarmUp
+        bool                    warmUp_;
+
+        /// Reads in flight, plus one held while the reads are being submitted
+        boost::atomic<int32_t>  readsInFlight_;
+    };
+
+    /**
+     *
+     * @brief DataItemsStream reads the AuxDataBlocks of one request in batches of sStreamBatchFrames from a snapshot of the Show.
+     * Nothing is read until the receiver asks for the next batch.
+     *
+     */
+    class ShowManager::DataItemsStream : public DataStream
+    {
+    public:
+
+        DataItemsStream(ShowManager *iShowManager, const std::string &iCodingUL, int32_t iStart, int32_t iCount) :
+              showManager_(iShowManager)
+            , show_()
+            , showGeneration_(0)
+            , showLoaded_(false)
+            , codingUL_(iCodingUL)
+            , start_(iStart)
+            , frame_(iStart)
+            , endFrame_(iStart)
+            , headerRead_(false)
+            , failed_(false)
+        {
+            showLoaded_ = showManager_->GetReaderSnapshot(show_, showGeneration_);
+
+            // The count comes from the Show timeline rather than from the items read
+            //
+            if (showLoaded_)
+                endFrame_ = iStart + showManager_->CountDataItems(show_, codingUL_, iStart, iCount);
+
+            if (endFrame_ > iStart)
+                showManager_->ScheduleReadAhead(codingUL_, iStart, endFrame_ - iStart, showGeneration_);
+        }
+
+        bool Read(std::vector<char> &oData)
+        {
+            // The header goes out before any data is read
+            //
+            if (!headerRead_)
+            {
+                showManager_->WriteTransferHeader(start_, endFrame_ - start_, oData);
+                headerRead_ = true;
+
+                return frame_ < endFrame_;
+            }
+
+            if (failed_ || frame_ >= endFrame_)
+                return false;
+
+            int32_t batchCount = std::min(endFrame_ - frame_, sStreamBatchFrames);
+            int32_t read = showManager_->ReadDataItems(show_, codingUL_, auxDataSource_, frame_, batchCount, oData);
+
+            if (read == 0)
+            {
+                SMPTE_SYNC_LOG << "ShowManager::DataItemsStream - stream ended early at frame = " << frame_;
+                failed_ = true;
+                return false;
+            }
+
+            frame_ += read;
+
+            return frame_ < endFrame_;
+        }
+
+        bool IsComplete(void)
+        {
+            return showLoaded_ && headerRead_ && frame_ >= endFrame_;
+        }
+
+    private:
+
+        /// The ShowManager the blocks are read through
+        ShowManager         *showManager_;
+
+        /// Snapshot of the Show taken when the stream was opened
+        ShowPtr             show_;
+
+        /// showGeneration_ when the stream was opened
+        uint32_t            showGeneration_;
+
+        /// True if a Show was loaded when the stream was opened
+        bool                showLoaded_;
+
+        /// Coding UL of the requested data
+        std::string         codingUL_;
+
+        /// First frame of the request
+        int32_t             start_;
+
+        /// Next frame to read
+        int32_t             frame_;
+
+        /// One past the last frame announced in the header
+        int32_t             endFrame_;
+
+        /// Set once the header has been read
+        bool                headerRead_;
+
+        /// Set when a frame announced in the header could not be read
+        bool                failed_;
+
+        /// The source used for the previous batch
+        AuxDataSourcePtr    auxDataSource_;
+    };
+
     ShowManager::ShowManager(int32_t iSampleRate) :
           sampleRate_(iSampleRate)
-        , auxDataParser_(nullptr)
-        , show_(nullptr)
+        , assetMapCache_(nullptr)
+        , auxDataParserPool_(nullptr)
+        , auxDataBlockCache_(nullptr)
+        , readAheadWorkerPool_(nullptr)
+        , auxDataIOEngine_(nullptr)
+        , show_()
+        , timelineVersion_(0)
+        , showGeneration_(0)
+        , readAheadWindows_(sDefaultReadAheadWindows)
+        , readAheadWindowCount_(0)
+        , readAheadBlockCount_(0)
+        , auxDataPreloadMaxSizeInBytes_(sDefaultAuxDataPreloadMaxSizeInBytes)
+        , warmUpSeconds_(sDefaultWarmUpSeconds)
+        , warmUpGeneration_(0)
+        , warmUpScheduled_(false)
+        , warmUpWindowsCompleted_(0)
+        , warmUpWindowsTotal_(0)
         , showLoaded_(false)
     {
         SMPTE_SYNC_LOG << "ShowManager::ShowManager\n";
+
+        assetMapCache_ = new AssetMapCache;
+        auxDataParserPool_ = new AuxDataParserPool(sDefaultMaxOpenAuxDataParsers);
+        auxDataBlockCache_ = new AuxDataBlockCache(sDefaultAuxDataBlockCacheSizeInBytes);
+        readAheadWorkerPool_ = new WorkerPool(1, "ShowManager read-ahead");
+        auxDataIOEngine_ = AuxDataIOEngine::Create(sAuxDataIOQueueDepth, sAuxDataIOThreads);
     }
 
     ShowManager::ShowManager(int32_t iSampleRate
                              , const CPLFileList &iCPLList) :
           sampleRate_(iSampleRate)
-        , auxDataParser_(nullptr)
-        , show_(nullptr)
+        , assetMapCache_(nullptr)
+        , auxDataParserPool_(nullptr)
+        , auxDataBlockCache_(nullptr)
+        , readAheadWorkerPool_(nullptr)
+        , auxDataIOEngine_(nullptr)
+        , show_()
+        , timelineVersion_(0)
+        , showGeneration_(0)
+        , readAheadWindows_(sDefaultReadAheadWindows)
+        , readAheadWindowCount_(0)
+        , readAheadBlockCount_(0)
+        , auxDataPreloadMaxSizeInBytes_(sDefaultAuxDataPreloadMaxSizeInBytes)
+        , warmUpSeconds_(sDefaultWarmUpSeconds)
+        , warmUpGeneration_(0)
+        , warmUpScheduled_(false)
+        , warmUpWindowsCompleted_(0)
+        , warmUpWindowsTotal_(0)
+        , showLoaded_(false)
     {
         SMPTE_SYNC_LOG << "ShowManager::ShowManager\n";
 
+        assetMapCache_ = new AssetMapCache;
+        auxDataParserPool_ = new AuxDataParserPool(sDefaultMaxOpenAuxDataParsers);
+        auxDataBlockCache_ = new AuxDataBlockCache(sDefaultAuxDataBlockCacheSizeInBytes);
+        readAheadWorkerPool_ = new WorkerPool(1, "ShowManager read-ahead");
+        auxDataIOEngine_ = AuxDataIOEngine::Create(sAuxDataIOQueueDepth, sAuxDataIOThreads);
+
         CPLList_ = iCPLList;
         
         this->Load();
@@ -73,8 +302,24 @@ namespace SMPTE_SYNC
     {
         SMPTE_SYNC_LOG << "ShowManager::~ShowManager";
 
-        delete auxDataParser_;
-        auxDataParser_ = nullptr;
+        // Stop the read-ahead first. Its tasks use everything below.
+        //
+        delete readAheadWorkerPool_;
+        readAheadWorkerPool_ = nullptr;
+
+        delete auxDataIOEngine_;
+        auxDataIOEngine_ = nullptr;
+
+        delete auxDataBlockCache_;
+        auxDataBlockCache_ = nullptr;
+
+        delete auxDataParserPool_;
+        auxDataParserPool_ = nullptr;
+
+        show_.reset();
+
+        delete assetMapCache_;
+        assetMapCache_ = nullptr;
     }
 
     bool ShowManager::AddCPL(const std::string &iCPLPath)
@@ -88,7 +333,10 @@ namespace SMPTE_SYNC
             success = false;;
         
         if (success)
+        {
+            boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
             CPLList_.push_back(iCPLPath);
+        }
         
         delete cplParser;
         
@@ -110,7 +358,10 @@ namespace SMPTE_SYNC
         }
 
         if (success)
+        {
+            boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
             CPLList_.insert(CPLList_.end(), iCPLList.begin(), iCPLList.end());
+        }
 
         return success;
     }
@@ -119,10 +370,25 @@ namespace SMPTE_SYNC
     {
         SMPTE_SYNC_LOG << "ShowManager::Reset";
 
+        boost::mutex::scoped_lock edit_lock(editMutex_);
+        boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
+
         showLoaded_ = false;
+        showGeneration_++;
+
+        this->ResetWarmUpProgress(showGeneration_);
         
-        delete show_;
-        show_ = nullptr;
+        // Close all of the track files belonging to the old Show
+        // and drop the data read from them
+        //
+        auxDataParserPool_->Clear();
+        auxDataBlockCache_->Clear();
+
+        if (auxDataIOEngine_ != nullptr)
+            auxDataIOEngine_->CloseFiles();
+
+        boost::atomic_store(&show_, ShowPtr());
+        timelineVersion_++;
         
         CPLList_.clear();
         
@@ -133,6 +399,9 @@ namespace SMPTE_SYNC
     {
         SMPTE_SYNC_LOG << "ShowManager::Load";
 
+        boost::mutex::scoped_lock edit_lock(editMutex_);
+        boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
+
         if (show_ != nullptr)
             return false;
         
@@ -141,241 +410,1263 @@ namespace SMPTE_SYNC
         
         assert(show_ == nullptr);
         
-        show_ = new Show(sampleRate_);
-        
-        for (CPLFileList::iterator iter = CPLList_.begin(); iter != CPLList_.end(); iter++)
-        {
-            CPLParser *cplParser = new CPLParser(*iter);
-            CPL *newCPL = cplParser->Parse();
+        showGeneration_++;
+        auxDataBlockCache_->Clear();
 
-            delete cplParser;
+        ShowPtr show(new Show(sampleRate_));
+
+        std::vector<CPL*> cpls;
+        bool compiled = false;
+
+        // Identify the files before parsing them so one modified while it is parsed invalidates the compiled show
+        //
+        CompiledShow::SourceFileList sourceFiles;
+        std::string compiledShowPath;
+
+        if (!compiledShowDirectory_.empty() && CompiledShow::GetSourceFiles(CPLList_, sourceFiles))
+        {
+            compiledShowPath = CompiledShow::BuildPath(compiledShowDirectory_, CPLList_);
+            compiled = CompiledShow::Load(compiledShowPath, sourceFiles, cpls);
+        }
 
-            if (newCPL != nullptr)
-                show_->AddCPLToEndOfTimeline(newCPL);
+        if (compiled)
+        {
+            SMPTE_SYNC_LOG << "ShowManager::Load - loaded compiled show " << compiledShowPath;
+        }
+        else
+        {
+            this->ParseCPLs(cpls);
         }
         
+        // Add the CPLs to the timeline in the order of the CPLList_, whatever order they were parsed in.
+        // CPLs that failed to parse are dropped from the CPLList_ so it matches the timeline edited by InsertCPL and RemoveCPL.
+        //
+        CPLFileList timelineCPLList;
+        bool allParsed = true;
+
+        for (size_t index = 0; index < cpls.size(); index++)
+        {
+            if (cpls[index] == nullptr)
+            {
+                SMPTE_SYNC_LOG << "ShowManager::Load - unable to parse " << CPLList_[index];
+                allParsed = false;
+                continue;
+            }
+
+            show->AddCPLToEndOfTimeline(cpls[index]);
+            timelineCPLList.push_back(CPLList_[index]);
+        }
+
+        CPLList_.swap(timelineCPLList);
+
+        boost::atomic_store(&show_, show);
+        timelineVersion_++;
         
-        if (show_->GetLengthInFrames() == 0)
+        if (show->GetLengthInFrames() == 0)
             return false;
-        
+
+        // A CPL that failed to parse is parsed again at the next Load rather than compiled without it
+        //
+        if (!compiled && !compiledShowPath.empty() && allParsed)
+        {
+            if (!CompiledShow::Save(compiledShowPath, sourceFiles, cpls))
+            {
+                SMPTE_SYNC_LOG << "ShowManager::Load - unable to write compiled show " << compiledShowPath;
+            }
+        }
+
+        std::vector<Asset*> assets = show->GetAssets(Asset::eAssetType_AuxData);
+        uint32_t showGeneration = showGeneration_;
+
+        this->ResetWarmUpProgress(showGeneration);
+
         showLoaded_ = true;
 
+        // Preload and warm up outside of the locks so serving aux data and the next edit are not held up by the reads.
+        // Both stop queueing once a later edit has moved on to a new generation.
+        //
+        show_lock.unlock();
+        edit_lock.unlock();
+
+        this->PreloadAuxData(assets, showGeneration);
+        this->WarmUp(assets, showGeneration);
+
         return true;
     }
 
-    bool ShowManager::IsShowLoaded(void)
+    bool ShowManager::InsertCPL(int32_t iIndex, const std::string &iCPLPath)
     {
-        return showLoaded_;
+        if (iIndex < 0 || iCPLPath.empty())
+            return false;
+
+        return this->EditTimeline(iIndex, 0, iCPLPath);
     }
-    
-    int32_t ShowManager::GetLongestFrameLength(void)
+
+    bool ShowManager::AppendCPL(const std::string &iCPLPath)
     {
-        if (show_ == nullptr)
-            return 0;
-        
-        int32_t frameTime = 0;
-        
-        if (show_ == nullptr)
-            return frameTime;
-        
-        frameTime = show_->GetLongestFrameLength();
-        
-        return frameTime;
+        if (iCPLPath.empty())
+            return false;
+
+        return this->EditTimeline(sAppendIndex, 0, iCPLPath);
     }
 
-    int32_t ShowManager::GetLengthInFrames(void)
+    bool ShowManager::ReplaceCPL(int32_t iIndex, const std::string &iCPLPath)
     {
-        if (show_ == nullptr)
-            return 0;
-        
-        int32_t length = 0;
-        
-        if (show_ == nullptr)
-            return length;
-        
-        length = show_->GetLengthInFrames();
-        
-        SMPTE_SYNC_LOG << "ShowManager::GetLengthInFrames " << length;
+        if (iCPLPath.empty())
+            return false;
 
-        return length;
+        return this->EditTimeline(iIndex, 1, iCPLPath);
     }
 
-    int32_t ShowManager::GetSampleRate(void)
+    bool ShowManager::RemoveCPL(int32_t iIndex)
     {
-        return sampleRate_;
+        return this->EditTimeline(iIndex, 1, std::string());
     }
-    
-    bool ShowManager::GetFrame(int32_t iFrame, FrameInfo& oFrameInfo)
+
+    uint32_t ShowManager::GetTimelineVersion(void)
     {
-        if (show_ == nullptr)
-            return false;
-        
-        return show_->GetAssetFrameInfo(iFrame, oFrameInfo);
+        return timelineVersion_;
     }
-    
-    bool ShowManager::OpenAuxDataParser(int32_t iStartFrame)
+
+    bool ShowManager::EditTimeline(int32_t iIndex, int32_t iRemoveCount, const std::string &iCPLPath)
     {
-        if (auxDataParser_ != nullptr)
-            return false;
+        SMPTE_SYNC_LOG << "ShowManager::EditTimeline iIndex = " << iIndex << " iRemoveCount = " << iRemoveCount << " iCPLPath = " << iCPLPath;
 
-        int32_t startFrame = 0;
-        int32_t endFrame = 0;
+        boost::mutex::scoped_lock edit_lock(editMutex_);
 
-        bool frameAvailable = show_->GetAssetRangeForFrame(iStartFrame
-                                     , Asset::eAssetType_AuxData
-                                     , startFrame
-                                     , endFrame);
-        if (frameAvailable)
+        ShowPtr show = boost::atomic_load(&show_);
+
+        // Nothing is playing. Edit the list parsed by the next Load.
+        //
+        if (!this->IsShowLoaded() || !show)
         {
-            std::string auxDataFilePath = show_->GetDataFilePath(startFrame, Asset::eAssetType_AuxData);
-            
-            auxDataParser_ = new AuxDataParser(startFrame, endFrame, auxDataFilePath);
-            
-            if (auxDataParser_->Open())
+            if (!iCPLPath.empty())
             {
-                return true;
+                CPLParser cplParser(iCPLPath);
+                if (!cplParser.IsFileCPL())
+                    return false;
             }
-            else
+
+            boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
+
+            int32_t index = iIndex == sAppendIndex ? static_cast<int32_t>(CPLList_.size()) : iIndex;
+
+            if (index < 0 || iRemoveCount < 0 || index + iRemoveCount > static_cast<int32_t>(CPLList_.size()))
+                return false;
+
+            CPLList_.erase(CPLList_.begin() + index, CPLList_.begin() + index + iRemoveCount);
+
+            if (!iCPLPath.empty())
+                CPLList_.insert(CPLList_.begin() + index, iCPLPath);
+
+            return true;
+        }
+
+        const std::vector<CPL*> &cpls = show->GetCPLs();
+        int32_t numberOfCPLs = static_cast<int32_t>(cpls.size());
+        int32_t editIndex = iIndex == sAppendIndex ? numberOfCPLs : iIndex;
+
+        if (editIndex < 0 || iRemoveCount < 0 || editIndex + iRemoveCount > numberOfCPLs)
+            return false;
+
+        // Parse and build the new timeline while the current one keeps playing.
+        // Each Show sets the start frames of its own Assets so the CPLs kept are copied.
+        //
+        CPL *cpl = nullptr;
+
+        if (!iCPLPath.empty())
+        {
+            cpl = this->ParseCPL(iCPLPath);
+
+            if (cpl == nullptr)
             {
-                SMPTE_SYNC_LOG << "ShowManager::Load - Failed to open auxDataFilePath = " << auxDataFilePath;
+                SMPTE_SYNC_LOG << "ShowManager::EditTimeline - unable to parse " << iCPLPath;
                 return false;
             }
         }
-        
-        return false;
-    }
 
-    bool ShowManager::GetDataItems(const std::string &iDataEssenceCodingUL_,
-                                 int32_t iStart,
-                                 int32_t iCount,
-                                 const std::string &iEncryptionType,
-                                 std::vector<char>& oContent)
-    {
-        SMPTE_SYNC_LOG << "ShowManager::GetDataItems iDataEssenceCodingUL_ = "
-        << iDataEssenceCodingUL_
-        << " iStart = "
-        << iStart
-        << " iCount = "
-        << iCount
-        << " iEncryptionType = "
-        << iEncryptionType;
-        
-        if (!this->IsShowLoaded())
-            return false;
-        
-        uint8_t *oDataItem = nullptr;
-        uint32_t oDataItemSize = 0;
+        ShowPtr newShow(new Show(sampleRate_));
 
-        int32_t startFrame = iStart;
-        int32_t endFrame = iStart + iCount;
-        int32_t itemsRead = 0;
+        for (int32_t index = 0; index <= numberOfCPLs; index++)
+        {
+            if (index == editIndex && cpl != nullptr)
+                newShow->AddCPLToEndOfTimeline(cpl);
 
-        // Write the payload
+            if (index == numberOfCPLs)
+                break;
+
+            if (index >= editIndex && index < editIndex + iRemoveCount)
+                continue;
+
+            newShow->AddCPLToEndOfTimeline(cpls[index]->Clone());
+        }
+
+        if (newShow->GetLengthInFrames() == 0)
+        {
+            SMPTE_SYNC_LOG << "ShowManager::EditTimeline - the edit leaves an empty Show";
+            return false;
+        }
+
+        // Appending moves no frame already on the timeline, so everything read for it stays valid
         //
-        while (startFrame < endFrame)
+        bool appended = iRemoveCount == 0 && editIndex == numberOfCPLs;
+        uint32_t showGeneration = 0;
+
         {
-            if (auxDataParser_ != nullptr)
+            boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
+
+            if (!appended)
             {
-                // If our requested frame is outside of the range of our current auxDataParser_
-                // we need to delete the current parser and then load a new parser
+                // Frames after the edit moved. Drop the read-ahead queued and the data read for the old frame numbers.
                 //
-                if (startFrame < auxDataParser_->GetStartFrame() || auxDataParser_->GetEndFrame() < startFrame)
-                {
-                    delete auxDataParser_;
-                    auxDataParser_ = nullptr;
+                showGeneration_++;
+                auxDataParserPool_->Clear();
+                auxDataBlockCache_->Clear();
 
-                    if (!this->OpenAuxDataParser(startFrame))
-                    {
-                        SMPTE_SYNC_LOG << "ShowManager::GetDataItems - unable to OpenAuxDataParser for startFrame = " << startFrame;
-                        break;
-                    }
-                }
+                this->ResetWarmUpProgress(showGeneration_);
             }
-            else
+
+            boost::atomic_store(&show_, newShow);
+            timelineVersion_++;
+
+            CPLList_.erase(CPLList_.begin() + editIndex, CPLList_.begin() + editIndex + iRemoveCount);
+
+            if (!iCPLPath.empty())
+                CPLList_.insert(CPLList_.begin() + editIndex, iCPLPath);
+
+            showGeneration = showGeneration_;
+        }
+
+        // Preload and warm up outside of the locks so serving aux data and the next edit are not held up by the reads.
+        // newShow keeps the Assets alive.
+        //
+        edit_lock.unlock();
+
+        std::vector<Asset*> assets;
+
+        if (appended)
+        {
+            for (std::vector<Reel*>::iterator reelIter = cpl->reels_.begin(); reelIter != cpl->reels_.end(); reelIter++)
             {
-                if (!this->OpenAuxDataParser(startFrame))
+                for (std::vector<Asset*>::iterator assetIter = (*reelIter)->assets_.begin(); assetIter != (*reelIter)->assets_.end(); assetIter++)
                 {
-                    SMPTE_SYNC_LOG << "ShowManager::GetDataItems - unable to OpenAuxDataParser for startFrame = " << startFrame;
-                    break;
+                    if ((*assetIter)->type_ == Asset::eAssetType_AuxData)
+                        assets.push_back(*assetIter);
                 }
             }
-            
-            if (auxDataParser_->GetDataItem(startFrame, &oDataItem, oDataItemSize))
-            {
-                SMPTE_SYNC_LOG << "ShowManager::GetDataItems - startFrame = " << startFrame;
-
-                itemsRead++;
-                AuxDataBlock *auxData = new AuxDataBlock;
-                
-                auxData->editUnitIndex_ = startFrame;
-
-                FrameInfo frameInfo;
-                show_->GetAssetFrameInfo(startFrame, frameInfo);
-
-                auxData->editUnitRateNumerator_ = frameInfo.editUnitRateNumerator_;
-                auxData->editUnitRateDenominator_ = frameInfo.editUnitRateDenominator_;
-
-                auxData->sourceDataEssenceCodingUL_.SetFromString(frameInfo.dataEssenceCodingUL_);
-                auxData->sourceDataItemLength_ = oDataItemSize;
-                auxData->sourceDataItem_ = new uint8_t[auxData->sourceDataItemLength_];
-                memcpy(auxData->sourceDataItem_, oDataItem, auxData->sourceDataItemLength_);
-                
-                int32_t dataSize = auxData->GetSizeInBytes();
-                uint8_t *buf = new uint8_t[dataSize];
-                uint8_t *bufOrig = buf;
-                memset(buf, 0, dataSize);
-                
-                auxData->write(&buf);
-                
-                std::string tmp((const char*)bufOrig, dataSize);
-                
-                oContent.insert(oContent.end(), tmp.begin(), tmp.end());
-
-                delete [] oDataItem;
-                // Make sure we set it to null as the next loop will
-                // reuse this same pointer
-                // If GetDataItem fails we should never get here,
-                // practice defensiving programming anyways.
-                //
-                oDataItem = nullptr;
-                
-                delete [] bufOrig;
-                delete auxData;
-            }
-            else
-            {
-                break;
-            }
-            
-            startFrame++;
         }
-        
-        // Now that we have read all of our items,
-        // We need to setup the header properly
-        // and then PRE-PEND the header to the
-        // beginning of the data.
-        //
-        
-        // Setup and write the header
-        //
-        AuxDataBlockTransferHeader header;
-        header.editUnitRangeStartIndex_ = iStart;
-        header.editUnitRangeCount_ = itemsRead;
-        
-        int32_t headerSize = header.GetSizeInBytes();
-        uint8_t *headerBuf = new uint8_t[headerSize];
-        uint8_t *headerBufOrig = headerBuf;
-        memset(headerBuf, 0, headerSize);
-        
-        header.write(&headerBuf);
-        
-        std::string tmp((const char*)headerBufOrig, headerSize);
-        
-        oContent.insert(oContent.begin(), tmp.begin(), tmp.end());
-        
-        delete [] headerBufOrig;
-        
+        else
+        {
+            assets = newShow->GetAssets(Asset::eAssetType_AuxData);
+        }
+
+        this->PreloadAuxData(assets, showGeneration);
+        this->WarmUp(assets, showGeneration);
+
+        SMPTE_SYNC_LOG << "ShowManager::EditTimeline - published " << newShow->GetCPLs().size() << " CPLs and " << newShow->GetLengthInFrames() << " frames";
+
         return true;
     }
 
+    void ShowManager::ParseCPLs(std::vector<CPL*> &oCPLs)
+    {
+        oCPLs.assign(CPLList_.size(), nullptr);
+
+        int32_t numberOfCPLs = static_cast<int32_t>(CPLList_.size());
+        int32_t numberOfThreads = std::min(std::min(numberOfCPLs, sMaxCPLParserThreads)
+                                           , std::max(static_cast<int32_t>(boost::thread::hardware_concurrency()), 1));
+
+        if (numberOfThreads <= 1)
+        {
+            for (int32_t index = 0; index < numberOfCPLs; index++)
+                oCPLs[index] = this->ParseCPL(CPLList_[index]);
+
+            return;
+        }
+
+        boost::mutex doneMutex;
+        boost::condition_variable doneCondition;
+        int32_t remaining = numberOfCPLs;
+
+        WorkerPool workerPool(numberOfThreads, "CPLParser");
+
+        for (int32_t index = 0; index < numberOfCPLs; index++)
+        {
+            workerPool.Post([this, index, &oCPLs, &doneMutex, &doneCondition, &remaining]()
+                            {
+                                oCPLs[index] = this->ParseCPL(CPLList_[index]);
+
+                                boost::mutex::scoped_lock done_lock(doneMutex);
+                                if (--remaining == 0)
+                                    doneCondition.notify_all();
+                            });
+        }
+
+        // The WorkerPool discards tasks that have not started when it stops. Wait for all of them first.
+        //
+        boost::mutex::scoped_lock done_lock(doneMutex);
+        while (remaining > 0)
+            doneCondition.wait(done_lock);
+    }
+
+    CPL *ShowManager::ParseCPL(const std::string &iCPLPath)
+    {
+        CPLParser cplParser(iCPLPath, assetMapCache_);
+        return cplParser.Parse();
+    }
+
+    void ShowManager::ResetWarmUpProgress(uint32_t iShowGeneration)
+    {
+        boost::mutex::scoped_lock warm_up_lock(warmUpMutex_);
+
+        warmUpGeneration_ = iShowGeneration;
+        warmUpScheduled_ = false;
+        warmUpWindowsCompleted_ = 0;
+        warmUpWindowsTotal_ = 0;
+    }
+
+    void ShowManager::WarmUp(const std::vector<Asset*> &iAssets, uint32_t iShowGeneration)
+    {
+        uint32_t showGeneration = iShowGeneration;
+        int32_t seconds = warmUpSeconds_;
+
+        {
+            boost::mutex::scoped_lock warm_up_lock(warmUpMutex_);
+
+            if (warmUpGeneration_ != showGeneration)
+                return;
+
+            warmUpScheduled_ = true;
+
+            if (seconds <= 0 || iAssets.empty())
+                return;
+
+            warmUpWindowsTotal_ += static_cast<int32_t>(iAssets.size());
+        }
+
+        // Every CPL starts with a reel, so the start of each aux data asset
+        // covers both the start of each CPL and each reel change
+        //
+        for (std::vector<Asset*>::const_iterator iter = iAssets.begin(); iter != iAssets.end(); iter++)
+        {
+            Asset *asset = *iter;
+
+            int32_t startFrame = asset->GetStartFrame();
+            int32_t count = asset->GetEndFrame() - startFrame + 1;
+
+            if (asset->editRateDenominator_ > 0)
+            {
+                int64_t frames = static_cast<int64_t>(seconds) * asset->editRateNumerator_ / asset->editRateDenominator_;
+                count = static_cast<int32_t>(std::min(static_cast<int64_t>(count), frames));
+            }
+
+            {
+                boost::mutex::scoped_lock scoped_lock(readAheadMutex_);
+
+                // Already being read
+                //
+                if (count <= 0 || !readAheadPending_.insert(std::make_pair(asset->dataEssenceCodingUL_, startFrame)).second)
+                {
+                    this->FinishWarmUpWindow(showGeneration);
+                    continue;
+                }
+            }
+
+            // The blocks are cached under the coding UL of the track. This is the coding UL clients request.
+            //
+            readAheadWorkerPool_->Post(boost::bind(&ShowManager::ReadAhead
+                                                   , this
+                                                   , asset->dataEssenceCodingUL_
+                                                   , startFrame
+                                                   , count
+                                                   , showGeneration
+                                                   , true));
+        }
+
+        SMPTE_SYNC_LOG << "ShowManager::WarmUp - queued the first " << seconds << " seconds of " << iAssets.size() << " reels";
+    }
+
+    void ShowManager::FinishWarmUpWindow(uint32_t iShowGeneration)
+    {
+        boost::mutex::scoped_lock warm_up_lock(warmUpMutex_);
+
+        if (iShowGeneration == warmUpGeneration_)
+            warmUpWindowsCompleted_++;
+    }
+
+    void ShowManager::PreloadAuxData(const std::vector<Asset*> &iAssets, uint32_t iShowGeneration)
+    {
+        boost::mutex::scoped_lock preload_lock(preloadMutex_);
+
+        // Tracks preloaded for CPLs added earlier keep their share
+        //
+        uint64_t maxSizeInBytes = auxDataPreloadMaxSizeInBytes_;
+        uint64_t availableSizeInBytes = maxSizeInBytes - std::min(maxSizeInBytes, auxDataParserPool_->GetPreloadedSizeInBytes());
+
+        if (availableSizeInBytes == 0)
+            return;
+
+        // Tracks are preloaded in timeline order while they fit.
+        // A track too large for what is left is read from disk and smaller tracks after it are still preloaded.
+        //
+        for (std::vector<Asset*>::const_iterator iter = iAssets.begin(); iter != iAssets.end(); iter++)
+        {
+            // A later edit cleared the pool. Its own preload takes over.
+            //
+            if (iShowGeneration != showGeneration_)
+                return;
+
+            uint64_t sizeInBytes = auxDataParserPool_->Preload((*iter)->path_
+                                                               , (*iter)->GetStartFrame()
+                                                               , (*iter)->GetEndFrame()
+                                                               , (*iter)->id_
+                                                               , availableSizeInBytes);
+
+            availableSizeInBytes -= std::min(sizeInBytes, availableSizeInBytes);
+        }
+
+        SMPTE_SYNC_LOG << "ShowManager::PreloadAuxData - preloaded " << auxDataParserPool_->GetNumberOfPreloadedTracks()
+        << " tracks using " << auxDataParserPool_->GetPreloadedSizeInBytes() << " bytes";
+    }
+
+    bool ShowManager::IsShowLoaded(void)
+    {
+        return showLoaded_;
+    }
+
+    bool ShowManager::IsShowWarm(void)
+    {
+        if (!showLoaded_)
+            return false;
+
+        boost::mutex::scoped_lock warm_up_lock(warmUpMutex_);
+
+        // The totals stay at 0 until WarmUp has queued the windows of the Show
+        //
+        return warmUpScheduled_ && warmUpWindowsCompleted_ >= warmUpWindowsTotal_;
+    }
+
+    void ShowManager::GetWarmUpProgress(int32_t &oWindowsCompleted, int32_t &oWindowsTotal)
+    {
+        boost::mutex::scoped_lock warm_up_lock(warmUpMutex_);
+
+        oWindowsCompleted = warmUpWindowsCompleted_;
+        oWindowsTotal = warmUpWindowsTotal_;
+    }
+
+    void ShowManager::SetWarmUpSeconds(int32_t iSeconds)
+    {
+        warmUpSeconds_ = iSeconds > 0 ? iSeconds : 0;
+    }
+
+    int32_t ShowManager::GetWarmUpSeconds(void)
+    {
+        return warmUpSeconds_;
+    }
+    
+    int32_t ShowManager::GetLongestFrameLength(void)
+    {
+        ShowPtr show = boost::atomic_load(&show_);
+
+        if (!show)
+            return 0;
+        
+        return show->GetLongestFrameLength();
+    }
+
+    int32_t ShowManager::GetLengthInFrames(void)
+    {
+        ShowPtr show = boost::atomic_load(&show_);
+
+        if (!show)
+            return 0;
+        
+        int32_t length = show->GetLengthInFrames();
+        
+        SMPTE_SYNC_LOG << "ShowManager::GetLengthInFrames " << length;
+
+        return length;
+    }
+
+    int32_t ShowManager::GetSampleRate(void)
+    {
+        return sampleRate_;
+    }
+    
+    bool ShowManager::GetFrame(int32_t iFrame, FrameInfo& oFrameInfo)
+    {
+        // The snapshot stays valid while it is read even if an edit publishes a new one
+        //
+        ShowPtr show = boost::atomic_load(&show_);
+
+        if (!show)
+            return false;
+        
+        return show->GetAssetFrameInfo(iFrame, oFrameInfo);
+    }
+
+    int32_t ShowManager::GetFrameRange(int32_t iStart, int32_t iCount, FrameInfo *oFrameInfo)
+    {
+        ShowPtr show = boost::atomic_load(&show_);
+
+        if (!show)
+            return 0;
+
+        return show->GetAssetFrameInfoRange(iStart, iCount, oFrameInfo);
+    }
+
+    void ShowManager::GetFrameInfoRuns(FrameInfoRunList &oRuns)
+    {
+        ShowPtr show = boost::atomic_load(&show_);
+
+        oRuns.clear();
+
+        if (!show)
+            return;
+
+        show->GetFrameInfoRuns(oRuns);
+    }
+
+    void ShowManager::GetAuxDataCodingULs(std::vector<std::string> &oCodingULs)
+    {
+        ShowPtr show = boost::atomic_load(&show_);
+
+        oCodingULs.clear();
+
+        if (!show)
+            return;
+
+        oCodingULs = show->GetAuxDataCodingULs();
+    }
+    
+    void ShowManager::SetMaxOpenAuxDataParsers(int32_t iMaxOpenParsers)
+    {
+        auxDataParserPool_->SetMaxOpenParsers(iMaxOpenParsers);
+    }
+
+    int32_t ShowManager::GetMaxOpenAuxDataParsers(void)
+    {
+        return auxDataParserPool_->GetMaxOpenParsers();
+    }
+
+    void ShowManager::SetUseMappedAuxDataFiles(bool iUseMappedFiles)
+    {
+        auxDataParserPool_->SetUseMappedFiles(iUseMappedFiles);
+    }
+
+    bool ShowManager::GetUseMappedAuxDataFiles(void)
+    {
+        return auxDataParserPool_->GetUseMappedFiles();
+    }
+
+    void ShowManager::SetAuxDataPreloadMaxSizeInBytes(uint64_t iMaxSizeInBytes)
+    {
+        auxDataPreloadMaxSizeInBytes_ = iMaxSizeInBytes;
+    }
+
+    uint64_t ShowManager::GetAuxDataPreloadMaxSizeInBytes(void)
+    {
+        return auxDataPreloadMaxSizeInBytes_;
+    }
+
+    void ShowManager::GetAuxDataPreloadStatistics(int32_t &oNumberOfTracks, uint64_t &oSizeInBytes)
+    {
+        oNumberOfTracks = auxDataParserPool_->GetNumberOfPreloadedTracks();
+        oSizeInBytes = auxDataParserPool_->GetPreloadedSizeInBytes();
+    }
+
+    void ShowManager::SetAuxDataIndexDirectory(const std::string &iDirectory)
+    {
+        auxDataParserPool_->SetIndexDirectory(iDirectory);
+    }
+
+    std::string ShowManager::GetAuxDataIndexDirectory(void)
+    {
+        return auxDataParserPool_->GetIndexDirectory();
+    }
+
+    void ShowManager::SetCompiledShowDirectory(const std::string &iDirectory)
+    {
+        boost::unique_lock<boost::shared_mutex> show_lock(showMutex_);
+        compiledShowDirectory_ = iDirectory;
+    }
+
+    std::string ShowManager::GetCompiledShowDirectory(void)
+    {
+        boost::shared_lock<boost::shared_mutex> show_lock(showMutex_);
+        return compiledShowDirectory_;
+    }
+
+    void ShowManager::SetAuxDataCacheMaxSizeInBytes(uint64_t iMaxSizeInBytes)
+    {
+        auxDataBlockCache_->SetMaxSizeInBytes(iMaxSizeInBytes);
+    }
+
+    uint64_t ShowManager::GetAuxDataCacheMaxSizeInBytes(void)
+    {
+        return auxDataBlockCache_->GetMaxSizeInBytes();
+    }
+
+    void ShowManager::SetReadAheadWindows(int32_t iWindows)
+    {
+        readAheadWindows_ = iWindows > 0 ? iWindows : 0;
+    }
+
+    int32_t ShowManager::GetReadAheadWindows(void)
+    {
+        return readAheadWindows_;
+    }
+
+    void ShowManager::GetAuxDataCacheStatistics(AuxDataCacheStatistics &oStatistics)
+    {
+        auxDataBlockCache_->GetStatistics(oStatistics);
+
+        oStatistics.readAheadWindows_ = readAheadWindowCount_;
+        oStatistics.readAheadBlocks_ = readAheadBlockCount_;
+        oStatistics.coalescedReads_ = blockReads_.GetNumberOfSharedCalls() + windowReads_.GetNumberOfSharedCalls();
+    }
+
+    void ShowManager::ResetAuxDataCacheStatistics(void)
+    {
+        auxDataBlockCache_->ResetStatistics();
+
+        readAheadWindowCount_ = 0;
+        readAheadBlockCount_ = 0;
+
+        blockReads_.ResetStatistics();
+        windowReads_.ResetStatistics();
+    }
+
+    bool ShowManager::GetReaderSnapshot(ShowPtr &oShow, uint32_t &oShowGeneration)
+    {
+        // The generation is taken first. An edit bumps it before it publishes its Show,
+        // so blocks serialized from a newer Show are never cached under an older generation.
+        //
+        oShowGeneration = showGeneration_;
+        oShow = boost::atomic_load(&show_);
+
+        return this->IsShowLoaded() && oShow;
+    }
+
+    bool ShowManager::CacheDataItem(const std::string &iCodingUL, int32_t iFrame, const AuxDataBlockBytesPtr &iBlock, bool iEvict, uint32_t iShowGeneration)
+    {
+        if (iShowGeneration != showGeneration_)
+            return false;
+
+        if (!auxDataBlockCache_->Put(iCodingUL, iFrame, iBlock, iEvict))
+            return false;
+
+        // An edit that moved the frames bumps the generation before it clears the cache.
+        // If it did so after the check above, the block may have landed after the Clear.
+        //
+        if (iShowGeneration != showGeneration_)
+        {
+            auxDataBlockCache_->Erase(iCodingUL, iFrame, iBlock);
+            return false;
+        }
+
+        return true;
+    }
+
+    AuxDataSourcePtr ShowManager::AcquireAuxDataSource(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iFrame)
+    {
+        int32_t startFrame = 0;
+        int32_t endFrame = 0;
+
+        bool frameAvailable = iShow->GetAuxDataRangeForFrame(iCodingUL
+                                     , iFrame
+                                     , startFrame
+                                     , endFrame);
+        if (frameAvailable)
+        {
+            std::string auxDataFilePath = iShow->GetAuxDataFilePath(iCodingUL, startFrame);
+
+            UUID assetId;
+            iShow->GetAuxDataAssetId(iCodingUL, startFrame, assetId);
+            
+            return auxDataParserPool_->Acquire(auxDataFilePath, startFrame, endFrame, assetId);
+        }
+        
+        return AuxDataSourcePtr();
+    }
+
+    bool ShowManager::GetDataItems(const std::string &iDataEssenceCodingUL_,
+                                 int32_t iStart,
+                                 int32_t iCount,
+                                 const std::string &iEncryptionType,
+                                 std::vector<char>& oContent)
+    {
+        SMPTE_SYNC_LOG << "ShowManager::GetDataItems iDataEssenceCodingUL_ = "
+        << iDataEssenceCodingUL_
+        << " iStart = "
+        << iStart
+        << " iCount = "
+        << iCount
+        << " iEncryptionType = "
+        << iEncryptionType;
+        
+        // Work on a snapshot of the Show so an edit never waits for the reads below
+        //
+        ShowPtr show;
+        uint32_t showGeneration = 0;
+
+        if (!this->GetReaderSnapshot(show, showGeneration))
+            return false;
+        
+        AuxDataSourcePtr auxDataSource;
+        std::vector<char> items;
+
+        int32_t startFrame = iStart;
+        int32_t endFrame = iStart + iCount;
+        int32_t itemsRead = 0;
+
+        // Read the payload as ranges. A window larger than the auxDataBlockCache_ would evict its own blocks if it went through it.
+        //
+        while (startFrame < endFrame)
+        {
+            int32_t read = this->ReadDataItems(show, iDataEssenceCodingUL_, auxDataSource, startFrame, endFrame - startFrame, items);
+
+            if (read == 0)
+                break;
+
+            itemsRead += read;
+            startFrame += read;
+        }
+
+        if (itemsRead > 0)
+            this->ScheduleReadAhead(iDataEssenceCodingUL_, iStart, itemsRead, showGeneration);
+        
+        // Now that we have read all of our items,
+        // we know the count for the header.
+        // Write the header followed by the data.
+        //
+        this->WriteTransferHeader(iStart, itemsRead, oContent);
+        
+        oContent.insert(oContent.end(), items.begin(), items.end());
+        
+        return true;
+    }
+
+    SharedContentPtr ShowManager::GetSharedDataItems(const std::string &iDataEssenceCodingUL_,
+                                                     int32_t iStart,
+                                                     int32_t iCount,
+                                                     const std::string &iEncryptionType)
+    {
+        std::string key = iDataEssenceCodingUL_
+                        + "|" + std::to_string(iStart)
+                        + "|" + std::to_string(iCount)
+                        + "|" + iEncryptionType
+                        + "|" + std::to_string(static_cast<uint32_t>(showGeneration_));
+
+        bool shared = false;
+
+        SharedContentPtr content = windowReads_.Do(key,
+                                                   boost::bind(&ShowManager::ReadSharedDataItems
+                                                               , this
+                                                               , iDataEssenceCodingUL_
+                                                               , iStart
+                                                               , iCount
+                                                               , iEncryptionType),
+                                                   &shared);
+
+        if (shared)
+        {
+            SMPTE_SYNC_LOG << "ShowManager::GetSharedDataItems - shared in flight read of " << key;
+        }
+
+        return content;
+    }
+
+    SharedContentPtr ShowManager::ReadSharedDataItems(const std::string &iCodingUL, int32_t iStart, int32_t iCount, const std::string &iAccept)
+    {
+        boost::shared_ptr<std::vector<char> > content(new std::vector<char>);
+
+        if (!this->GetDataItems(iCodingUL, iStart, iCount, iAccept, *content))
+            return SharedContentPtr();
+
+        return content;
+    }
+
+    DataStreamPtr ShowManager::OpenDataItemsStream(const std::string &iDataEssenceCodingUL_,
+                                                   int32_t iStart,
+                                                   int32_t iCount,
+                                                   const std::string &iEncryptionType)
+    {
+        SMPTE_SYNC_LOG << "ShowManager::OpenDataItemsStream iDataEssenceCodingUL_ = "
+        << iDataEssenceCodingUL_
+        << " iStart = "
+        << iStart
+        << " iCount = "
+        << iCount
+        << " iEncryptionType = "
+        << iEncryptionType;
+
+        return DataStreamPtr(new DataItemsStream(this, iDataEssenceCodingUL_, iStart, iCount));
+    }
+
+    int32_t ShowManager::CountDataItems(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iStart, int32_t iCount)
+    {
+        int32_t count = 0;
+        int32_t frame = iStart;
+        int32_t endFrame = iStart + iCount;
+
+        // Walk the aux data assets of iCodingUL covering the range.
+        // Stop at the first frame with no aux data, the same place ReadDataItems would fail.
+        //
+        while (frame < endFrame)
+        {
+            int32_t assetStartFrame = 0;
+            int32_t assetEndFrame = 0;
+
+            if (!iShow->GetAuxDataRangeForFrame(iCodingUL, frame, assetStartFrame, assetEndFrame))
+                break;
+
+            int32_t nextFrame = std::min(assetEndFrame + 1, endFrame);
+            count += nextFrame - frame;
+            frame = nextFrame;
+        }
+
+        return count;
+    }
+
+    int32_t ShowManager::ReadDataItems(const ShowPtr &iShow, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iCount, std::vector<char> &oContent)
+    {
+        int32_t itemsRead = 0;
+        AuxDataBlockBytesPtr block;
+
+        // Blocks read ahead for this window are served from the cache
+        //
+        while (itemsRead < iCount && auxDataBlockCache_->Get(iCodingUL, iFrame + itemsRead, block))
+        {
+            oContent.insert(oContent.end(), block->begin(), block->end());
+            itemsRead++;
+        }
+
+        if (itemsRead > 0)
+            return itemsRead;
+
+        if (!ioAuxDataSource || iFrame < ioAuxDataSource->GetStartFrame() || ioAuxDataSource->GetEndFrame() < iFrame)
+        {
+            ioAuxDataSource = this->AcquireAuxDataSource(iShow, iCodingUL, iFrame);
+
+            if (!ioAuxDataSource)
+            {
+                SMPTE_SYNC_LOG << "ShowManager::ReadDataItems - unable to AcquireAuxDataSource for iFrame = " << iFrame;
+                return 0;
+            }
+        }
+
+        // Read the rest of the range in one pass without caching it.
+        // The read-ahead caches the next window.
+        //
+        int32_t count = std::min(iCount, ioAuxDataSource->GetEndFrame() - iFrame + 1);
+
+        return ioAuxDataSource->GetDataItems(iFrame, count,
+            [this, &iShow, &iCodingUL, &oContent](int32_t iItemNumber, const uint8_t *iDataItem, uint32_t iDataItemSize)
+            {
+                AuxDataBlockBytesPtr item = this->SerializeDataItem(iShow, iCodingUL, iItemNumber, iDataItem, iDataItemSize);
+                oContent.insert(oContent.end(), item->begin(), item->end());
+
+                return true;
+            });
+    }
+
+    AuxDataBlockBytesPtr ShowManager::SerializeDataItem(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iFrame, const uint8_t *iDataItem, uint32_t iDataItemSize)
+    {
+        AuxDataBlock auxData;
+        
+        auxData.editUnitIndex_ = iFrame;
+
+        FrameInfo frameInfo;
+        iShow->GetAssetFrameInfo(iFrame, frameInfo);
+
+        auxData.editUnitRateNumerator_ = frameInfo.editUnitRateNumerator_;
+        auxData.editUnitRateDenominator_ = frameInfo.editUnitRateDenominator_;
+
+        // The FrameInfo only names one of the aux data tracks of the frame. Use the one the item came from.
+        //
+        auxData.sourceDataEssenceCodingUL_.SetFromString(iCodingUL);
+
+        // The data item is only read while writing, so reference it rather than copying it
+        //
+        auxData.sourceDataItemLength_ = iDataItemSize;
+        auxData.sourceDataItem_ = const_cast<uint8_t*>(iDataItem);
+        
+        // Serialize straight into the block that is cached and sent
+        //
+        boost::shared_ptr<std::vector<char> > block(new std::vector<char>(auxData.GetSizeInBytes(), 0));
+        uint8_t *buf = reinterpret_cast<uint8_t*>(block->data());
+        
+        auxData.write(&buf);
+
+        return block;
+    }
+
+    AuxDataBlockBytesPtr ShowManager::FetchDataItems(const ShowPtr &iShow, uint32_t iShowGeneration, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iBatchCount, bool iEvict)
+    {
+        return blockReads_.Do(BlockReadKey(iCodingUL, iShowGeneration, iFrame),
+                              boost::bind(&ShowManager::LoadAndCacheDataItems
+                                          , this
+                                          , boost::cref(iShow)
+                                          , iShowGeneration
+                                          , boost::cref(iCodingUL)
+                                          , boost::ref(ioAuxDataSource)
+                                          , iFrame
+                                          , iBatchCount
+                                          , iEvict));
+    }
+
+    AuxDataBlockBytesPtr ShowManager::LoadAndCacheDataItems(const ShowPtr &iShow, uint32_t iShowGeneration, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iBatchCount, bool iEvict)
+    {
+        AuxDataBlockBytesPtr block;
+
+        // The previous read of this block may have completed between our
+        // cache lookup and this read being started
+        //
+        if (auxDataBlockCache_->Peek(iCodingUL, iFrame, block))
+            return block;
+
+        // If our requested frame is outside of the range of our current auxDataSource
+        // we need to acquire the parser for the track file containing the frame
+        //
+        if (!ioAuxDataSource || iFrame < ioAuxDataSource->GetStartFrame() || ioAuxDataSource->GetEndFrame() < iFrame)
+        {
+            ioAuxDataSource = this->AcquireAuxDataSource(iShow, iCodingUL, iFrame);
+
+            if (!ioAuxDataSource)
+            {
+                SMPTE_SYNC_LOG << "ShowManager::LoadAndCacheDataItems - unable to AcquireAuxDataSource for iFrame = " << iFrame;
+                return AuxDataBlockBytesPtr();
+            }
+        }
+
+        // A batch never crosses into the next track file
+        //
+        int32_t count = std::min(std::max(iBatchCount, 1), ioAuxDataSource->GetEndFrame() - iFrame + 1);
+
+        int32_t itemsRead = ioAuxDataSource->GetDataItems(iFrame, count,
+            [this, &iShow, iShowGeneration, &iCodingUL, iFrame, iEvict, &block](int32_t iItemNumber, const uint8_t *iDataItem, uint32_t iDataItemSize)
+            {
+                AuxDataBlockBytesPtr item = this->SerializeDataItem(iShow, iCodingUL, iItemNumber, iDataItem, iDataItemSize);
+
+                if (iItemNumber == iFrame)
+                    block = item;
+
+                bool cached = this->CacheDataItem(iCodingUL, iItemNumber, item, iEvict, iShowGeneration);
+
+                // Read-ahead stops splitting once the cache is full
+                //
+                if (!iEvict)
+                {
+                    if (!cached)
+                        return false;
+
+                    readAheadBlockCount_++;
+                }
+
+                return true;
+            });
+
+        SMPTE_SYNC_LOG << "ShowManager::LoadAndCacheDataItems - iFrame = " << iFrame << " itemsRead = " << itemsRead;
+
+        return block;
+    }
+
+    void ShowManager::ScheduleReadAhead(const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration)
+    {
+        int32_t windows = readAheadWindows_;
+
+        for (int32_t window = 1; window <= windows; window++)
+        {
+            int32_t windowStart = iStart + window * iCount;
+
+            {
+                boost::mutex::scoped_lock scoped_lock(readAheadMutex_);
+
+                // Clients in the same room ask for the same windows.
+                // Only load each window once.
+                //
+                if (!readAheadPending_.insert(std::make_pair(iCodingUL, windowStart)).second)
+                    continue;
+            }
+
+            readAheadWorkerPool_->Post(boost::bind(&ShowManager::ReadAhead
+                                                   , this
+                                                   , iCodingUL
+                                                   , windowStart
+                                                   , iCount
+                                                   , iShowGeneration
+                                                   , false));
+        }
+    }
+
+    void ShowManager::ReadAhead(const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration, bool iWarmUp)
+    {
+        {
+            ShowPtr show;
+            uint32_t showGeneration = 0;
+
+            // The Show was reset or reloaded after this window was scheduled
+            //
+            if (this->GetReaderSnapshot(show, showGeneration) && iShowGeneration == showGeneration)
+            {
+                int32_t count = this->CountDataItems(show, iCodingUL, iStart, iCount);
+
+                // Queue the reads of the window and return without waiting for the disk.
+                // The window is completed by the last read.
+                //
+                if (auxDataIOEngine_ != nullptr)
+                {
+                    this->SubmitReadAhead(show, iCodingUL, iStart, count, iShowGeneration, iWarmUp);
+                    return;
+                }
+
+                AuxDataSourcePtr auxDataSource;
+
+                for (int32_t frame = iStart; frame < iStart + count; frame++)
+                {
+                    if (auxDataBlockCache_->Contains(iCodingUL, frame))
+                        continue;
+
+                    // Loads the rest of the window, up to the end of the track file, in one read
+                    //
+                    AuxDataBlockBytesPtr block = this->FetchDataItems(show, iShowGeneration, iCodingUL, auxDataSource, frame, iStart + count - frame, false);
+                    if (!block)
+                        break;
+
+                    // Read-ahead never evicts. Stop once the cache is full so
+                    // speculative data does not push out the windows being played.
+                    //
+                    if (!auxDataBlockCache_->Contains(iCodingUL, frame))
+                        break;
+                }
+
+                if (count > 0)
+                    readAheadWindowCount_++;
+
+                SMPTE_SYNC_LOG << "ShowManager::ReadAhead iStart = " << iStart << " count = " << count;
+            }
+        }
+
+        if (iWarmUp)
+            this->FinishWarmUpWindow(iShowGeneration);
+
+        boost::mutex::scoped_lock scoped_lock(readAheadMutex_);
+        readAheadPending_.erase(std::make_pair(iCodingUL, iStart));
+    }
+
+    void ShowManager::SubmitReadAhead(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration, bool iWarmUp)
+    {
+        ReadAheadWindowPtr window(new ReadAheadWindow);
+        window->codingUL_ = iCodingUL;
+        window->start_ = iStart;
+        window->show_ = iShow;
+        window->showGeneration_ = iShowGeneration;
+        window->warmUp_ = iWarmUp;
+        window->readsInFlight_ = 1;
+
+        AuxDataSourcePtr auxDataSource;
+
+        int32_t frame = iStart;
+        int32_t endFrame = iStart + iCount;
+
+        while (frame < endFrame)
+        {
+            if (auxDataBlockCache_->Contains(iCodingUL, frame))
+            {
+                frame++;
+                continue;
+            }
+
+            if (!auxDataSource || frame < auxDataSource->GetStartFrame() || auxDataSource->GetEndFrame() < frame)
+            {
+                auxDataSource = this->AcquireAuxDataSource(iShow, iCodingUL, frame);
+
+                if (!auxDataSource)
+                    break;
+            }
+
+            int32_t count = std::min(endFrame - frame, auxDataSource->GetEndFrame() - frame + 1);
+
+            // A preloaded track needs no I/O. Cache its items right away.
+            //
+            AuxDataParser *auxDataParser = dynamic_cast<AuxDataParser*>(auxDataSource.get());
+            if (auxDataParser == nullptr)
+            {
+                if (!this->FetchDataItems(iShow, iShowGeneration, iCodingUL, auxDataSource, frame, count, false))
+                    break;
+
+                frame += count;
+                continue;
+            }
+
+            // One read per track file covered by the window.
+            // Locate one extra item when the track file has it. Its offset is where the read ends.
+            //
+            bool hasNextItem = frame + count <= auxDataParser->GetEndFrame();
+
+            std::vector<uint64_t> offsets;
+            if (!auxDataParser->LocateDataItems(frame, count + (hasNextItem ? 1 : 0), offsets))
+                break;
+
+            uint64_t length = 0;
+
+            if (hasNextItem && static_cast<int32_t>(offsets.size()) == count + 1)
+            {
+                length = offsets.back() - offsets.front();
+                offsets.pop_back();
+            }
+            else
+            {
+                // The size of the last item is not known until its K and L have been read.
+                // CompleteReadAhead reads the rest of it if needed.
+                //
+                if (static_cast<int32_t>(offsets.size()) > count)
+                    offsets.resize(count);
+
+                count = static_cast<int32_t>(offsets.size());
+                length = offsets.back() - offsets.front() + AuxDataParser::klvPeekSize_;
+            }
+
+            window->readsInFlight_++;
+
+            if (!auxDataIOEngine_->Read(auxDataParser->GetPath()
+                                        , offsets.front()
+                                        , static_cast<uint32_t>(length)
+                                        , boost::bind(&ShowManager::CompleteReadAhead
+                                                      , this
+                                                      , window
+                                                      , auxDataParser->GetPath()
+                                                      , frame
+                                                      , offsets
+                                                      , _1
+                                                      , _2)))
+            {
+                window->readsInFlight_--;
+                break;
+            }
+
+            frame += count;
+        }
+
+        SMPTE_SYNC_LOG << "ShowManager::SubmitReadAhead iStart = " << iStart << " iCount = " << iCount << " submitted through frame = " << frame;
+
+        this->FinishReadAhead(window);
+    }
+
+    void ShowManager::CompleteReadAhead(ReadAheadWindowPtr iWindow
+                                        , const std::string &iPath
+                                        , int32_t iFirstFrame
+                                        , const std::vector<uint64_t> &iOffsets
+                                        , bool iSuccess
+                                        , const AuxDataReadBufferPtr &iBuffer)
+    {
+        if (iSuccess)
+        {
+            uint64_t size = 0;
+
+            // Read the rest of a last item that extends past the read
+            //
+            if (AuxDataParser::GetDataItemsSize(iOffsets, iBuffer->data(), iBuffer->size(), size)
+                && size > iBuffer->size()
+                && auxDataIOEngine_->Read(iPath
+                                          , iOffsets.front() + iBuffer->size()
+                                          , static_cast<uint32_t>(size - iBuffer->size())
+                                          , boost::bind(&ShowManager::ContinueReadAhead
+                                                        , this
+                                                        , iWindow
+                                                        , iFirstFrame
+                                                        , iOffsets
+                                                        , iBuffer
+                                                        , _1
+                                                        , _2)))
+            {
+                return;
+            }
+
+            this->CacheReadAhead(iWindow, iFirstFrame, iOffsets, iBuffer);
+        }
+
+        this->FinishReadAhead(iWindow);
+    }
+
+    void ShowManager::ContinueReadAhead(ReadAheadWindowPtr iWindow
+                                        , int32_t iFirstFrame
+                                        , const std::vector<uint64_t> &iOffsets
+                                        , const AuxDataReadBufferPtr &iBuffer
+                                        , bool iSuccess
+                                        , const AuxDataReadBufferPtr &iRemainder)
+    {
+        if (iSuccess)
+        {
+            iBuffer->insert(iBuffer->end(), iRemainder->begin(), iRemainder->end());
+
+            this->CacheReadAhead(iWindow, iFirstFrame, iOffsets, iBuffer);
+        }
+
+        this->FinishReadAhead(iWindow);
+    }
+
+    void ShowManager::CacheReadAhead(ReadAheadWindowPtr iWindow
+                                     , int32_t iFirstFrame
+                                     , const std::vector<uint64_t> &iOffsets
+                                     , const AuxDataReadBufferPtr &iBuffer)
+    {
+        // The Show was reset or reloaded while the read was in flight
+        //
+        if (!this->IsShowLoaded() || iWindow->showGeneration_ != showGeneration_)
+            return;
+
+        const std::string &codingUL = iWindow->codingUL_;
+        const ShowPtr &show = iWindow->show_;
+        uint32_t showGeneration = iWindow->showGeneration_;
+
+        AuxDataParser::SplitDataItems(iFirstFrame, iOffsets, iOffsets.front(), iBuffer->data(), iBuffer->size(),
+            [this, &codingUL, &show, showGeneration](int32_t iItemNumber, const uint8_t *iDataItem, uint32_t iDataItemSize)
+            {
+                AuxDataBlockBytesPtr item = this->SerializeDataItem(show, codingUL, iItemNumber, iDataItem, iDataItemSize);
+
+                // Read-ahead never evicts. Stop once the cache is full or the Show has been edited.
+                //
+                if (!this->CacheDataItem(codingUL, iItemNumber, item, false, showGeneration))
+                    return false;
+
+                readAheadBlockCount_++;
+
+                return true;
+            });
+    }
+
+    void ShowManager::FinishReadAhead(ReadAheadWindowPtr iWindow)
+    {
+        if (--iWindow->readsInFlight_ != 0)
+            return;
+
+        readAheadWindowCount_++;
+
+        if (iWindow->warmUp_)
+            this->FinishWarmUpWindow(iWindow->showGeneration_);
+
+        boost::mutex::scoped_lock scoped_lock(readAheadMutex_);
+        readAheadPending_.erase(std::make_pair(iWindow->codingUL_, iWindow->start_));
+    }
+
+    void ShowManager::WriteTransferHeader(int32_t iStart, int32_t iCount, std::vector<char> &oContent)
+    {
+        AuxDataBlockTransferHeader header;
+        header.editUnitRangeStartIndex_ = iStart;
+        header.editUnitRangeCount_ = iCount;
+        
+        int32_t headerSize = header.GetSizeInBytes();
+        uint8_t *headerBuf = new uint8_t[headerSize];
+        uint8_t *headerBufOrig = headerBuf;
+        memset(headerBuf, 0, headerSize);
+        
+        header.write(&headerBuf);
+        
+        oContent.insert(oContent.end(), (const char*)headerBufOrig, (const char*)headerBufOrig + headerSize);
+        
+        delete [] headerBufOrig;
+    }
+
 }  // namespace SMPTE_SYNC
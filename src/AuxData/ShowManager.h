@@ -33,18 +33,32 @@
 #include <assert.h>
 #include <cstdio>
 #include <cstdlib>
+#include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "boost/atomic.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/shared_mutex.hpp"
 
 #include "DataTypes.h"
 #include "AuxData.h"
+#include "AuxDataBlockCache.h"
+#include "AuxDataIOEngine.h"
+#include "AuxDataParserPool.h"
+#include "DataStream.h"
+#include "SingleFlight.h"
 
 namespace SMPTE_SYNC
 {
+    class AssetMapCache;
+    class CPL;
     class CPLParser;
-    class AuxDataParser;
+    class AuxDataParserPool;
+    class WorkerPool;
     class Show;
     class Asset;
     class FrameInfo;
@@ -56,6 +70,14 @@ namespace SMPTE_SYNC
      * The ShowManager must be loaded before the SE_Server or SS_Server are started.
      * The SE_Server and SS_Server access this data from different threads and expect the ShowManager to be in a consistent state. 
      * The showLoaded_ flag represents the loaded state of the show.
+     * GetFrame and GetDataItems are threadsafe and can be called concurrently.
+     * Serialized aux data is kept in an AuxDataBlockCache. After a window is served the following windows are read ahead
+     * on a background thread so sequential SS_Client requests are answered from memory.
+     * Identical requests and overlapping reads that are in flight at the same time share a single read.
+     * Load also reads the start of every reel into the cache in the background. IsShowWarm reports when it is done.
+     * The Show is published as an immutable snapshot. InsertCPL, AppendCPL, ReplaceCPL and RemoveCPL build a new snapshot
+     * next to the one being played and swap it in atomically. GetFrame, GetFrameRange and GetFrameInfoRuns never wait for an edit.
+     * Neither do the aux data readers. Each request works on its own snapshot, and blocks read for a Show that was edited meanwhile are not cached.
      *
      */
 
@@ -133,6 +155,64 @@ namespace SMPTE_SYNC
          */
         bool Load(void);
 
+        /**
+         *
+         * Inserts a CPL into the Show timeline without reloading the Show.
+         * The CPL is parsed and a new timeline is built while the current one keeps playing, then the new one replaces it.
+         * Frames before the inserted CPL keep their frame numbers. If the Show is not loaded only the CPL list is changed.
+         * Call GetLengthInFrames and GetFrameInfoRuns afterwards to update the SE_Server.
+         *
+         * @param iIndex is the position of the CPL in the Show timeline. 0 inserts at the start, the number of CPLs appends.
+         * @param iCPLPath is path to the CPL XML file to be inserted
+         * @return bool true/false if the CPL was parsed and inserted
+         *
+         */
+        bool InsertCPL(int32_t iIndex, const std::string &iCPLPath);
+
+        /**
+         *
+         * Appends a CPL to the end of the Show timeline without reloading the Show.
+         * No frame already on the timeline moves so nothing read for the current timeline is dropped.
+         * Used for trailers or adverts delivered after the Show was loaded.
+         *
+         * @param iCPLPath is path to the CPL XML file to be appended
+         * @return bool true/false if the CPL was parsed and appended
+         *
+         */
+        bool AppendCPL(const std::string &iCPLPath);
+
+        /**
+         *
+         * Replaces a CPL in the Show timeline without reloading the Show
+         *
+         * @param iIndex is the position of the CPL to replace in the Show timeline
+         * @param iCPLPath is path to the CPL XML file replacing it
+         * @return bool true/false if the CPL was parsed and replaced
+         *
+         */
+        bool ReplaceCPL(int32_t iIndex, const std::string &iCPLPath);
+
+        /**
+         *
+         * Removes a CPL from the Show timeline without reloading the Show.
+         * The last CPL of a loaded Show cannot be removed. Use Reset instead.
+         *
+         * @param iIndex is the position of the CPL to remove in the Show timeline
+         * @return bool true/false if the CPL was removed
+         *
+         */
+        bool RemoveCPL(int32_t iIndex);
+
+        /**
+         *
+         * Returns a counter incremented each time Load or an edit publishes a new Show timeline.
+         * Clients poll it to know when the SE_Server needs a new length and new FrameInfoRunList.
+         *
+         * @return uint32_t version of the Show timeline
+         *
+         */
+        uint32_t GetTimelineVersion(void);
+
         /**
          *
          * Checks the showLoaded_ flag
@@ -142,6 +222,33 @@ namespace SMPTE_SYNC
          */
         bool IsShowLoaded(void);
 
+        /**
+         *
+         * Checks if the start of every reel with aux data has been read into memory since the Show was loaded.
+         * Load queues the first GetWarmUpSeconds of each reel to be read in the background so
+         * the first request at the start of the Show or at a reel change is answered from memory.
+         *
+         * @return bool true/false if the Show is loaded and its warm-up has been queued and has completed
+         *
+         */
+        bool IsShowWarm(void);
+
+        /**
+         *
+         * Returns the progress of the warm-up queued by the last Load
+         *
+         * @param oWindowsCompleted is the number of reels whose start has been read
+         * @param oWindowsTotal is the number of reels with aux data in the Show
+         *
+         */
+        void GetWarmUpProgress(int32_t &oWindowsCompleted, int32_t &oWindowsTotal);
+
+        /// Sets the number of seconds read at the start of each reel when the Show is loaded. 0 disables warm-up. Takes effect at the next Load.
+        void SetWarmUpSeconds(int32_t iSeconds);
+
+        /// Gets the number of seconds read at the start of each reel when the Show is loaded
+        int32_t GetWarmUpSeconds(void);
+
         /// TODO: Should we expose a Show pointer to the client or force them through the ShowManager?
         
         /**
@@ -184,10 +291,44 @@ namespace SMPTE_SYNC
          */
         bool GetFrame(int32_t iFrame, FrameInfo& oFrameInfo);
 
+        /**
+         *
+         * Returns the FrameInfo of consecutive frames in the Show with a single lock of the Show.
+         * Matches GetFrameDataRangeCallback so the SE_Server can fetch frames in batches.
+         *
+         * @param iStart is the first requested frame on the Show timeline
+         * @param iCount is the number of requested frames
+         * @param oFrameInfo is an array of at least iCount FrameInfo filled in frame order
+         * @return int32_t number of frames filled. Stops at the first frame not found.
+         *
+         */
+        int32_t GetFrameRange(int32_t iStart, int32_t iCount, FrameInfo *oFrameInfo);
+
+        /**
+         *
+         * Returns the runs of frames that play the same track files for the whole Show.
+         * Small enough to hand to the SE_Server once per Load. See SE_Server::SetFrameInfoRuns.
+         *
+         * @param oRuns is replaced with the runs of the Show, empty if the Show is not loaded
+         *
+         */
+        void GetFrameInfoRuns(FrameInfoRunList &oRuns);
+
+        /**
+         *
+         * Returns the coding UL of every aux data track in the Show.
+         * A Reel can carry several aux data tracks. Each is requested, cached and read ahead under its own coding UL.
+         *
+         * @param oCodingULs is replaced with the coding ULs, empty if the Show is not loaded
+         *
+         */
+        void GetAuxDataCodingULs(std::vector<std::string> &oCodingULs);
+
         /**
          *
          * Populates a vector<char> for the requested data.
-         * Potentially creates an AuxDataParser and parses data from a MXF file
+         * Reads from a preloaded track or potentially opens an AuxDataParser in the auxDataParserPool_ and parses data from a MXF file
+         * Threadsafe. Can be called concurrently from multiple connection handlers.
          *
          * @param iCodingUL is requested coding UL for the data
          * @param iStart is requested start frame
@@ -202,28 +343,398 @@ namespace SMPTE_SYNC
                           int32_t iCount,
                           const std::string &iAccept,
                           std::vector<char>& oContent);
+
+        /**
+         *
+         * Returns the same content as GetDataItems as an immutable, reference counted buffer.
+         * Identical requests in flight at the same time share one read and all get the same buffer.
+         * Threadsafe. Can be called concurrently from multiple connection handlers.
+         *
+         * @param iCodingUL is requested coding UL for the data
+         * @param iStart is requested start frame
+         * @param iCount is requested number of frames
+         * @param iAccept is requested accept type
+         * @return SharedContentPtr to the content, empty if the Show is not loaded
+         *
+         */
+        SharedContentPtr GetSharedDataItems(const std::string &iCodingUL,
+                                            int32_t iStart,
+                                            int32_t iCount,
+                                            const std::string &iAccept);
+
+        /**
+         *
+         * Opens a stream of the requested data that is read one batch of AuxDataBlocks at a time.
+         * The first Read returns the AuxDataBlockTransferHeader with a count computed from the Show timeline.
+         * Each following Read reads the next batch. Lets the SS_Server read the next batch only once the previous one has been sent.
+         * Threadsafe. Each stream is read by one thread at a time.
+         *
+         * @param iCodingUL is requested coding UL for the data
+         * @param iStart is requested start frame
+         * @param iCount is requested number of frames
+         * @param iAccept is requested accept type
+         * @return DataStreamPtr to the stream. Complete once every item announced in the header has been read.
+         *
+         */
+        DataStreamPtr OpenDataItemsStream(const std::string &iCodingUL,
+                                          int32_t iStart,
+                                          int32_t iCount,
+                                          const std::string &iAccept);
+
+        /// Sets the maximum number of aux data track files kept open at the same time
+        void SetMaxOpenAuxDataParsers(int32_t iMaxOpenParsers);
+
+        /// Gets the maximum number of aux data track files kept open at the same time
+        int32_t GetMaxOpenAuxDataParsers(void);
+
+        /// Sets if aux data track files are memory mapped when opened. Enabled by default where supported.
+        void SetUseMappedAuxDataFiles(bool iUseMappedFiles);
+
+        /// Gets if aux data track files are memory mapped when opened
+        bool GetUseMappedAuxDataFiles(void);
+
+        /**
+         *
+         * Sets the memory available to preload aux data track files when the Show is loaded.
+         * Preloaded tracks are served from memory with no I/O. Tracks that do not fit are read from disk.
+         * Takes effect at the next Load.
+         *
+         * @param iMaxSizeInBytes is the memory available to preloaded tracks. 0 disables preloading.
+         *
+         */
+        void SetAuxDataPreloadMaxSizeInBytes(uint64_t iMaxSizeInBytes);
+
+        /// Gets the memory available to preload aux data track files
+        uint64_t GetAuxDataPreloadMaxSizeInBytes(void);
+
+        /// Returns the number of preloaded aux data tracks and the memory they use
+        void GetAuxDataPreloadStatistics(int32_t &oNumberOfTracks, uint64_t &oSizeInBytes);
+
+        /**
+         *
+         * Sets the directory the offset index of each aux data track file is persisted in.
+         * Indexes are always kept in memory for the life of the ShowManager. With a directory they also survive restarts.
+         *
+         * @param iDirectory is an existing, writable directory. An empty string keeps indexes in memory only.
+         *
+         */
+        void SetAuxDataIndexDirectory(const std::string &iDirectory);
+
+        /// Gets the directory the offset index of each aux data track file is persisted in
+        std::string GetAuxDataIndexDirectory(void);
+
+        /**
+         *
+         * Sets the directory compiled shows are kept in.
+         * Load writes the parsed timeline of each list of CPLs to a binary file there and reads it back on the next Load
+         * of the same, unchanged CPLs instead of parsing XML. Use with SetAuxDataIndexDirectory so the track files are not indexed again either.
+         *
+         * @param iDirectory is an existing, writable directory. An empty string disables compiled shows.
+         *
+         */
+        void SetCompiledShowDirectory(const std::string &iDirectory);
+
+        /// Gets the directory compiled shows are kept in
+        std::string GetCompiledShowDirectory(void);
+
+        /// Sets the maximum number of bytes of serialized aux data kept in memory
+        void SetAuxDataCacheMaxSizeInBytes(uint64_t iMaxSizeInBytes);
+
+        /// Gets the maximum number of bytes of serialized aux data kept in memory
+        uint64_t GetAuxDataCacheMaxSizeInBytes(void);
+
+        /// Sets the number of windows read ahead after each request. 0 disables read-ahead.
+        void SetReadAheadWindows(int32_t iWindows);
+
+        /// Gets the number of windows read ahead after each request
+        int32_t GetReadAheadWindows(void);
+
+        /// Returns the hit, miss, read-ahead and memory counters of the aux data cache
+        void GetAuxDataCacheStatistics(AuxDataCacheStatistics &oStatistics);
+
+        /// Resets the hit, miss and read-ahead counters of the aux data cache
+        void ResetAuxDataCacheStatistics(void);
         
     private:
 
+        /// Immutable snapshot of the Show timeline
+        typedef boost::shared_ptr<Show> ShowPtr;
+
+        /// Coding UL, showGeneration_ and frame of a block read in flight
+        typedef std::tuple<std::string, uint32_t, int32_t> BlockReadKey;
+
+        /**
+         *
+         * Builds a new Show timeline from the current one with iRemoveCount CPLs removed at iIndex and iCPLPath inserted there, then publishes it.
+         * Implements InsertCPL, AppendCPL, ReplaceCPL and RemoveCPL.
+         *
+         * @param iIndex is the position of the edit in the Show timeline
+         * @param iRemoveCount is the number of CPLs removed at iIndex
+         * @param iCPLPath is path to the CPL XML file inserted at iIndex. An empty string inserts nothing.
+         * @return bool true/false if the new timeline was published
+         *
+         */
+        bool EditTimeline(int32_t iIndex, int32_t iRemoveCount, const std::string &iCPLPath);
+
+        /**
+         *
+         * Parses the CPLList_ concurrently. Requires showMutex_ to be held exclusively.
+         *
+         * @param oCPLs is filled with one CPL per item of the CPLList_ in the same order. nullptr where parsing failed.
+         *
+         */
+        void ParseCPLs(std::vector<CPL*> &oCPLs);
+
+        /// Parses one CPL using the assetMapCache_
+        CPL *ParseCPL(const std::string &iCPLPath);
+
+        /**
+         *
+         * Takes the Show and its generation that a reader of the aux data works on.
+         * The readers never take showMutex_. They detect an edit made while they read by comparing oShowGeneration with showGeneration_.
+         *
+         * @param oShow is the current Show
+         * @param oShowGeneration is showGeneration_, taken before oShow
+         * @return bool true/false if a Show is loaded
+         *
+         */
+        bool GetReaderSnapshot(ShowPtr &oShow, uint32_t &oShowGeneration);
+
+        /**
+         *
+         * Adds a block serialized for the Show with iShowGeneration to the auxDataBlockCache_.
+         * Nothing is cached once an edit has moved on to a new generation.
+         *
+         * @return bool true/false if the block is in the cache
+         *
+         */
+        bool CacheDataItem(const std::string &iCodingUL, int32_t iFrame, const AuxDataBlockBytesPtr &iBlock, bool iEvict, uint32_t iShowGeneration);
+
+        /**
+         *
+         * Acquires an open AuxDataSource from the auxDataParserPool_ for the aux data track file with iCodingUL containing iFrame.
+         *
+         * @param iShow is the snapshot of the Show being read
+         * @param iCodingUL is the coding UL of the requested data
+         * @param iFrame is requested frame on the Show timeline
+         * @return AuxDataSourcePtr to an open AuxDataSource, empty if the frame has no aux data with iCodingUL or the track file could not be opened
+         *
+         */
+        AuxDataSourcePtr AcquireAuxDataSource(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iFrame);
+
+        /**
+         *
+         * Counts the frames of iShow starting at iStart that have aux data with iCodingUL, up to iCount frames.
+         *
+         */
+        int32_t CountDataItems(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iStart, int32_t iCount);
+
+        /**
+         *
+         * Appends the serialized AuxDataBlocks of up to iCount frames starting at iFrame to oContent.
+         * The blocks at iFrame found in the auxDataBlockCache_ are served from it. Otherwise the range is read
+         * from disk in one pass, up to the end of the track file, without being cached.
+         *
+         * @param iShow is the snapshot of the Show being read
+         * @param iCodingUL is the coding UL of the requested data
+         * @param ioAuxDataSource is the source used for the previous frame. Replaced if it does not contain iFrame.
+         * @param iFrame is the first requested frame on the Show timeline
+         * @param iCount is the number of requested frames
+         * @param oContent is the buffer the AuxDataBlocks are appended to
+         * @return int32_t number of AuxDataBlocks appended, 0 if iFrame could not be read
+         *
+         */
+        int32_t ReadDataItems(const ShowPtr &iShow, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iCount, std::vector<char> &oContent);
+
         /**
          *
-         * Attempts to create a new AuxDataParser and calls Open on the AuxDataParser
-         * Requires that there is no existing AuxDataParser. That is, auxDataParser_ is nullptr
+         * Serializes a data item read from the MXF file as an AuxDataBlock.
          *
-         * @param iStartFrame is requested start frame
-         * @return bool true/false if the requested iFrame was found and the AuxDataParser was created and AuxDataParser::Open succeeded
+         * @param iShow is the snapshot of the Show the item was read for
+         * @param iCodingUL is the coding UL of the track file the item was read from
+         * @param iFrame is the frame of the item on the Show timeline
+         * @param iDataItem is the KLV read from the MXF file
+         * @param iDataItemSize is the size of the KLV
+         * @return AuxDataBlockBytesPtr to the serialized block
          *
          */
-        bool OpenAuxDataParser(int32_t iStartFrame);
+        AuxDataBlockBytesPtr SerializeDataItem(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iFrame, const uint8_t *iDataItem, uint32_t iDataItemSize);
+
+        /**
+         *
+         * Loads iBatchCount blocks starting at iFrame with a single read and adds them to the auxDataBlockCache_.
+         * Concurrent calls starting at the same block share one read through blockReads_.
+         *
+         * @param iShow is the snapshot of the Show being read
+         * @param iShowGeneration is showGeneration_ when iShow was taken. Nothing is cached once it changes.
+         * @param iCodingUL is the coding UL of the requested data
+         * @param ioAuxDataSource is the source used for the previous frame. Replaced if it does not contain iFrame.
+         * @param iFrame is requested frame on the Show timeline
+         * @param iBatchCount is the number of frames to read. Clipped to the end of the track file.
+         * @param iEvict is passed to AuxDataBlockCache::Put. False for read-ahead, which stops once the cache is full.
+         * @return AuxDataBlockBytesPtr to the serialized block for iFrame, empty if the item could not be read
+         *
+         */
+        AuxDataBlockBytesPtr FetchDataItems(const ShowPtr &iShow, uint32_t iShowGeneration, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iBatchCount, bool iEvict);
+
+        /// Runs once per batch read in flight on behalf of FetchDataItems
+        AuxDataBlockBytesPtr LoadAndCacheDataItems(const ShowPtr &iShow, uint32_t iShowGeneration, const std::string &iCodingUL, AuxDataSourcePtr &ioAuxDataSource, int32_t iFrame, int32_t iBatchCount, bool iEvict);
+
+        /// Runs once per request in flight on behalf of GetSharedDataItems
+        SharedContentPtr ReadSharedDataItems(const std::string &iCodingUL, int32_t iStart, int32_t iCount, const std::string &iAccept);
+
+        /// Queues the windows following [iStart, iStart + iCount) of the Show with iShowGeneration to be read into the auxDataBlockCache_
+        void ScheduleReadAhead(const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration);
+
+        /// Runs on readAheadWorkerPool_ to load one window into the auxDataBlockCache_. iWarmUp is true for the windows queued by WarmUp.
+        void ReadAhead(const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration, bool iWarmUp);
+
+        /// Tracks the asynchronous reads of one window. Defined in ShowManager.cpp.
+        struct ReadAheadWindow;
+
+        /// The DataStream returned by OpenDataItemsStream. Defined in ShowManager.cpp.
+        class DataItemsStream;
+
+        /// Reference held by each read of a window
+        typedef boost::shared_ptr<ReadAheadWindow> ReadAheadWindowPtr;
+
+        /**
+         *
+         * Queues one read on the auxDataIOEngine_ for each track file covered by a window.
+         * Frames already cached are skipped.
+         *
+         * @param iShow is the snapshot of the Show the window belongs to
+         * @param iCodingUL is the coding UL of the window
+         * @param iStart is the first frame of the window
+         * @param iCount is the number of frames in the window
+         * @param iShowGeneration is showGeneration_ when the window was scheduled
+         * @param iWarmUp is true for the windows queued by WarmUp
+         *
+         */
+        void SubmitReadAhead(const ShowPtr &iShow, const std::string &iCodingUL, int32_t iStart, int32_t iCount, uint32_t iShowGeneration, bool iWarmUp);
+
+        /// Runs on the auxDataIOEngine_ when a read-ahead read completes. Reads the rest of the last item if needed, then caches the items.
+        void CompleteReadAhead(ReadAheadWindowPtr iWindow
+                               , const std::string &iPath
+                               , int32_t iFirstFrame
+                               , const std::vector<uint64_t> &iOffsets
+                               , bool iSuccess
+                               , const AuxDataReadBufferPtr &iBuffer);
+
+        /// Runs on the auxDataIOEngine_ when the rest of the last item has been read
+        void ContinueReadAhead(ReadAheadWindowPtr iWindow
+                               , int32_t iFirstFrame
+                               , const std::vector<uint64_t> &iOffsets
+                               , const AuxDataReadBufferPtr &iBuffer
+                               , bool iSuccess
+                               , const AuxDataReadBufferPtr &iRemainder);
+
+        /// Splits the items read for a window, serializes them and adds them to the auxDataBlockCache_ without evicting
+        void CacheReadAhead(ReadAheadWindowPtr iWindow
+                            , int32_t iFirstFrame
+                            , const std::vector<uint64_t> &iOffsets
+                            , const AuxDataReadBufferPtr &iBuffer);
+
+        /// Releases one reference to a window. The last one removes the window from readAheadPending_.
+        void FinishReadAhead(ReadAheadWindowPtr iWindow);
+
+        /// Queues the first warmUpSeconds_ of each aux data Asset to be read ahead and adds them to the warm-up progress
+        void WarmUp(const std::vector<Asset*> &iAssets, uint32_t iShowGeneration);
+
+        /// Starts counting the warm-up progress of the Show with iShowGeneration from zero
+        void ResetWarmUpProgress(uint32_t iShowGeneration);
+
+        /// Counts one warm-up window as completed if it belongs to the current Show
+        void FinishWarmUpWindow(uint32_t iShowGeneration);
+
+        /// Preloads the aux data Assets that fit in what is left of auxDataPreloadMaxSizeInBytes_ while iShowGeneration is current
+        void PreloadAuxData(const std::vector<Asset*> &iAssets, uint32_t iShowGeneration);
+
+        /// Appends a serialized AuxDataBlockTransferHeader to oContent
+        void WriteTransferHeader(int32_t iStart, int32_t iCount, std::vector<char> &oContent);
         
         /// List of CPL XML files to parse and add to the Show timeline
         CPLFileList     CPLList_;
         
-        /// Pointer to the current AuxDataParser
-        AuxDataParser   *auxDataParser_;
+        /// Parsed ASSETMAP.xml files shared by the CPLs of each package
+        AssetMapCache       *assetMapCache_;
+
+        /// Pool of open AuxDataParser objects and preloaded tracks keyed by track file
+        AuxDataParserPool   *auxDataParserPool_;
         
-        /// Pointer to the Show
-        Show            *show_;
+        /// Serialized aux data blocks kept in memory
+        AuxDataBlockCache   *auxDataBlockCache_;
+
+        /// Runs the read-ahead of the windows following each request
+        WorkerPool          *readAheadWorkerPool_;
+
+        /// Reads the windows being read ahead asynchronously. nullptr if not available on this platform.
+        AuxDataIOEngine     *auxDataIOEngine_;
+
+        /// The current Show timeline. Never modified once published. Replaced with boost::atomic_store while holding showMutex_ exclusively.
+        /// Readers never hold showMutex_. They take their own reference with boost::atomic_load.
+        ShowPtr         show_;
+
+        /// Incremented each time a new Show timeline is published
+        boost::atomic<uint32_t> timelineVersion_;
+
+        /// Incremented when the Show is reset or loaded so stale read-ahead is dropped
+        boost::atomic<uint32_t> showGeneration_;
+
+        /// Number of windows read ahead after each request
+        boost::atomic<int32_t>  readAheadWindows_;
+
+        /// Number of windows loaded by the read-ahead
+        boost::atomic<uint64_t> readAheadWindowCount_;
+
+        /// Number of blocks loaded by the read-ahead
+        boost::atomic<uint64_t> readAheadBlockCount_;
+
+        /// Memory available to preloaded aux data tracks
+        boost::atomic<uint64_t> auxDataPreloadMaxSizeInBytes_;
+
+        /// Number of seconds read at the start of each reel when the Show is loaded
+        boost::atomic<int32_t>  warmUpSeconds_;
+
+        /// Protects warmUpGeneration_, warmUpScheduled_, warmUpWindowsCompleted_ and warmUpWindowsTotal_
+        boost::mutex    warmUpMutex_;
+
+        /// showGeneration_ of the Show being warmed up
+        uint32_t        warmUpGeneration_;
+
+        /// Set once WarmUp has queued the windows of warmUpGeneration_
+        bool            warmUpScheduled_;
+
+        /// Number of warm-up windows completed for the current Show
+        int32_t         warmUpWindowsCompleted_;
+
+        /// Number of warm-up windows queued for the current Show
+        int32_t         warmUpWindowsTotal_;
+
+        /// Protects readAheadPending_
+        boost::mutex    readAheadMutex_;
+
+        /// Windows queued or being read ahead, keyed by coding UL and start frame
+        std::set<std::pair<std::string, int32_t> > readAheadPending_;
+
+        /// Block reads in flight keyed by coding UL, generation and frame
+        SingleFlight<BlockReadKey, AuxDataBlockBytesPtr> blockReads_;
+
+        /// Requests in flight keyed by coding UL, start, count and accept type
+        SingleFlight<std::string, SharedContentPtr> windowReads_;
+
+        /// Protects the publishing of show_ and CPLList_. Reset, Load and the publishing of an edit take an exclusive lock.
+        /// The readers of the aux data work on a snapshot of show_ and never take it.
+        boost::shared_mutex showMutex_;
+
+        /// Serializes Reset, Load and edits of the timeline. Taken before showMutex_.
+        boost::mutex    editMutex_;
+
+        /// Serializes PreloadAuxData, which runs after editMutex_ is released, so the preload budget is shared correctly
+        boost::mutex    preloadMutex_;
+
+        /// Directory compiled shows are kept in. Protected by showMutex_.
+        std::string     compiledShowDirectory_;
 
         /// Sample rate of the Show
         int32_t         sampleRate_;
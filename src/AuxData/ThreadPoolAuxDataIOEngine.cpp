@@ -0,0 +1,125 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "ThreadPoolAuxDataIOEngine.h"
+
+#include <errno.h>
+#include <string>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    ThreadPoolAuxDataIOEngine::ThreadPoolAuxDataIOEngine(int32_t iNumberOfThreads) :
+          workerPool_(iNumberOfThreads, "AuxDataIO")
+    {
+    }
+
+    ThreadPoolAuxDataIOEngine::~ThreadPoolAuxDataIOEngine()
+    {
+        this->Stop();
+    }
+
+    bool ThreadPoolAuxDataIOEngine::Read(const std::string &iPath
+                                         , uint64_t iOffset
+                                         , uint32_t iLength
+                                         , const AuxDataReadCallback &iCallback)
+    {
+        workerPool_.Post(boost::bind(&ThreadPoolAuxDataIOEngine::DoRead
+                                     , this
+                                     , iPath
+                                     , iOffset
+                                     , iLength
+                                     , iCallback));
+        return true;
+    }
+
+    void ThreadPoolAuxDataIOEngine::Stop(void)
+    {
+        workerPool_.Stop();
+    }
+
+    std::string ThreadPoolAuxDataIOEngine::GetName(void)
+    {
+        return "thread pool";
+    }
+
+    void ThreadPoolAuxDataIOEngine::DoRead(const std::string &iPath
+                                           , uint64_t iOffset
+                                           , uint32_t iLength
+                                           , const AuxDataReadCallback &iCallback)
+    {
+        AuxDataReadBufferPtr buffer(new std::vector<uint8_t>(iLength));
+        bool success = false;
+
+#if !defined(_WIN32)
+        AuxDataFilePtr file = this->AcquireFile(iPath);
+
+        if (file)
+        {
+            size_t bytesRead = 0;
+            success = true;
+
+            while (bytesRead < iLength)
+            {
+                ssize_t result = ::pread(file->GetFileDescriptor()
+                                         , buffer->data() + bytesRead
+                                         , iLength - bytesRead
+                                         , static_cast<off_t>(iOffset + bytesRead));
+
+                if (result < 0 && errno == EINTR)
+                    continue;
+
+                if (result < 0)
+                {
+                    SMPTE_SYNC_LOG << "ThreadPoolAuxDataIOEngine::DoRead - Failed to read iPath = " << iPath << " errno = " << errno;
+                    success = false;
+                    break;
+                }
+
+                // End of file
+                //
+                if (result == 0)
+                    break;
+
+                bytesRead += static_cast<size_t>(result);
+            }
+
+            buffer->resize(bytesRead);
+        }
+#endif
+
+        iCallback(success, buffer);
+    }
+
+}  // namespace SMPTE_SYNC
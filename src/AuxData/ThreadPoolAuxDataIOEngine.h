@@ -0,0 +1,91 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef THREADPOOLAUXDATAIOENGINE_H
+#define THREADPOOLAUXDATAIOENGINE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "AuxDataIOEngine.h"
+#include "WorkerPool.h"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief ThreadPoolAuxDataIOEngine runs each read as a blocking pread on a WorkerPool.
+     * The number of reads in flight is bounded by the number of threads.
+     * Used when io_uring is not available.
+     *
+     */
+
+    class ThreadPoolAuxDataIOEngine : public AuxDataIOEngine
+    {
+    public:
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iNumberOfThreads is the number of threads running reads
+         *
+         */
+        ThreadPoolAuxDataIOEngine(int32_t iNumberOfThreads);
+
+        /// Destructor. Calls Stop.
+        virtual ~ThreadPoolAuxDataIOEngine();
+
+        /// See AuxDataIOEngine::Read
+        virtual bool Read(const std::string &iPath
+                          , uint64_t iOffset
+                          , uint32_t iLength
+                          , const AuxDataReadCallback &iCallback);
+
+        /// See AuxDataIOEngine::Stop
+        virtual void Stop(void);
+
+        /// See AuxDataIOEngine::GetName
+        virtual std::string GetName(void);
+
+    private:
+
+        /// Runs on workerPool_ to perform one read
+        void DoRead(const std::string &iPath
+                    , uint64_t iOffset
+                    , uint32_t iLength
+                    , const AuxDataReadCallback &iCallback);
+
+        /// Threads running the reads
+        WorkerPool      workerPool_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // THREADPOOLAUXDATAIOENGINE_H
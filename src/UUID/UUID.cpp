@@ -30,138 +30,82 @@
 
 #include "UUID.h"
 
-#include <stdio.h>
-#include <ctype.h>
-#include <stdlib.h>
-#include <string.h>
+#include <type_traits>
 
 namespace SMPTE_SYNC
 {
-    /*
-     *  Function: GetHexChar
-     *  Hex character to hex value
-     */
+    static_assert(sizeof(UUID) == UUID::sizeInBytes_, "UUID must have the layout of a uint8_t[16]");
+    static_assert(std::is_trivially_copyable<UUID>::value, "UUID must be trivially copyable");
 
-    bool GetHexChar(uint8_t cin, uint8_t *cout, bool *count);
-    bool GetHexChar(uint8_t cin, uint8_t *cout, bool *count)
-    {
-        cin = tolower(cin);
-        
-        *count = false;
-        *cout = 0;
-        
-        if (('0' <= cin) && (cin <= '9'))
-        {
-            *cout = (uint8_t) (cin - '0');
-            *count = true;
-            
-            return true;
-        }
-        
-        if (('a' <= cin) && (cin <= 'f'))
-        {
-            *cout = (uint8_t) (cin - 'a' + 10);
-            *count = true;
-            
-            return true;
-        }
-        
-        if (cin == '-')
-        {
-            *count = false;
-            return true;
-        }
-        
-        return false;
-    }
+    // Lower case hex digits used to format a UUID
+    //
+    static const char sHexDigits[] = "0123456789abcdef";
 
-    void Initialize(UUID uuid)
+    // Returns the value of a hex digit or -1 if iChar is not one
+    //
+    static inline int32_t HexValue(char iChar)
     {
-        memset(uuid, 0, 16);
-    }
+        if ('0' <= iChar && iChar <= '9')
+            return iChar - '0';
+
+        // Folds upper case onto lower case
+        //
+        char lower = static_cast<char>(iChar | 0x20);
 
-    /*
-     *  Function: Str2UUID
-     *  UUID string to UUID value
-     */
+        if ('a' <= lower && lower <= 'f')
+            return lower - 'a' + 10;
+
+        return -1;
+    }
 
-    bool Str2UUID(const char *str, UUID uuid)
+    bool UUID::Parse(const char *iString, size_t iLength, UUID &oUUID)
     {
-        for (int i = 0; i < 16; i++)
+        UUID uuid;
+        size_t position = 0;
+
+        for (size_t index = 0; index < sizeInBytes_; index++)
         {
-            uint8_t cm, cl;
-            bool count;
-            
-            // Get first char
-            if (!GetHexChar(*(str++),&cm,&count))
-            {
+            if (position < iLength && iString[position] == '-')
+                position++;
+
+            if (position + 2 > iLength)
+                return false;
+
+            int32_t high = HexValue(iString[position]);
+            int32_t low = HexValue(iString[position + 1]);
+
+            if (high < 0 || low < 0)
                 return false;
-            }
-            
-            if (count)
-            {
-                // If first not '-'
-                if (!GetHexChar(*(str++),&cl,&count))
-                {
-                    return false;
-                }
-                
-                if (!count)
-                {
-                    // If second is '-'
-                    return false;
-                }
-            }
-            else
-            {
-                // If first is '-'
-                if (!GetHexChar(*(str++),&cm,&count))
-                {
-                    return false;
-                }
-                
-                // First is not '-'
-                if (!count)
-                {
-                    // If second is '-'
-                    return false;
-                }
-
-                // Second is not '-'
-                if (!GetHexChar(*(str++),&cl,&count))
-                {
-                    return false;
-                }
-                
-                if (!count)
-                {
-                    // If third is '-'
-                    return false;
-                }
-            }
-            
-            uuid[i] = (uint8_t) ((cm << 4) | cl) & 0xFF;
+
+            uuid.data_[index] = static_cast<uint8_t>((high << 4) | low);
+            position += 2;
         }
-        
+
+        if (position != iLength)
+            return false;
+
+        oUUID = uuid;
+
         return true;
     }
-    
-    bool StringToUUID(const std::string &iUUIDStr, UUID oUUID)
-    {
-        return Str2UUID(iUUIDStr.c_str(), oUUID);
-    }
-    
-    bool IsEqual(const UUID iUUID1, const UUID iUUID2)
-    {
-        return strncmp((char*)iUUID1, (char*)iUUID2, 16) == 0;
-    }
-    
-    bool Copy(const UUID iSource, UUID oDestination)
+
+    std::string UUID::ToString(void) const
     {
-        memcpy(oDestination, iSource, 16);
-        
-        return true;
+        std::string uuidString(stringLength_, '-');
+        size_t position = 0;
+
+        for (size_t index = 0; index < sizeInBytes_; index++)
+        {
+            // Dashes after bytes 4, 6, 8 and 10
+            //
+            if (index == 4 || index == 6 || index == 8 || index == 10)
+                position++;
+
+            uuidString[position++] = sHexDigits[data_[index] >> 4];
+            uuidString[position++] = sHexDigits[data_[index] & 0x0f];
+        }
+
+        return uuidString;
     }
-    
 
-}  // namespace SMPTE_SYNC
\ No newline at end of file
+}  // namespace SMPTE_SYNC
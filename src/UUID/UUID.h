@@ -31,70 +31,169 @@
 #define UUID_H
 
 #include <stdint.h>
+#include <string.h>
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace SMPTE_SYNC
 {
-    /// TODO: Implement a full C++ class to support UUID
-    
     /**
      *
-     * @brief buffer of uint8_t to hold a UUID
+     * @brief UUID is a 16 byte universally unique identifier held by value.
+     * It is trivially copyable with the layout of a uint8_t[16] so it can be written to files and sync packets as is.
+     * UUIDs are compared 8 bytes at a time and can be used as keys of std and boost hash maps.
      *
      */
-    typedef uint8_t   UUID[16];
 
-    /**
-     *
-     * @brief Initializes a UUID to all 0s
-     *
-     */
-    void Initialize(UUID iUUID);
+    class UUID
+    {
+    public:
 
-    /**
-     *
-     * @brief Converts a nullptr terminated char buff to a UUID
-     *
-     * @param str is nullptr terminated char buffer to be converted
-     * @param uuid is UUID represented by the string
-     * @return true if conversion was successful, false otherwise
-     *
-     */
-    bool Str2UUID(const char *str, UUID oUUID);
+        /// Number of bytes in a UUID
+        static const size_t sizeInBytes_ = 16;
 
-    /**
-     *
-     * @brief Converts a std::string to a UUID
-     *
-     * @param iUUIDStr is string representation of UUID
-     * @param oUUID is UUID represented by the string
-     * @return true if conversion was successful, false otherwise
-     *
-     */
-    bool StringToUUID(const std::string &iUUIDStr, UUID oUUID);
-    
-    /**
-     *
-     * @brief Compares to UUID objects
-     *
-     * @param iUUID1 is first UUID to compare
-     * @param iUUID2 is second UUID to compare
-     * @return true if the UUID objects are equal, false otherwise
-     *
-     */
-    bool IsEqual(const UUID iUUID1, const UUID iUUID2);
+        /// Number of characters of the canonical string form, xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+        static const size_t stringLength_ = 36;
 
-    /**
-     *
-     * @brief Copies a UUID to another UUID
-     *
-     * @param iSource is the UUID to copy
-     * @param oDestination is the destination UUID to copy to
-     * @return true if the UUID objects are equal, false otherwise
-     *
-     */
-    bool Copy(const UUID iSource, UUID oDestination);
+        /// Constructs the nil UUID, all 0s
+        constexpr UUID() : data_() {}
+
+        /**
+         *
+         * Constructs a UUID from its first and last 8 bytes, most significant byte first.
+         * Usable in constant expressions.
+         *
+         * @param iHigh is bytes 0 to 7
+         * @param iLow is bytes 8 to 15
+         *
+         */
+        constexpr UUID(uint64_t iHigh, uint64_t iLow) :
+            data_{  static_cast<uint8_t>(iHigh >> 56), static_cast<uint8_t>(iHigh >> 48)
+                  , static_cast<uint8_t>(iHigh >> 40), static_cast<uint8_t>(iHigh >> 32)
+                  , static_cast<uint8_t>(iHigh >> 24), static_cast<uint8_t>(iHigh >> 16)
+                  , static_cast<uint8_t>(iHigh >> 8), static_cast<uint8_t>(iHigh)
+                  , static_cast<uint8_t>(iLow >> 56), static_cast<uint8_t>(iLow >> 48)
+                  , static_cast<uint8_t>(iLow >> 40), static_cast<uint8_t>(iLow >> 32)
+                  , static_cast<uint8_t>(iLow >> 24), static_cast<uint8_t>(iLow >> 16)
+                  , static_cast<uint8_t>(iLow >> 8), static_cast<uint8_t>(iLow) }
+        {
+        }
+
+        /// Constructs a UUID from 16 bytes
+        explicit UUID(const uint8_t *iBytes)
+        {
+            memcpy(data_, iBytes, sizeInBytes_);
+        }
+
+        /**
+         *
+         * Parses a UUID from hex digits. Each byte is 2 hex digits of either case optionally preceded by a '-',
+         * so both the canonical form and 32 hex digits are accepted. Nothing else may follow the last byte.
+         *
+         * @param iString is the string to parse. It does not need to be nullptr terminated.
+         * @param iLength is the number of characters in iString
+         * @param oUUID is set to the UUID parsed. Unchanged if the string is not a UUID.
+         * @return true if the whole string is a UUID, false otherwise
+         *
+         */
+        static bool Parse(const char *iString, size_t iLength, UUID &oUUID);
+
+        /// Parses a UUID from a std::string. See Parse.
+        static bool FromString(const std::string &iString, UUID &oUUID)
+        {
+            return Parse(iString.data(), iString.size(), oUUID);
+        }
+
+        /// Returns the canonical lower case string form, xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+        std::string ToString(void) const;
+
+        /// Sets the UUID to the nil UUID, all 0s
+        void Clear(void)
+        {
+            memset(data_, 0, sizeInBytes_);
+        }
+
+        /// Returns true if all 16 bytes are 0
+        bool IsNil(void) const
+        {
+            return this->GetHigh() == 0 && this->GetLow() == 0;
+        }
+
+        /// Returns bytes 0 to 7 in memory order
+        uint64_t GetHigh(void) const
+        {
+            uint64_t value;
+            memcpy(&value, data_, sizeof(value));
+            return value;
+        }
+
+        /// Returns bytes 8 to 15 in memory order
+        uint64_t GetLow(void) const
+        {
+            uint64_t value;
+            memcpy(&value, data_ + sizeof(value), sizeof(value));
+            return value;
+        }
+
+        /// Returns a hash of the UUID. UUIDs are already random so the two halves are only mixed.
+        size_t Hash(void) const
+        {
+            return static_cast<size_t>(this->GetHigh() ^ (this->GetLow() * 0x9e3779b97f4a7c15ULL));
+        }
+
+        /// Byte access
+        uint8_t &operator[](size_t iIndex) { return data_[iIndex]; }
+        const uint8_t &operator[](size_t iIndex) const { return data_[iIndex]; }
+
+        /// Returns the 16 bytes
+        uint8_t *data(void) { return data_; }
+        const uint8_t *data(void) const { return data_; }
+
+        /// Iterators over the 16 bytes
+        const uint8_t *begin(void) const { return data_; }
+        const uint8_t *end(void) const { return data_ + sizeInBytes_; }
+
+        bool operator==(const UUID &iOther) const
+        {
+            return this->GetHigh() == iOther.GetHigh() && this->GetLow() == iOther.GetLow();
+        }
+
+        bool operator!=(const UUID &iOther) const
+        {
+            return !(*this == iOther);
+        }
+
+        /// Orders UUIDs by their bytes
+        bool operator<(const UUID &iOther) const
+        {
+            return memcmp(data_, iOther.data_, sizeInBytes_) < 0;
+        }
+
+    private:
+
+        /// The 16 bytes of the UUID in network order
+        uint8_t     data_[sizeInBytes_];
+    };
+
+    /// Used by boost::hash and so boost::unordered_map
+    inline size_t hash_value(const UUID &iUUID)
+    {
+        return iUUID.Hash();
+    }
 
 }  // namespace SMPTE_SYNC
 
+namespace std
+{
+    template <>
+    struct hash<SMPTE_SYNC::UUID>
+    {
+        size_t operator()(const SMPTE_SYNC::UUID &iUUID) const
+        {
+            return iUUID.Hash();
+        }
+    };
+}  // namespace std
+
 #endif // UUID_H
@@ -43,7 +43,7 @@ namespace SMPTE_SYNC
                                        , int32_t iSampleRate) :
           auxDataMgr_(iAuxDataMgr)
         , baseSampleRate_(iSampleRate)
-        , auxData_(nullptr)
+        , auxData_()
         , isValid_(false)
         , timelineEditUnitIndex_(-1)
     {
@@ -70,73 +70,40 @@ namespace SMPTE_SYNC
         //
         // Play State
         //
-        // 1) Fetch the next data item on the queue
+        // 1) Look up the data item of the syncPacket edit unit
         // 2) If this data item matches the syncPacket
         //      Success!
-        // 3) If this data item does not match the syncPacket
-        //      If it comes ealier in the timeline,
-        //          log the error and keep fetching
-        //          if you get to the end of the queue and did not find
-        //          the data item, log the error
+        // 3) If there is no data item for the edit unit
+        //      log the error once per edit unit
         //
-        //      If it comes later in the timeline
-        //          log the error
-        //          hold onto the data item to use for a future syncPacket
+        // Data items stay in the AuxDataMgr after being tested so
+        // a backward seek can be validated without fetching them again.
+        // Items for later edit units are simply left for a future syncPacket.
         //
 
-        do
+        // Edit units behind the sync packet are the first to go when the AuxDataMgr is full
+        //
+        auxDataMgr_->SetPlayhead(iSyncPacket.timelineEditUnitIndex_);
+
+        if (auxDataMgr_->GetDataItem(iSyncPacket.timelineEditUnitIndex_, auxData_))
         {
-            if (auxData_ == nullptr)
-                auxData_ = auxDataMgr_->GetNextDataItem();
-            
-            if (auxData_ != nullptr)
-            {
-                if (this->Test(iSyncPacket, auxData_))
-                {
-                    delete auxData_;
-                    auxData_ = nullptr;
-                    isValid_ = true;
-
-                    //SMPTE_SYNC_LOG << "Valid iSyncPacket = " << iSyncPacket.timelineEditUnitIndex_;
-                    
-                    break;
-                }
-                else
-                if (auxData_->editUnitIndex_ < iSyncPacket.timelineEditUnitIndex_)
-                {
-                    SMPTE_SYNC_LOG << "Dropping earlier AuxDataItem"
-                    << " auxData_->editUnitIndex_ = " << auxData_->editUnitIndex_
-                    << " iSyncPacket.timelineEditUnitIndex_ = " << iSyncPacket.timelineEditUnitIndex_;
-
-                    isValid_ = false;
-
-                    delete auxData_;
-                    auxData_ = auxDataMgr_->GetNextDataItem();
-                }
-                else
-                if (auxData_->editUnitIndex_ > iSyncPacket.timelineEditUnitIndex_)
-                {
-                    SMPTE_SYNC_LOG_LEVEL(trace) << "Found an aux data item that is ahead of the current sync sample time. Hold item until we get to the current sync sample time. "
-                    << " auxData_->editUnitIndex_ = " << auxData_->editUnitIndex_
-                    << " iSyncPacket.timelineEditUnitIndex_ = " << iSyncPacket.timelineEditUnitIndex_;
-                    
-                    isValid_ = false;
-
-                    break;
-                }
-            }
-            else
+            isValid_ = this->Test(iSyncPacket, &auxData_);
+
+            //SMPTE_SYNC_LOG << "Valid iSyncPacket = " << iSyncPacket.timelineEditUnitIndex_;
+        }
+        else
+        {
+            if (iSyncPacket.timelineEditUnitIndex_ != timelineEditUnitIndex_)
             {
-                if (iSyncPacket.timelineEditUnitIndex_ != timelineEditUnitIndex_)
-                {
-                    SMPTE_SYNC_LOG << "No AuxDataItems to test. Not testing syncPacket timelineEditUnitIndex_ = " << timelineEditUnitIndex_ << " iSyncPacket.timelineEditUnitIndex_ = " << iSyncPacket.timelineEditUnitIndex_;
-                }
-                
-                isValid_ = false;
-
-                break;
+                SMPTE_SYNC_LOG << "No AuxDataItem to test. Not testing syncPacket timelineEditUnitIndex_ = " << timelineEditUnitIndex_ << " iSyncPacket.timelineEditUnitIndex_ = " << iSyncPacket.timelineEditUnitIndex_;
             }
-        } while (auxData_ != nullptr);
+            
+            isValid_ = false;
+        }
+
+        // Drop the reference to the payload until the next syncPacket
+        //
+        auxData_ = AuxDataBlock();
         
         // Update the saved edit unit index
         //
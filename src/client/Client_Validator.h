@@ -42,11 +42,11 @@
 
 #include "sync.h"
 #include "DataTypes.h"
+#include "AuxData.h"
 
 namespace SMPTE_SYNC
 {
     class AuxDataMgr;
-    class AuxDataBlock;
 
     /**
      * @brief Callback function for the client to validate the sync signal.
@@ -90,10 +90,9 @@ namespace SMPTE_SYNC
         /**
          *
          * Provides validation checks on the syncPacket object.
-         * Takes the syncPacket object and looks through the queue of aux data items to 
-         * find one that is the same as the syncPacket. If the syncPacket has a greater
-         * edit unit index (timeline timestamp), it stops dequeueing aux data items 
-         * until a syncSignal with a larger edit unit index arrives.
+         * Takes the syncPacket object and looks up the aux data item of its
+         * edit unit index (timeline timestamp) in the AuxDataMgr.
+         * The aux data item stays in the AuxDataMgr for later syncPackets of the same edit unit.
          *
          * @param iSyncPacket syncPacket is the sync signal data to be validated
          *
@@ -119,8 +118,8 @@ namespace SMPTE_SYNC
         /// Sample rate of the sync signal (AES/EBU signal)
         const int32_t   baseSampleRate_;
 
-        /// A pointer to the last dequeued AuxDataBlock. This is the AuxDataBlock that is being tested with the syncSignal
-        AuxDataBlock    *auxData_;
+        /// Copy of the AuxDataBlock being tested with the syncSignal. Shares the payload held by the AuxDataMgr.
+        AuxDataBlock    auxData_;
 
         /**
          *
@@ -93,6 +93,11 @@ namespace SMPTE_SYNC
         io_service_.post(boost::bind(&DCS_Client::DoClose, this));
     }
 
+    void DCS_Client::SetUpdateTimelineCallback(UpdateTimelineCallback iCallback)
+    {
+        updateTimelineCallback_ = iCallback;
+    }
+
     void DCS_Client::HandleConnect(const boost::system::error_code& error)
     {
         if (!error)
@@ -390,6 +395,9 @@ namespace SMPTE_SYNC
             {
                 uint32_t requestID = request->GetRequestID();
                 SMPTE_SYNC_LOG_LEVEL(trace) << "requestID = " << requestID;
+
+                if (updateTimelineCallback_)
+                    updateTimelineCallback_(request->GetTinelinePosition());
                 
                 DCS_Message_UpdateTimelineResponse *response = new DCS_Message_UpdateTimelineResponse();
                 
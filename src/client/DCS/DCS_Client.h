@@ -90,6 +90,9 @@ namespace SMPTE_SYNC
         /// Closes the TCP/IP connection to the DCS_Server
         void Close();
 
+        /// Sets the callback called with the new timeline position of each DCS_Message_UpdateTimelineRequest, such as SS_Client::Seek
+        void SetUpdateTimelineCallback(UpdateTimelineCallback iCallback);
+
     private:
 
         /**
@@ -201,6 +204,9 @@ namespace SMPTE_SYNC
         
         /// Callback installed by the client to provide location of the Aux Data server
         SetRPLLocationCallback      setRPLLocationCallback_;
+
+        /// Callback installed by the client to follow the playhead when the DCS_Server updates the timeline
+        UpdateTimelineCallback      updateTimelineCallback_;
     };
 
 }  // namespace SMPTE_SYNC
@@ -0,0 +1,284 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "PrefetchController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SMPTE_SYNC
+{
+    // Weight of a new sample in the smoothed round trip time, throughput and edit unit size
+    //
+    static const double sSmoothing = 0.25;
+
+    // Multiple of the estimated fetch time kept in hand, covering jitter in the round trip and throughput
+    //
+    static const double sSafetyFactor = 2.0;
+
+    // Milliseconds between checks while the playhead is not moving or the server has nothing more to send
+    //
+    static const int64_t sIdleMilliseconds = 250;
+
+    // Edit units the playhead may get ahead of playback between two samples before it counts as a seek
+    //
+    static const int64_t sSeekToleranceEditUnits = 12;
+
+    // Round trip time assumed until the first response is measured
+    //
+    static const double sInitialRoundTripMilliseconds = 100.0;
+
+    static double Smooth(double iAverage, double iSample)
+    {
+        if (iAverage <= 0.0)
+            return iSample;
+
+        return iAverage + sSmoothing * (iSample - iAverage);
+    }
+
+    PrefetchController::PrefetchController(int32_t iMillisecondsPerFrame
+                                           , int32_t iMaxEditUnitsPerRequest
+                                           , int32_t iTargetHeadroom
+                                           , int32_t iMinimumHeadroom)
+        : millisecondsPerFrame_(std::max(iMillisecondsPerFrame, 1))
+        , maxEditUnitsPerRequest_(std::max(iMaxEditUnitsPerRequest, 1))
+        , targetHeadroom_(std::max(iTargetHeadroom, 1))
+        , minimumHeadroom_(std::max(iMinimumHeadroom, 0))
+        , roundTripMilliseconds_(sInitialRoundTripMilliseconds)
+        , bytesPerMillisecond_(0.0)
+        , bytesPerEditUnit_(0.0)
+        , requestSentTime_(0)
+        , firstByteTime_(0)
+        , lastPlayhead_(-1)
+        , lastPlayheadMoveTime_(0)
+        , lastPlayheadSampleTime_(0)
+        , lastResponseEmpty_(false)
+    {
+    }
+
+    PrefetchController::~PrefetchController()
+    {
+    }
+
+    void PrefetchController::SetMillisecondsPerFrame(int32_t iMilliseconds)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        millisecondsPerFrame_ = std::max(iMilliseconds, 1);
+    }
+
+    void PrefetchController::SetMaxEditUnitsPerRequest(int32_t iEditUnits)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        maxEditUnitsPerRequest_ = std::max(iEditUnits, 1);
+    }
+
+    void PrefetchController::SetTargetHeadroom(int32_t iEditUnits)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        targetHeadroom_ = std::max(iEditUnits, 1);
+    }
+
+    void PrefetchController::SetMinimumHeadroom(int32_t iEditUnits)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        minimumHeadroom_ = std::max(iEditUnits, 0);
+    }
+
+    bool PrefetchController::UpdatePlayhead(int32_t iEditUnit, int64_t iNow)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        bool jumped = false;
+        if (lastPlayhead_ >= 0 && iEditUnit >= 0)
+        {
+            int64_t playedEditUnits = std::max<int64_t>(iNow - lastPlayheadSampleTime_, 0) / millisecondsPerFrame_;
+
+            jumped = iEditUnit < lastPlayhead_
+                || iEditUnit > lastPlayhead_ + playedEditUnits + sSeekToleranceEditUnits;
+        }
+
+        if (iEditUnit != lastPlayhead_)
+        {
+            lastPlayhead_ = iEditUnit;
+            lastPlayheadMoveTime_ = iNow;
+        }
+
+        lastPlayheadSampleTime_ = iNow;
+
+        return jumped;
+    }
+
+    void PrefetchController::OnSeek(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        lastResponseEmpty_ = false;
+        requestSentTime_ = 0;
+        firstByteTime_ = 0;
+    }
+
+    void PrefetchController::OnRequestSent(int64_t iNow)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        requestSentTime_ = iNow;
+        firstByteTime_ = 0;
+    }
+
+    void PrefetchController::OnFirstByte(int64_t iNow)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        if (requestSentTime_ == 0 || firstByteTime_ != 0)
+            return;
+
+        firstByteTime_ = iNow;
+        roundTripMilliseconds_ = Smooth(roundTripMilliseconds_, static_cast<double>(std::max<int64_t>(iNow - requestSentTime_, 0)));
+    }
+
+    void PrefetchController::OnResponseComplete(int32_t iEditUnits, uint64_t iBytes, int64_t iNow)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        lastResponseEmpty_ = (iEditUnits <= 0);
+
+        if (iEditUnits > 0 && iBytes > 0)
+        {
+            bytesPerEditUnit_ = Smooth(bytesPerEditUnit_, static_cast<double>(iBytes) / iEditUnits);
+
+            // Throughput is measured from the first byte so the round trip is not counted twice
+            //
+            int64_t start = firstByteTime_ != 0 ? firstByteTime_ : requestSentTime_;
+            int64_t elapsed = std::max<int64_t>(iNow - start, 1);
+            bytesPerMillisecond_ = Smooth(bytesPerMillisecond_, static_cast<double>(iBytes) / elapsed);
+        }
+
+        requestSentTime_ = 0;
+        firstByteTime_ = 0;
+    }
+
+    int64_t PrefetchController::GetMillisecondsUntilNextRequest(int32_t iHeadroom)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        int32_t trigger = TriggerHeadroom();
+
+        if (iHeadroom <= trigger)
+            return 0;
+
+        if (!Playing() || lastResponseEmpty_)
+            return sIdleMilliseconds;
+
+        return static_cast<int64_t>(iHeadroom - trigger) * millisecondsPerFrame_;
+    }
+
+    int32_t PrefetchController::GetEditUnitsToRequest(int32_t iHeadroom)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        // Top up to the target, plus whatever plays out while the window is in flight
+        //
+        int32_t shortfall = std::max(targetHeadroom_ - std::max(iHeadroom, 0), 0);
+        int32_t editUnits = shortfall + LeadEditUnits(shortfall);
+
+        return std::min(std::max(editUnits, 1), maxEditUnitsPerRequest_);
+    }
+
+    int32_t PrefetchController::GetUrgentEditUnits(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+
+        // The next window is requested once this one completes and its first edit units
+        // arrive a round trip later, so this one only has to cover the round trip
+        //
+        return std::min(std::max(LeadEditUnits(0), 1), maxEditUnitsPerRequest_);
+    }
+
+    int32_t PrefetchController::GetLeadEditUnits(int32_t iEditUnits)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return LeadEditUnits(iEditUnits);
+    }
+
+    int32_t PrefetchController::GetTriggerHeadroom(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return TriggerHeadroom();
+    }
+
+    double PrefetchController::GetRoundTripMilliseconds(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return roundTripMilliseconds_;
+    }
+
+    double PrefetchController::GetBytesPerMillisecond(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return bytesPerMillisecond_;
+    }
+
+    double PrefetchController::GetBytesPerEditUnit(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return bytesPerEditUnit_;
+    }
+
+    bool PrefetchController::IsPlaying(void)
+    {
+        boost::mutex::scoped_lock lock(controllerMutex_);
+        return Playing();
+    }
+
+    int32_t PrefetchController::LeadEditUnits(int32_t iEditUnits) const
+    {
+        double fetchMilliseconds = roundTripMilliseconds_;
+
+        if (bytesPerMillisecond_ > 0.0)
+            fetchMilliseconds += std::max(iEditUnits, 0) * bytesPerEditUnit_ / bytesPerMillisecond_;
+
+        return static_cast<int32_t>(std::ceil(sSafetyFactor * fetchMilliseconds / millisecondsPerFrame_));
+    }
+
+    bool PrefetchController::Playing(void) const
+    {
+        // Playback has stopped once the playhead stays put for longer than a couple of frames
+        //
+        return lastPlayhead_ >= 0 && (lastPlayheadSampleTime_ - lastPlayheadMoveTime_) <= 2 * millisecondsPerFrame_;
+    }
+
+    int32_t PrefetchController::TriggerHeadroom(void) const
+    {
+        // The window requested at the trigger is the target less the trigger, so estimate its lead from that
+        //
+        int32_t window = std::min(std::max(targetHeadroom_ - minimumHeadroom_, 1), maxEditUnitsPerRequest_);
+
+        return std::min(std::max(minimumHeadroom_, LeadEditUnits(window)), targetHeadroom_);
+    }
+
+}  // namespace SMPTE_SYNC
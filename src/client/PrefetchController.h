@@ -0,0 +1,226 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef PREFETCHCONTROLLER_H
+#define PREFETCHCONTROLLER_H
+
+#include <stdint.h>
+
+#include "boost/thread/mutex.hpp"
+
+namespace SMPTE_SYNC
+{
+    /**
+     * @brief PrefetchController class decides when the SS_Client requests the next window of aux data items and how large it is.
+     *
+     * The controller measures the round trip time to the first byte of each response, the throughput of the
+     * content and the average size of an edit unit. From those it estimates the lead, the number of edit units
+     * played while a window is being fetched. The next request is due when the buffered headroom ahead of the
+     * playhead falls to the trigger headroom, the larger of the minimum headroom and the lead. The window
+     * is sized to bring the headroom back to the target headroom once it arrives, so as few requests as
+     * possible are made. While the playhead is not moving no request is due until the headroom falls to the trigger.
+     *
+     * Times are passed in as milliseconds from any fixed origin so the controller can be driven by tests. Threadsafe.
+     *
+     */
+    class PrefetchController
+    {
+    public:
+
+        /**
+         *
+         * Constructor
+         *
+         * @param iMillisecondsPerFrame is the number of milliseconds in a frame
+         * @param iMaxEditUnitsPerRequest is the largest window that can be requested
+         * @param iTargetHeadroom is the number of edit units ahead of the playhead to keep buffered
+         * @param iMinimumHeadroom is the number of edit units ahead of the playhead at which a request is always due
+         *
+         */
+        PrefetchController(int32_t iMillisecondsPerFrame
+                           , int32_t iMaxEditUnitsPerRequest
+                           , int32_t iTargetHeadroom
+                           , int32_t iMinimumHeadroom);
+
+        /// Destructor
+        ~PrefetchController();
+
+        /// Sets the number of milliseconds in a frame
+        void SetMillisecondsPerFrame(int32_t iMilliseconds);
+
+        /// Sets the largest window that can be requested
+        void SetMaxEditUnitsPerRequest(int32_t iEditUnits);
+
+        /// Sets the number of edit units ahead of the playhead to keep buffered
+        void SetTargetHeadroom(int32_t iEditUnits);
+
+        /// Sets the number of edit units ahead of the playhead at which a request is always due
+        void SetMinimumHeadroom(int32_t iEditUnits);
+
+        /**
+         *
+         * Samples the playhead to tell whether playback is moving or has jumped.
+         *
+         * @param iEditUnit is the current edit unit of the playhead
+         * @param iNow is the current time in milliseconds
+         * @return true if the playhead moved backwards or further forwards than playback since the last sample allows
+         *
+         */
+        bool UpdatePlayhead(int32_t iEditUnit, int64_t iNow);
+
+        /**
+         *
+         * Called after a seek. Forgets an empty last response and the request in flight.
+         * The playhead samples are left alone, they catch up with the seek on their own.
+         *
+         */
+        void OnSeek(void);
+
+        /// Records that a request has been sent at iNow milliseconds
+        void OnRequestSent(int64_t iNow);
+
+        /// Records that the first byte of the response arrived at iNow milliseconds. Samples the round trip time.
+        void OnFirstByte(int64_t iNow);
+
+        /**
+         *
+         * Records that a response completed. Samples the throughput and the size of an edit unit.
+         *
+         * @param iEditUnits is the number of edit units in the response
+         * @param iBytes is the number of bytes of content in the response
+         * @param iNow is the current time in milliseconds
+         *
+         */
+        void OnResponseComplete(int32_t iEditUnits, uint64_t iBytes, int64_t iNow);
+
+        /**
+         *
+         * Gets the number of milliseconds until the next request is due.
+         *
+         * @param iHeadroom is the number of edit units buffered ahead of the playhead
+         * @return 0 if a request is due now
+         *
+         */
+        int64_t GetMillisecondsUntilNextRequest(int32_t iHeadroom);
+
+        /**
+         *
+         * Gets the size of the next window.
+         *
+         * @param iHeadroom is the number of edit units buffered ahead of the playhead
+         * @return the number of edit units to request, between 1 and the largest window
+         *
+         */
+        int32_t GetEditUnitsToRequest(int32_t iHeadroom);
+
+        /**
+         *
+         * Gets the size of the first window after a seek.
+         * Only covers the round trip of the larger window that follows it, so it arrives as soon as possible.
+         *
+         * @return the number of edit units to request, between 1 and the largest window
+         *
+         */
+        int32_t GetUrgentEditUnits(void);
+
+        /// Gets the number of edit units played while iEditUnits edit units are being fetched, with a safety margin
+        int32_t GetLeadEditUnits(int32_t iEditUnits);
+
+        /// Gets the headroom at which the next request is due
+        int32_t GetTriggerHeadroom(void);
+
+        /// Gets the smoothed round trip time to the first byte of a response in milliseconds
+        double GetRoundTripMilliseconds(void);
+
+        /// Gets the smoothed throughput of response content in bytes per millisecond. 0 until measured.
+        double GetBytesPerMillisecond(void);
+
+        /// Gets the smoothed size of an edit unit in bytes. 0 until measured.
+        double GetBytesPerEditUnit(void);
+
+        /// Returns true if the playhead moved recently
+        bool IsPlaying(void);
+
+    private:
+
+        /// Implements GetLeadEditUnits. Expects controllerMutex_ to be held.
+        int32_t LeadEditUnits(int32_t iEditUnits) const;
+
+        /// Implements GetTriggerHeadroom. Expects controllerMutex_ to be held.
+        int32_t TriggerHeadroom(void) const;
+
+        /// Implements IsPlaying. Expects controllerMutex_ to be held.
+        bool Playing(void) const;
+
+        /// Guards every member
+        boost::mutex    controllerMutex_;
+
+        /// Number of milliseconds in a frame
+        int32_t         millisecondsPerFrame_;
+
+        /// Largest window that can be requested
+        int32_t         maxEditUnitsPerRequest_;
+
+        /// Number of edit units ahead of the playhead to keep buffered
+        int32_t         targetHeadroom_;
+
+        /// Number of edit units ahead of the playhead at which a request is always due
+        int32_t         minimumHeadroom_;
+
+        /// Smoothed round trip time to the first byte in milliseconds
+        double          roundTripMilliseconds_;
+
+        /// Smoothed throughput in bytes per millisecond
+        double          bytesPerMillisecond_;
+
+        /// Smoothed size of an edit unit in bytes
+        double          bytesPerEditUnit_;
+
+        /// Time the current request was sent
+        int64_t         requestSentTime_;
+
+        /// Time the first byte of the current response arrived
+        int64_t         firstByteTime_;
+
+        /// Last sampled playhead. -1 before the first sample.
+        int32_t         lastPlayhead_;
+
+        /// Time the playhead was last seen moving
+        int64_t         lastPlayheadMoveTime_;
+
+        /// Time of the last playhead sample
+        int64_t         lastPlayheadSampleTime_;
+
+        /// Set when the last response had no edit units, such as at the end of the show
+        bool            lastResponseEmpty_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // PREFETCHCONTROLLER_H
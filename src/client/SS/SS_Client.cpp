@@ -35,6 +35,17 @@
 
 namespace SMPTE_SYNC
 {
+    // Value of seekEditUnit_ when there is no seek to handle
+    //
+    static const int32_t sNoSeek = -1;
+
+    // Milliseconds since the epoch, the clock the PrefetchController is driven by
+    //
+    static int64_t GetMilliseconds(void)
+    {
+        static const boost::posix_time::ptime sEpoch(boost::gregorian::date(1970, 1, 1));
+        return (boost::get_system_time() - sEpoch).total_milliseconds();
+    }
 
     SS_Client::SS_Client(boost::asio::io_service& io_service
                          , AuxDataMgr *iAuxDataMgr
@@ -45,27 +56,41 @@ namespace SMPTE_SYNC
                          , const std::string& iCodingUL
                          , const std::string& iEncryptionType
                          , CurrentFrameCallback iCallback)
-    :   resolver_(io_service)
+    :   io_service_(io_service)
+        , resolver_(io_service)
         , socket_(io_service)
-        , auxDataMgr_(iAuxDataMgr)
-        , currentFrameCallback_(iCallback)
-        , keepRequestingAuxDataItem_(true)
-        , pauseRequestAuxDataItem_(true)
-        , getInProgress_(false)
-        , port_("")
+        , retryTimer_(io_service)
+        , streamParser_(iAuxDataMgr)
         , server_("")
+        , port_("")
+        , codingUL_(iCodingUL)
         , startEditUnit_(0)
+        , getInProgress_(false)
+        , requestNumber_(0)
+        , seekEditUnit_(sNoSeek)
+        , seekInProgress_(false)
         , editUnitsPerRequest_(iEditUnitsPerRequest) // approximately 10 seconds
+        , editUnitsToRequest_(iEditUnitsPerRequest)
+        , responseBytes_(0)
+        , encryptionType_(iEncryptionType)
         , editUnitsAheadOfCurrentEditUnitToRequest_(iEditUnitsAheadOfCurrentEditUnitToRequest) // approximately 10 seconds
         , editUnitsAheadOfCurrentEditUnitToInitiateRequest_(iEditUnitsAheadOfCurrentEditUnitToInitiateRequest) // approximately 5 seconds
+        , auxDataMgr_(iAuxDataMgr)
+        , keepRequestingAuxDataItem_(true)
+        , currentFrameCallback_(iCallback)
         , millisecondsPerFrame_(iMillisecondsPerFrame) // 1000 / 24
-        , codingUL_(iCodingUL)
-        , encryptionType_(iEncryptionType)
+        , prefetchController_(iMillisecondsPerFrame
+                              , iEditUnitsPerRequest
+                              , iEditUnitsAheadOfCurrentEditUnitToRequest
+                              , iEditUnitsAheadOfCurrentEditUnitToInitiateRequest)
     {
     }
     
     SS_Client::~SS_Client()
     {
+        boost::system::error_code ignored_ec;
+        retryTimer_.cancel(ignored_ec);
+
         keepRequestingAuxDataItem_ = false;
         runRequestAuxDataItem_.notify_one();
         fetchAuxDataItemThread_.join();
@@ -114,7 +139,8 @@ namespace SMPTE_SYNC
             // Kick off our first fetch of data
             //
             std::string path = this->BuildPath();
-            this->GET(path);
+            if (!path.empty())
+                this->GET(path);
 
             // Now that we have a valid IP and port of the server
             // spin up the thread
@@ -135,8 +161,16 @@ namespace SMPTE_SYNC
         
         getInProgress_ = true;
 
+        // Handlers carry the number of their request so they can tell when a seek cancelled it
+        //
+        uint32_t request = ++requestNumber_;
+
         this->SetState(eState_Buffering);
 
+        streamParser_.Reset();
+        responseBytes_ = 0;
+        prefetchController_.OnRequestSent(GetMilliseconds());
+
         // Form the request. We specify the "Connection: close" header so that the
         // server will close the socket after transmitting the response. This will
         // allow us to treat all data up until the EOF as the content.
@@ -153,19 +187,25 @@ namespace SMPTE_SYNC
         resolver_.async_resolve(query,
                                 boost::bind(&SS_Client::handle_resolve, this,
                                             boost::asio::placeholders::error,
-                                            boost::asio::placeholders::iterator));
+                                            boost::asio::placeholders::iterator,
+                                            request));
     }
 
     void SS_Client::handle_resolve(const boost::system::error_code& err,
-                        tcp::resolver::iterator endpoint_iterator)
+                        tcp::resolver::iterator endpoint_iterator,
+                        uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
             // Attempt a connection to each endpoint in the list until we
             // successfully establish a connection.
             boost::asio::async_connect(socket_, endpoint_iterator,
                                        boost::bind(&SS_Client::handle_connect, this,
-                                                   boost::asio::placeholders::error));
+                                                   boost::asio::placeholders::error,
+                                                   iRequest));
         }
         else
         {
@@ -174,8 +214,11 @@ namespace SMPTE_SYNC
         }
     }
     
-    void SS_Client::handle_connect(const boost::system::error_code& err)
+    void SS_Client::handle_connect(const boost::system::error_code& err, uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
             this->SetState(eState_Connected);
@@ -183,7 +226,8 @@ namespace SMPTE_SYNC
             // The connection was successful. Send the request.
             boost::asio::async_write(socket_, request_,
                                      boost::bind(&SS_Client::handle_write_request, this,
-                                                 boost::asio::placeholders::error));
+                                                 boost::asio::placeholders::error,
+                                                 iRequest));
         }
         else
         {
@@ -192,8 +236,11 @@ namespace SMPTE_SYNC
         }
     }
     
-    void SS_Client::handle_write_request(const boost::system::error_code& err)
+    void SS_Client::handle_write_request(const boost::system::error_code& err, uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
             // Read the response status line. The response_ streambuf will
@@ -201,7 +248,8 @@ namespace SMPTE_SYNC
             // limited by passing a maximum size to the streambuf constructor.
             boost::asio::async_read_until(socket_, response_, "\r\n",
                                           boost::bind(&SS_Client::handle_read_status_line, this,
-                                                      boost::asio::placeholders::error));
+                                                      boost::asio::placeholders::error,
+                                                      iRequest));
         }
         else
         {
@@ -210,10 +258,15 @@ namespace SMPTE_SYNC
         }
     }
     
-    void SS_Client::handle_read_status_line(const boost::system::error_code& err)
+    void SS_Client::handle_read_status_line(const boost::system::error_code& err, uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
+            prefetchController_.OnFirstByte(GetMilliseconds());
+
             // Check that response is OK.
             std::istream response_stream(&response_);
             std::string http_version;
@@ -232,13 +285,20 @@ namespace SMPTE_SYNC
             {
                 SMPTE_SYNC_LOG << "Response returned with status code ";
                 SMPTE_SYNC_LOG << status_code;
+
+                // Read the headers to find out when the server wants us to retry
+                boost::asio::async_read_until(socket_, response_, "\r\n\r\n",
+                                              boost::bind(&SS_Client::handle_read_error_headers, this,
+                                                          boost::asio::placeholders::error,
+                                                          iRequest));
                 return;
             }
             
             // Read the response headers, which are terminated by a blank line.
             boost::asio::async_read_until(socket_, response_, "\r\n\r\n",
                                           boost::bind(&SS_Client::handle_read_headers, this,
-                                                      boost::asio::placeholders::error));
+                                                      boost::asio::placeholders::error,
+                                                      iRequest));
         }
         else
         {
@@ -247,8 +307,11 @@ namespace SMPTE_SYNC
         }
     }
     
-    void SS_Client::handle_read_headers(const boost::system::error_code& err)
+    void SS_Client::handle_read_headers(const boost::system::error_code& err, uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
             // Process the response headers.
@@ -260,77 +323,108 @@ namespace SMPTE_SYNC
             }
             //SMPTE_SYNC_LOG;
             
-            // Write whatever content we already have to output.
-            if (response_.size() > 0)
+            // Decode whatever content was read along with the headers
+            boost::asio::streambuf::const_buffers_type content = response_.data();
+            responseBytes_ += boost::asio::buffer_size(content);
+            bool valid = streamParser_.Append(boost::asio::buffer_cast<const uint8_t*>(content),
+                                              boost::asio::buffer_size(content));
+            response_.consume(response_.size());
+
+            if (!valid)
             {
-                std::ostringstream ss;
-                ss << &response_;
-                
-                responsePayload_ = ss.str();
+                this->HandleMalformedResponse();
+                return;
+            }
 
-                //SMPTE_SYNC_LOG << "SS_Client::handle_read_headers\n";
-                //SMPTE_SYNC_LOG << responsePayload_;
+            if (streamParser_.GetState() == AuxDataStreamParser::eState_Full)
+            {
+                this->HandlePartialResponse();
+                return;
             }
+
             // Start reading remaining data until EOF.
-            boost::asio::async_read(socket_, response_,
-                                    boost::asio::transfer_at_least(1),
-                                    boost::bind(&SS_Client::handle_read_content, this,
-                                                boost::asio::placeholders::error));
+            this->ReadContent(iRequest);
         }
         else
         {
             SMPTE_SYNC_LOG << "SS_Client::handle_read_headers Error: " << err;
-            responsePayload_.clear();
             this->HandleError();
         }
     }
     
-    void SS_Client::handle_read_content(const boost::system::error_code& err)
+    void SS_Client::ReadContent(uint32_t iRequest)
+    {
+        // Read straight into the receive buffer the AuxDataBlock objects reference
+        //
+        size_t size = 0;
+        uint8_t *buffer = streamParser_.PrepareReceive(size);
+
+        socket_.async_read_some(boost::asio::buffer(buffer, size),
+                                boost::bind(&SS_Client::handle_read_content, this,
+                                            boost::asio::placeholders::error,
+                                            boost::asio::placeholders::bytes_transferred,
+                                            iRequest));
+    }
+
+    void SS_Client::handle_read_content(const boost::system::error_code& err, std::size_t bytes_transferred, uint32_t iRequest)
     {
+        if (this->IsCancelled(iRequest))
+            return;
+
         if (!err)
         {
-            // Write all of the data that has been read so far.
-            std::ostringstream ss;
-            ss << &response_;
-            
-            responsePayload_ += ss.str();
+            responseBytes_ += bytes_transferred;
 
-            //SMPTE_SYNC_LOG << "SS_Client::handle_read_content\n";
-            //SMPTE_SYNC_LOG << responsePayload_;
+            // Queue every AuxDataBlock that has been completed by this read.
+            if (!streamParser_.CommitReceive(bytes_transferred))
+            {
+                this->HandleMalformedResponse();
+                return;
+            }
+
+            if (streamParser_.GetState() == AuxDataStreamParser::eState_Full)
+            {
+                this->HandlePartialResponse();
+                return;
+            }
 
             // Continue reading remaining data until EOF.
-            boost::asio::async_read(socket_, response_,
-                                    boost::asio::transfer_at_least(1),
-                                    boost::bind(&SS_Client::handle_read_content, this,
-                                                boost::asio::placeholders::error));
+            this->ReadContent(iRequest);
         }
         else if (err == boost::asio::error::eof)
         {
             //SMPTE_SYNC_LOG << "SS_Client::handle_read_content EOF\n" << std::flush;
-            //SMPTE_SYNC_LOG << "responsePayload_\n" << responsePayload_ << std::endl;
-            
-            int32_t bytesConsumed = 0;
-            int32_t payloadLength = static_cast<int32_t>(responsePayload_.length());
-            uint8_t *dataBuf = new uint8_t[payloadLength];
-            uint8_t *dataBufOrig = dataBuf;
-            
-            memcpy(dataBuf, responsePayload_.data(), payloadLength);
 
-            // Read the header
+            // Every complete AuxDataBlock has already been queued while reading
             //
-            AuxDataBlockTransferHeader header;
-            header.read(&dataBuf);
-            bytesConsumed += header.GetSizeInBytes();
+            responseBytes_ += bytes_transferred;
 
-            while (bytesConsumed < payloadLength)
+            if (bytes_transferred > 0 && !streamParser_.CommitReceive(bytes_transferred))
             {
-                AuxDataBlock *item = new AuxDataBlock();
-                item->read(&dataBuf);
-                bytesConsumed += item->GetSizeInBytes();
-                
-                auxDataMgr_->AddDataItem(item);
+                this->HandleMalformedResponse();
+                return;
             }
-            
+
+            if (!streamParser_.HasHeader())
+            {
+                SMPTE_SYNC_LOG << "SS_Client::handle_read_content response ended before the AuxDataBlockTransferHeader";
+                this->HandleError();
+                return;
+            }
+
+            if (streamParser_.GetState() == AuxDataStreamParser::eState_Full || streamParser_.GetPendingBytes() > 0)
+            {
+                // The response was cut short in the middle of a AuxDataBlock
+                //
+                SMPTE_SYNC_LOG << "SS_Client::handle_read_content response truncated, " << streamParser_.GetPendingBytes() << " bytes of an incomplete AuxDataBlock dropped" << std::endl;
+                this->HandlePartialResponse();
+                return;
+            }
+
+            const AuxDataBlockTransferHeader &header = streamParser_.GetHeader();
+
+            prefetchController_.OnResponseComplete(header.editUnitRangeCount_, responseBytes_, GetMilliseconds());
+
             {
                 boost::mutex::scoped_lock path_lock(buildPathMutex_);
                 
@@ -353,27 +447,134 @@ namespace SMPTE_SYNC
                 getInProgress_ = false;
             }
 
-            delete [] dataBufOrig;
-            responsePayload_.clear();
+            // Schedule the next request now that the headroom has grown
+            //
+            runRequestAuxDataItem_.notify_one();
         }
         else if (err != boost::asio::error::eof)
         {
             SMPTE_SYNC_LOG << "SS_Client::handle_read_content Error: " << err;
-            responsePayload_.clear();
             this->HandleError();
         }
     }
 
+    void SS_Client::HandlePartialResponse(void)
+    {
+        boost::system::error_code ignored_ec;
+        socket_.close(ignored_ec);
+
+        prefetchController_.OnResponseComplete(static_cast<int32_t>(streamParser_.GetBlockCount()), responseBytes_, GetMilliseconds());
+
+        {
+            boost::mutex::scoped_lock path_lock(buildPathMutex_);
+
+            // Resume after the last edit unit that was stored
+            //
+            if (streamParser_.GetBlockCount() > 0)
+                startEditUnit_ = streamParser_.GetLastEditUnitIndex() + 1;
+            else
+                startEditUnit_ = streamParser_.GetHeader().editUnitRangeStartIndex_;
+
+            SMPTE_SYNC_LOG << "SS_Client::HandlePartialResponse " << streamParser_.GetBlockCount() << " blocks stored, startEditUnit_ - " << startEditUnit_;
+
+            // Clear the flag for waiting on a response
+            // such that we can make another request
+            //
+            getInProgress_ = false;
+        }
+
+        runRequestAuxDataItem_.notify_one();
+    }
+
+    void SS_Client::HandleMalformedResponse(void)
+    {
+        SMPTE_SYNC_LOG << "SS_Client::HandleMalformedResponse malformed response after " << streamParser_.GetBlockCount() << " blocks";
+
+        boost::system::error_code ignored_ec;
+        socket_.close(ignored_ec);
+
+        this->HandleError();
+    }
+
+    void SS_Client::handle_read_error_headers(const boost::system::error_code& err, uint32_t iRequest)
+    {
+        if (this->IsCancelled(iRequest))
+            return;
+
+        if (err)
+        {
+            SMPTE_SYNC_LOG << "SS_Client::handle_read_error_headers Error: " << err;
+            this->HandleError();
+            return;
+        }
+
+        static const std::string sRetryAfter = "Retry-After:";
+
+        // Without a Retry-After header wait a frame so we do not spin on a failing request
+        //
+        int32_t millisecondsToWait = millisecondsPerFrame_;
+
+        std::istream response_stream(&response_);
+        std::string header;
+        while (std::getline(response_stream, header) && header != "\r")
+        {
+            if (header.compare(0, sRetryAfter.length(), sRetryAfter) == 0)
+            {
+                int32_t seconds = atoi(header.substr(sRetryAfter.length()).c_str());
+                if (seconds > 0)
+                    millisecondsToWait = seconds * 1000;
+            }
+        }
+
+        response_.consume(response_.size());
+
+        boost::system::error_code ignored_ec;
+        socket_.close(ignored_ec);
+
+        SMPTE_SYNC_LOG << "SS_Client::handle_read_error_headers retrying in " << millisecondsToWait << "ms";
+
+        retryTimer_.expires_from_now(boost::posix_time::milliseconds(millisecondsToWait));
+        retryTimer_.async_wait(boost::bind(&SS_Client::handle_retry_timer, this,
+                                           boost::asio::placeholders::error,
+                                           iRequest));
+    }
+
+    void SS_Client::handle_retry_timer(const boost::system::error_code& err, uint32_t iRequest)
+    {
+        if (err == boost::asio::error::operation_aborted || this->IsCancelled(iRequest))
+            return;
+
+        {
+            boost::mutex::scoped_lock path_lock(buildPathMutex_);
+
+            // Clear the flag for waiting on a response
+            // such that we can make another request
+            //
+            getInProgress_ = false;
+        }
+
+        runRequestAuxDataItem_.notify_one();
+    }
+
     std::string SS_Client::BuildPath(void)
     {
         std::string path = "";
         
         boost::mutex::scoped_lock path_lock(buildPathMutex_);
 
+        // Only ask for what the AuxDataMgr has room for
+        //
+        int32_t count = std::min(editUnitsToRequest_, editUnitsPerRequest_);
+        if (auxDataMgr_ != nullptr && count > 0)
+            count = auxDataMgr_->GetEditUnitsWithinBudget(std::max(startEditUnit_, 0), count);
+
+        if (count <= 0)
+            return path;
+
         path = std::string("/v1/auxdata/editunits?coding_UL=")
         + codingUL_
         + std::string("&start=") + std::to_string(startEditUnit_)
-        + std::string("&count=") + std::to_string(editUnitsPerRequest_)
+        + std::string("&count=") + std::to_string(count)
         + std::string("&accept=") + encryptionType_
         ;
         
@@ -388,6 +589,7 @@ namespace SMPTE_SYNC
             boost::mutex::scoped_lock path_lock(buildPathMutex_);
             editUnitsPerRequest_ = iUnits;
         }
+        prefetchController_.SetMaxEditUnitsPerRequest(iUnits);
         this->BuildPath();
     }
     
@@ -399,6 +601,7 @@ namespace SMPTE_SYNC
     void SS_Client::SetEditUnitsAheadOfCurrentEditUnitToRequest(int32_t iUnits)
     {
         editUnitsAheadOfCurrentEditUnitToRequest_ = iUnits;
+        prefetchController_.SetTargetHeadroom(iUnits);
         this->BuildPath();
     }
 
@@ -410,6 +613,7 @@ namespace SMPTE_SYNC
     void SS_Client::SetEditUnitsAheadOfCurrentEditUnitToInitiateRequest(int32_t iUnits)
     {
         editUnitsAheadOfCurrentEditUnitToInitiateRequest_ = iUnits;
+        prefetchController_.SetMinimumHeadroom(iUnits);
     }
     
     int32_t SS_Client::GetEditUnitsAheadOfCurrentEditUnitToInitiateRequest(void)
@@ -420,6 +624,7 @@ namespace SMPTE_SYNC
     void SS_Client::SetMillisecondsPerFrame(int32_t iMilliseconds)
     {
         millisecondsPerFrame_ = iMilliseconds;
+        prefetchController_.SetMillisecondsPerFrame(iMilliseconds);
     }
     
     int32_t SS_Client::GetMillisecondsPerFrame(void)
@@ -432,6 +637,7 @@ namespace SMPTE_SYNC
         float frameRate = static_cast<float>(iNumerator) / static_cast<float>(iDenominator);
         
         millisecondsPerFrame_ = 1000 / frameRate;
+        prefetchController_.SetMillisecondsPerFrame(millisecondsPerFrame_);
     }
     
     void SS_Client::SetCodingUL(const std::string &iCodingUL)
@@ -470,188 +676,243 @@ namespace SMPTE_SYNC
         {
             {
                 boost::mutex::scoped_lock scoped_lock(runAuxDataItemMutex_);
-                while (pauseRequestAuxDataItem_ && keepRequestingAuxDataItem_)
+
+                if (!keepRequestingAuxDataItem_)
+                    break;
+
+                int32_t currentFrame = 0;
+                if (currentFrameCallback_)
+                    currentFrame = currentFrameCallback_();
+
+                // Edit units behind the playhead are the first to go when the AuxDataMgr is full
+                //
+                if (currentFrame >= 0)
+                    auxDataMgr_->SetPlayhead(currentFrame);
+
+                bool jumped = prefetchController_.UpdatePlayhead(currentFrame, GetMilliseconds());
+
+                // Either the DCS_Server moved the timeline or the current frame jumped
+                //
+                int32_t seekEditUnit = seekEditUnit_.exchange(sNoSeek);
+                if (seekEditUnit == sNoSeek && jumped)
+                    seekEditUnit = currentFrame;
+
+                if (seekEditUnit != sNoSeek)
+                {
+                    this->RecoverFromSeek(scoped_lock, seekEditUnit);
+                    continue;
+                }
+
+                bool inProgress = false;
+                int32_t headroom = 0;
+                {
+                    boost::mutex::scoped_lock path_lock(buildPathMutex_);
+                    inProgress = getInProgress_;
+
+                    // Everything before startEditUnit_ has been requested and received
+                    //
+                    headroom = std::max(startEditUnit_ - currentFrame, 0);
+                }
+
+                SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem"
+                << " getInProgress_ = " << (inProgress ? "true" : "false")
+                << " headroom - " << headroom
+                << " currentFrame - " << currentFrame
+                << std::endl;
+
+                if (inProgress)
                 {
-                    int32_t currentFrame = 0;
-                    if (currentFrameCallback_)
-                        currentFrame = currentFrameCallback_();
-                    
-                    SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem"
-                    << " getInProgress_ = " << (getInProgress_ ? "true" : "false")
-                    << " startEditUnit_ - " << startEditUnit_
-                    << " currentFrame - " << currentFrame
-                    << std::endl;
-
-                    if (getInProgress_)
+                    // A get has already been sent and we are still waiting for a response.
+                    // Sleep until it completes or the next request would be due, at least a frame
+                    // so a failed request is not retried in a tight loop.
+                    //
+                    if (headroom == 0)
                     {
-                        // A get has already been sent and we are still waiting for a response
+                        // We've blown our deadline
+                        // Just keep checking and warning
                         //
-                        if (currentFrame > startEditUnit_)
-                        {
-                            // We've blown our deadline
-                            // Just keep checking and warning
-                            //
-                            SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem deadline missed, keep looping " << std::endl;
-                        }
-                        else
-                        {
-                            // Go back to sleep
-                            //
-                            // Compute the time to fetch data.
-                            // This will be the data point we need to fetch minus our fetch ahead buffer
-                            //
-                            int32_t frameToStartNextFetchOn = 0;
-
-                            {
-                                boost::mutex::scoped_lock path_lock(buildPathMutex_);
-                                frameToStartNextFetchOn = (startEditUnit_ + editUnitsAheadOfCurrentEditUnitToRequest_) - editUnitsAheadOfCurrentEditUnitToInitiateRequest_;
-                            }
-
-                            int32_t framesToWait = 0;
-                            if (currentFrame <= frameToStartNextFetchOn)
-                            {
-                                framesToWait = frameToStartNextFetchOn - currentFrame;
-                            }
-                            else
-                            {
-                                //SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem Less time to fetch than required!\n";
-                            }
-                            
-                            int32_t millisecondsToWait = framesToWait * millisecondsPerFrame_;
-                            boost::posix_time::milliseconds wait_duration(millisecondsToWait);
-
-                            boost::system_time currentTime = boost::get_system_time();
-                            boost::system_time const timeout = currentTime + wait_duration;
-                            
-                            runRequestAuxDataItem_.timed_wait(scoped_lock, timeout);
-
-                            boost::posix_time::time_duration diff = boost::get_system_time() - currentTime;
-                            SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem slept = " << diff.total_milliseconds() << "ms";
-                        }
+                        SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem deadline missed, keep looping " << std::endl;
                     }
-                    else
+
+                    int64_t millisecondsToWait = std::max<int64_t>(prefetchController_.GetMillisecondsUntilNextRequest(headroom), millisecondsPerFrame_);
+
+                    runRequestAuxDataItem_.timed_wait(scoped_lock, boost::get_system_time() + boost::posix_time::milliseconds(millisecondsToWait));
+                    continue;
+                }
+
+                int64_t millisecondsToWait = prefetchController_.GetMillisecondsUntilNextRequest(headroom);
+                if (millisecondsToWait > 0)
+                {
+                    this->SetState(eState_Buffered);
+
+                    SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem about to sleep "
+                    << "wait_duration = " << millisecondsToWait
+                    << " triggerHeadroom = " << prefetchController_.GetTriggerHeadroom()
+                    << " roundTrip = " << prefetchController_.GetRoundTripMilliseconds() << "ms"
+                    << " throughput = " << prefetchController_.GetBytesPerMillisecond() << " bytes/ms";
+
+                    runRequestAuxDataItem_.timed_wait(scoped_lock, boost::get_system_time() + boost::posix_time::milliseconds(millisecondsToWait));
+                    continue;
+                }
+
+                {
+                    boost::mutex::scoped_lock path_lock(buildPathMutex_);
+
+                    // If our position of our next aux data item fetch is
+                    // less than the current position, we are in an
+                    // underflow situation.
+                    //
+                    // Skip ahead by what will play out while the request is in flight.
+                    //
+                    if (currentFrame > startEditUnit_)
                     {
-                        int32_t frameToStartNextFetchOn = 0;
-                        {
-                            boost::mutex::scoped_lock path_lock(buildPathMutex_);
-
-                            // If our position of our next aux data item fetch is
-                            // less than the current position, we are in an
-                            // underflow situation.
-                            //
-                            // We need to update the value for what we aux data item
-                            // we need to fecth.
-                            //
-                            if (currentFrame > startEditUnit_)
-                                startEditUnit_ = currentFrame + editUnitsAheadOfCurrentEditUnitToRequest_;
-                            
-                            // Compute the time to fetch data.
-                            // This will be the data point we need to fetch minus our fetch ahead buffer
-                            //
-                            frameToStartNextFetchOn = startEditUnit_ - editUnitsAheadOfCurrentEditUnitToInitiateRequest_;
-
-                            if (frameToStartNextFetchOn < 0)
-                                frameToStartNextFetchOn = 0;
-                        }
-                        
-                        boost::system_time currentTime = boost::get_system_time();
-
-                        int32_t framesToWait = 0;
-                        if (currentFrame <= frameToStartNextFetchOn)
-                        {
-                            framesToWait = frameToStartNextFetchOn - currentFrame;
-                        }
-                        else
-                        {
-                            //SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem Less time to fetch than required!\n";
-                        }
-                        
-                        int32_t millisecondsToWait = framesToWait * millisecondsPerFrame_;
-                        boost::posix_time::milliseconds wait_duration(millisecondsToWait);
-                        
-                        SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem about to sleep "
-                        << "wait_duration = "
-                        << wait_duration.total_milliseconds()
-                        << " currentFrame = "
-                        << currentFrame
-                        << " frameToStartNextFetchOn = "
-                        << frameToStartNextFetchOn
-                        << " startEditUnit_ = "
-                        << startEditUnit_;
-                        
-                        boost::system_time const timeout = currentTime + wait_duration;
-
-                        // We aren't checking the return value since
-                        // we really just want to make a new request
-                        // if for some reason we request too soon
-                        // the request will do the right thing and return
-                        // an error code.
-                        //
-                        if (framesToWait > 0)
-                        {
-                            this->SetState(eState_Buffered);
-                            runRequestAuxDataItem_.timed_wait(scoped_lock, timeout);
-
-                            // Check time of the frames
-                            // now that we have woken up
-                            //
-                            if (currentFrameCallback_)
-                                currentFrame = currentFrameCallback_();
-                        }
-                        else
-                        {
-                            SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem framesToWait = 0 Skipped runRequestAuxDataItem_.timed_wait\n";
-                        }
-                        
-                        boost::posix_time::time_duration diff = boost::get_system_time() - currentTime;
-                        SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem slept = " << diff.total_milliseconds() << "ms";
-                        
-                        // Now that the thread has woken up
-                        // See if we need to fetch new frames
-                        //
-                        if (currentFrame >= frameToStartNextFetchOn)
-                        {
-                            pauseRequestAuxDataItem_ = false;
-                        }
-                        
-                        SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem pauseRequestAuxDataItem_ = "
-                        << (pauseRequestAuxDataItem_ ? "true" : "false")
-                        << " startEditUnit_ - " << startEditUnit_;
-                        
-                        SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem"
-                        << " currentFrame - " << currentFrame
-                        << " frameToStartNextFetchOn - " << frameToStartNextFetchOn;
+                        startEditUnit_ = currentFrame + prefetchController_.GetLeadEditUnits(editUnitsPerRequest_);
+                        headroom = startEditUnit_ - currentFrame;
                     }
+
+                    editUnitsToRequest_ = prefetchController_.GetEditUnitsToRequest(headroom);
+
+                    SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem requesting " << editUnitsToRequest_
+                    << " edit units with headroom - " << headroom
+                    << " startEditUnit_ - " << startEditUnit_;
                 }
-                // Now that we are outside of the timing, pause loop
-                // Set the pause flag to true such that we execute
-                // the pause code after fetching our aux data items
-                //
-                pauseRequestAuxDataItem_ = true;
             }
 
             if (!keepRequestingAuxDataItem_)
                 break;
             
-            // Only initiate the request for the startEditUnit_ once
-            //
-            if (!getInProgress_)
+            std::string path = this->BuildPath();
+            if (!path.empty())
             {
-                std::string path = this->BuildPath();
                 this->GET(path);
             }
+            else
+            {
+                AuxDataMemoryStatistics statistics;
+                auxDataMgr_->GetMemoryStatistics(statistics);
+
+                SMPTE_SYNC_LOG << "SS_Client::RequestAuxDataItem AuxDataMgr has no room, waiting a frame."
+                << " bufferedBytes_ = " << statistics.bufferedBytes_
+                << " maxBufferedBytes_ = " << statistics.maxBufferedBytes_
+                << " numberOfBlocks_ = " << statistics.numberOfBlocks_
+                << " receiveBufferBytes_ = " << statistics.receiveBufferBytes_;
+
+                // Wait for the playhead to move on and free some of the buffered edit units
+                //
+                boost::mutex::scoped_lock scoped_lock(runAuxDataItemMutex_);
+                boost::system_time const timeout = boost::get_system_time() + boost::posix_time::milliseconds(millisecondsPerFrame_);
+                runRequestAuxDataItem_.timed_wait(scoped_lock, timeout);
+            }
         }
     }
     
+    void SS_Client::Seek(int32_t iEditUnit)
+    {
+        if (iEditUnit < 0)
+            return;
+
+        seekEditUnit_ = iEditUnit;
+        runRequestAuxDataItem_.notify_one();
+    }
+
+    bool SS_Client::IsCancelled(uint32_t iRequest)
+    {
+        return iRequest != requestNumber_;
+    }
+
+    void SS_Client::RecoverFromSeek(boost::mutex::scoped_lock &ioLock, int32_t iEditUnit)
+    {
+        prefetchController_.OnSeek();
+        auxDataMgr_->SetPlayhead(iEditUnit);
+
+        uint32_t buffered = auxDataMgr_->GetBufferedCount(iEditUnit);
+
+        {
+            boost::mutex::scoped_lock path_lock(buildPathMutex_);
+
+            // Still within the edit units requested so far, the requests carry on from there
+            //
+            if (iEditUnit <= startEditUnit_ && static_cast<int64_t>(iEditUnit) + buffered >= startEditUnit_)
+            {
+                SMPTE_SYNC_LOG << "SS_Client::RecoverFromSeek " << iEditUnit << " already buffered up to startEditUnit_ - " << startEditUnit_;
+                return;
+            }
+        }
+
+        SMPTE_SYNC_LOG << "SS_Client::RecoverFromSeek seeking to " << iEditUnit << " with " << buffered << " edit units buffered";
+
+        // The socket_ and the streamParser_ belong to the io_service thread
+        //
+        seekInProgress_ = true;
+        io_service_.post(boost::bind(&SS_Client::HandleSeek, this, iEditUnit));
+
+        while (seekInProgress_ && keepRequestingAuxDataItem_)
+        {
+            boost::system_time const timeout = boost::get_system_time() + boost::posix_time::milliseconds(millisecondsPerFrame_);
+            runRequestAuxDataItem_.timed_wait(ioLock, timeout);
+        }
+    }
+
+    void SS_Client::HandleSeek(int32_t iEditUnit)
+    {
+        // Handlers of the request in flight find a newer request number and do nothing
+        //
+        ++requestNumber_;
+
+        boost::system::error_code ignored_ec;
+        resolver_.cancel();
+        socket_.close(ignored_ec);
+        retryTimer_.cancel(ignored_ec);
+
+        request_.consume(request_.size());
+        response_.consume(response_.size());
+        streamParser_.Reset();
+
+        // Keep what is already buffered from the new position onwards and drop the rest
+        //
+        uint32_t buffered = auxDataMgr_->GetBufferedCount(iEditUnit);
+        uint32_t released = auxDataMgr_->InvalidateOutside(iEditUnit, buffered);
+
+        int32_t urgentEditUnits = prefetchController_.GetUrgentEditUnits();
+        bool requestNow = static_cast<int32_t>(buffered) < urgentEditUnits;
+
+        {
+            boost::mutex::scoped_lock path_lock(buildPathMutex_);
+
+            startEditUnit_ = iEditUnit + buffered;
+            editUnitsToRequest_ = urgentEditUnits;
+            getInProgress_ = false;
+        }
+
+        SMPTE_SYNC_LOG << "SS_Client::HandleSeek " << released << " edit units released, startEditUnit_ - " << iEditUnit + buffered;
+
+        // A short window first so the playhead has data after one round trip.
+        // RequestAuxDataItem backfills with larger windows once it completes.
+        //
+        if (requestNow)
+        {
+            std::string path = this->BuildPath();
+            if (!path.empty())
+                this->GET(path);
+        }
+
+        {
+            boost::mutex::scoped_lock scoped_lock(runAuxDataItemMutex_);
+            seekInProgress_ = false;
+        }
+
+        runRequestAuxDataItem_.notify_one();
+    }
+
     void SS_Client::HandleError(void)
     {
         this->SetState(eState_Disconnected);
-        // If we have an error, we need to decrement the startEditUnit_
-        // Since we incremented it before initiating the GET request
+
+        // startEditUnit_ only advances past the edit units received, so the
+        // next request picks up where this one stopped
         //
         boost::mutex::scoped_lock scoped_lock(buildPathMutex_);
-        startEditUnit_ -= editUnitsPerRequest_;
-        
+
         // Clear the flag for waiting on a response
         // such that we can make another request
         //
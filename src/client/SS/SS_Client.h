@@ -42,6 +42,8 @@
 #include "boost/atomic.hpp"
 
 #include "DataTypes.h"
+#include "AuxDataStreamParser.h"
+#include "PrefetchController.h"
 
 #include "SS_State.h"
 
@@ -163,6 +165,17 @@ namespace SMPTE_SYNC
         /// Gets number of milliseconds per frame
         int32_t GetMillisecondsPerFrame(void);
 
+        /**
+         *
+         * Moves the requests to a new playhead position, such as from a DCS_Message_UpdateTimelineRequest.
+         * The fetchAuxDataItemThread_ cancels the request in flight, drops the buffered edit units away
+         * from iEditUnit and requests a short window at iEditUnit. Jumps of the current frame are handled the same way.
+         *
+         * @param iEditUnit is the edit unit the playhead jumped to
+         *
+         */
+        void Seek(int32_t iEditUnit);
+
     private:
 
         /**
@@ -182,10 +195,12 @@ namespace SMPTE_SYNC
          *
          * @param err is from the async_resolve if there is any, the error is logged and HandleError is called
          * @param endpoint_iterator is the resolved endpoint
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
         void handle_resolve(const boost::system::error_code& err,
-                            tcp::resolver::iterator endpoint_iterator);
+                            tcp::resolver::iterator endpoint_iterator,
+                            uint32_t iRequest);
 
         /**
          *
@@ -193,9 +208,10 @@ namespace SMPTE_SYNC
          * Initiates the boost::asio::async_connect
          *
          * @param err is from the async_connect if there is any, the error is logged and HandleError is called
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
-        void handle_connect(const boost::system::error_code& err);
+        void handle_connect(const boost::system::error_code& err, uint32_t iRequest);
         
         /**
          *
@@ -203,9 +219,10 @@ namespace SMPTE_SYNC
          * Initiates the boost::asio::async_read_until
          *
          * @param err is from the async_write if there is any, the error is logged and HandleError is called
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
-        void handle_write_request(const boost::system::error_code& err);
+        void handle_write_request(const boost::system::error_code& err, uint32_t iRequest);
         
         /**
          *
@@ -214,31 +231,97 @@ namespace SMPTE_SYNC
          * Reads the response status line.
          *
          * @param err is from the async_write if there is any, the error is logged and HandleError is called
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
-        void handle_read_status_line(const boost::system::error_code& err);
+        void handle_read_status_line(const boost::system::error_code& err, uint32_t iRequest);
 
         /**
          *
          * Called once the boost::asio::handle_write_request completes
-         * Initiates the boost::asio::async_read_until
-         * Reads the response headers
+         * Reads the response headers and hands any content read along with them to the streamParser_
+         * Calls ReadContent
          *
          * @param err is from the async_read_until if there is any, the error is logged and HandleError is called
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
-        void handle_read_headers(const boost::system::error_code& err);
+        void handle_read_headers(const boost::system::error_code& err, uint32_t iRequest);
         
         /**
          *
-         * Called once the handle_read_headers completes
-         * Initiates the boost::asio::async_read
-         * Reads the content of the response
+         * Called once each read started by ReadContent completes
+         * Reads the content of the response, queuing each AuxDataBlock as soon as all of its bytes have arrived
+         *
+         * @param err is from the async_read_some if there is any, the error is logged and HandleError is called
+         * @param bytes_transferred is the number of bytes read into the receive buffer of the streamParser_
+         * @param iRequest is the requestNumber_ of the GET request
+         *
+         */
+        void handle_read_content(const boost::system::error_code& err, std::size_t bytes_transferred, uint32_t iRequest);
+
+        /// Initiates a boost::asio::async_read_some of the response content of request iRequest straight into the receive buffer of the streamParser_
+        void ReadContent(uint32_t iRequest);
+
+        /// Called when the streamParser_ finds a malformed response. Closes the socket and calls HandleError.
+        void HandleMalformedResponse(void);
+
+        /**
+         *
+         * Called when a response ends early, either cut short by the server or because the AuxDataMgr reached its byte budget.
+         * Closes the socket and sets startEditUnit_ to resume after the last edit unit that was stored.
+         *
+         */
+        void HandlePartialResponse(void);
+
+        /**
+         *
+         * Called once the headers of a response with a status other than 200 have been read.
+         * Honors a Retry-After header by waiting on the retryTimer_ before the next request can be made.
+         * Does not call HandleError as the request was answered.
          *
          * @param err is from the async_read_until if there is any, the error is logged and HandleError is called
+         * @param iRequest is the requestNumber_ of the GET request
          *
          */
-        void handle_read_content(const boost::system::error_code& err);
+        void handle_read_error_headers(const boost::system::error_code& err, uint32_t iRequest);
+
+        /**
+         *
+         * Called once the retryTimer_ expires. Clears getInProgress_ so the next request can be made.
+         *
+         * @param err is from the async_wait. Set if the timer was cancelled.
+         * @param iRequest is the requestNumber_ of the GET request that was rejected
+         *
+         */
+        void handle_retry_timer(const boost::system::error_code& err, uint32_t iRequest);
+
+        /// Returns true if a seek cancelled the request iRequest, in which case its handlers must not touch any state
+        bool IsCancelled(uint32_t iRequest);
+
+        /**
+         *
+         * Called on the fetchAuxDataItemThread_ when the playhead jumped.
+         * Unless iEditUnit is within the edit units already requested, posts HandleSeek to the io_service
+         * and waits for it to complete. Expects runAuxDataItemMutex_ to be held by ioLock.
+         *
+         * @param ioLock is the lock on runAuxDataItemMutex_ held by RequestAuxDataItem
+         * @param iEditUnit is the edit unit the playhead jumped to
+         *
+         */
+        void RecoverFromSeek(boost::mutex::scoped_lock &ioLock, int32_t iEditUnit);
+
+        /**
+         *
+         * Runs on the io_service thread, which owns the socket_ and the streamParser_.
+         * Cancels the request in flight, releases the buffered edit units outside of those buffered from iEditUnit onwards
+         * and, unless enough is already buffered, requests a window from the prefetchController_ just long enough to
+         * cover the round trip of the larger requests that follow.
+         *
+         * @param iEditUnit is the edit unit the playhead jumped to
+         *
+         */
+        void HandleSeek(int32_t iEditUnit);
 
         /**
          *
@@ -252,8 +335,8 @@ namespace SMPTE_SYNC
         /**
          *
          * Runs on the fetchAuxDataItemThread_ to request aux data items from the SS_Server
-         * This thread runs at some point in time in the future as computed by the number of frames
-         * last requested and the number of frames editUnitsAheadOfCurrentEditUnitToInitiateRequest_
+         * Sleeps until the deadline the prefetchController_ computes from the edit units buffered ahead of the current frame,
+         * or until a response completes, then requests the window the prefetchController_ sizes
          * Sets the state of the SS_Client to eState_Buffered when enough frames have been received
          *
          */
@@ -264,24 +347,33 @@ namespace SMPTE_SYNC
          * Creates the path to be requested by the next GET request.
          * The path contains teh base URL and any additional parameters such as 
          * the codingUL, startEditUnit_, editUnitsPerRequest_, and encryptionType_
+         * The number of edit units is clipped to what fits in the AuxDataMgr.
+         *
+         * @return the path or an empty string if the AuxDataMgr has no room for another request
          *
          */
         std::string BuildPath(void);
 
+        /// Reference to the boost::asio::io_service used for the SS_Client
+        boost::asio::io_service&    io_service_;
+
         /// Boost endpoint resolver
         tcp::resolver resolver_;
         
         /// Boost TCP/IP socket used for the GET request
         tcp::socket socket_;
 
+        /// Delays the next request after the server rejected one, for example with a 503 and a Retry-After header
+        boost::asio::deadline_timer retryTimer_;
+
         /// Boost buffer for storing the request. That is the header and data for the GET request
         boost::asio::streambuf request_;
         
         /// Boost buffer for storing the GET request response data
         boost::asio::streambuf response_;
         
-        /// This is used to store the whole response accumulated from mutliple read requests
-        std::string responsePayload_;
+        /// Receives and decodes the response content as it arrives and queues each AuxDataBlock on the auxDataMgr_
+        AuxDataStreamParser streamParser_;
         
         /// The server address
         std::string server_;
@@ -300,10 +392,25 @@ namespace SMPTE_SYNC
 
         /// Flag to track if a get request has been made but not completed yet. Used to not initiate new get requests until the current one has completed.
         bool            getInProgress_;
+
+        /// Number of the current GET request. Incremented by each GET and by HandleSeek so the handlers of a cancelled request do nothing.
+        boost::atomic<uint32_t>     requestNumber_;
+
+        /// Edit unit passed to Seek that the fetchAuxDataItemThread_ has not handled yet, or -1
+        boost::atomic<int32_t>      seekEditUnit_;
+
+        /// Set by RecoverFromSeek while it waits for HandleSeek to run. Guarded by runAuxDataItemMutex_.
+        bool            seekInProgress_;
         
         /// The edit units per request used for each request. Protected as part of the group of items used in SS_Client::BuildPath. Guarded by buildPathMutex_.
         int32_t         editUnitsPerRequest_;
 
+        /// The edit units the next request asks for, sized by the prefetchController_ and clipped to editUnitsPerRequest_. Guarded by buildPathMutex_.
+        int32_t         editUnitsToRequest_;
+
+        /// Number of bytes of content received for the current request. Measures the throughput for the prefetchController_.
+        uint64_t        responseBytes_;
+
         /// The encryption type request used for each request. Protected as part of the group of items used in SS_Client::BuildPath. Guarded by buildPathMutex_.
         std::string     encryptionType_;
 
@@ -344,9 +451,6 @@ namespace SMPTE_SYNC
          */
         boost::atomic<bool>            keepRequestingAuxDataItem_;
 
-        /// Pauses calls to RequestAuxDataItem when there is enough data already buffered
-        bool            pauseRequestAuxDataItem_;
-        
         /// Mutex used to trigger next update for RequestAuxDataItem
         boost::mutex    runAuxDataItemMutex_;
 
@@ -358,6 +462,9 @@ namespace SMPTE_SYNC
         
         /// Number of milliseconds per frame based on the current frame rate. Used in determing how long to sleep the fetchAuxDataItemThread_ thread
         int32_t         millisecondsPerFrame_;
+
+        /// Decides when to make the next request and how many edit units it asks for from the measured round trip time and throughput
+        PrefetchController  prefetchController_;
     };
 
 }  // namespace SMPTE_SYNC
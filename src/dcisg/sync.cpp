@@ -226,14 +226,16 @@ namespace SMPTE_SYNC
         primaryPictureTrackFileEditUnitIndex_ = iIndex;
     }
 
-    bool syncPacket::SetPrimaryPictureTrackFileUUID(UUID uuid)
+    bool syncPacket::SetPrimaryPictureTrackFileUUID(const UUID &uuid)
     {
-        return Copy(uuid, primaryPictureTrackFileUUID_);
+        primaryPictureTrackFileUUID_ = uuid;
+
+        return true;
     }
 
     bool syncPacket::SetPrimaryPictureTrackFileUUID(char *uuid)
     {
-        if (!Str2UUID(uuid,primaryPictureTrackFileUUID_))
+        if (!UUID::Parse(uuid, strlen(uuid), primaryPictureTrackFileUUID_))
         {
             return false;
         }
@@ -246,14 +248,16 @@ namespace SMPTE_SYNC
         primarySoundTrackFileEditUnitIndex_ = iIndex;
     }
 
-    bool syncPacket::SetPrimarySoundTrackFileUUID(UUID uuid)
+    bool syncPacket::SetPrimarySoundTrackFileUUID(const UUID &uuid)
     {
-        return Copy(uuid, primarySoundTrackFileUUID_);
+        primarySoundTrackFileUUID_ = uuid;
+
+        return true;
     }
 
     bool syncPacket::SetPrimarySoundTrackFileUUID(char *uuid)
     {
-        if (!Str2UUID(uuid,primarySoundTrackFileUUID_))
+        if (!UUID::Parse(uuid, strlen(uuid), primarySoundTrackFileUUID_))
         {
             return false;
         }
@@ -261,14 +265,16 @@ namespace SMPTE_SYNC
         return true;
     }
 
-    bool syncPacket::SetCompositionPlaylistUUID(UUID uuid)
+    bool syncPacket::SetCompositionPlaylistUUID(const UUID &uuid)
     {
-        return Copy(uuid, compositionPlaylistUUID_);
+        compositionPlaylistUUID_ = uuid;
+
+        return true;
     }
 
     bool syncPacket::SetCompositionPlaylistUUID(char *uuid)
     {
-        if (!Str2UUID(uuid,compositionPlaylistUUID_))
+        if (!UUID::Parse(uuid, strlen(uuid), compositionPlaylistUUID_))
         {
             return false;
         }
@@ -357,7 +363,7 @@ namespace SMPTE_SYNC
         return WriteUInt32((uint32_t) value, buffer,count,first);
     }
 
-    bool WriteUUID(UUID uuid, uint8_t *buffer, uint8_t *count, bool first)
+    bool WriteUUID(const UUID &uuid, uint8_t *buffer, uint8_t *count, bool first)
     {
         uint16_t val;
         uint8_t  lcount;
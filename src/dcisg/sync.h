@@ -77,12 +77,9 @@ namespace SMPTE_SYNC
             extensionLength_ = 0;
             extension_ = nullptr;
             
-            for (int i = 0; i < 16; i++)
-            {
-                primaryPictureTrackFileUUID_[i] = 0;
-                primarySoundTrackFileUUID_[i] = 0;
-                compositionPlaylistUUID_[i] = 0;
-            }
+            primaryPictureTrackFileUUID_.Clear();
+            primarySoundTrackFileUUID_.Clear();
+            compositionPlaylistUUID_.Clear();
         }
         
         /// Destructor
@@ -112,12 +109,9 @@ namespace SMPTE_SYNC
                 extension_ = nullptr;
             }
             
-            for (int i = 0; i < 16; i++)
-            {
-                primaryPictureTrackFileUUID_[i] = 0;
-                primarySoundTrackFileUUID_[i] = 0;
-                compositionPlaylistUUID_[i] = 0;
-            }
+            primaryPictureTrackFileUUID_.Clear();
+            primarySoundTrackFileUUID_.Clear();
+            compositionPlaylistUUID_.Clear();
         }
         
         /// TODO: Do we realy need count as this is a preallocated buffer based on the number of samples per frame
@@ -170,7 +164,7 @@ namespace SMPTE_SYNC
          * @return true/false if the UUID is valid and could be set
          *
          */
-        bool SetPrimaryPictureTrackFileUUID(UUID uuid);
+        bool SetPrimaryPictureTrackFileUUID(const UUID &uuid);
 
         /**
          * Sets the primaryPictureTrackFileUUID_
@@ -191,7 +185,7 @@ namespace SMPTE_SYNC
          * @return true/false if the UUID is valid and could be set
          *
          */
-        bool SetPrimarySoundTrackFileUUID(UUID uuid);
+        bool SetPrimarySoundTrackFileUUID(const UUID &uuid);
 
         /**
          * Sets the primarySoundTrackFileUUID_
@@ -209,7 +203,7 @@ namespace SMPTE_SYNC
          * @return true/false if the UUID is valid and could be set
          *
          */
-        bool SetCompositionPlaylistUUID(UUID uuid);
+        bool SetCompositionPlaylistUUID(const UUID &uuid);
         
         /**
          * Sets the compositionPlaylistUUID_
@@ -297,7 +291,7 @@ namespace SMPTE_SYNC
      * @return true/false if the UUID data was properly written
      *
      */
-    bool WriteUUID(UUID uuid, uint8_t *buffer, uint8_t *count, bool first);
+    bool WriteUUID(const UUID &uuid, uint8_t *buffer, uint8_t *count, bool first);
 
     /**
      * Reads a uint16_t value from the buffer i.e. the syncPacket data stream
@@ -28,6 +28,7 @@
  *======================================================================*/
 
 #include "SE_Server.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -37,6 +38,10 @@
 
 namespace SMPTE_SYNC
 {
+    // Number of frames requested from the GetFrameDataRangeCallback at a time.
+    // Approximately 2 seconds at 24 fps.
+    //
+    static const int32_t sFrameDataBatchSize = 48;
 
     SE_Server::SE_Server(int32_t iSampleRate
                          , int32_t iCallbackBufferSize
@@ -60,9 +65,17 @@ namespace SMPTE_SYNC
         , currentFrame_(0)
         , offsetIntoFrame_(0)
         , offsetIntoCurrentAudioBuffer_(0)
+        , frameDataBatchStart_(0)
+        , frameDataBatchCount_(0)
+        , frameInfoRunCursor_(0)
+        , frameDataChanged_(false)
     {
         converter_ = new UTILS::ConverterInt24Float32(sampleRate_);
 
+        // Allocated once so building frames never allocates
+        //
+        frameDataBatch_.resize(sFrameDataBatchSize);
+
         currentFrameBuffer_ = new uint8_t[currentFrameSize_];
         memset(currentFrameBuffer_, 0x0, currentFrameSize_);
 
@@ -203,6 +216,7 @@ namespace SMPTE_SYNC
         }
         
         showLengthInFrames_ = iShowLengthInFrames;
+        frameDataChanged_ = true;
         this->Reset();
         
         this->Stop();
@@ -381,6 +395,17 @@ namespace SMPTE_SYNC
             //
             boost::this_thread::sleep(boost::posix_time::milliseconds(threadSleepTimeInMS_));
             EState state = this->GetState();
+
+            // Pick up new runs and drop frame data of the previous Show
+            //
+            if (frameDataChanged_.exchange(false))
+            {
+                boost::mutex::scoped_lock scoped_lock(frameInfoRunsMutex_);
+
+                frameInfoRuns_ = pendingFrameInfoRuns_;
+                frameInfoRunCursor_ = 0;
+                frameDataBatchCount_ = 0;
+            }
             
             if (state == eState_NoData)
             {
@@ -542,18 +567,15 @@ namespace SMPTE_SYNC
                     currentFrame_++;
                 }
                 
-                if (frameDataCallback_)
+                if (!this->GetFrameData(syncSamp_.timelineEditUnitIndex_))
                 {
-                    if (!frameDataCallback_(syncSamp_.timelineEditUnitIndex_, frameData_))
-                    {
-                        this->SetState(eState_NoData);
-                        this->Reset();
-                        
-                        // Break out of our fill buffer loop
-                        // We will sleep and start again
-                        //
-                        break;
-                    }
+                    this->SetState(eState_NoData);
+                    this->Reset();
+                    
+                    // Break out of our fill buffer loop
+                    // We will sleep and start again
+                    //
+                    break;
                 }
                 
                 if (this->SetupPacket())
@@ -640,6 +662,67 @@ namespace SMPTE_SYNC
         }
     }
 
+    bool SE_Server::GetFrameData(int32_t iFrame)
+    {
+        if (frameInfoRuns_ && !frameInfoRuns_->empty())
+        {
+            const FrameInfoRunList &runs = *frameInfoRuns_;
+
+            // Playing stays in the same run or moves on to the next one.
+            // Anything else is a locate and searches the runs.
+            //
+            if (frameInfoRunCursor_ >= runs.size()
+                || iFrame < runs[frameInfoRunCursor_].startFrame_
+                || runs[frameInfoRunCursor_].endFrame_ < iFrame)
+            {
+                if (frameInfoRunCursor_ + 1 < runs.size()
+                    && runs[frameInfoRunCursor_ + 1].startFrame_ <= iFrame
+                    && iFrame <= runs[frameInfoRunCursor_ + 1].endFrame_)
+                {
+                    frameInfoRunCursor_++;
+                }
+                else
+                {
+                    FrameInfoRunList::const_iterator iter = std::upper_bound(runs.begin(), runs.end(), iFrame,
+                        [](int32_t iFrame, const FrameInfoRun &iRun)
+                        {
+                            return iFrame < iRun.startFrame_;
+                        });
+
+                    if (iter == runs.begin() || (iter - 1)->endFrame_ < iFrame)
+                        return false;
+
+                    frameInfoRunCursor_ = static_cast<size_t>(iter - 1 - runs.begin());
+                }
+            }
+
+            runs[frameInfoRunCursor_].GetFrameInfo(iFrame, frameData_);
+
+            return true;
+        }
+
+        if (frameDataRangeCallback_)
+        {
+            if (iFrame < frameDataBatchStart_ || frameDataBatchStart_ + frameDataBatchCount_ <= iFrame)
+            {
+                frameDataBatchStart_ = iFrame;
+                frameDataBatchCount_ = std::max(frameDataRangeCallback_(iFrame, sFrameDataBatchSize, frameDataBatch_.data()), 0);
+
+                if (frameDataBatchCount_ == 0)
+                    return false;
+            }
+
+            frameData_ = frameDataBatch_[iFrame - frameDataBatchStart_];
+
+            return true;
+        }
+
+        if (frameDataCallback_)
+            return frameDataCallback_(iFrame, frameData_);
+
+        return true;
+    }
+
     bool SE_Server::SetupPacket(void)
     {
         bool success = true;
@@ -706,6 +789,33 @@ namespace SMPTE_SYNC
         frameDataCallback_ = iCallback;
     }
 
+    void SE_Server::SetGetFrameDataRangeCallback(GetFrameDataRangeCallback iCallback)
+    {
+        frameDataRangeCallback_ = iCallback;
+        frameDataChanged_ = true;
+    }
+
+    void SE_Server::SetFrameInfoRuns(const FrameInfoRunList &iRuns)
+    {
+        boost::shared_ptr<const FrameInfoRunList> runs;
+
+        if (!iRuns.empty())
+            runs.reset(new FrameInfoRunList(iRuns));
+
+        {
+            boost::mutex::scoped_lock scoped_lock(frameInfoRunsMutex_);
+            pendingFrameInfoRuns_ = runs;
+        }
+
+        frameDataChanged_ = true;
+    }
+
+    void SE_Server::SetShowLengthInFrames(int32_t iShowLengthInFrames)
+    {
+        showLengthInFrames_ = iShowLengthInFrames;
+        frameDataChanged_ = true;
+    }
+
     void SE_Server::SetPlayoutID(uint32_t iID)
     {
         playoutID_ = iID;
@@ -33,7 +33,10 @@
 #include "SE_State.h"
 
 #include <string>
+#include <vector>
 
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
 #include "boost/thread/thread.hpp"
 #include "boost/lockfree/queue.hpp"
 
@@ -224,8 +227,49 @@ namespace SMPTE_SYNC
          */
         void SetGetFrameDataCallback(GetFrameDataCallback iCallback);
 
+        /**
+         *
+         * Sets a callback for requesting data for a range of frames.
+         * When set, it is used instead of the GetFrameDataCallback and frames are requested in batches.
+         *
+         * @param iCallback is the callback for requesting frame data for consecutive frames
+         *
+         */
+        void SetGetFrameDataRangeCallback(GetFrameDataRangeCallback iCallback);
+
+        /**
+         *
+         * Sets the runs of frames of the whole Show. When set, frame data is taken from the runs and no callback is called.
+         * Can be called at any time. Takes effect the next time frames are built.
+         *
+         * @param iRuns is the FrameInfoRunList of the Show, such as from ShowManager::GetFrameInfoRuns. An empty list goes back to the callbacks.
+         *
+         */
+        void SetFrameInfoRuns(const FrameInfoRunList &iRuns);
+
+        /**
+         *
+         * Sets the length of the Show in frames after CPLs are added to or removed from a loaded Show.
+         * Can be called in any state, including while playing. Frame data fetched before the call is dropped.
+         *
+         * @param iShowLengthInFrames is length of the entire show based on all loaded CPL objects
+         *
+         */
+        void SetShowLengthInFrames(int32_t iShowLengthInFrames);
+
     private:
 
+        /**
+         *
+         * Fills frameData_ for a frame from the frameInfoRuns_, the frameDataBatch_ or the frame data callbacks, in that order.
+         * Called only from BuildFrames.
+         *
+         * @param iFrame is the frame on the Show timeline
+         * @return true/false if the frame data is available
+         *
+         */
+        bool GetFrameData(int32_t iFrame);
+
         /**
          *
          * SetupPacket builds the specific syncPacket by setting the various parameters and serializing the data into a 24-bit audio buffer
@@ -300,7 +344,7 @@ namespace SMPTE_SYNC
         syncPacket      syncSamp_;
 
         /// The length of a show in frames which is used by the SE_Server to stop playback at the end of the show
-        int32_t         showLengthInFrames_;
+        boost::atomic<int32_t>         showLengthInFrames_;
         
         /// The currentFrame_ is updated when in the state eState_Playing. Multiple clients from multiple threads read this value.
         boost::atomic<int32_t>         currentFrame_;
@@ -321,6 +365,33 @@ namespace SMPTE_SYNC
 
         /// The callback function for getting frame data information to be played back
         GetFrameDataCallback frameDataCallback_;
+
+        /// The callback function for getting frame data information of consecutive frames to be played back
+        GetFrameDataRangeCallback frameDataRangeCallback_;
+
+        /// Preallocated FrameInfo of consecutive frames requested from the frameDataRangeCallback_. Used by BuildFrames only.
+        std::vector<FrameInfo> frameDataBatch_;
+
+        /// First frame in the frameDataBatch_
+        int32_t         frameDataBatchStart_;
+
+        /// Number of frames in the frameDataBatch_
+        int32_t         frameDataBatchCount_;
+
+        /// Runs of frames of the Show used by BuildFrames. Empty when the callbacks are used.
+        boost::shared_ptr<const FrameInfoRunList> frameInfoRuns_;
+
+        /// Index of the run in frameInfoRuns_ the last frame was found in
+        size_t          frameInfoRunCursor_;
+
+        /// Runs set by SetFrameInfoRuns and not yet picked up by BuildFrames
+        boost::shared_ptr<const FrameInfoRunList> pendingFrameInfoRuns_;
+
+        /// Protects pendingFrameInfoRuns_
+        boost::mutex    frameInfoRunsMutex_;
+
+        /// Set when the Show or the source of frame data changes so BuildFrames drops what it holds
+        boost::atomic<bool> frameDataChanged_;
         
         
         /// TODO: Finish implementation for delay between CPL
@@ -32,6 +32,7 @@
 #include <string>
 
 #include "boost/asio.hpp"
+#include "boost/thread/thread.hpp"
 
 #include "DCS_Message.h"
 
@@ -40,11 +41,19 @@ namespace SMPTE_SYNC
 
     SS_Server::SS_Server(boost::asio::io_service& io_service,
                const std::string& address,
-               const std::string& port)
+               const std::string& port,
+               int32_t iNumberOfAcceptors,
+               int32_t iNumberOfDiskThreads,
+               int32_t iNumberOfIOThreads)
     :
-          server( io_service, address, port)
+          server( io_service, address, port, iNumberOfAcceptors, iNumberOfDiskThreads)
+        , numberOfIOThreads_(iNumberOfIOThreads)
     {
-        
+        if (numberOfIOThreads_ <= 0)
+            numberOfIOThreads_ = static_cast<int32_t>(boost::thread::hardware_concurrency());
+
+        if (numberOfIOThreads_ < 1)
+            numberOfIOThreads_ = 1;
     }
     
     SS_Server::~SS_Server(void)
@@ -52,4 +61,14 @@ namespace SMPTE_SYNC
         
     }
 
+    void SS_Server::Run(void)
+    {
+        this->Run(numberOfIOThreads_);
+    }
+
+    int32_t SS_Server::GetNumberOfIOThreads(void)
+    {
+        return numberOfIOThreads_;
+    }
+
 }  // namespace SMPTE_SYNC
@@ -58,16 +58,38 @@ namespace SMPTE_SYNC
          * @param io_service \link boost::asio::io_service \endlink is the io service running communication
          * @param address is address of the HTTP server
          * @param port is port of the HTTP server
+         * @param iNumberOfAcceptors is the number of acceptors listening on the port. More than one requires SO_REUSEPORT.
+         * @param iNumberOfDiskThreads is the number of threads reading aux data so the io threads never block on disk
+         * @param iNumberOfIOThreads is the number of threads Run runs the io_service on. 0 uses one per hardware thread.
          *
          */
         explicit SS_Server(boost::asio::io_service& io_service,
                         const std::string& address,
-                        const std::string& port);
+                        const std::string& port,
+                        int32_t iNumberOfAcceptors = 1,
+                        int32_t iNumberOfDiskThreads = 2,
+                        int32_t iNumberOfIOThreads = 0);
 
         /// Destructor
         virtual ~SS_Server(void);
+
+        using http::server::server::Run;
+
+        /**
+         *
+         * Runs the io_service on the number of io threads the SS_Server was constructed with, including the calling thread.
+         * Blocks until the io_service runs out of work or is stopped.
+         *
+         */
+        void Run(void);
+
+        /// Number of threads Run runs the io_service on
+        int32_t GetNumberOfIOThreads(void);
         
     private:
+
+        /// Number of threads Run runs the io_service on
+        int32_t numberOfIOThreads_;
     };
 }  // namespace SMPTE_SYNC
 
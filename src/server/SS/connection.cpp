@@ -17,11 +17,25 @@
 namespace http {
 namespace server {
 
+/// Bytes of a streamed reply that may be queued before the stream is parked.
+static const std::size_t max_queued_bytes = 1024 * 1024;
+
 connection::connection(boost::asio::ip::tcp::socket socket,
-    connection_manager& manager, request_handler& handler)
+    boost::asio::io_service& io_service,
+    connection_manager& manager, request_handler& handler,
+    request_scheduler& scheduler)
   : socket_(std::move(socket)),
+    strand_(io_service),
     connection_manager_(manager),
-    request_handler_(handler)
+    request_handler_(handler),
+    request_scheduler_(scheduler),
+    queued_bytes_(0),
+    frames_ahead_(0),
+    reading_(false),
+    stream_parked_(false),
+    writing_(false),
+    stream_complete_(false),
+    stopped_(false)
 {
 }
 
@@ -32,13 +46,23 @@ void connection::start()
 
 void connection::stop()
 {
-  socket_.close();
+  // May be called from any thread. Close the socket on the strand so it does
+  // not race the handlers of this connection.
+  stopped_ = true;
+  auto self(shared_from_this());
+  strand_.dispatch(
+      [this, self]()
+      {
+        boost::system::error_code ignored_ec;
+        socket_.close(ignored_ec);
+      });
 }
 
 void connection::do_read()
 {
   auto self(shared_from_this());
   socket_.async_read_some(boost::asio::buffer(buffer_),
+      strand_.wrap(
       [this, self](boost::system::error_code ec, std::size_t bytes_transferred)
       {
         if (!ec)
@@ -49,8 +73,7 @@ void connection::do_read()
 
           if (result == request_parser::good)
           {
-            request_handler_.handle_request(request_, reply_);
-            do_write();
+            do_handle_request();
           }
           else if (result == request_parser::bad)
           {
@@ -66,13 +89,164 @@ void connection::do_read()
         {
           connection_manager_.stop(shared_from_this());
         }
+      }));
+}
+
+void connection::do_handle_request()
+{
+  int32_t frames_ahead = 0;
+  if (!request_handler_.admit_request(request_, reply_, frames_ahead))
+  {
+    do_write();
+    return;
+  }
+
+  frames_ahead_ = frames_ahead;
+
+  auto self(shared_from_this());
+  request_scheduler_.submit(frames_ahead,
+      [this, self]()
+      {
+        request_handler_.handle_request(request_, reply_);
+
+        if (reply_.transfer == reply::buffered)
+        {
+          strand_.post([this, self]() { do_write(); });
+        }
+        else
+        {
+          strand_.post(
+              [this, self]()
+              {
+                queue_write(reply_.headers_to_string());
+                read_stream();
+              });
+        }
       });
 }
 
+void connection::read_stream()
+{
+  if (stopped_)
+    return;
+
+  reading_ = true;
+
+  auto self(shared_from_this());
+  request_scheduler_.submit(frames_ahead_,
+      [this, self]()
+      {
+        std::shared_ptr<std::vector<char> > data =
+            std::make_shared<std::vector<char> >();
+        bool more = reply_.stream->Read(*data);
+
+        strand_.post(
+            [this, self, data, more]() { handle_stream_read(*data, more); });
+      });
+}
+
+void connection::handle_stream_read(const std::vector<char>& data, bool more)
+{
+  reading_ = false;
+
+  if (stopped_)
+    return;
+
+  bool chunked = reply_.transfer == reply::chunked;
+
+  if (!data.empty())
+  {
+    if (chunked)
+      queue_write(reply::to_chunk(data.data(), data.size()));
+    else
+      queue_write(std::string(data.begin(), data.end()));
+  }
+
+  if (more)
+  {
+    // Hold the rest back while the client is slower than the disk. The write
+    // completion reads the next part once the queue has drained.
+    if (queued_bytes_ > max_queued_bytes)
+      stream_parked_ = true;
+    else
+      read_stream();
+    return;
+  }
+
+  // A chunked reply is only terminated when it holds everything the transfer
+  // header announced so the client can detect a stream that ended early.
+  if (chunked && reply_.stream->IsComplete())
+    queue_write(reply::last_chunk());
+
+  // Everything has been queued. Close once the queue drains.
+  stream_complete_ = true;
+  if (!writing_)
+    do_close();
+}
+
+void connection::queue_write(std::string data)
+{
+  queued_bytes_ += data.size();
+  write_queue_.push_back(std::move(data));
+  if (!writing_)
+    do_stream_write();
+}
+
+void connection::do_stream_write()
+{
+  writing_ = true;
+
+  auto self(shared_from_this());
+  boost::asio::async_write(socket_, boost::asio::buffer(write_queue_.front()),
+      strand_.wrap(
+      [this, self](boost::system::error_code ec, std::size_t)
+      {
+        queued_bytes_ -= write_queue_.front().size();
+        write_queue_.pop_front();
+
+        if (ec)
+        {
+          writing_ = false;
+          if (ec != boost::asio::error::operation_aborted)
+          {
+            connection_manager_.stop(shared_from_this());
+          }
+          return;
+        }
+
+        if (stream_parked_ && queued_bytes_ <= max_queued_bytes)
+        {
+          stream_parked_ = false;
+          read_stream();
+        }
+
+        if (!write_queue_.empty())
+        {
+          do_stream_write();
+          return;
+        }
+
+        writing_ = false;
+        if (stream_complete_)
+          do_close();
+      }));
+}
+
+void connection::do_close()
+{
+  // Initiate graceful connection closure.
+  boost::system::error_code ignored_ec;
+  socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both,
+    ignored_ec);
+
+  connection_manager_.stop(shared_from_this());
+}
+
 void connection::do_write()
 {
   auto self(shared_from_this());
   boost::asio::async_write(socket_, reply_.to_buffers(),
+      strand_.wrap(
       [this, self](boost::system::error_code ec, std::size_t)
       {
         if (!ec)
@@ -87,7 +261,7 @@ void connection::do_write()
         {
           connection_manager_.stop(shared_from_this());
         }
-      });
+      }));
 }
 
 } // namespace server
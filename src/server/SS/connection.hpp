@@ -12,19 +12,25 @@
 #define HTTP_CONNECTION_HPP
 
 #include <array>
+#include <deque>
 #include <memory>
+#include <string>
+#include "boost/asio.hpp"
 #include "boost/atomic.hpp"
 #include "reply.hpp"
 #include "request.hpp"
 #include "request_handler.hpp"
 #include "request_parser.hpp"
+#include "request_scheduler.hpp"
 
 namespace http {
 namespace server {
 
 class connection_manager;
 
-/// Represents a single connection from a client.
+/// Represents a single connection from a client. All socket operations and
+/// completion handlers of a connection run on its strand so the io_service may
+/// be run from several threads. Requests are handled by the request scheduler.
 class connection
   : public std::enable_shared_from_this<connection>
 {
@@ -34,7 +40,9 @@ public:
 
   /// Construct a connection with the given socket.
   explicit connection(boost::asio::ip::tcp::socket socket,
-      connection_manager& manager, request_handler& handler);
+      boost::asio::io_service& io_service,
+      connection_manager& manager, request_handler& handler,
+      request_scheduler& scheduler);
 
   /// Start the first asynchronous operation for the connection.
   void start();
@@ -46,18 +54,46 @@ private:
   /// Perform an asynchronous read operation.
   void do_read();
 
+  /// Admit the parsed request and schedule it by urgency, then write the reply
+  /// from the strand.
+  void do_handle_request();
+
   /// Perform an asynchronous write operation.
   void do_write();
 
+  /// Read the next part of a streamed reply on the request scheduler so the
+  /// io threads never wait for the disk.
+  void read_stream();
+
+  /// Queue the part read by read_stream and read the next one, unless more
+  /// than the high-water mark of bytes is queued. Then the stream is parked
+  /// until the client has taken enough of it.
+  void handle_stream_read(const std::vector<char>& data, bool more);
+
+  /// Queue part of a streamed reply for writing.
+  void queue_write(std::string data);
+
+  /// Write the next queued part of a streamed reply.
+  void do_stream_write();
+
+  /// Shut down and release the connection once the reply has been written.
+  void do_close();
+
   /// Socket for the connection.
   boost::asio::ip::tcp::socket socket_;
 
+  /// Serializes the handlers of this connection across io threads.
+  boost::asio::io_service::strand strand_;
+
   /// The manager for this connection.
   connection_manager& connection_manager_;
 
   /// The handler used to process the incoming request.
   request_handler& request_handler_;
 
+  /// Runs request handling off of the io threads, most urgent first.
+  request_scheduler& request_scheduler_;
+
   /// Buffer for incoming data.
   std::array<char, 8192> buffer_;
 
@@ -69,6 +105,32 @@ private:
 
   /// The reply to be sent back to the client.
   reply reply_;
+
+  /// Parts of a streamed reply waiting to be written. This and the stream
+  /// state below are only touched on the strand.
+  std::deque<std::string> write_queue_;
+
+  /// Bytes queued for writing and not yet written.
+  std::size_t queued_bytes_;
+
+  /// Frames between the current edit unit and the start of the request. Used
+  /// to schedule each read of a streamed reply.
+  int32_t frames_ahead_;
+
+  /// Set while a read of the streamed reply is in flight.
+  bool reading_;
+
+  /// Set while the stream waits for the write queue to drain.
+  bool stream_parked_;
+
+  /// Set while an asynchronous write of write_queue_ is in progress.
+  bool writing_;
+
+  /// Set once the request handler has queued the last part of a streamed reply.
+  bool stream_complete_;
+
+  /// Set once the connection has been stopped.
+  boost::atomic<bool> stopped_;
 };
 
 typedef std::shared_ptr<connection> connection_ptr;
@@ -12,13 +12,14 @@
 #define HTTP_CONNECTION_MANAGER_HPP
 
 #include <set>
+#include "boost/thread/mutex.hpp"
 #include "connection.hpp"
 
 namespace http {
 namespace server {
 
 /// Manages open connections so that they may be cleanly stopped when the server
-/// needs to shut down.
+/// needs to shut down. Connections may be started and stopped from any io thread.
 class connection_manager
 {
 public:
@@ -40,6 +41,9 @@ public:
 private:
   /// The managed connections.
   std::set<connection_ptr> connections_;
+
+  /// Protects connections_.
+  boost::mutex connections_mutex_;
 };
 
 } // namespace server
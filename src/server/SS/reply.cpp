@@ -9,6 +9,7 @@
 //
 
 #include "reply.hpp"
+#include <sstream>
 #include <string>
 
 namespace http {
@@ -112,10 +113,55 @@ std::vector<boost::asio::const_buffer> reply::to_buffers()
     buffers.push_back(boost::asio::buffer(misc_strings::crlf));
   }
   buffers.push_back(boost::asio::buffer(misc_strings::crlf));
-  buffers.push_back(boost::asio::buffer(content));
+  if (shared_content)
+    buffers.push_back(boost::asio::buffer(*shared_content));
+  else
+    buffers.push_back(boost::asio::buffer(content));
   return buffers;
 }
 
+std::string reply::headers_to_string() const
+{
+  std::string result;
+  boost::asio::const_buffer status_line = status_strings::to_buffer(status);
+  result.append(static_cast<const char*>(status_line.data()), status_line.size());
+
+  // Chunked transfer encoding is only defined for HTTP/1.1
+  if (transfer == chunked)
+    result[7] = '1';
+
+  for (std::size_t i = 0; i < headers.size(); ++i)
+  {
+    const header& h = headers[i];
+    result.append(h.name);
+    result.append(misc_strings::name_value_separator, sizeof(misc_strings::name_value_separator));
+    result.append(h.value);
+    result.append(misc_strings::crlf, sizeof(misc_strings::crlf));
+  }
+  result.append(misc_strings::crlf, sizeof(misc_strings::crlf));
+  return result;
+}
+
+std::string reply::to_chunk(const char* data, std::size_t size)
+{
+  std::ostringstream chunk_size;
+  chunk_size << std::hex << size;
+
+  std::string result;
+  result.reserve(chunk_size.str().size() + size + 2 * sizeof(misc_strings::crlf));
+  result.append(chunk_size.str());
+  result.append(misc_strings::crlf, sizeof(misc_strings::crlf));
+  result.append(data, size);
+  result.append(misc_strings::crlf, sizeof(misc_strings::crlf));
+  return result;
+}
+
+const std::string& reply::last_chunk()
+{
+  static const std::string last = "0\r\n\r\n";
+  return last;
+}
+
 namespace stock_replies {
 
 const char ok[] = "";
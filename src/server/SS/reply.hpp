@@ -14,7 +14,9 @@
 #include <string>
 #include <vector>
 #include "boost/asio.hpp"
+#include "boost/shared_ptr.hpp"
 #include "header.hpp"
+#include "DataStream.h"
 
 namespace http {
 namespace server {
@@ -43,17 +45,45 @@ struct reply
     service_unavailable = 503
   } status;
 
+  /// How the content is transferred to the client.
+  enum transfer_type
+  {
+    /// The content member is sent after the headers in a single write.
+    buffered,
+    /// The content is streamed after the headers and ends when the connection closes (HTTP/1.0).
+    close_delimited,
+    /// The content is streamed after the headers using Transfer-Encoding: chunked (HTTP/1.1).
+    chunked
+  } transfer = buffered;
+
   /// The headers to be included in the reply.
   std::vector<header> headers;
 
   /// The content to be sent in the reply.
   std::string content;
 
+  /// Content shared with other replies. Sent instead of content when set.
+  boost::shared_ptr<const std::vector<char> > shared_content;
+
+  /// The content of a close_delimited or chunked reply. Read by the connection
+  /// one part at a time as the client takes the data.
+  SMPTE_SYNC::DataStreamPtr stream;
+
   /// Convert the reply into a vector of buffers. The buffers do not own the
   /// underlying memory blocks, therefore the reply object must remain valid and
   /// not be changed until the write operation has completed.
   std::vector<boost::asio::const_buffer> to_buffers();
 
+  /// Convert the status line and headers into a string. Used when the content
+  /// is streamed rather than buffered. Chunked replies use an HTTP/1.1 status line.
+  std::string headers_to_string() const;
+
+  /// Frame data as a single chunk of a chunked transfer encoding.
+  static std::string to_chunk(const char* data, std::size_t size);
+
+  /// The last chunk terminating a chunked transfer encoding.
+  static const std::string& last_chunk();
+
   /// Get a stock reply.
   static reply stock_reply(status_type status);
 };
@@ -104,7 +104,12 @@ namespace server {
         << " val_count = " << val_count
         << " val_accept = " << val_accept;
         
-        if (populateContentCallback_)
+        // Coalescing identical requests wins over streaming. Streaming is used
+        // only when no shared content callback is set.
+        //
+        bool stream = streamContentCallback_ && !sharedContentCallback_;
+
+        if (populateContentCallback_ || sharedContentCallback_ || stream)
         {
             if (count > maxEditUnitsPerRequest_)
             {
@@ -119,26 +124,64 @@ namespace server {
                  */
             }
             
-            int32_t currentFrame = 0;
-            if (currentFrameCallback_)
-                currentFrame = currentFrameCallback_();
-            
-            int32_t framesAhead = 0;
-            if (currentFrame < start)
-                framesAhead = start - currentFrame;
-            
-            if (framesAhead < maxEditUnitsAheadOfCurrentEditUnitToRequest_)
-            {
-                /*
-                SMPTE_SYNC_LOG << "request_handler::handle_request framesAhead = "
-                << framesAhead
-                << " maxEditUnitsAheadOfCurrentEditUnitToRequest_ = "
-                << maxEditUnitsAheadOfCurrentEditUnitToRequest_;
-                 */
-            }
-            
             if ((val_accept == SMPTE_SYNC::sPlainText) || (val_accept == SMPTE_SYNC::sEncrypted))
             {
+                if (stream)
+                {
+                    // HTTP/1.1 clients get a chunked reply, HTTP/1.0 clients a reply
+                    // that ends when the connection closes
+                    //
+                    bool chunked = (req.http_version_major > 1)
+                                || (req.http_version_major == 1 && req.http_version_minor >= 1);
+
+                    rep.status = reply::ok;
+                    rep.transfer = chunked ? reply::chunked : reply::close_delimited;
+                    rep.headers.resize(2);
+                    rep.headers[0].name = "Content-Type";
+                    rep.headers[0].value = "application/smpte336m";
+                    rep.headers[1].name = "Connection";
+                    rep.headers[1].value = "close";
+                    
+                    if (chunked)
+                    {
+                        rep.headers.resize(3);
+                        rep.headers[2].name = "Transfer-Encoding";
+                        rep.headers[2].value = "chunked";
+                    }
+
+                    rep.stream = streamContentCallback_(val_dataEssenceCodingUL_,
+                                                        start,
+                                                        count,
+                                                        val_accept);
+                    if (!rep.stream)
+                        rep = reply::stock_reply(reply::internal_server_error);
+                    
+                    return;
+                }
+
+                if (sharedContentCallback_)
+                {
+                    // Identical requests in flight share one read and one buffer.
+                    // The reply references the buffer rather than copying it.
+                    //
+                    SMPTE_SYNC::SharedContentPtr content = sharedContentCallback_(val_dataEssenceCodingUL_,
+                                                                                  start,
+                                                                                  count,
+                                                                                  val_accept);
+                    if (!content)
+                        content.reset(new std::vector<char>());
+
+                    rep.status = reply::ok;
+                    rep.headers.resize(2);
+                    rep.headers[0].name = "Content-Length";
+                    rep.headers[0].value = std::to_string(content->size());
+                    rep.headers[1].name = "Content-Type";
+                    rep.headers[1].value = "application/smpte336m";
+                    rep.shared_content = content;
+                    
+                    return;
+                }
+
                 //SMPTE_SYNC_LOG << "About to call populateContentCallback_ currentFrame = " << currentFrame;
 
                 std::vector<char> content;
@@ -172,6 +215,64 @@ namespace server {
         rep = reply::stock_reply(reply::not_found);
     }
 
+    bool request_handler::admit_request(const request& req, reply& rep, int32_t& frames_ahead)
+    {
+        frames_ahead = 0;
+
+        std::string request_path;
+        std::string val_start;
+        if (!url_decode(req.uri, request_path) || !query_value(request_path, "start", val_start))
+        {
+            // Malformed requests are rejected by handle_request
+            //
+            return true;
+        }
+
+        int32_t start = atoi(val_start.c_str());
+
+        int32_t currentFrame = 0;
+        if (currentFrameCallback_)
+            currentFrame = currentFrameCallback_();
+        
+        if (currentFrame < start)
+            frames_ahead = start - currentFrame;
+        
+        int32_t horizon = maxEditUnitsAheadOfCurrentEditUnitToRequest_;
+        if (frames_ahead <= horizon)
+            return true;
+
+        // Too far ahead of playback. Ask the client to come back once the
+        // playhead is within the horizon.
+        //
+        int32_t millisecondsToWait = (frames_ahead - horizon) * millisecondsPerFrame_;
+        int32_t secondsToWait = (millisecondsToWait + 999) / 1000;
+        if (secondsToWait < 1)
+            secondsToWait = 1;
+
+        SMPTE_SYNC_LOG << "request_handler::admit_request rejecting start = " << start
+        << " currentFrame = " << currentFrame
+        << " retry after " << secondsToWait << "s";
+
+        rep = reply::stock_reply(reply::service_unavailable);
+        rep.headers.resize(3);
+        rep.headers[2].name = "Retry-After";
+        rep.headers[2].value = std::to_string(secondsToWait);
+
+        return false;
+    }
+
+    bool request_handler::query_value(const std::string& request_path, const std::string& key, std::string& value)
+    {
+        std::string::size_type strStart = request_path.find(key + "=");
+        if (strStart == std::string::npos)
+            return false;
+
+        strStart += (key + "=").length();
+        std::string::size_type strEnd = request_path.find("&", strStart);
+        value = request_path.substr(strStart, strEnd - strStart);
+        return true;
+    }
+
     bool request_handler::url_decode(const std::string& in, std::string& out)
     {
       out.clear();
@@ -216,6 +317,16 @@ namespace server {
         populateContentCallback_ = iCallback;
     }
 
+    void request_handler::SetStreamContentCallback(StreamCallback iCallback)
+    {
+        streamContentCallback_ = iCallback;
+    }
+
+    void request_handler::SetSharedContentCallback(SharedCallback iCallback)
+    {
+        sharedContentCallback_ = iCallback;
+    }
+
     void request_handler::SetMaxEditUnitsPerRequest(int32_t iUnits)
     {
         maxEditUnitsPerRequest_ = iUnits;
@@ -13,7 +13,9 @@
 
 #include <string>
 #include <vector>
+#include "boost/atomic.hpp"
 #include "boost/function.hpp"
+#include "DataStream.h"
 #include "DataTypes.h"
 
 namespace http {
@@ -31,17 +33,43 @@ public:
                                  int32_t iCount,
                                  const std::string &iEncryptionType,
                                  std::vector<char> &iContent)> Callback;
-    
+
+    typedef boost::function<SMPTE_SYNC::DataStreamPtr(const std::string &iDataEssenceCodingUL_,
+                                                      int32_t iStart,
+                                                      int32_t iCount,
+                                                      const std::string &iEncryptionType)> StreamCallback;
+
+    typedef boost::function<SMPTE_SYNC::SharedContentPtr(const std::string &iDataEssenceCodingUL_,
+                                                         int32_t iStart,
+                                                         int32_t iCount,
+                                                         const std::string &iEncryptionType)> SharedCallback;
+
     request_handler(const request_handler&) = delete;
     request_handler& operator=(const request_handler&) = delete;
 
     explicit request_handler(void);
 
     /// Handle a request and produce a reply.
+    /// A shared content callback takes priority so identical requests in
+    /// flight keep sharing one read and one buffer. Otherwise, when a stream
+    /// callback is set, rep.stream is set to the opened stream and rep.transfer
+    /// to close_delimited or chunked. Nothing is read from the stream here. The
+    /// connection reads it one part at a time as the client takes the data.
     void handle_request(const request& req, reply& rep);
 
+    /// Decide whether a request may be handled now. Returns false and fills in
+    /// a 503 reply with a Retry-After header when the request starts further
+    /// ahead of the current edit unit than the configured horizon. Otherwise
+    /// returns the number of edit units between the current edit unit and the
+    /// start of the request, used to schedule it.
+    bool admit_request(const request& req, reply& rep, int32_t& frames_ahead);
+
     void SetPopulateContentCallback(Callback iCallback);
 
+    void SetStreamContentCallback(StreamCallback iCallback);
+
+    void SetSharedContentCallback(SharedCallback iCallback);
+
     void SetMaxEditUnitsPerRequest(int32_t iUnits);
     int32_t GetMaxEditUnitsPerRequest(void);
     
@@ -57,13 +85,20 @@ private:
     /// Perform URL-decoding on a string. Returns false if the encoding was
     /// invalid.
     static bool url_decode(const std::string& in, std::string& out);
+
+    /// Find the value of key in the query of a decoded request path.
+    static bool query_value(const std::string& request_path, const std::string& key, std::string& value);
     
     Callback populateContentCallback_;
+    StreamCallback streamContentCallback_;
+    SharedCallback sharedContentCallback_;
     SMPTE_SYNC::CurrentFrameCallback currentFrameCallback_;
 
-    int32_t         maxEditUnitsPerRequest_;
-    int32_t         maxEditUnitsAheadOfCurrentEditUnitToRequest_;
-    int32_t         millisecondsPerFrame_;
+    // Requests are handled on several threads while these may be changed at any time
+    //
+    boost::atomic<int32_t>  maxEditUnitsPerRequest_;
+    boost::atomic<int32_t>  maxEditUnitsAheadOfCurrentEditUnitToRequest_;
+    boost::atomic<int32_t>  millisecondsPerFrame_;
 };
 
 } // namespace server
@@ -0,0 +1,157 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "request_scheduler.hpp"
+#include "boost/bind.hpp"
+
+namespace http {
+namespace server {
+
+request_scheduler::request_scheduler(SMPTE_SYNC::WorkerPool& worker_pool)
+  : worker_pool_(worker_pool),
+    sequence_(0),
+    running_speculative_(0),
+    parked_(0),
+    urgent_edit_units_(48), // approximately 2 seconds
+    max_speculative_requests_(1)
+{
+}
+
+void request_scheduler::submit(int32_t frames_ahead, const task& t)
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    entry e;
+    e.frames_ahead = frames_ahead;
+    e.sequence = sequence_++;
+    e.t = t;
+    queue_.push(e);
+  }
+
+  // One run_next per task. The task it runs is picked when it runs, not now,
+  // so a time-critical request submitted later still overtakes prefetch.
+  worker_pool_.Post(boost::bind(&request_scheduler::run_next, this));
+}
+
+void request_scheduler::run_next()
+{
+  entry e;
+  bool speculative = false;
+
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if (queue_.empty())
+      return;
+
+    int32_t max_speculative = max_speculative_requests_;
+    int32_t workers = worker_pool_.GetNumberOfThreads();
+    if (workers > 1 && max_speculative > workers - 1)
+      max_speculative = workers - 1;
+    if (max_speculative < 1)
+      max_speculative = 1;
+
+    speculative = queue_.top().frames_ahead > urgent_edit_units_;
+
+    // Everything queued is speculative and enough of it is already running.
+    // Leave it queued. A finishing speculative task picks it up.
+    if (speculative && running_speculative_ >= max_speculative)
+    {
+      parked_++;
+      return;
+    }
+
+    e = queue_.top();
+    queue_.pop();
+
+    if (speculative)
+      running_speculative_++;
+  }
+
+  if (!speculative)
+  {
+    e.t();
+    return;
+  }
+
+  /// Releases the speculative slot even if the task throws. Otherwise the
+  /// slot would be lost and parked tasks never resumed.
+  struct speculative_guard
+  {
+    request_scheduler* scheduler;
+    ~speculative_guard() { scheduler->finish_speculative(); }
+  } guard = { this };
+
+  e.t();
+}
+
+void request_scheduler::finish_speculative()
+{
+  bool resume = false;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    running_speculative_--;
+    if (parked_ > 0)
+    {
+      parked_--;
+      resume = true;
+    }
+  }
+
+  if (resume)
+    worker_pool_.Post(boost::bind(&request_scheduler::run_next, this));
+}
+
+void request_scheduler::SetUrgentEditUnits(int32_t iUnits)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  urgent_edit_units_ = iUnits;
+}
+
+int32_t request_scheduler::GetUrgentEditUnits(void)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return urgent_edit_units_;
+}
+
+void request_scheduler::SetMaxSpeculativeRequests(int32_t iRequests)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  max_speculative_requests_ = iRequests;
+}
+
+int32_t request_scheduler::GetMaxSpeculativeRequests(void)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return max_speculative_requests_;
+}
+
+} // namespace server
+} // namespace http
@@ -0,0 +1,126 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef HTTP_REQUEST_SCHEDULER_HPP
+#define HTTP_REQUEST_SCHEDULER_HPP
+
+#include <stdint.h>
+#include <queue>
+#include <vector>
+#include "boost/function.hpp"
+#include "boost/thread/mutex.hpp"
+#include "WorkerPool.h"
+
+namespace http {
+namespace server {
+
+/// Orders request handling by how soon the requested edit units are played.
+/// Requests starting within the urgent window of the current edit unit are
+/// time-critical and always run first. Requests further ahead are speculative
+/// prefetch; only a limited number of them run at once so at least one worker
+/// is left for time-critical requests.
+class request_scheduler
+{
+public:
+  typedef boost::function<void(void)> task;
+
+  request_scheduler(const request_scheduler&) = delete;
+  request_scheduler& operator=(const request_scheduler&) = delete;
+
+  /// Construct a scheduler running tasks on the given pool.
+  explicit request_scheduler(SMPTE_SYNC::WorkerPool& worker_pool);
+
+  /// Queue a task. Tasks with fewer frames ahead run first. Tasks with the
+  /// same number of frames ahead run in the order they were submitted.
+  void submit(int32_t frames_ahead, const task& t);
+
+  /// Requests starting more than this many edit units ahead are speculative.
+  void SetUrgentEditUnits(int32_t iUnits);
+  int32_t GetUrgentEditUnits(void);
+
+  /// The maximum number of speculative requests running at once.
+  /// Limited to one less than the number of workers when there is more than one.
+  void SetMaxSpeculativeRequests(int32_t iRequests);
+  int32_t GetMaxSpeculativeRequests(void);
+
+private:
+  /// A queued task.
+  struct entry
+  {
+    int32_t frames_ahead;
+    uint64_t sequence;
+    task t;
+
+    /// Orders the priority queue so the smallest frames_ahead is on top.
+    bool operator<(const entry& other) const
+    {
+      if (frames_ahead != other.frames_ahead)
+        return frames_ahead > other.frames_ahead;
+      return sequence > other.sequence;
+    }
+  };
+
+  /// Runs on the worker pool. Runs the most urgent queued task, or parks if
+  /// it is speculative and the speculative limit has been reached.
+  void run_next();
+
+  /// Releases the slot of a speculative task that has finished and resumes a
+  /// parked run_next if there is one.
+  void finish_speculative();
+
+  /// The pool tasks are run on.
+  SMPTE_SYNC::WorkerPool& worker_pool_;
+
+  /// Protects queue_, sequence_, running_speculative_, parked_,
+  /// urgent_edit_units_ and max_speculative_requests_.
+  boost::mutex mutex_;
+
+  /// Queued tasks, most urgent on top.
+  std::priority_queue<entry> queue_;
+
+  /// Submission counter used to keep equal priorities in order.
+  uint64_t sequence_;
+
+  /// Number of speculative tasks running.
+  int32_t running_speculative_;
+
+  /// Number of run_next calls that found only speculative work over the limit.
+  int32_t parked_;
+
+  /// Requests starting more than this many edit units ahead are speculative.
+  int32_t urgent_edit_units_;
+
+  /// The maximum number of speculative requests running at once.
+  int32_t max_speculative_requests_;
+};
+
+} // namespace server
+} // namespace http
+
+#endif // HTTP_REQUEST_SCHEDULER_HPP
@@ -17,12 +17,15 @@ namespace server {
 
 server::server(boost::asio::io_service& io_service,
                const std::string& address,
-               const std::string& port)
+               const std::string& port,
+               int32_t iNumberOfAcceptors,
+               int32_t iNumberOfDiskThreads)
     :   io_service_(io_service),
         signals_(io_service_),
-        acceptor_(io_service_),
+        acceptors_(),
         connection_manager_(),
-        socket_(io_service_)
+        disk_worker_pool_(iNumberOfDiskThreads, "SS disk"),
+        request_scheduler_(disk_worker_pool_)
 {
   // Register to handle the signals that indicate when the server should exit.
   // It is safe to register for the same signal multiple times in a program,
@@ -35,22 +38,67 @@ server::server(boost::asio::io_service& io_service,
 
   do_await_stop();
 
-  // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR).
+  // Without SO_REUSEPORT a second acceptor cannot bind the same endpoint.
+#if !defined(SO_REUSEPORT)
+  iNumberOfAcceptors = 1;
+#endif // !defined(SO_REUSEPORT)
+
+  if (iNumberOfAcceptors < 1)
+    iNumberOfAcceptors = 1;
+
+  // Open the acceptors with the option to reuse the address (i.e. SO_REUSEADDR).
+  // Each acceptor additionally sets SO_REUSEPORT so the kernel spreads incoming
+  // connections across them.
   boost::asio::ip::tcp::resolver resolver(io_service_);
   boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve({address, port});
-  acceptor_.open(endpoint.protocol());
-  acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-  acceptor_.bind(endpoint);
-  acceptor_.listen();
 
-  do_accept();
+  for (int32_t i = 0; i < iNumberOfAcceptors; i++)
+  {
+    std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor =
+        std::make_shared<boost::asio::ip::tcp::acceptor>(io_service_);
+    acceptor->open(endpoint.protocol());
+    acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+#if defined(SO_REUSEPORT)
+    acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+#endif // defined(SO_REUSEPORT)
+    acceptor->bind(endpoint);
+    acceptor->listen();
+    acceptors_.push_back(acceptor);
+  }
+
+  for (auto acceptor : acceptors_)
+    do_accept(acceptor);
 }
 
+    void server::Run(int32_t iNumberOfIOThreads)
+    {
+        boost::thread_group ioThreads;
+        
+        for (int32_t i = 1; i < iNumberOfIOThreads; i++)
+        {
+            ioThreads.create_thread([this]() { io_service_.run(); });
+        }
+        
+        io_service_.run();
+        
+        ioThreads.join_all();
+    }
+
     void server::SetPopulateContentCallback(request_handler::Callback iCallback)
     {
         request_handler_.SetPopulateContentCallback(iCallback);
     }
     
+    void server::SetStreamContentCallback(request_handler::StreamCallback iCallback)
+    {
+        request_handler_.SetStreamContentCallback(iCallback);
+    }
+    
+    void server::SetSharedContentCallback(request_handler::SharedCallback iCallback)
+    {
+        request_handler_.SetSharedContentCallback(iCallback);
+    }
+    
     void server::SetMaxEditUnitsPerRequest(int32_t iUnits)
     {
         request_handler_.SetMaxEditUnitsPerRequest(iUnits);
@@ -86,14 +134,39 @@ server::server(boost::asio::io_service& io_service,
         request_handler_.SetCurrentFrameCallback(iCallback);
     }
 
-void server::do_accept()
+    void server::SetUrgentEditUnits(int32_t iUnits)
+    {
+        request_scheduler_.SetUrgentEditUnits(iUnits);
+    }
+    
+    int32_t server::GetUrgentEditUnits(void)
+    {
+        return request_scheduler_.GetUrgentEditUnits();
+    }
+    
+    void server::SetMaxSpeculativeRequests(int32_t iRequests)
+    {
+        request_scheduler_.SetMaxSpeculativeRequests(iRequests);
+    }
+    
+    int32_t server::GetMaxSpeculativeRequests(void)
+    {
+        return request_scheduler_.GetMaxSpeculativeRequests();
+    }
+
+void server::do_accept(std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor)
 {
-  acceptor_.async_accept(socket_,
-      [this](boost::system::error_code ec)
+  // Each pending accept gets its own socket so acceptors running on different
+  // io threads never share one.
+  std::shared_ptr<boost::asio::ip::tcp::socket> socket =
+      std::make_shared<boost::asio::ip::tcp::socket>(io_service_);
+
+  acceptor->async_accept(*socket,
+      [this, acceptor, socket](boost::system::error_code ec)
       {
         // Check whether the server was stopped by a signal before this
         // completion handler had a chance to run.
-        if (!acceptor_.is_open())
+        if (!acceptor->is_open())
         {
           return;
         }
@@ -103,10 +176,11 @@ void server::do_accept()
             this->SetState(eState_Connected);
             
           connection_manager_.start(std::make_shared<connection>(
-              std::move(socket_), connection_manager_, request_handler_));
+              std::move(*socket), io_service_, connection_manager_,
+              request_handler_, request_scheduler_));
         }
 
-        do_accept();
+        do_accept(acceptor);
       });
 }
 
@@ -118,7 +192,8 @@ void server::do_await_stop()
         // The server is stopped by cancelling all outstanding asynchronous
         // operations. Once all operations have finished the io_service::run()
         // call will exit.
-        acceptor_.close();
+        for (auto acceptor : acceptors_)
+          acceptor->close();
         connection_manager_.stop_all();
       });
 }
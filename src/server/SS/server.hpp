@@ -12,11 +12,16 @@
 #define HTTP_SERVER_HPP
 
 #include <string>
+#include <vector>
+#include <memory>
 #include "boost/asio.hpp"
+#include "boost/thread/thread.hpp"
 #include "connection.hpp"
 #include "connection_manager.hpp"
 #include "request_handler.hpp"
+#include "request_scheduler.hpp"
 #include "SS_State.h"
+#include "WorkerPool.h"
 
 namespace http {
 namespace server {
@@ -30,16 +35,37 @@ public:
 
     virtual ~server()
     {
+        // Stop running requests before the handler and scheduler they use go away
+        disk_worker_pool_.Stop();
     }
     
     /// Construct the server to listen on the specified TCP address and port, and
     /// serve up files from the given directory.
+    /// iNumberOfAcceptors acceptors are bound to the same endpoint using SO_REUSEPORT
+    /// where the platform supports it. Requests are handled on a pool of
+    /// iNumberOfDiskThreads threads so blocking reads never run on the io threads.
     explicit server(boost::asio::io_service& io_service,
                     const std::string& address,
-                    const std::string& port);
+                    const std::string& port,
+                    int32_t iNumberOfAcceptors = 1,
+                    int32_t iNumberOfDiskThreads = 2);
+
+    /// Run the io_service on iNumberOfIOThreads threads, including the calling
+    /// thread. Blocks until the io_service runs out of work or is stopped.
+    virtual void Run(int32_t iNumberOfIOThreads);
 
     virtual void SetPopulateContentCallback(request_handler::Callback iCallback);
 
+    /// When set, replies are streamed to the client from the DataStream the
+    /// callback opens instead of being buffered by SetPopulateContentCallback.
+    /// The next part is only read once the previous parts have been written.
+    virtual void SetStreamContentCallback(request_handler::StreamCallback iCallback);
+
+    /// When set, buffered replies reference content shared between identical
+    /// requests instead of copying content from SetPopulateContentCallback.
+    /// Takes priority over SetStreamContentCallback when both are set.
+    virtual void SetSharedContentCallback(request_handler::SharedCallback iCallback);
+
     virtual void SetMaxEditUnitsPerRequest(int32_t iUnits);
     
     virtual int32_t GetMaxEditUnitsPerRequest(void);
@@ -54,9 +80,19 @@ public:
     
     virtual void SetCurrentFrameCallback(SMPTE_SYNC::CurrentFrameCallback iCallback);
 
+    /// Requests starting within this many edit units of the current edit unit are time-critical
+    virtual void SetUrgentEditUnits(int32_t iUnits);
+    
+    virtual int32_t GetUrgentEditUnits(void);
+    
+    /// Maximum number of speculative (not time-critical) requests handled at once
+    virtual void SetMaxSpeculativeRequests(int32_t iRequests);
+    
+    virtual int32_t GetMaxSpeculativeRequests(void);
+
 private:
-  /// Perform an asynchronous accept operation.
-  void do_accept();
+  /// Perform an asynchronous accept operation on the given acceptor.
+  void do_accept(std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor);
 
   /// Wait for a request to stop the server.
   void do_await_stop();
@@ -67,17 +103,20 @@ private:
   /// The signal_set is used to register for process termination notifications.
   boost::asio::signal_set signals_;
 
-  /// Acceptor used to listen for incoming connections.
-  boost::asio::ip::tcp::acceptor acceptor_;
+  /// Acceptors used to listen for incoming connections.
+  std::vector<std::shared_ptr<boost::asio::ip::tcp::acceptor> > acceptors_;
 
   /// The connection manager which owns all live connections.
   connection_manager connection_manager_;
 
-  /// The next socket to be accepted.
-  boost::asio::ip::tcp::socket socket_;
-
   /// The handler for all incoming requests.
   request_handler request_handler_;
+
+  /// Runs request handling off of the io threads.
+  SMPTE_SYNC::WorkerPool disk_worker_pool_;
+
+  /// Orders requests on disk_worker_pool_ by how close they are to playback.
+  request_scheduler request_scheduler_;
 };
 
 } // namespace server
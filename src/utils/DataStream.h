@@ -0,0 +1,73 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef DATASTREAM_H
+#define DATASTREAM_H
+
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief DataStream hands out a response one part at a time so the receiver decides when the next part is read.
+     * The SS_Server pulls the next part once the previous ones have been written to the client,
+     * so a slow client never holds a thread waiting to write.
+     * A DataStream is read by one thread at a time.
+     *
+     */
+    class DataStream
+    {
+    public:
+
+        /// Destructor
+        virtual ~DataStream(void) {}
+
+        /**
+         *
+         * Reads the next part of the stream.
+         *
+         * @param oData is the buffer the next part is appended to
+         * @return bool true if more parts may follow, false once the stream has ended
+         *
+         */
+        virtual bool Read(std::vector<char> &oData) = 0;
+
+        /// Returns true once everything announced at the start of the stream has been read
+        virtual bool IsComplete(void) = 0;
+    };
+
+    /// Reference to a DataStream shared by the request handler and the connection writing it
+    typedef boost::shared_ptr<DataStream> DataStreamPtr;
+
+}  // namespace SMPTE_SYNC
+
+#endif // DATASTREAM_H
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
 
 #include "sync.h"
 
@@ -85,10 +86,10 @@ namespace SMPTE_SYNC {
         {
             currentFrameDuration_ = 0;
             primaryPictureTrackFileEditUnitIndex_ = 0;
-            Initialize(primaryPictureTrackFileUUID_);
+            primaryPictureTrackFileUUID_.Clear();
             primarySoundTrackFileEditUnitIndex_ = 0;
-            Initialize(primarySoundTrackFileUUID_);
-            Initialize(compositionPlaylistUUID_);
+            primarySoundTrackFileUUID_.Clear();
+            compositionPlaylistUUID_.Clear();
             dataEssenceCodingUL_ = "";
             editUnitRateNumerator_ = 0;
             editUnitRateDenominator_ = 0;
@@ -106,6 +107,55 @@ namespace SMPTE_SYNC {
         int32_t    editUnitRateDenominator_;
     } FrameInfo;
 
+    /**
+     *
+     * @brief FrameInfoRun describes consecutive frames that play the same track files, typically one reel.
+     * The FrameInfo of each frame is frameInfo_ with the edit unit indexes advanced by the offset of the frame into the run.
+     * Lets the SE_Server walk the whole Show without asking the Show for every frame.
+     *
+     * @struct FrameInfoRun
+     *
+     */
+    typedef struct FrameInfoRun
+    {
+        /// Constructor
+        FrameInfoRun() :
+              startFrame_(0)
+            , endFrame_(-1)
+            , hasSound_(false)
+        {
+        }
+
+        /// Fills oFrameInfo for iFrame. iFrame must be in the run.
+        void GetFrameInfo(int32_t iFrame, FrameInfo &oFrameInfo) const
+        {
+            oFrameInfo = frameInfo_;
+            oFrameInfo.primaryPictureTrackFileEditUnitIndex_ += iFrame - startFrame_;
+
+            if (hasSound_)
+                oFrameInfo.primarySoundTrackFileEditUnitIndex_ += iFrame - startFrame_;
+        }
+
+        /// First frame of the run on the Show timeline
+        int32_t     startFrame_;
+
+        /// Last frame of the run on the Show timeline
+        int32_t     endFrame_;
+
+        /// True if the frames have a main sound track file
+        bool        hasSound_;
+
+        /// FrameInfo of startFrame_
+        FrameInfo   frameInfo_;
+    } FrameInfoRun;
+
+    /**
+     *
+     * @brief List of FrameInfoRun sorted by frame covering a Show
+     *
+     */
+    typedef std::vector<FrameInfoRun> FrameInfoRunList;
+
     /**
      *
      * @brief This is a list of path to CPL files. The CPL objects will be added to the Show based on the order they appear in this list.
@@ -152,12 +202,34 @@ namespace SMPTE_SYNC {
      */
     typedef boost::function<void(uint32_t)> SetPlayoutIDCallback;
 
+    /**
+     *
+     * @brief Callback function definition for a DCS_Message_UpdateTimelineRequest moving the playhead to a new timeline position in edit units. Used by DCS_Client.
+     *
+     */
+    typedef boost::function<void(uint64_t iTimelinePosition)> UpdateTimelineCallback;
+
     /**
      *
      * @brief Callback function definition for getting the current frame information from the Show. Used by SE_Server.
      *
      */
     typedef boost::function<bool(int32_t iFrame, FrameInfo& oFrameInfo)> GetFrameDataCallback;
+
+    /**
+     *
+     * @brief Callback function definition for getting the information of iCount consecutive frames from the Show. Used by SE_Server.
+     * Fills oFrameInfo[0] through oFrameInfo[iCount - 1] and returns the number of frames filled, stopping at the first frame not in the Show.
+     *
+     */
+    typedef boost::function<int32_t(int32_t iStart, int32_t iCount, FrameInfo *oFrameInfo)> GetFrameDataRangeCallback;
+
+    /**
+     *
+     * @brief Immutable bytes shared by reference count. Lets many SS_Server connections send the same response without copying it.
+     *
+     */
+    typedef boost::shared_ptr<const std::vector<char> > SharedContentPtr;
     
 } // namespace SMPTE_SYNC
 
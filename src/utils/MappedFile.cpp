@@ -0,0 +1,150 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "MappedFile.h"
+
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    MappedFile::MappedFile() :
+          data_(nullptr)
+        , size_(0)
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        this->Close();
+    }
+
+    bool MappedFile::Open(const std::string &iPath)
+    {
+        this->Close();
+
+#if !defined(_WIN32)
+        int fd = ::open(iPath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            SMPTE_SYNC_LOG << "MappedFile::Open - Failed to open iPath = " << iPath;
+            return false;
+        }
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+        {
+            SMPTE_SYNC_LOG << "MappedFile::Open - Failed to stat iPath = " << iPath;
+            ::close(fd);
+            return false;
+        }
+
+        void *data = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+        // The mapping keeps its own reference to the file
+        //
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            SMPTE_SYNC_LOG << "MappedFile::Open - Failed to map iPath = " << iPath;
+            return false;
+        }
+
+        data_ = static_cast<uint8_t*>(data);
+        size_ = static_cast<uint64_t>(fileStat.st_size);
+
+        return true;
+#else
+        SMPTE_SYNC_LOG << "MappedFile::Open - not supported on this platform";
+        return false;
+#endif
+    }
+
+    void MappedFile::Close(void)
+    {
+#if !defined(_WIN32)
+        if (data_ != nullptr)
+            ::munmap(data_, static_cast<size_t>(size_));
+#endif
+
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool MappedFile::IsOpen(void) const
+    {
+        return data_ != nullptr;
+    }
+
+    const uint8_t* MappedFile::GetData(void) const
+    {
+        return data_;
+    }
+
+    uint64_t MappedFile::GetSize(void) const
+    {
+        return size_;
+    }
+
+    void MappedFile::AdviseSequential(void)
+    {
+#if !defined(_WIN32)
+        if (data_ != nullptr)
+            ::madvise(data_, static_cast<size_t>(size_), MADV_SEQUENTIAL);
+#endif
+    }
+
+    void MappedFile::AdviseWillNeed(uint64_t iOffset, uint64_t iLength)
+    {
+#if !defined(_WIN32)
+        if (data_ == nullptr || iOffset >= size_)
+            return;
+
+        if (iLength > size_ - iOffset)
+            iLength = size_ - iOffset;
+
+        // madvise requires a page aligned address
+        //
+        uint64_t pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        uint64_t alignedOffset = iOffset - (iOffset % pageSize);
+
+        ::madvise(data_ + alignedOffset, static_cast<size_t>(iLength + (iOffset - alignedOffset)), MADV_WILLNEED);
+#endif
+    }
+
+}  // namespace SMPTE_SYNC
@@ -0,0 +1,108 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stdint.h>
+#include <string>
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief MappedFile maps a whole file read only into memory.
+     * Clients read the file through pointers into the mapping, served from the page cache without copies.
+     * Pages are shared by every reader of the same file, in this process and others.
+     * Mapping is only supported on POSIX systems. Open fails elsewhere so clients can fall back to reading the file.
+     *
+     */
+
+    class MappedFile
+    {
+    public:
+
+        /// Constructor
+        MappedFile();
+
+        /// Destructor. Calls Close.
+        ~MappedFile();
+
+        /**
+         *
+         * Maps the file at iPath
+         *
+         * @param iPath is the path to the file to be mapped
+         * @return bool true/false if the file was mapped
+         *
+         */
+        bool Open(const std::string &iPath);
+
+        /// Unmaps the file. Pointers returned by GetData are no longer valid.
+        void Close(void);
+
+        /// Returns true if a file is mapped
+        bool IsOpen(void) const;
+
+        /// Returns the start of the mapping. nullptr if no file is mapped.
+        const uint8_t* GetData(void) const;
+
+        /// Returns the size of the mapped file in bytes
+        uint64_t GetSize(void) const;
+
+        /// Hints that the mapping will be read mostly in increasing order
+        void AdviseSequential(void);
+
+        /**
+         *
+         * Hints that a range of the file will be read soon so the kernel can start reading it into the page cache.
+         * The range is clipped to the file.
+         *
+         * @param iOffset is the offset of the range in the file
+         * @param iLength is the length of the range
+         *
+         */
+        void AdviseWillNeed(uint64_t iOffset, uint64_t iLength);
+
+    private:
+
+        /// Not copyable
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+        /// The start of the mapping
+        uint8_t     *data_;
+
+        /// The size of the mapping in bytes
+        uint64_t    size_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,218 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <stdint.h>
+#include <exception>
+#include <map>
+
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/mutex.hpp"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief SingleFlight runs a function at most once at a time for each key.
+     * Callers asking for a key that is already being computed wait for that call and get its result instead of running the function again.
+     * The result is copied to every caller so Value is expected to be cheap to copy, for example a boost::shared_ptr.
+     * If the function throws, every caller waiting on that call gets the same exception and the next caller for the key runs the function again.
+     * Threadsafe.
+     *
+     */
+
+    template <typename Key, typename Value>
+    class SingleFlight
+    {
+    public:
+
+        /// Function computing the value of a key
+        typedef boost::function<Value(void)> Function;
+
+        /// Constructor
+        SingleFlight() :
+              numberOfSharedCalls_(0)
+        {
+        }
+
+        /**
+         *
+         * Runs iFunction for iKey unless a call for iKey is already in flight, in which case waits for it and returns its result.
+         *
+         * @param iKey identifies the value being computed
+         * @param iFunction computes the value. Only run if no call for iKey is in flight.
+         * @param oShared is set to true if the result came from a call made by another caller. May be nullptr.
+         * @return Value computed for iKey
+         * @throws whatever iFunction throws, also to the callers waiting on it
+         *
+         */
+        Value Do(const Key &iKey, const Function &iFunction, bool *oShared = nullptr)
+        {
+            boost::shared_ptr<Call> call;
+            bool leader = false;
+
+            {
+                boost::mutex::scoped_lock scoped_lock(mutex_);
+
+                typename std::map<Key, boost::shared_ptr<Call> >::iterator iter = calls_.find(iKey);
+                if (iter != calls_.end())
+                {
+                    call = iter->second;
+                    numberOfSharedCalls_++;
+                }
+                else
+                {
+                    call.reset(new Call);
+                    calls_[iKey] = call;
+                    leader = true;
+                }
+            }
+
+            if (oShared != nullptr)
+                *oShared = !leader;
+
+            if (!leader)
+            {
+                boost::mutex::scoped_lock call_lock(call->mutex_);
+                while (!call->done_)
+                    call->doneCondition_.wait(call_lock);
+
+                if (call->exception_)
+                    std::rethrow_exception(call->exception_);
+
+                return call->value_;
+            }
+
+            Value value;
+
+            try
+            {
+                value = iFunction();
+            }
+            catch (...)
+            {
+                // Release the waiters and the key before passing the exception on
+                //
+                this->Complete(iKey, call, Value(), std::current_exception());
+                throw;
+            }
+
+            this->Complete(iKey, call, value, std::exception_ptr());
+
+            return value;
+        }
+
+        /// Returns the number of calls that got their result from another caller
+        uint64_t GetNumberOfSharedCalls(void)
+        {
+            boost::mutex::scoped_lock scoped_lock(mutex_);
+            return numberOfSharedCalls_;
+        }
+
+        /// Resets the count of shared calls
+        void ResetStatistics(void)
+        {
+            boost::mutex::scoped_lock scoped_lock(mutex_);
+            numberOfSharedCalls_ = 0;
+        }
+
+    private:
+
+        /**
+         *
+         * @brief Call is a single in-flight computation and its result
+         *
+         */
+        typedef struct Call
+        {
+            /// Constructor
+            Call() :
+                  done_(false)
+            {
+            }
+
+            /// Protects done_ and value_
+            boost::mutex                mutex_;
+
+            /// Signaled once value_ is set
+            boost::condition_variable   doneCondition_;
+
+            /// Set once the leader has computed value_
+            bool                        done_;
+
+            /// The computed value
+            Value                       value_;
+
+            /// Set instead of value_ if the leader's function threw
+            std::exception_ptr          exception_;
+        } Call;
+
+        /**
+         *
+         * Removes the call for iKey from calls_ and hands its result to the callers waiting on it
+         *
+         * @param iKey identifies the call
+         * @param ioCall is the call
+         * @param iValue is the computed value
+         * @param iException is the exception thrown computing the value, if any
+         *
+         */
+        void Complete(const Key &iKey, const boost::shared_ptr<Call> &ioCall, const Value &iValue, std::exception_ptr iException)
+        {
+            {
+                boost::mutex::scoped_lock scoped_lock(mutex_);
+                calls_.erase(iKey);
+            }
+
+            {
+                boost::mutex::scoped_lock call_lock(ioCall->mutex_);
+                ioCall->value_ = iValue;
+                ioCall->exception_ = iException;
+                ioCall->done_ = true;
+            }
+            ioCall->doneCondition_.notify_all();
+        }
+
+        /// Protects calls_ and numberOfSharedCalls_
+        boost::mutex                                mutex_;
+
+        /// Calls in flight
+        std::map<Key, boost::shared_ptr<Call> >     calls_;
+
+        /// Number of calls that waited on another caller
+        uint64_t                                    numberOfSharedCalls_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // SINGLEFLIGHT_H
@@ -0,0 +1,109 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#include "WorkerPool.h"
+
+#include <string>
+
+#include "Logger.h"
+
+namespace SMPTE_SYNC
+{
+    WorkerPool::WorkerPool(int32_t iNumberOfThreads, const std::string &iName) :
+          name_(iName)
+        , work_(nullptr)
+        , numberOfThreads_(iNumberOfThreads > 0 ? iNumberOfThreads : 1)
+        , stopped_(false)
+    {
+        SMPTE_SYNC_LOG << "WorkerPool::WorkerPool " << name_ << " numberOfThreads_ = " << numberOfThreads_;
+
+        work_ = new boost::asio::io_service::work(ioService_);
+
+        for (int32_t i = 0; i < numberOfThreads_; i++)
+        {
+            threads_.create_thread(boost::bind(&WorkerPool::Run, this));
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        SMPTE_SYNC_LOG << "WorkerPool::~WorkerPool " << name_;
+
+        this->Stop();
+    }
+
+    void WorkerPool::Post(const Task &iTask)
+    {
+        if (stopped_)
+            return;
+
+        ioService_.post(iTask);
+    }
+
+    void WorkerPool::Stop(void)
+    {
+        if (stopped_.exchange(true))
+            return;
+
+        delete work_;
+        work_ = nullptr;
+
+        ioService_.stop();
+        threads_.join_all();
+    }
+
+    int32_t WorkerPool::GetNumberOfThreads(void)
+    {
+        return numberOfThreads_;
+    }
+
+    boost::asio::io_service& WorkerPool::GetIOService(void)
+    {
+        return ioService_;
+    }
+
+    void WorkerPool::Run(void)
+    {
+        // A task throwing should not take down the whole pool
+        //
+        while (!stopped_)
+        {
+            try
+            {
+                ioService_.run();
+                break;
+            }
+            catch (std::exception &e)
+            {
+                SMPTE_SYNC_LOG << "WorkerPool::Run " << name_ << " task threw an exception: " << e.what();
+            }
+        }
+    }
+
+}  // namespace SMPTE_SYNC
@@ -0,0 +1,123 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <stdint.h>
+#include <string>
+
+#include "boost/asio.hpp"
+#include "boost/atomic.hpp"
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+#include "boost/thread/thread.hpp"
+
+namespace SMPTE_SYNC
+{
+    /**
+     *
+     * @brief WorkerPool runs tasks on a fixed number of threads.
+     * It is used to move blocking work, such as reading MXF files, off of the threads running network IO.
+     * Tasks are run in the order they are posted but may complete in any order when there is more than one thread.
+     *
+     */
+
+    class WorkerPool
+    {
+    public:
+
+        /// Task to be run on one of the threads of the WorkerPool
+        typedef boost::function<void(void)> Task;
+
+        /**
+         *
+         * Constructor
+         * Starts the threads of the WorkerPool.
+         *
+         * @param iNumberOfThreads is the number of threads running tasks. At least one thread is always started.
+         * @param iName is the name of the pool used for logging
+         *
+         */
+        WorkerPool(int32_t iNumberOfThreads, const std::string &iName);
+
+        /// Destructor. Calls Stop.
+        ~WorkerPool();
+
+        /**
+         *
+         * Queues a task to be run on one of the threads of the WorkerPool.
+         * Tasks posted after Stop is called are discarded.
+         *
+         * @param iTask is the task to run
+         *
+         */
+        void Post(const Task &iTask);
+
+        /**
+         *
+         * Stops the WorkerPool. Tasks that have not started yet are discarded.
+         * Waits for running tasks to complete and joins all threads.
+         *
+         */
+        void Stop(void);
+
+        /// Returns the number of threads running tasks
+        int32_t GetNumberOfThreads(void);
+
+        /// Returns the io_service the tasks are run on. Allows asynchronous operations to complete on the WorkerPool threads.
+        boost::asio::io_service& GetIOService(void);
+
+    private:
+
+        /// Runs ioService_ on each thread of the pool
+        void Run(void);
+
+        /// Name of the pool used for logging
+        std::string                         name_;
+
+        /// The io_service tasks are posted to
+        boost::asio::io_service             ioService_;
+
+        /// Keeps the threads running while there are no tasks to run
+        boost::asio::io_service::work       *work_;
+
+        /// The threads running tasks
+        boost::thread_group                 threads_;
+
+        /// Number of threads running tasks
+        int32_t                             numberOfThreads_;
+
+        /// Set once Stop has been called
+        boost::atomic<bool>                 stopped_;
+    };
+
+}  // namespace SMPTE_SYNC
+
+#endif // WORKERPOOL_H
@@ -0,0 +1,224 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  AssetMapCache_Test.cpp
+//
+//
+
+#include "AssetMapCache_Test.h"
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+#include "AssetMapCache.h"
+#include "CPLParser.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static const char *sPictureId = "0123abcd-4567-89ef-0123-456789abcdef";
+static const char *sSoundId = "11111111-2222-3333-4444-555555555555";
+static const char *sAuxDataId = "66666666-7777-8888-9999-aaaaaaaaaaaa";
+
+// Writes an ASSETMAP.xml listing the first iNumberOfAssets of the picture, sound and aux data assets
+//
+static void WriteAssetMap(const std::string &iDirectory, int32_t iNumberOfAssets)
+{
+    const char *ids[] = { sPictureId, sSoundId, sAuxDataId };
+    const char *paths[] = { "picture.mxf", "sound.mxf", "aux.mxf" };
+
+    std::ofstream file(CPLParser::GetAssetMapPath(iDirectory).c_str(), std::ios::trunc);
+
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<AssetMap>\n<AssetList>\n";
+
+    for (int32_t index = 0; index < iNumberOfAssets; index++)
+    {
+        file << "<Asset><Id>urn:uuid:" << ids[index] << "</Id><ChunkList><Chunk>"
+             << "<Path>" << paths[index] << "</Path><VolumeIndex>1</VolumeIndex>"
+             << "<Offset>0</Offset><Length>" << (index + 1) * 1000 << "</Length>"
+             << "</Chunk></ChunkList></Asset>\n";
+    }
+
+    file << "</AssetList>\n</AssetMap>\n";
+}
+
+// Sets the modification time of a file to iSeconds past the epoch
+//
+static bool SetModificationTime(const std::string &iPath, time_t iSeconds)
+{
+    struct timespec times[2];
+    times[0].tv_sec = iSeconds;
+    times[0].tv_nsec = 0;
+    times[1].tv_sec = iSeconds;
+    times[1].tv_nsec = 0;
+
+    return utimensat(AT_FDCWD, iPath.c_str(), times, 0) == 0;
+}
+
+static std::string CreateDirectory(void)
+{
+    char directory[] = "/tmp/AssetMapCache_Test.XXXXXX";
+
+    if (mkdtemp(directory) == nullptr)
+        return std::string();
+
+    return std::string(directory) + "/";
+}
+
+static void RemoveDirectory(const std::string &iDirectory)
+{
+    std::remove(CPLParser::GetAssetMapPath(iDirectory).c_str());
+    rmdir(iDirectory.c_str());
+}
+
+TEST(AssetMapCache_Test, AssetMapCache_Test_Find)
+{
+    std::string directory = CreateDirectory();
+    ASSERT_FALSE(directory.empty());
+
+    WriteAssetMap(directory, 2);
+
+    AssetMapCache cache;
+    ASSERT_EQ(0u, cache.GetNumberOfParses());
+
+    AssetFileInfoMapPtr assetMap = cache.Find(directory);
+    ASSERT_TRUE(assetMap != nullptr);
+    ASSERT_EQ(2u, assetMap->size());
+    ASSERT_EQ(1u, cache.GetNumberOfParses());
+
+    UUID pictureId;
+    ASSERT_TRUE(UUID::FromString(sPictureId, pictureId));
+
+    AssetFileInfoMap::const_iterator iter = assetMap->find(pictureId);
+    ASSERT_TRUE(iter != assetMap->end());
+    ASSERT_EQ(1u, iter->second.chunkList_.size());
+    ASSERT_EQ(directory + "picture.mxf", iter->second.chunkList_[0].path_);
+    ASSERT_EQ(1000, iter->second.chunkList_[0].length_);
+
+    // The CPLs of a package share one parse
+    //
+    for (int32_t index = 0; index < 10; index++)
+        ASSERT_TRUE(cache.Find(directory) == assetMap);
+
+    ASSERT_EQ(1u, cache.GetNumberOfParses());
+
+    // Directories are cached separately
+    //
+    std::string otherDirectory = CreateDirectory();
+    ASSERT_FALSE(otherDirectory.empty());
+
+    WriteAssetMap(otherDirectory, 3);
+
+    ASSERT_EQ(3u, cache.Find(otherDirectory)->size());
+    ASSERT_EQ(2u, cache.Find(directory)->size());
+    ASSERT_EQ(2u, cache.GetNumberOfParses());
+
+    RemoveDirectory(otherDirectory);
+    RemoveDirectory(directory);
+}
+
+TEST(AssetMapCache_Test, AssetMapCache_Test_Changed)
+{
+    std::string directory = CreateDirectory();
+    ASSERT_FALSE(directory.empty());
+
+    std::string path = CPLParser::GetAssetMapPath(directory);
+
+    WriteAssetMap(directory, 2);
+    ASSERT_TRUE(SetModificationTime(path, 1000000));
+
+    AssetMapCache cache;
+    AssetFileInfoMapPtr assetMap = cache.Find(directory);
+    ASSERT_EQ(2u, assetMap->size());
+    ASSERT_EQ(1u, cache.GetNumberOfParses());
+
+    // A different size is parsed again even with the same modification time
+    //
+    WriteAssetMap(directory, 3);
+    ASSERT_TRUE(SetModificationTime(path, 1000000));
+
+    AssetFileInfoMapPtr changedAssetMap = cache.Find(directory);
+    ASSERT_EQ(3u, changedAssetMap->size());
+    ASSERT_EQ(2u, cache.GetNumberOfParses());
+
+    // The map handed out before is unchanged
+    //
+    ASSERT_EQ(2u, assetMap->size());
+
+    // A different modification time is parsed again even with the same size
+    //
+    ASSERT_TRUE(SetModificationTime(path, 2000000));
+
+    ASSERT_TRUE(cache.Find(directory) != changedAssetMap);
+    ASSERT_EQ(3u, cache.GetNumberOfParses());
+
+    ASSERT_EQ(3u, cache.Find(directory)->size());
+    ASSERT_EQ(3u, cache.GetNumberOfParses());
+
+    RemoveDirectory(directory);
+}
+
+TEST(AssetMapCache_Test, AssetMapCache_Test_ClearAndMissing)
+{
+    std::string directory = CreateDirectory();
+    ASSERT_FALSE(directory.empty());
+
+    AssetMapCache cache;
+
+    // A missing ASSETMAP.xml gives an empty map and is not cached
+    //
+    AssetFileInfoMapPtr assetMap = cache.Find(directory);
+    ASSERT_TRUE(assetMap != nullptr);
+    ASSERT_TRUE(assetMap->empty());
+    ASSERT_EQ(0u, cache.GetNumberOfParses());
+
+    WriteAssetMap(directory, 2);
+
+    assetMap = cache.Find(directory);
+    ASSERT_EQ(2u, assetMap->size());
+    ASSERT_EQ(1u, cache.GetNumberOfParses());
+
+    cache.Clear();
+
+    ASSERT_EQ(2u, cache.Find(directory)->size());
+    ASSERT_EQ(2u, cache.GetNumberOfParses());
+
+    // Removed after it was cached
+    //
+    RemoveDirectory(directory);
+
+    ASSERT_TRUE(cache.Find(directory)->empty());
+    ASSERT_EQ(2u, cache.GetNumberOfParses());
+}
@@ -0,0 +1,135 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  AuxDataBlockCache_Test.cpp
+//
+//
+
+#include "AuxDataBlockCache_Test.h"
+#include "gtest/gtest.h"
+
+#include "AuxDataBlockCache.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static AuxDataBlockBytesPtr MakeBlock(size_t iSize, char iValue)
+{
+    return AuxDataBlockBytesPtr(new std::vector<char>(iSize, iValue));
+}
+
+TEST(AuxDataBlockCache_Test, AuxDataBlockCache_Test_GetPut)
+{
+    AuxDataBlockCache cache(1024);
+    AuxDataBlockBytesPtr block;
+
+    ASSERT_FALSE(cache.Get("UL", 0, block));
+    ASSERT_TRUE(cache.Put("UL", 0, MakeBlock(100, 'a'), true));
+    ASSERT_TRUE(cache.Get("UL", 0, block));
+    ASSERT_EQ(100u, block->size());
+    ASSERT_EQ('a', (*block)[0]);
+
+    // Same edit unit with a different coding UL is a different block
+    ASSERT_FALSE(cache.Get("OtherUL", 0, block));
+
+    AuxDataCacheStatistics statistics;
+    cache.GetStatistics(statistics);
+    ASSERT_EQ(1u, statistics.hits_);
+    ASSERT_EQ(2u, statistics.misses_);
+    ASSERT_EQ(100u, statistics.sizeInBytes_);
+    ASSERT_EQ(1u, statistics.numberOfBlocks_);
+}
+
+TEST(AuxDataBlockCache_Test, AuxDataBlockCache_Test_EvictsLeastRecentlyUsed)
+{
+    AuxDataBlockCache cache(300);
+    AuxDataBlockBytesPtr block;
+
+    ASSERT_TRUE(cache.Put("UL", 0, MakeBlock(100, 'a'), true));
+    ASSERT_TRUE(cache.Put("UL", 1, MakeBlock(100, 'b'), true));
+    ASSERT_TRUE(cache.Put("UL", 2, MakeBlock(100, 'c'), true));
+
+    // Touch 0 so 1 becomes the least recently used
+    ASSERT_TRUE(cache.Get("UL", 0, block));
+
+    ASSERT_TRUE(cache.Put("UL", 3, MakeBlock(100, 'd'), true));
+
+    ASSERT_TRUE(cache.Contains("UL", 0));
+    ASSERT_FALSE(cache.Contains("UL", 1));
+    ASSERT_TRUE(cache.Contains("UL", 2));
+    ASSERT_TRUE(cache.Contains("UL", 3));
+
+    // A block held by a reader stays valid after eviction
+    ASSERT_TRUE(cache.Get("UL", 2, block));
+    cache.SetMaxSizeInBytes(0);
+    ASSERT_FALSE(cache.Contains("UL", 2));
+    ASSERT_EQ('c', (*block)[0]);
+}
+
+TEST(AuxDataBlockCache_Test, AuxDataBlockCache_Test_PutWithoutEvict)
+{
+    AuxDataBlockCache cache(200);
+
+    ASSERT_TRUE(cache.Put("UL", 0, MakeBlock(100, 'a'), false));
+    ASSERT_TRUE(cache.Put("UL", 1, MakeBlock(100, 'b'), false));
+    ASSERT_FALSE(cache.Put("UL", 2, MakeBlock(100, 'c'), false));
+
+    ASSERT_TRUE(cache.Contains("UL", 0));
+    ASSERT_TRUE(cache.Contains("UL", 1));
+    ASSERT_FALSE(cache.Contains("UL", 2));
+
+    // Larger than the whole cache
+    ASSERT_FALSE(cache.Put("UL", 3, MakeBlock(500, 'd'), true));
+
+    cache.Clear();
+    ASSERT_FALSE(cache.Contains("UL", 0));
+}
+
+TEST(AuxDataBlockCache_Test, AuxDataBlockCache_Test_Erase)
+{
+    AuxDataBlockCache cache(1024);
+    AuxDataBlockBytesPtr block = MakeBlock(100, 'a');
+    AuxDataBlockBytesPtr other = MakeBlock(100, 'b');
+
+    ASSERT_TRUE(cache.Put("UL", 0, block, true));
+
+    // Only the block that was put is removed
+    ASSERT_FALSE(cache.Erase("UL", 0, other));
+    ASSERT_TRUE(cache.Contains("UL", 0));
+
+    ASSERT_TRUE(cache.Erase("UL", 0, block));
+    ASSERT_FALSE(cache.Contains("UL", 0));
+    ASSERT_FALSE(cache.Erase("UL", 0, block));
+
+    AuxDataCacheStatistics statistics;
+    cache.GetStatistics(statistics);
+    ASSERT_EQ(0u, statistics.sizeInBytes_);
+    ASSERT_EQ(0u, statistics.numberOfBlocks_);
+}
@@ -0,0 +1,371 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  AuxDataMgr_Test.cpp
+//
+//
+
+#include "AuxDataMgr_Test.h"
+#include "gtest/gtest.h"
+
+#include "AuxDataMgr.h"
+
+#include "boost/thread/thread.hpp"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static void AddItems(AuxDataMgr &ioAuxDataMgr, uint32_t iStart, uint32_t iCount)
+{
+    for (uint32_t editUnit = iStart; editUnit < iStart + iCount; editUnit++)
+    {
+        AuxDataBlock *item = ioAuxDataMgr.NewDataItem();
+        item->editUnitIndex_ = editUnit;
+        ASSERT_TRUE(ioAuxDataMgr.AddDataItem(item));
+    }
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_GetDataItem)
+{
+    AuxDataMgr auxDataMgr(8);
+    ASSERT_EQ(8u, auxDataMgr.GetCapacity());
+
+    AddItems(auxDataMgr, 0, 10);
+
+    // 8 and 9 replaced 0 and 1 in the ring
+    AuxDataBlock item;
+    ASSERT_FALSE(auxDataMgr.GetDataItem(0, item));
+    ASSERT_FALSE(auxDataMgr.GetDataItem(1, item));
+    ASSERT_TRUE(auxDataMgr.GetDataItem(8, item));
+    ASSERT_EQ(8u, item.editUnitIndex_);
+
+    // Looking an item up leaves it in the ring
+    ASSERT_TRUE(auxDataMgr.GetDataItem(2, item));
+    ASSERT_TRUE(auxDataMgr.GetDataItem(2, item));
+    ASSERT_EQ(2u, item.editUnitIndex_);
+
+    // An edit unit mapping to a slot holding another edit unit
+    ASSERT_FALSE(auxDataMgr.GetDataItem(10, item));
+    ASSERT_FALSE(auxDataMgr.GetDataItem(16, item));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_BufferedCount)
+{
+    AuxDataMgr auxDataMgr(8);
+    AddItems(auxDataMgr, 2, 8);
+
+    ASSERT_EQ(8u, auxDataMgr.GetBufferedCount(2));
+    ASSERT_EQ(3u, auxDataMgr.GetBufferedCount(7));
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedCount(0));
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedCount(10));
+
+    ASSERT_FALSE(auxDataMgr.IsBelowLowWaterMark(2, 8));
+    ASSERT_TRUE(auxDataMgr.IsBelowLowWaterMark(2, 9));
+    ASSERT_TRUE(auxDataMgr.IsBelowLowWaterMark(7, 4));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_Invalidate)
+{
+    AuxDataMgr auxDataMgr(8);
+    AddItems(auxDataMgr, 2, 8);
+
+    ASSERT_EQ(3u, auxDataMgr.Invalidate(4, 3));
+    ASSERT_EQ(2u, auxDataMgr.GetBufferedCount(2));
+    ASSERT_EQ(3u, auxDataMgr.GetBufferedCount(7));
+
+    AuxDataBlock item;
+    ASSERT_FALSE(auxDataMgr.GetDataItem(5, item));
+
+    // Slots holding edit units outside of the range are left alone
+    ASSERT_EQ(0u, auxDataMgr.Invalidate(100, 1000));
+    ASSERT_TRUE(auxDataMgr.GetDataItem(9, item));
+
+    // The whole timeline
+    ASSERT_EQ(5u, auxDataMgr.Invalidate(0, 0xFFFFFFFF));
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedCount(2));
+
+    // Keep only the edit units around a seek
+    AddItems(auxDataMgr, 10, 8);
+    ASSERT_EQ(5u, auxDataMgr.InvalidateOutside(12, 3));
+    ASSERT_EQ(3u, auxDataMgr.GetBufferedCount(12));
+    ASSERT_FALSE(auxDataMgr.GetDataItem(11, item));
+    ASSERT_FALSE(auxDataMgr.GetDataItem(15, item));
+
+    AddItems(auxDataMgr, 0, 4);
+    auxDataMgr.Clear();
+    ASSERT_FALSE(auxDataMgr.GetDataItem(0, item));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_SlabReuse)
+{
+    AuxDataMgr auxDataMgr;
+    ASSERT_EQ(0u, auxDataMgr.GetNumberOfSlabs());
+
+    AuxDataBlock *item = auxDataMgr.NewDataItem();
+    ASSERT_EQ(1u, auxDataMgr.GetNumberOfSlabs());
+    ASSERT_EQ(0u, item->sourceDataItemLength_);
+
+    // A released block is handed out again
+    auxDataMgr.ReleaseDataItem(item);
+    ASSERT_EQ(item, auxDataMgr.NewDataItem());
+
+    // More blocks than fit in one slab
+    vector<AuxDataBlock*> items(1, item);
+    for (int32_t i = 0; i < 1000; i++)
+        items.push_back(auxDataMgr.NewDataItem());
+
+    ASSERT_LT(1u, auxDataMgr.GetNumberOfSlabs());
+
+    for (size_t i = 0; i < items.size(); i++)
+        auxDataMgr.ReleaseDataItem(items[i]);
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_FixedMemory)
+{
+    AuxDataMgr auxDataMgr(64);
+
+    // Replaced blocks go back to the slab, however far the timeline jumps
+    AddItems(auxDataMgr, 0, 10000);
+    AddItems(auxDataMgr, 1000000, 10000);
+    AddItems(auxDataMgr, 500, 10000);
+
+    ASSERT_EQ(1u, auxDataMgr.GetNumberOfSlabs());
+    ASSERT_EQ(64u, auxDataMgr.GetBufferedCount(10500 - 64));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_ByteBudget)
+{
+    // A block without a payload is 65 bytes. Room for 10 of them.
+    AuxDataMgr auxDataMgr(64, 650);
+
+    AddItems(auxDataMgr, 0, 10);
+    ASSERT_EQ(650u, auxDataMgr.GetBufferedBytes());
+
+    // Nothing is behind the playhead yet
+    AuxDataBlock *item = auxDataMgr.NewDataItem();
+    item->editUnitIndex_ = 10;
+    ASSERT_FALSE(auxDataMgr.AddDataItem(item));
+
+    // Edit units behind the playhead are evicted to make room
+    auxDataMgr.SetPlayhead(5);
+    AddItems(auxDataMgr, 10, 1);
+
+    AuxDataMemoryStatistics statistics;
+    auxDataMgr.GetMemoryStatistics(statistics);
+    ASSERT_EQ(390u, statistics.bufferedBytes_);
+    ASSERT_EQ(650u, statistics.peakBufferedBytes_);
+    ASSERT_EQ(650u, statistics.maxBufferedBytes_);
+    ASSERT_EQ(6u, statistics.numberOfBlocks_);
+    ASSERT_EQ(64u, statistics.capacity_);
+    ASSERT_LT(0u, statistics.slabBytes_);
+    ASSERT_EQ(5u, statistics.evictedBlocks_);
+    ASSERT_EQ(1u, statistics.rejectedBlocks_);
+
+    AuxDataBlock copy;
+    ASSERT_FALSE(auxDataMgr.GetDataItem(4, copy));
+    ASSERT_TRUE(auxDataMgr.GetDataItem(5, copy));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_EditUnitsWithinBudget)
+{
+    AuxDataMgr auxDataMgr(64, 650);
+    auxDataMgr.SetPlayhead(5);
+
+    // Without any data received only the capacity ahead of the playhead counts
+    ASSERT_EQ(64u, auxDataMgr.GetEditUnitsWithinBudget(5, 100));
+
+    AddItems(auxDataMgr, 5, 6);
+
+    // 6 blocks of 65 bytes leave room for 4 more
+    ASSERT_EQ(4u, auxDataMgr.GetEditUnitsWithinBudget(11, 100));
+
+    // Without a byte budget the capacity ahead of the playhead is the limit
+    auxDataMgr.SetMaxBufferedBytes(0);
+    ASSERT_EQ(58u, auxDataMgr.GetEditUnitsWithinBudget(11, 100));
+    ASSERT_EQ(10u, auxDataMgr.GetEditUnitsWithinBudget(11, 10));
+    ASSERT_EQ(0u, auxDataMgr.GetEditUnitsWithinBudget(69, 10));
+
+    // The edit units behind the playhead count as room but are only evicted once it is needed
+    auxDataMgr.SetMaxBufferedBytes(650);
+    auxDataMgr.SetPlayhead(11);
+    ASSERT_EQ(10u, auxDataMgr.GetEditUnitsWithinBudget(11, 100));
+    ASSERT_EQ(390u, auxDataMgr.GetBufferedBytes());
+    ASSERT_EQ(6u, auxDataMgr.GetBufferedCount(5));
+
+    AddItems(auxDataMgr, 11, 10);
+    ASSERT_EQ(650u, auxDataMgr.GetBufferedBytes());
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedCount(5));
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_ChargeBuffer)
+{
+    AuxDataMgr auxDataMgr(64, 1000);
+
+    AuxDataBufferPtr buffer(new vector<uint8_t>(600));
+
+    {
+        // Blocks referencing the buffer are charged once through it
+        AuxDataBufferPtr charge = auxDataMgr.ChargeBuffer(buffer);
+        ASSERT_TRUE(charge);
+        ASSERT_EQ(buffer->data(), charge->data());
+
+        for (uint32_t editUnit = 0; editUnit < 4; editUnit++)
+        {
+            AuxDataBlock *item = auxDataMgr.NewDataItem();
+            item->editUnitIndex_ = editUnit;
+            item->buffer_ = charge;
+            ASSERT_TRUE(auxDataMgr.AddDataItem(item));
+        }
+
+        ASSERT_EQ(600u, auxDataMgr.GetBufferedBytes());
+
+        // A second buffer does not fit next to it
+        ASSERT_FALSE(auxDataMgr.ChargeBuffer(AuxDataBufferPtr(new vector<uint8_t>(600))));
+
+        AuxDataMemoryStatistics statistics;
+        auxDataMgr.GetMemoryStatistics(statistics);
+        ASSERT_EQ(600u, statistics.bufferedBytes_);
+        ASSERT_EQ(600u, statistics.receiveBufferBytes_);
+        ASSERT_EQ(1u, statistics.numberOfReceiveBuffers_);
+        ASSERT_EQ(1u, statistics.rejectedBlocks_);
+    }
+
+    // A block looked up keeps the buffer charged after it left the ring
+    AuxDataBlock copy;
+    ASSERT_TRUE(auxDataMgr.GetDataItem(3, copy));
+    ASSERT_EQ(4u, auxDataMgr.Invalidate(0, 4));
+    ASSERT_EQ(600u, auxDataMgr.GetBufferedBytes());
+
+    copy = AuxDataBlock();
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedBytes());
+    ASSERT_TRUE(buffer.unique());
+
+    // Evicting the edit units behind the playhead makes room for the next buffer
+    {
+        AuxDataBufferPtr charge = auxDataMgr.ChargeBuffer(buffer);
+        AuxDataBlock *item = auxDataMgr.NewDataItem();
+        item->editUnitIndex_ = 0;
+        item->buffer_ = charge;
+        ASSERT_TRUE(auxDataMgr.AddDataItem(item));
+    }
+
+    auxDataMgr.SetPlayhead(1);
+    ASSERT_TRUE(auxDataMgr.ChargeBuffer(AuxDataBufferPtr(new vector<uint8_t>(600))));
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedBytes());
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_ConcurrentByteBudget)
+{
+    // Room for 20 blocks of 65 bytes
+    AuxDataMgr auxDataMgr(1024, 20 * 65);
+
+    // Producers racing for the last bytes of the budget never overshoot it together
+    vector<boost::thread> threads;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        threads.push_back(boost::thread([&auxDataMgr, i]()
+        {
+            for (uint32_t editUnit = i * 100; editUnit < i * 100 + 100; editUnit++)
+            {
+                AuxDataBlock *item = auxDataMgr.NewDataItem();
+                item->editUnitIndex_ = editUnit;
+                auxDataMgr.AddDataItem(item);
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    AuxDataMemoryStatistics statistics;
+    auxDataMgr.GetMemoryStatistics(statistics);
+    ASSERT_EQ(20u * 65u, statistics.bufferedBytes_);
+    ASSERT_EQ(20u * 65u, statistics.peakBufferedBytes_);
+    ASSERT_EQ(20u, statistics.numberOfBlocks_);
+    ASSERT_EQ(380u, statistics.rejectedBlocks_);
+}
+
+TEST(AuxDataMgr_Test, AuxDataMgr_Test_ConcurrentAddAndRelease)
+{
+    AuxDataMgr auxDataMgr(16);
+
+    // Producers keep storing the same edit units while they are invalidated and looked up
+    boost::atomic<bool> running(true);
+    vector<boost::thread> threads;
+
+    for (int32_t i = 0; i < 2; i++)
+    {
+        threads.push_back(boost::thread([&auxDataMgr, &running]()
+        {
+            while (running)
+            {
+                for (uint32_t editUnit = 0; editUnit < 16; editUnit++)
+                {
+                    AuxDataBlock *item = auxDataMgr.NewDataItem();
+                    item->editUnitIndex_ = editUnit;
+                    auxDataMgr.AddDataItem(item);
+                }
+            }
+        }));
+    }
+
+    threads.push_back(boost::thread([&auxDataMgr, &running]()
+    {
+        AuxDataBlock item;
+        while (running)
+        {
+            auxDataMgr.Invalidate(0, 16);
+            auxDataMgr.GetDataItem(3, item);
+        }
+    }));
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    running = false;
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    // Every buffered block can still be found and is accounted for exactly once
+    AuxDataMemoryStatistics statistics;
+    auxDataMgr.GetMemoryStatistics(statistics);
+
+    uint32_t found = 0;
+    AuxDataBlock item;
+    for (uint32_t editUnit = 0; editUnit < 16; editUnit++)
+    {
+        if (auxDataMgr.GetDataItem(editUnit, item))
+            found++;
+    }
+
+    ASSERT_EQ(statistics.numberOfBlocks_, found);
+    ASSERT_EQ(found * 65u, statistics.bufferedBytes_);
+
+    ASSERT_EQ(found, auxDataMgr.Invalidate(0, 16));
+    ASSERT_EQ(0u, auxDataMgr.GetBufferedBytes());
+}
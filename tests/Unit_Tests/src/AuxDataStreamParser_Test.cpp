@@ -0,0 +1,301 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  AuxDataStreamParser_Test.cpp
+//
+//
+
+#include "AuxDataStreamParser_Test.h"
+#include "gtest/gtest.h"
+
+#include "AuxDataStreamParser.h"
+#include "AuxDataMgr.h"
+#include "SerializationUtils.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static void WriteHeader(uint32_t iStart, uint32_t iCount, vector<uint8_t> &oResponse)
+{
+    AuxDataBlockTransferHeader header;
+    header.editUnitRangeStartIndex_ = iStart;
+    header.editUnitRangeCount_ = iCount;
+
+    vector<uint8_t> buffer(header.GetSizeInBytes());
+    uint8_t *data = buffer.data();
+    header.write(&data);
+
+    oResponse.insert(oResponse.end(), buffer.begin(), buffer.end());
+}
+
+static void WriteBlock(uint32_t iEditUnit, uint64_t iDataItemLength, vector<uint8_t> &oResponse)
+{
+    vector<uint8_t> dataItem(iDataItemLength, static_cast<uint8_t>(iEditUnit));
+
+    AuxDataBlock block;
+    block.editUnitIndex_ = iEditUnit;
+    block.editUnitRateNumerator_ = 24;
+    block.editUnitRateDenominator_ = 1;
+    block.sourceDataItemLength_ = iDataItemLength;
+    block.sourceDataItem_ = dataItem.data();
+
+    vector<uint8_t> buffer(block.GetSizeInBytes());
+    uint8_t *data = buffer.data();
+    block.write(&data);
+
+    oResponse.insert(oResponse.end(), buffer.begin(), buffer.end());
+}
+
+static vector<uint32_t> GetEditUnits(AuxDataMgr &ioAuxDataMgr, uint32_t iStart, uint32_t iCount)
+{
+    vector<uint32_t> editUnits;
+
+    for (uint32_t editUnit = iStart; editUnit < iStart + iCount; editUnit++)
+    {
+        AuxDataBlock item;
+        if (!ioAuxDataMgr.GetDataItem(editUnit, item))
+            continue;
+
+        if (item.sourceDataItemLength_ > 0)
+        {
+            EXPECT_EQ(static_cast<uint8_t>(item.editUnitIndex_), item.sourceDataItem_[0]);
+
+            // The payload is a slice of the receive buffer
+            EXPECT_TRUE(item.buffer_ != nullptr);
+            EXPECT_GE(item.sourceDataItem_, item.buffer_->data());
+            EXPECT_LE(item.sourceDataItem_ + item.sourceDataItemLength_, item.buffer_->data() + item.buffer_->size());
+        }
+
+        editUnits.push_back(item.editUnitIndex_);
+    }
+
+    return editUnits;
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_QueuesBlocksAsTheyArrive)
+{
+    vector<uint8_t> response;
+    WriteHeader(100, 3, response);
+    WriteBlock(100, 10, response);
+    WriteBlock(101, 100000, response);
+    WriteBlock(102, 0, response);
+
+    AuxDataMgr auxDataMgr;
+    AuxDataStreamParser parser(&auxDataMgr);
+
+    // Receive the bytes in small reads like a slow socket
+    //
+    vector<uint32_t> editUnits;
+    size_t received = 0;
+
+    while (received < response.size())
+    {
+        size_t size = 0;
+        uint8_t *buffer = parser.PrepareReceive(size);
+        ASSERT_GT(size, 0u);
+
+        size = std::min(std::min(size, static_cast<size_t>(1000)), response.size() - received);
+        memcpy(buffer, response.data() + received, size);
+        received += size;
+
+        ASSERT_TRUE(parser.CommitReceive(size));
+
+        editUnits = GetEditUnits(auxDataMgr, 100, 3);
+
+        // The first block is available before the second has fully arrived
+        if (received == 10000)
+            ASSERT_EQ(1u, editUnits.size());
+    }
+
+    ASSERT_EQ(AuxDataStreamParser::eState_Blocks, parser.GetState());
+    ASSERT_TRUE(parser.HasHeader());
+    ASSERT_EQ(100u, parser.GetHeader().editUnitRangeStartIndex_);
+    ASSERT_EQ(3u, parser.GetHeader().editUnitRangeCount_);
+    ASSERT_EQ(3u, parser.GetBlockCount());
+    ASSERT_EQ(102u, parser.GetLastEditUnitIndex());
+    ASSERT_EQ(0u, parser.GetPendingBytes());
+
+    ASSERT_EQ(3u, editUnits.size());
+    ASSERT_EQ(100u, editUnits[0]);
+    ASSERT_EQ(102u, editUnits[2]);
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_WholeResponse)
+{
+    vector<uint8_t> response;
+    WriteHeader(0, 5, response);
+    for (uint32_t i = 0; i < 5; i++)
+        WriteBlock(i, 64, response);
+
+    AuxDataMgr auxDataMgr;
+    AuxDataStreamParser parser(&auxDataMgr);
+
+    ASSERT_TRUE(parser.Append(response.data(), response.size()));
+    ASSERT_EQ(5u, GetEditUnits(auxDataMgr, 0, 5).size());
+
+    // Reset for the next response
+    parser.Reset();
+    ASSERT_FALSE(parser.HasHeader());
+    ASSERT_EQ(0u, parser.GetBlockCount());
+    ASSERT_TRUE(parser.Append(response.data(), 10));
+    ASSERT_EQ(10u, parser.GetPendingBytes());
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_BlocksOutliveTheParser)
+{
+    vector<uint8_t> response;
+    WriteHeader(0, 2, response);
+    WriteBlock(0, 64, response);
+    WriteBlock(1, 64, response);
+
+    AuxDataMgr auxDataMgr;
+
+    {
+        AuxDataStreamParser parser(&auxDataMgr);
+        ASSERT_TRUE(parser.Append(response.data(), response.size()));
+    }
+
+    // Both blocks share the receive buffer, which is still alive
+    AuxDataBlock first;
+    AuxDataBlock second;
+    ASSERT_TRUE(auxDataMgr.GetDataItem(0, first));
+    ASSERT_TRUE(auxDataMgr.GetDataItem(1, second));
+    ASSERT_TRUE(first.buffer_ == second.buffer_);
+    ASSERT_EQ(4, first.buffer_.use_count());
+    ASSERT_EQ(1u, second.sourceDataItem_[63]);
+
+    // A copy shares the payload rather than copying it
+    AuxDataBlock copy(second);
+    ASSERT_EQ(second.sourceDataItem_, copy.sourceDataItem_);
+    ASSERT_EQ(5, copy.buffer_.use_count());
+
+    ASSERT_EQ(2u, auxDataMgr.Invalidate(0, 2));
+    ASSERT_EQ(3, copy.buffer_.use_count());
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_StopsWhenFull)
+{
+    vector<uint8_t> response;
+    WriteHeader(0, 5, response);
+    size_t headerSize = response.size();
+    for (uint32_t i = 0; i < 5; i++)
+        WriteBlock(i, 64, response);
+
+    // Room for one receive buffer holding the header and two blocks of 129 bytes
+    AuxDataMgr auxDataMgr(64, headerSize + 2 * 129);
+    AuxDataStreamParser parser(&auxDataMgr);
+
+    ASSERT_TRUE(parser.Append(response.data(), response.size()));
+    ASSERT_EQ(AuxDataStreamParser::eState_Full, parser.GetState());
+    ASSERT_TRUE(parser.HasHeader());
+    ASSERT_EQ(2u, parser.GetBlockCount());
+    ASSERT_EQ(1u, parser.GetLastEditUnitIndex());
+    ASSERT_EQ(2u, GetEditUnits(auxDataMgr, 0, 5).size());
+
+    // The receive buffer is charged once for both blocks
+    AuxDataMemoryStatistics statistics;
+    auxDataMgr.GetMemoryStatistics(statistics);
+    ASSERT_EQ(headerSize + 2 * 129, statistics.receiveBufferBytes_);
+    ASSERT_EQ(statistics.receiveBufferBytes_, statistics.bufferedBytes_);
+    ASSERT_EQ(1u, statistics.numberOfReceiveBuffers_);
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_MalformedResponse)
+{
+    AuxDataMgr auxDataMgr;
+
+    // Not a transfer header
+    {
+        vector<uint8_t> response;
+        WriteBlock(0, 64, response);
+
+        AuxDataStreamParser parser(&auxDataMgr);
+        ASSERT_FALSE(parser.Append(response.data(), response.size()));
+        ASSERT_EQ(AuxDataStreamParser::eState_Error, parser.GetState());
+    }
+
+    // Data item length larger than the block
+    {
+        vector<uint8_t> response;
+        WriteHeader(0, 2, response);
+        size_t headerSize = response.size();
+        WriteBlock(0, 64, response);
+        WriteBlock(1, 64, response);
+
+        // sourceDataItemLength_ follows the PackKey, BER5 length, edit unit, edit rate and coding UL
+        uint8_t *dataItemLength = response.data() + headerSize + 16 + 5 + 4 + 4 + 4 + 16;
+        dataItemLength[0] = 0xFF;
+        dataItemLength[7] = 0xFF;
+
+        AuxDataStreamParser parser(&auxDataMgr);
+        ASSERT_FALSE(parser.Append(response.data(), response.size()));
+        ASSERT_EQ(AuxDataStreamParser::eState_Error, parser.GetState());
+        ASSERT_EQ(0u, parser.GetBlockCount());
+    }
+
+    ASSERT_TRUE(GetEditUnits(auxDataMgr, 0, 2).empty());
+}
+
+TEST(AuxDataStreamParser_Test, AuxDataStreamParser_Test_OversizedBlock)
+{
+    // A BER5 length of about 2GB arriving ahead of its payload
+    {
+        vector<uint8_t> response;
+        WriteHeader(0, 1, response);
+        size_t headerSize = response.size();
+        WriteBlock(0, 64, response);
+
+        uint8_t *length = response.data() + headerSize + 16;
+        WriteBER5(&length, 0x7FFFFFF0);
+
+        AuxDataMgr auxDataMgr;
+        AuxDataStreamParser parser(&auxDataMgr);
+        ASSERT_FALSE(parser.Append(response.data(), headerSize + 16 + 5));
+        ASSERT_EQ(AuxDataStreamParser::eState_Error, parser.GetState());
+
+        // The receive buffer was not grown to the announced length
+        size_t size = 0;
+        parser.PrepareReceive(size);
+        ASSERT_LE(size, static_cast<size_t>(64 * 1024));
+    }
+
+    // A block that could never fit in the byte budget
+    {
+        vector<uint8_t> response;
+        WriteHeader(0, 1, response);
+        WriteBlock(0, 2000, response);
+
+        AuxDataMgr auxDataMgr(64, 1000);
+        AuxDataStreamParser parser(&auxDataMgr);
+        ASSERT_FALSE(parser.Append(response.data(), response.size()));
+        ASSERT_EQ(AuxDataStreamParser::eState_Error, parser.GetState());
+        ASSERT_EQ(0u, parser.GetBlockCount());
+    }
+}
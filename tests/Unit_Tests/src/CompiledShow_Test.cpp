@@ -0,0 +1,350 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  CompiledShow_Test.cpp
+//
+//
+
+#include "CompiledShow_Test.h"
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "AuxDataIndex.h"
+#include "CompiledShow.h"
+#include "CPLParser.h"
+#include "Show.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static Asset *CreateAsset(Asset::AssetType iType, int32_t iDuration, const std::string &iPath)
+{
+    Asset *asset = new Asset;
+    asset->type_ = iType;
+    asset->editRateNumerator_ = 24;
+    asset->editRateDenominator_ = 1;
+    asset->frameRateNumerator_ = 48;
+    asset->frameRateDenominator_ = 1;
+    asset->intrinsicDuration_ = iDuration + 10;
+    asset->entryPoint_ = 5;
+    asset->duration_ = iDuration;
+    asset->volumeIndex_ = 1;
+    asset->offset_ = 0;
+    asset->length_ = iDuration * 1000;
+    asset->path_ = iPath;
+    asset->dataEssenceCodingUL_ = iPath + ".UL";
+    asset->id_[0] = static_cast<uint8_t>(iPath.size());
+    asset->id_[1] = static_cast<uint8_t>(iType);
+    return asset;
+}
+
+// Creates a CPL of iNumberOfReels reels of iDuration frames.
+// Every other reel has aux data.
+//
+static CPL *CreateCPL(const std::string &iName, int32_t iNumberOfReels, int32_t iDuration)
+{
+    CPL *cpl = new CPL;
+    cpl->id_[0] = static_cast<uint8_t>(iName[0]);
+
+    for (int32_t reel = 0; reel < iNumberOfReels; reel++)
+    {
+        std::string name = iName + "_" + std::to_string(reel);
+
+        Reel *newReel = new Reel;
+        newReel->id_[0] = static_cast<uint8_t>(reel);
+        newReel->assets_.push_back(CreateAsset(Asset::eAssetType_MainPicture, iDuration, name + ".picture"));
+        newReel->assets_.push_back(CreateAsset(Asset::eAssetType_MainSound, iDuration, name + ".sound"));
+
+        if (reel % 2 == 0)
+            newReel->assets_.push_back(CreateAsset(Asset::eAssetType_AuxData, iDuration, name + ".aux"));
+
+        cpl->reels_.push_back(newReel);
+    }
+
+    return cpl;
+}
+
+static void DeleteCPLs(std::vector<CPL*> &ioCPLs)
+{
+    for (std::vector<CPL*>::iterator iter = ioCPLs.begin(); iter != ioCPLs.end(); iter++)
+        delete *iter;
+
+    ioCPLs.clear();
+}
+
+static void WriteFile(const std::string &iPath, const std::string &iContent)
+{
+    std::ofstream file(iPath.c_str(), std::ios::binary | std::ios::trunc);
+    file << iContent;
+}
+
+static std::string ReadFile(const std::string &iPath)
+{
+    std::ifstream file(iPath.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// A package directory holding two CPLs and an ASSETMAP.xml, removed when it goes out of scope.
+// Only the identity of the files is compiled, their content is never parsed here.
+//
+class TestPackage
+{
+public:
+
+    TestPackage()
+    {
+        char directory[] = "/tmp/CompiledShow_Test.XXXXXX";
+
+        if (mkdtemp(directory) != nullptr)
+            directory_ = std::string(directory) + "/";
+
+        cplList_.push_back(directory_ + "a.xml");
+        cplList_.push_back(directory_ + "b.xml");
+
+        WriteFile(cplList_[0], "<CompositionPlaylist>a</CompositionPlaylist>");
+        WriteFile(cplList_[1], "<CompositionPlaylist>b</CompositionPlaylist>");
+        WriteFile(CPLParser::GetAssetMapPath(directory_), "<AssetMap></AssetMap>");
+
+        path_ = CompiledShow::BuildPath(directory_, cplList_);
+
+        cpls_.push_back(CreateCPL("a", 3, 100));
+        cpls_.push_back(CreateCPL("b", 2, 50));
+
+        CompiledShow::GetSourceFiles(cplList_, sourceFiles_);
+    }
+
+    ~TestPackage()
+    {
+        DeleteCPLs(cpls_);
+
+        std::remove(path_.c_str());
+        std::remove(cplList_[0].c_str());
+        std::remove(cplList_[1].c_str());
+        std::remove(CPLParser::GetAssetMapPath(directory_).c_str());
+        rmdir(directory_.c_str());
+    }
+
+    std::string                     directory_;
+    std::string                     path_;
+    CPLFileList                     cplList_;
+    CompiledShow::SourceFileList    sourceFiles_;
+    std::vector<CPL*>               cpls_;
+};
+
+TEST(CompiledShow_Test, CompiledShow_Test_SaveLoad)
+{
+    TestPackage package;
+    ASSERT_EQ(3u, package.sourceFiles_.size());
+
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+
+    std::vector<CPL*> loaded;
+    ASSERT_TRUE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    ASSERT_EQ(package.cpls_.size(), loaded.size());
+
+    for (size_t cplIndex = 0; cplIndex < package.cpls_.size(); cplIndex++)
+    {
+        ASSERT_TRUE(package.cpls_[cplIndex]->id_ == loaded[cplIndex]->id_);
+        ASSERT_EQ(package.cpls_[cplIndex]->reels_.size(), loaded[cplIndex]->reels_.size());
+
+        for (size_t reelIndex = 0; reelIndex < package.cpls_[cplIndex]->reels_.size(); reelIndex++)
+        {
+            const Reel *reel = package.cpls_[cplIndex]->reels_[reelIndex];
+            const Reel *loadedReel = loaded[cplIndex]->reels_[reelIndex];
+
+            ASSERT_TRUE(reel->id_ == loadedReel->id_);
+            ASSERT_EQ(reel->assets_.size(), loadedReel->assets_.size());
+
+            for (size_t assetIndex = 0; assetIndex < reel->assets_.size(); assetIndex++)
+            {
+                const Asset *asset = reel->assets_[assetIndex];
+                const Asset *loadedAsset = loadedReel->assets_[assetIndex];
+
+                ASSERT_TRUE(asset->id_ == loadedAsset->id_);
+                ASSERT_EQ(asset->type_, loadedAsset->type_);
+                ASSERT_EQ(asset->editRateNumerator_, loadedAsset->editRateNumerator_);
+                ASSERT_EQ(asset->editRateDenominator_, loadedAsset->editRateDenominator_);
+                ASSERT_EQ(asset->frameRateNumerator_, loadedAsset->frameRateNumerator_);
+                ASSERT_EQ(asset->frameRateDenominator_, loadedAsset->frameRateDenominator_);
+                ASSERT_EQ(asset->intrinsicDuration_, loadedAsset->intrinsicDuration_);
+                ASSERT_EQ(asset->entryPoint_, loadedAsset->entryPoint_);
+                ASSERT_EQ(asset->duration_, loadedAsset->duration_);
+                ASSERT_EQ(asset->volumeIndex_, loadedAsset->volumeIndex_);
+                ASSERT_EQ(asset->offset_, loadedAsset->offset_);
+                ASSERT_EQ(asset->length_, loadedAsset->length_);
+                ASSERT_EQ(asset->path_, loadedAsset->path_);
+                ASSERT_EQ(asset->dataEssenceCodingUL_, loadedAsset->dataEssenceCodingUL_);
+            }
+        }
+    }
+
+    // The loaded CPLs build the same timeline
+    //
+    Show show(48000);
+
+    for (size_t index = 0; index < loaded.size(); index++)
+        show.AddCPLToEndOfTimeline(loaded[index]);
+
+    ASSERT_EQ(400, show.GetLengthInFrames());
+}
+
+TEST(CompiledShow_Test, CompiledShow_Test_SourceFileChanged)
+{
+    TestPackage package;
+    ASSERT_EQ(3u, package.sourceFiles_.size());
+
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+
+    std::vector<CPL*> loaded;
+
+    // Only the size and modification time of each file are compared
+    //
+    CompiledShow::SourceFileList sourceFiles = package.sourceFiles_;
+    sourceFiles[1].modificationTime_++;
+    ASSERT_FALSE(CompiledShow::Load(package.path_, sourceFiles, loaded));
+    ASSERT_TRUE(loaded.empty());
+
+    sourceFiles = package.sourceFiles_;
+    sourceFiles[2].fileSize_++;
+    ASSERT_FALSE(CompiledShow::Load(package.path_, sourceFiles, loaded));
+
+    sourceFiles = package.sourceFiles_;
+    sourceFiles[0].path_ = package.directory_ + "c.xml";
+    ASSERT_FALSE(CompiledShow::Load(package.path_, sourceFiles, loaded));
+
+    sourceFiles = package.sourceFiles_;
+    sourceFiles.pop_back();
+    ASSERT_FALSE(CompiledShow::Load(package.path_, sourceFiles, loaded));
+
+    // Rewrite a CPL on disk
+    //
+    WriteFile(package.cplList_[1], "<CompositionPlaylist>b, edited</CompositionPlaylist>");
+
+    ASSERT_TRUE(CompiledShow::GetSourceFiles(package.cplList_, sourceFiles));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, sourceFiles, loaded));
+    ASSERT_TRUE(loaded.empty());
+
+    // A CPL that no longer exists has no identity
+    //
+    std::remove(package.cplList_[0].c_str());
+    ASSERT_FALSE(CompiledShow::GetSourceFiles(package.cplList_, sourceFiles));
+
+    // Load only compares the identities it is given, the compiled show itself is still intact
+    //
+    ASSERT_TRUE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    ASSERT_EQ(2u, loaded.size());
+    DeleteCPLs(loaded);
+}
+
+TEST(CompiledShow_Test, CompiledShow_Test_Corrupt)
+{
+    TestPackage package;
+    ASSERT_EQ(3u, package.sourceFiles_.size());
+
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+
+    std::string content = ReadFile(package.path_);
+    ASSERT_GT(content.size(), 64u);
+
+    std::vector<CPL*> loaded;
+
+    // Truncated
+    //
+    WriteFile(package.path_, content.substr(0, content.size() - 1));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    ASSERT_TRUE(loaded.empty());
+
+    WriteFile(package.path_, content.substr(0, 16));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    WriteFile(package.path_, std::string());
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    // Extended
+    //
+    WriteFile(package.path_, content + "x");
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    // Bad magic
+    //
+    std::string corrupt = content;
+    corrupt[0] ^= 0xff;
+    WriteFile(package.path_, corrupt);
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    // Missing
+    //
+    std::remove(package.path_.c_str());
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    WriteFile(package.path_, content);
+    ASSERT_TRUE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    DeleteCPLs(loaded);
+}
+
+TEST(CompiledShow_Test, CompiledShow_Test_InvalidEditRate)
+{
+    TestPackage package;
+    ASSERT_EQ(3u, package.sourceFiles_.size());
+
+    std::vector<CPL*> loaded;
+
+    // Show divides by the whole edit rate of every asset, not only the picture
+    //
+    Asset *asset = package.cpls_[1]->reels_[1]->assets_[1];
+
+    asset->editRateNumerator_ = 24;
+    asset->editRateDenominator_ = 0;
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    ASSERT_TRUE(loaded.empty());
+
+    asset->editRateNumerator_ = 1;
+    asset->editRateDenominator_ = 2;
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    asset->editRateNumerator_ = 24;
+    asset->editRateDenominator_ = -1;
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+    ASSERT_FALSE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+
+    asset->editRateNumerator_ = 24000;
+    asset->editRateDenominator_ = 1001;
+    ASSERT_TRUE(CompiledShow::Save(package.path_, package.sourceFiles_, package.cpls_));
+    ASSERT_TRUE(CompiledShow::Load(package.path_, package.sourceFiles_, loaded));
+    ASSERT_EQ(24000, loaded[1]->reels_[1]->assets_[1]->editRateNumerator_);
+    DeleteCPLs(loaded);
+}
@@ -0,0 +1,99 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  MemoryAuxDataSource_Test.cpp
+//
+//
+
+#include "MemoryAuxDataSource_Test.h"
+#include "gtest/gtest.h"
+
+#include "MemoryAuxDataSource.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static void AddItems(MemoryAuxDataSource &ioSource, int32_t iCount)
+{
+    for (int32_t i = 0; i < iCount; i++)
+    {
+        vector<uint8_t> item(10 + i, static_cast<uint8_t>(i));
+        ioSource.AddDataItem(item.data(), static_cast<uint32_t>(item.size()));
+    }
+}
+
+TEST(MemoryAuxDataSource_Test, MemoryAuxDataSource_Test_GetDataItems)
+{
+    MemoryAuxDataSource source(100);
+    AddItems(source, 5);
+
+    ASSERT_EQ(100, source.GetStartFrame());
+    ASSERT_EQ(104, source.GetEndFrame());
+
+    vector<int32_t> itemNumbers;
+    int32_t itemsRead = source.GetDataItems(101, 10,
+        [&itemNumbers](int32_t iItemNumber, const uint8_t *iDataItem, uint32_t iDataItemSize)
+        {
+            EXPECT_EQ(static_cast<uint32_t>(10 + iItemNumber - 100), iDataItemSize);
+            EXPECT_EQ(static_cast<uint8_t>(iItemNumber - 100), iDataItem[0]);
+            itemNumbers.push_back(iItemNumber);
+            return true;
+        });
+
+    // Clipped to the end of the track
+    ASSERT_EQ(4, itemsRead);
+    ASSERT_EQ(101, itemNumbers.front());
+    ASSERT_EQ(104, itemNumbers.back());
+
+    // Outside of the track
+    ASSERT_EQ(0, source.GetDataItems(99, 1, [](int32_t, const uint8_t*, uint32_t) { return true; }));
+    ASSERT_EQ(0, source.GetDataItems(105, 1, [](int32_t, const uint8_t*, uint32_t) { return true; }));
+}
+
+TEST(MemoryAuxDataSource_Test, MemoryAuxDataSource_Test_Load)
+{
+    MemoryAuxDataSource original(10);
+    AddItems(original, 300);
+
+    MemoryAuxDataSource copy(0);
+    ASSERT_TRUE(copy.Load(original, 0));
+
+    ASSERT_EQ(10, copy.GetStartFrame());
+    ASSERT_EQ(309, copy.GetEndFrame());
+
+    uint8_t *item = nullptr;
+    uint32_t itemSize = 0;
+
+    ASSERT_TRUE(copy.GetDataItem(309, &item, itemSize));
+    ASSERT_EQ(309u, itemSize);
+    ASSERT_EQ(static_cast<uint8_t>(299), item[0]);
+
+    delete [] item;
+}
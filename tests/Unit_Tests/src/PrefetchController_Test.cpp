@@ -0,0 +1,161 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  PrefetchController_Test.cpp
+//
+//
+
+#include "PrefetchController_Test.h"
+#include "gtest/gtest.h"
+
+#include "PrefetchController.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+// 25 fps, at most 240 edit units per request, keep 240 buffered and always request below 120
+static const int32_t sMillisecondsPerFrame = 40;
+
+static void Play(PrefetchController &ioController)
+{
+    ioController.UpdatePlayhead(0, 0);
+    ioController.UpdatePlayhead(1, sMillisecondsPerFrame);
+}
+
+TEST(PrefetchController_Test, PrefetchController_Test_Unmeasured)
+{
+    PrefetchController controller(sMillisecondsPerFrame, 240, 240, 120);
+    Play(controller);
+    ASSERT_TRUE(controller.IsPlaying());
+
+    // Before anything is measured the lead only covers the assumed round trip
+    ASSERT_EQ(5, controller.GetLeadEditUnits(240));
+    ASSERT_EQ(120, controller.GetTriggerHeadroom());
+
+    // Sleep until the headroom falls to the trigger
+    ASSERT_EQ((200 - 120) * sMillisecondsPerFrame, controller.GetMillisecondsUntilNextRequest(200));
+    ASSERT_EQ(0, controller.GetMillisecondsUntilNextRequest(120));
+    ASSERT_EQ(0, controller.GetMillisecondsUntilNextRequest(0));
+
+    // Top up to the target plus the lead, clipped to the largest window
+    ASSERT_EQ(125, controller.GetEditUnitsToRequest(120));
+    ASSERT_EQ(240, controller.GetEditUnitsToRequest(0));
+
+    // Already past the target, only cover what plays out while in flight
+    ASSERT_EQ(5, controller.GetEditUnitsToRequest(500));
+}
+
+TEST(PrefetchController_Test, PrefetchController_Test_Measured)
+{
+    PrefetchController controller(sMillisecondsPerFrame, 240, 240, 120);
+    Play(controller);
+
+    // 200ms to the first byte then 100 edit units of 1000 bytes in 2 seconds
+    controller.OnRequestSent(1000);
+    controller.OnFirstByte(1200);
+    controller.OnResponseComplete(100, 100000, 3200);
+
+    ASSERT_DOUBLE_EQ(125.0, controller.GetRoundTripMilliseconds());
+    ASSERT_DOUBLE_EQ(1000.0, controller.GetBytesPerEditUnit());
+    ASSERT_DOUBLE_EQ(50.0, controller.GetBytesPerMillisecond());
+
+    // Fetching 120 edit units takes 125 + 120 * 20 ms, twice that is 127 frames
+    ASSERT_EQ(127, controller.GetLeadEditUnits(120));
+    ASSERT_EQ(127, controller.GetTriggerHeadroom());
+    ASSERT_EQ(0, controller.GetMillisecondsUntilNextRequest(127));
+    ASSERT_EQ(sMillisecondsPerFrame, controller.GetMillisecondsUntilNextRequest(128));
+
+    // A later sample only moves the averages part of the way
+    controller.OnRequestSent(5000);
+    controller.OnFirstByte(5100);
+    ASSERT_DOUBLE_EQ(118.75, controller.GetRoundTripMilliseconds());
+
+    // A second first byte for the same request is not a new sample
+    controller.OnFirstByte(9000);
+    ASSERT_DOUBLE_EQ(118.75, controller.GetRoundTripMilliseconds());
+}
+
+TEST(PrefetchController_Test, PrefetchController_Test_Idle)
+{
+    PrefetchController controller(sMillisecondsPerFrame, 240, 240, 120);
+
+    // The playhead has not moved for a second
+    controller.UpdatePlayhead(10, 0);
+    controller.UpdatePlayhead(10, 1000);
+    ASSERT_FALSE(controller.IsPlaying());
+
+    // Check back periodically rather than sleeping on a deadline that never arrives
+    int64_t idle = controller.GetMillisecondsUntilNextRequest(200);
+    ASSERT_GT(idle, 0);
+    ASSERT_LT(idle, (200 - 120) * sMillisecondsPerFrame);
+
+    // Still fill up to the trigger while paused
+    ASSERT_EQ(0, controller.GetMillisecondsUntilNextRequest(100));
+
+    // Playing again, but the server had nothing more to send
+    controller.UpdatePlayhead(11, 1040);
+    ASSERT_TRUE(controller.IsPlaying());
+    controller.OnRequestSent(1040);
+    controller.OnResponseComplete(0, 0, 1100);
+    ASSERT_EQ(idle, controller.GetMillisecondsUntilNextRequest(200));
+
+    // Back to the deadline once edit units arrive
+    controller.OnRequestSent(1200);
+    controller.OnResponseComplete(10, 10000, 1300);
+    ASSERT_EQ((200 - controller.GetTriggerHeadroom()) * sMillisecondsPerFrame, controller.GetMillisecondsUntilNextRequest(200));
+}
+
+TEST(PrefetchController_Test, PrefetchController_Test_Seek)
+{
+    PrefetchController controller(sMillisecondsPerFrame, 240, 240, 120);
+
+    // Playing along in real time is not a jump, even with a late sample
+    ASSERT_FALSE(controller.UpdatePlayhead(100, 0));
+    ASSERT_FALSE(controller.UpdatePlayhead(125, 25 * sMillisecondsPerFrame));
+    ASSERT_FALSE(controller.UpdatePlayhead(135, 26 * sMillisecondsPerFrame));
+    ASSERT_FALSE(controller.UpdatePlayhead(135, 27 * sMillisecondsPerFrame));
+
+    // Forwards further than playback allows, then backwards
+    ASSERT_TRUE(controller.UpdatePlayhead(1000, 28 * sMillisecondsPerFrame));
+    ASSERT_TRUE(controller.UpdatePlayhead(10, 29 * sMillisecondsPerFrame));
+    ASSERT_FALSE(controller.UpdatePlayhead(11, 30 * sMillisecondsPerFrame));
+
+    // The end of the show was reached before seeking back
+    controller.OnRequestSent(2000);
+    controller.OnResponseComplete(0, 0, 2100);
+    int64_t idle = controller.GetMillisecondsUntilNextRequest(200);
+    controller.OnSeek();
+    ASSERT_NE(idle, controller.GetMillisecondsUntilNextRequest(200));
+    ASSERT_EQ((200 - 120) * sMillisecondsPerFrame, controller.GetMillisecondsUntilNextRequest(200));
+
+    // The urgent window covers the round trip of the next one only
+    ASSERT_EQ(5, controller.GetUrgentEditUnits());
+    ASSERT_LT(controller.GetUrgentEditUnits(), controller.GetEditUnitsToRequest(controller.GetUrgentEditUnits()));
+}
@@ -0,0 +1,140 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  RequestHandler_Test.cpp
+//
+//
+
+#include "RequestHandler_Test.h"
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+
+#include "SS/reply.hpp"
+#include "SS/request.hpp"
+#include "SS/request_handler.hpp"
+
+using namespace http::server;
+using namespace std;
+
+static request MakeRequest(void)
+{
+    request req;
+    req.method = "GET";
+    req.uri = "/v1/auxdata/editunits?coding_UL=test&start=0&count=2&accept=" + SMPTE_SYNC::sPlainText;
+    req.http_version_major = 1;
+    req.http_version_minor = 1;
+    return req;
+}
+
+// Returns "data" from the first Read and nothing after it
+class TestDataStream : public SMPTE_SYNC::DataStream
+{
+public:
+    TestDataStream(void) : read_(false) {}
+
+    bool Read(std::vector<char> &oData)
+    {
+        if (!read_)
+            oData.insert(oData.end(), "data", "data" + 4);
+        read_ = true;
+        return false;
+    }
+
+    bool IsComplete(void) { return read_; }
+
+private:
+    bool read_;
+};
+
+static SMPTE_SYNC::DataStreamPtr Stream(int32_t *oCalls,
+                                        const std::string &,
+                                        int32_t,
+                                        int32_t,
+                                        const std::string &)
+{
+    ++*oCalls;
+    return SMPTE_SYNC::DataStreamPtr(new TestDataStream());
+}
+
+static SMPTE_SYNC::SharedContentPtr Shared(int32_t *oCalls,
+                                           const std::string &,
+                                           int32_t,
+                                           int32_t,
+                                           const std::string &)
+{
+    ++*oCalls;
+    return SMPTE_SYNC::SharedContentPtr(new std::vector<char>(4, 'd'));
+}
+
+// Streams when only a stream callback is set
+TEST(RequestHandler_Test, RequestHandler_Test_Stream)
+{
+    request_handler handler;
+
+    int32_t streamCalls = 0;
+    handler.SetStreamContentCallback(boost::bind(Stream, &streamCalls, _1, _2, _3, _4));
+
+    reply rep;
+    handler.handle_request(MakeRequest(), rep);
+
+    EXPECT_EQ(1, streamCalls);
+    EXPECT_EQ(reply::chunked, rep.transfer);
+    EXPECT_FALSE(rep.shared_content);
+
+    // The connection pulls the content from the stream as the client takes it
+    ASSERT_TRUE(rep.stream);
+    std::vector<char> data;
+    EXPECT_FALSE(rep.stream->Read(data));
+    EXPECT_EQ("data", std::string(data.begin(), data.end()));
+    EXPECT_TRUE(rep.stream->IsComplete());
+}
+
+// The shared content callback wins over streaming so identical requests
+// keep sharing one read
+TEST(RequestHandler_Test, RequestHandler_Test_SharedWinsOverStream)
+{
+    request_handler handler;
+
+    int32_t streamCalls = 0;
+    int32_t sharedCalls = 0;
+    handler.SetStreamContentCallback(boost::bind(Stream, &streamCalls, _1, _2, _3, _4));
+    handler.SetSharedContentCallback(boost::bind(Shared, &sharedCalls, _1, _2, _3, _4));
+
+    reply rep;
+    handler.handle_request(MakeRequest(), rep);
+
+    EXPECT_EQ(0, streamCalls);
+    EXPECT_EQ(1, sharedCalls);
+    EXPECT_EQ(reply::buffered, rep.transfer);
+    EXPECT_FALSE(rep.stream);
+    ASSERT_TRUE(rep.shared_content);
+    EXPECT_EQ(4u, rep.shared_content->size());
+}
@@ -0,0 +1,90 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  RequestScheduler_Test.cpp
+//
+//
+
+#include "RequestScheduler_Test.h"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+#include "boost/atomic.hpp"
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "SS/request_scheduler.hpp"
+#include "WorkerPool.h"
+
+using namespace http::server;
+using namespace std;
+
+static void Throw(void)
+{
+    throw std::runtime_error("request failed");
+}
+
+static void MarkRan(boost::atomic<bool> *oRan)
+{
+    *oRan = true;
+}
+
+TEST(RequestScheduler_Test, RequestScheduler_Test_Settings)
+{
+    SMPTE_SYNC::WorkerPool workerPool(1, "RequestScheduler_Test");
+    request_scheduler scheduler(workerPool);
+
+    scheduler.SetUrgentEditUnits(24);
+    scheduler.SetMaxSpeculativeRequests(2);
+
+    ASSERT_EQ(24, scheduler.GetUrgentEditUnits());
+    ASSERT_EQ(2, scheduler.GetMaxSpeculativeRequests());
+}
+
+// A speculative task that throws still releases its slot so the next one runs
+TEST(RequestScheduler_Test, RequestScheduler_Test_SpeculativeThrows)
+{
+    SMPTE_SYNC::WorkerPool workerPool(1, "RequestScheduler_Test");
+    request_scheduler scheduler(workerPool);
+
+    scheduler.SetUrgentEditUnits(0);
+    scheduler.SetMaxSpeculativeRequests(1);
+
+    boost::atomic<bool> ran(false);
+
+    scheduler.submit(10, Throw);
+    scheduler.submit(20, boost::bind(MarkRan, &ran));
+
+    for (int32_t i = 0; i < 1000 && !ran; i++)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+    ASSERT_TRUE(ran);
+}
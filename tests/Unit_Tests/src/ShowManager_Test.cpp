@@ -0,0 +1,237 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  ShowManager_Test.cpp
+//
+//
+
+#include "ShowManager_Test.h"
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+#include "CPLParser.h"
+#include "ShowManager.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+// Every CPL of the test package has one reel with a picture and a sound of its own
+//
+static const int32_t sNumberOfCPLs = 3;
+static const int32_t sDurations[sNumberOfCPLs] = { 100, 50, 25 };
+
+static std::string GetAssetId(int32_t iCPL, int32_t iAsset)
+{
+    return "0000000" + std::to_string(iCPL) + "-0000-0000-0000-00000000000" + std::to_string(iAsset);
+}
+
+static UUID GetPictureId(int32_t iCPL)
+{
+    UUID id;
+    UUID::FromString(GetAssetId(iCPL, 1), id);
+    return id;
+}
+
+static std::string GetCPLPath(const std::string &iDirectory, int32_t iCPL)
+{
+    return iDirectory + "CPL_" + std::to_string(iCPL) + ".xml";
+}
+
+// Writes a package of sNumberOfCPLs CPLs and an ASSETMAP.xml into a new directory
+//
+static std::string CreatePackage(void)
+{
+    char directoryName[] = "/tmp/ShowManager_Test.XXXXXX";
+
+    if (mkdtemp(directoryName) == nullptr)
+        return std::string();
+
+    std::string directory = std::string(directoryName) + "/";
+
+    std::ofstream assetMap(CPLParser::GetAssetMapPath(directory).c_str());
+    assetMap << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<AssetMap>\n<AssetList>\n";
+
+    for (int32_t cpl = 0; cpl < sNumberOfCPLs; cpl++)
+    {
+        for (int32_t asset = 1; asset <= 2; asset++)
+        {
+            assetMap << "<Asset><Id>urn:uuid:" << GetAssetId(cpl, asset) << "</Id><ChunkList><Chunk>"
+                     << "<Path>" << cpl << "_" << asset << ".mxf</Path><VolumeIndex>1</VolumeIndex>"
+                     << "<Offset>0</Offset><Length>1000</Length></Chunk></ChunkList></Asset>\n";
+        }
+
+        std::ofstream file(GetCPLPath(directory, cpl).c_str());
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CompositionPlaylist>\n"
+             << "<Id>urn:uuid:" << GetAssetId(cpl, 0) << "</Id>\n<ReelList>\n<Reel>\n"
+             << "<Id>urn:uuid:" << GetAssetId(cpl, 3) << "</Id>\n<AssetList>\n";
+
+        const char *types[] = { "MainPicture", "MainSound" };
+
+        for (int32_t asset = 1; asset <= 2; asset++)
+        {
+            file << "<" << types[asset - 1] << "><Id>urn:uuid:" << GetAssetId(cpl, asset) << "</Id>"
+                 << "<EditRate>24 1</EditRate><IntrinsicDuration>" << sDurations[cpl] << "</IntrinsicDuration>"
+                 << "<EntryPoint>0</EntryPoint><Duration>" << sDurations[cpl] << "</Duration>"
+                 << "</" << types[asset - 1] << ">\n";
+        }
+
+        file << "</AssetList>\n</Reel>\n</ReelList>\n</CompositionPlaylist>\n";
+    }
+
+    assetMap << "</AssetList>\n</AssetMap>\n";
+
+    return directory;
+}
+
+static void RemovePackage(const std::string &iDirectory)
+{
+    for (int32_t cpl = 0; cpl < sNumberOfCPLs; cpl++)
+        std::remove(GetCPLPath(iDirectory, cpl).c_str());
+
+    std::remove(CPLParser::GetAssetMapPath(iDirectory).c_str());
+    rmdir(iDirectory.c_str());
+}
+
+// Returns the index of the CPL whose picture is shown at iFrame, -1 if there is none
+//
+static int32_t GetCPLAtFrame(ShowManager &iShowManager, int32_t iFrame)
+{
+    FrameInfo frameInfo;
+
+    if (!iShowManager.GetFrame(iFrame, frameInfo))
+        return -1;
+
+    for (int32_t cpl = 0; cpl < sNumberOfCPLs; cpl++)
+    {
+        if (frameInfo.primaryPictureTrackFileUUID_ == GetPictureId(cpl))
+            return cpl;
+    }
+
+    return -1;
+}
+
+TEST(ShowManager_Test, ShowManager_Test_EditLoadedShow)
+{
+    std::string directory = CreatePackage();
+    ASSERT_FALSE(directory.empty());
+
+    ShowManager showManager(48000);
+    ASSERT_TRUE(showManager.AddCPL(GetCPLPath(directory, 0)));
+    ASSERT_TRUE(showManager.AddCPL(GetCPLPath(directory, 2)));
+    ASSERT_TRUE(showManager.Load());
+    ASSERT_TRUE(showManager.IsShowLoaded());
+
+    ASSERT_EQ(125, showManager.GetLengthInFrames());
+    uint32_t timelineVersion = showManager.GetTimelineVersion();
+
+    // 0, 1, 2. Frames before the inserted CPL keep their numbers.
+    //
+    ASSERT_TRUE(showManager.InsertCPL(1, GetCPLPath(directory, 1)));
+    ASSERT_EQ(175, showManager.GetLengthInFrames());
+    ASSERT_EQ(timelineVersion + 1, showManager.GetTimelineVersion());
+    ASSERT_EQ(0, GetCPLAtFrame(showManager, 0));
+    ASSERT_EQ(0, GetCPLAtFrame(showManager, 99));
+    ASSERT_EQ(1, GetCPLAtFrame(showManager, 100));
+    ASSERT_EQ(1, GetCPLAtFrame(showManager, 149));
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 150));
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 174));
+    ASSERT_EQ(-1, GetCPLAtFrame(showManager, 175));
+
+    // 2, 1, 2
+    //
+    ASSERT_TRUE(showManager.ReplaceCPL(0, GetCPLPath(directory, 2)));
+    ASSERT_EQ(100, showManager.GetLengthInFrames());
+    ASSERT_EQ(timelineVersion + 2, showManager.GetTimelineVersion());
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 0));
+    ASSERT_EQ(1, GetCPLAtFrame(showManager, 25));
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 75));
+
+    // 2, 2
+    //
+    ASSERT_TRUE(showManager.RemoveCPL(1));
+    ASSERT_EQ(50, showManager.GetLengthInFrames());
+    ASSERT_EQ(timelineVersion + 3, showManager.GetTimelineVersion());
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 25));
+
+    // Rejected edits leave the timeline as it is
+    //
+    ASSERT_FALSE(showManager.InsertCPL(3, GetCPLPath(directory, 1)));
+    ASSERT_FALSE(showManager.InsertCPL(-1, GetCPLPath(directory, 1)));
+    ASSERT_FALSE(showManager.ReplaceCPL(2, GetCPLPath(directory, 1)));
+    ASSERT_FALSE(showManager.ReplaceCPL(0, directory + "missing.xml"));
+    ASSERT_FALSE(showManager.RemoveCPL(2));
+    ASSERT_EQ(50, showManager.GetLengthInFrames());
+    ASSERT_EQ(timelineVersion + 3, showManager.GetTimelineVersion());
+
+    // The last CPL cannot be removed
+    //
+    ASSERT_TRUE(showManager.RemoveCPL(0));
+    ASSERT_EQ(25, showManager.GetLengthInFrames());
+    ASSERT_FALSE(showManager.RemoveCPL(0));
+    ASSERT_EQ(25, showManager.GetLengthInFrames());
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 0));
+    ASSERT_EQ(timelineVersion + 4, showManager.GetTimelineVersion());
+
+    RemovePackage(directory);
+}
+
+TEST(ShowManager_Test, ShowManager_Test_EditBeforeLoad)
+{
+    std::string directory = CreatePackage();
+    ASSERT_FALSE(directory.empty());
+
+    ShowManager showManager(48000);
+    ASSERT_FALSE(showManager.IsShowLoaded());
+
+    // Only the CPL list is changed until the Show is loaded
+    //
+    ASSERT_TRUE(showManager.AddCPL(GetCPLPath(directory, 0)));
+    ASSERT_TRUE(showManager.InsertCPL(0, GetCPLPath(directory, 1)));
+    ASSERT_TRUE(showManager.ReplaceCPL(1, GetCPLPath(directory, 2)));
+    ASSERT_TRUE(showManager.AppendCPL(GetCPLPath(directory, 0)));
+    ASSERT_TRUE(showManager.RemoveCPL(0));
+    ASSERT_FALSE(showManager.InsertCPL(0, directory + "missing.xml"));
+    ASSERT_FALSE(showManager.RemoveCPL(2));
+    ASSERT_FALSE(showManager.IsShowLoaded());
+
+    // 2, 0
+    //
+    ASSERT_TRUE(showManager.Load());
+    ASSERT_EQ(125, showManager.GetLengthInFrames());
+    ASSERT_EQ(2, GetCPLAtFrame(showManager, 0));
+    ASSERT_EQ(0, GetCPLAtFrame(showManager, 25));
+    ASSERT_EQ(0, GetCPLAtFrame(showManager, 124));
+
+    RemovePackage(directory);
+}
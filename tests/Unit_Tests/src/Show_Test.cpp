@@ -0,0 +1,246 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  Show_Test.cpp
+//
+//
+
+#include "Show_Test.h"
+#include "gtest/gtest.h"
+
+#include "Show.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static Asset *CreateAsset(Asset::AssetType iType, int32_t iDuration, const std::string &iPath)
+{
+    Asset *asset = new Asset;
+    asset->type_ = iType;
+    asset->editRateNumerator_ = 24;
+    asset->editRateDenominator_ = 1;
+    asset->duration_ = iDuration;
+    asset->path_ = iPath;
+    asset->dataEssenceCodingUL_ = iPath + ".UL";
+    asset->id_[0] = static_cast<uint8_t>(iPath.size());
+    return asset;
+}
+
+// Creates a CPL of iNumberOfReels reels of iDuration frames.
+// Every other reel has aux data.
+//
+static CPL *CreateCPL(const std::string &iName, int32_t iNumberOfReels, int32_t iDuration)
+{
+    CPL *cpl = new CPL;
+
+    for (int32_t reel = 0; reel < iNumberOfReels; reel++)
+    {
+        std::string name = iName + "_" + std::to_string(reel);
+
+        Reel *newReel = new Reel;
+        newReel->assets_.push_back(CreateAsset(Asset::eAssetType_MainPicture, iDuration, name + ".picture"));
+        newReel->assets_.push_back(CreateAsset(Asset::eAssetType_MainSound, iDuration, name + ".sound"));
+
+        if (reel % 2 == 0)
+            newReel->assets_.push_back(CreateAsset(Asset::eAssetType_AuxData, iDuration, name + ".aux"));
+
+        cpl->reels_.push_back(newReel);
+    }
+
+    return cpl;
+}
+
+TEST(Show_Test, Show_Test_GetAssetRangeForFrame)
+{
+    Show show(48000);
+    show.AddCPLToEndOfTimeline(CreateCPL("a", 3, 100));
+    show.AddCPLToEndOfTimeline(CreateCPL("b", 2, 50));
+
+    ASSERT_EQ(400, show.GetLengthInFrames());
+
+    int32_t startFrame = 0;
+    int32_t endFrame = 0;
+
+    // Sequential, backwards and random access
+    //
+    int32_t frames[] = { 0, 1, 99, 100, 150, 99, 0, 250, 399, 300, 349 };
+
+    for (size_t index = 0; index < sizeof(frames) / sizeof(frames[0]); index++)
+    {
+        int32_t frame = frames[index];
+
+        ASSERT_TRUE(show.GetAssetRangeForFrame(frame, Asset::eAssetType_MainPicture, startFrame, endFrame));
+        ASSERT_EQ(frame < 300 ? (frame / 100) * 100 : 300 + ((frame - 300) / 50) * 50, startFrame);
+    }
+
+    // Only reels 0 and 2 of "a" and reel 0 of "b" have aux data
+    //
+    ASSERT_TRUE(show.GetAssetRangeForFrame(250, Asset::eAssetType_AuxData, startFrame, endFrame));
+    ASSERT_EQ(200, startFrame);
+    ASSERT_EQ(299, endFrame);
+
+    ASSERT_FALSE(show.GetAssetRangeForFrame(150, Asset::eAssetType_AuxData, startFrame, endFrame));
+    ASSERT_FALSE(show.GetAssetRangeForFrame(360, Asset::eAssetType_AuxData, startFrame, endFrame));
+    ASSERT_FALSE(show.GetAssetRangeForFrame(-1, Asset::eAssetType_MainPicture, startFrame, endFrame));
+    ASSERT_FALSE(show.GetAssetRangeForFrame(400, Asset::eAssetType_MainPicture, startFrame, endFrame));
+
+    ASSERT_EQ("b_0.aux", show.GetDataFilePath(320, Asset::eAssetType_AuxData));
+    ASSERT_EQ("", show.GetDataFilePath(120, Asset::eAssetType_AuxData));
+}
+
+TEST(Show_Test, Show_Test_GetAssetFrameInfo)
+{
+    Show show(48000);
+    show.AddCPLToEndOfTimeline(CreateCPL("a", 2, 24));
+
+    FrameInfo frameInfo;
+
+    for (int32_t frame = 0; frame < 48; frame++)
+    {
+        ASSERT_TRUE(show.GetAssetFrameInfo(frame, frameInfo));
+        ASSERT_EQ(2000, frameInfo.currentFrameDuration_);
+        ASSERT_EQ(frame, frameInfo.primaryPictureTrackFileEditUnitIndex_);
+        ASSERT_EQ(frame, frameInfo.primarySoundTrackFileEditUnitIndex_);
+        ASSERT_EQ(frame < 24 ? "a_0.aux.UL" : "", frameInfo.dataEssenceCodingUL_);
+    }
+
+    ASSERT_FALSE(show.GetAssetFrameInfo(48, frameInfo));
+}
+
+TEST(Show_Test, Show_Test_GetAssetFrameInfoRange)
+{
+    Show show(48000);
+    show.AddCPLToEndOfTimeline(CreateCPL("a", 3, 10));
+
+    std::vector<FrameInfo> frameInfos(40);
+
+    // Stops at the end of the Show
+    //
+    ASSERT_EQ(25, show.GetAssetFrameInfoRange(5, 40, frameInfos.data()));
+
+    for (int32_t index = 0; index < 25; index++)
+    {
+        FrameInfo frameInfo;
+        ASSERT_TRUE(show.GetAssetFrameInfo(5 + index, frameInfo));
+
+        ASSERT_EQ(frameInfo.primaryPictureTrackFileEditUnitIndex_, frameInfos[index].primaryPictureTrackFileEditUnitIndex_);
+        ASSERT_EQ(frameInfo.primarySoundTrackFileEditUnitIndex_, frameInfos[index].primarySoundTrackFileEditUnitIndex_);
+        ASSERT_TRUE(frameInfo.primaryPictureTrackFileUUID_ == frameInfos[index].primaryPictureTrackFileUUID_);
+        ASSERT_EQ(frameInfo.dataEssenceCodingUL_, frameInfos[index].dataEssenceCodingUL_);
+    }
+
+    ASSERT_EQ(0, show.GetAssetFrameInfoRange(30, 5, frameInfos.data()));
+
+    FrameInfoRunList runs;
+    show.GetFrameInfoRuns(runs);
+
+    ASSERT_EQ(3u, runs.size());
+    ASSERT_EQ(10, runs[1].startFrame_);
+    ASSERT_EQ(19, runs[1].endFrame_);
+
+    FrameInfo frameInfo;
+    runs[2].GetFrameInfo(27, frameInfo);
+    ASSERT_EQ(27u, frameInfo.primaryPictureTrackFileEditUnitIndex_);
+    ASSERT_EQ(27u, frameInfo.primarySoundTrackFileEditUnitIndex_);
+}
+
+TEST(Show_Test, Show_Test_CloneIntoNewShow)
+{
+    Show show(48000);
+    show.AddCPLToEndOfTimeline(CreateCPL("a", 1, 100));
+    show.AddCPLToEndOfTimeline(CreateCPL("b", 1, 50));
+
+    // Build a new timeline with "c" inserted between "a" and "b" from copies of the CPLs
+    //
+    const std::vector<CPL*> &cpls = show.GetCPLs();
+    ASSERT_EQ(2u, cpls.size());
+
+    Show newShow(48000);
+    newShow.AddCPLToEndOfTimeline(cpls[0]->Clone());
+    newShow.AddCPLToEndOfTimeline(CreateCPL("c", 1, 25));
+    newShow.AddCPLToEndOfTimeline(cpls[1]->Clone());
+
+    ASSERT_EQ(175, newShow.GetLengthInFrames());
+    ASSERT_EQ("c_0.aux", newShow.GetDataFilePath(110, Asset::eAssetType_AuxData));
+    ASSERT_EQ("b_0.aux", newShow.GetDataFilePath(130, Asset::eAssetType_AuxData));
+
+    UUID assetId;
+    ASSERT_TRUE(newShow.GetAssetId(130, Asset::eAssetType_AuxData, assetId));
+    ASSERT_EQ(static_cast<uint8_t>(std::string("b_0.aux").size()), assetId[0]);
+
+    // The original timeline is unchanged
+    //
+    int32_t startFrame = 0;
+    int32_t endFrame = 0;
+
+    ASSERT_EQ(150, show.GetLengthInFrames());
+    ASSERT_TRUE(show.GetAssetRangeForFrame(130, Asset::eAssetType_AuxData, startFrame, endFrame));
+    ASSERT_EQ(100, startFrame);
+    ASSERT_EQ(149, endFrame);
+    ASSERT_EQ("b_0.aux", show.GetDataFilePath(130, Asset::eAssetType_AuxData));
+}
+
+TEST(Show_Test, Show_Test_MultipleAuxDataTracksPerReel)
+{
+    Show show(48000);
+
+    // Reel 0 of "a" also carries a second aux data track
+    //
+    CPL *cpl = CreateCPL("a", 3, 100);
+    cpl->reels_[0]->assets_.push_back(CreateAsset(Asset::eAssetType_AuxData, 100, "a_0.captions"));
+    cpl->reels_[1]->assets_.push_back(CreateAsset(Asset::eAssetType_AuxData, 100, "a_1.captions"));
+    show.AddCPLToEndOfTimeline(cpl);
+
+    int32_t startFrame = 0;
+    int32_t endFrame = 0;
+
+    ASSERT_TRUE(show.GetAuxDataRangeForFrame("a_0.aux.UL", 50, startFrame, endFrame));
+    ASSERT_EQ(0, startFrame);
+    ASSERT_EQ(99, endFrame);
+    ASSERT_EQ("a_0.aux", show.GetAuxDataFilePath("a_0.aux.UL", 50));
+    ASSERT_EQ("a_0.captions", show.GetAuxDataFilePath("a_0.captions.UL", 50));
+    ASSERT_EQ("a_1.captions", show.GetAuxDataFilePath("a_1.captions.UL", 150));
+
+    UUID assetId;
+    ASSERT_TRUE(show.GetAuxDataAssetId("a_0.captions.UL", 99, assetId));
+    ASSERT_EQ(static_cast<uint8_t>(std::string("a_0.captions").size()), assetId[0]);
+
+    // Each track is only found at its own frames and under its own coding UL
+    //
+    ASSERT_FALSE(show.GetAuxDataRangeForFrame("a_0.captions.UL", 100, startFrame, endFrame));
+    ASSERT_FALSE(show.GetAuxDataRangeForFrame("a_0.aux.UL", 150, startFrame, endFrame));
+    ASSERT_FALSE(show.GetAuxDataRangeForFrame("unknown.UL", 50, startFrame, endFrame));
+    ASSERT_EQ("", show.GetAuxDataFilePath("a_2.aux.UL", 50));
+    ASSERT_EQ("a_2.aux", show.GetAuxDataFilePath("a_2.aux.UL", 250));
+
+    std::vector<std::string> codingULs = show.GetAuxDataCodingULs();
+    ASSERT_EQ(4u, codingULs.size());
+    ASSERT_EQ("a_0.aux.UL", codingULs[0]);
+}
@@ -0,0 +1,117 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  SingleFlight_Test.cpp
+//
+//
+
+#include "SingleFlight_Test.h"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+#include "boost/atomic.hpp"
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "SingleFlight.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+static int32_t Answer(void)
+{
+    return 42;
+}
+
+// Signals that the call is in flight, waits to be released, then throws
+static int32_t Fail(boost::atomic<bool> *oStarted, boost::atomic<bool> *iRelease)
+{
+    *oStarted = true;
+
+    while (!*iRelease)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+    throw std::runtime_error("read failed");
+}
+
+static void DoAndCountFailures(SingleFlight<int32_t, int32_t> *ioSingleFlight,
+                               SingleFlight<int32_t, int32_t>::Function iFunction,
+                               boost::atomic<int32_t> *oFailures)
+{
+    try
+    {
+        ioSingleFlight->Do(1, iFunction);
+    }
+    catch (const std::runtime_error&)
+    {
+        (*oFailures)++;
+    }
+}
+
+TEST(SingleFlight_Test, SingleFlight_Test_Do)
+{
+    SingleFlight<int32_t, int32_t> singleFlight;
+
+    bool shared = true;
+    ASSERT_EQ(42, singleFlight.Do(1, &Answer, &shared));
+    ASSERT_FALSE(shared);
+    ASSERT_EQ(0u, singleFlight.GetNumberOfSharedCalls());
+}
+
+TEST(SingleFlight_Test, SingleFlight_Test_Throws)
+{
+    SingleFlight<int32_t, int32_t> singleFlight;
+    boost::atomic<bool> started(false);
+    boost::atomic<bool> release(false);
+    boost::atomic<int32_t> failures(0);
+
+    SingleFlight<int32_t, int32_t>::Function fail = boost::bind(&Fail, &started, &release);
+    boost::thread leader(&DoAndCountFailures, &singleFlight, fail, &failures);
+    while (!started)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+    // A second caller joins the call in flight
+    boost::thread waiter(&DoAndCountFailures, &singleFlight, &Answer, &failures);
+    while (singleFlight.GetNumberOfSharedCalls() == 0)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+    release = true;
+    leader.join();
+    waiter.join();
+
+    // Both got the exception and nobody is left blocked
+    ASSERT_EQ(2, failures);
+
+    // The key is free again for the next caller
+    bool shared = true;
+    ASSERT_EQ(42, singleFlight.Do(1, &Answer, &shared));
+    ASSERT_FALSE(shared);
+}
@@ -225,12 +225,12 @@ public:
 
         UUID uuid;
         
-        ASSERT_EQ(StringToUUID(si.pictureUUID, uuid), true);
+        ASSERT_EQ(UUID::FromString(si.pictureUUID, uuid), true);
         ASSERT_EQ(sSample.SetPrimaryPictureTrackFileUUID(uuid), true);
         sSample.SetPrimarySoundTrackFileEditUnitIndex(si.soundIndex);
-        ASSERT_EQ(StringToUUID(si.soundUUID, uuid), true);
+        ASSERT_EQ(UUID::FromString(si.soundUUID, uuid), true);
         ASSERT_EQ(sSample.SetPrimarySoundTrackFileUUID(uuid), true);
-        ASSERT_EQ(StringToUUID(si.playlistUUID, uuid), true);
+        ASSERT_EQ(UUID::FromString(si.playlistUUID, uuid), true);
         ASSERT_EQ(sSample.SetCompositionPlaylistUUID(uuid), true);
         ASSERT_EQ(sSample.WriteSyncPacket(frame, &count), true);
         
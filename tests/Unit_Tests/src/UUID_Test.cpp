@@ -0,0 +1,116 @@
+/*======================================================================*
+    Copyright (c) 2015-2022 DTS, Inc. and its affiliates.
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its contributors
+    may be used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+    ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *======================================================================*/
+
+//
+//  UUID_Test.cpp
+//
+//
+
+#include "UUID_Test.h"
+#include "gtest/gtest.h"
+
+#include <unordered_map>
+
+#include "boost/unordered_map.hpp"
+
+#include "UUID.h"
+
+using namespace SMPTE_SYNC;
+using namespace std;
+
+TEST(UUID_Test, UUID_Test_Parse)
+{
+    UUID uuid;
+    ASSERT_TRUE(uuid.IsNil());
+
+    ASSERT_TRUE(UUID::FromString("0123abcd-4567-89EF-0123-456789abcdef", uuid));
+    ASSERT_EQ(0x01, uuid[0]);
+    ASSERT_EQ(0xef, uuid[7]);
+    ASSERT_EQ(0xcd, uuid[3]);
+    ASSERT_EQ("0123abcd-4567-89ef-0123-456789abcdef", uuid.ToString());
+
+    UUID undashed;
+    ASSERT_TRUE(UUID::FromString("0123abcd456789ef0123456789abcdef", undashed));
+    ASSERT_TRUE(uuid == undashed);
+
+    // Invalid strings leave the UUID unchanged
+    //
+    ASSERT_FALSE(UUID::FromString("0123abcd-4567-89ef-0123-456789abcde", uuid));
+    ASSERT_FALSE(UUID::FromString("0123abcd-4567-89ef-0123-456789abcdef0", uuid));
+    ASSERT_FALSE(UUID::FromString("0123abcd-4567-89ef-0123-456789abcdeg", uuid));
+    ASSERT_FALSE(UUID::FromString("0123abcd--4567-89ef-0123-456789abcdef", uuid));
+    ASSERT_FALSE(UUID::FromString("", uuid));
+    ASSERT_TRUE(uuid == undashed);
+}
+
+TEST(UUID_Test, UUID_Test_Compare)
+{
+    // Usable in constant expressions
+    //
+    constexpr UUID constant(0x0123abcd456789efULL, 0x0123456789abcdefULL);
+
+    UUID uuid;
+    ASSERT_TRUE(UUID::FromString("0123abcd-4567-89ef-0123-456789abcdef", uuid));
+    ASSERT_TRUE(uuid == constant);
+
+    // Differs only in the last byte, which a string compare of the bytes would stop before if a byte were 0
+    //
+    UUID other = uuid;
+    other[15] = 0;
+    ASSERT_TRUE(uuid != other);
+    ASSERT_TRUE(other < uuid);
+
+    UUID zeros;
+    UUID leadingZero = zeros;
+    leadingZero[1] = 1;
+    ASSERT_TRUE(zeros != leadingZero);
+
+    other.Clear();
+    ASSERT_TRUE(other.IsNil());
+}
+
+TEST(UUID_Test, UUID_Test_Hash)
+{
+    std::unordered_map<UUID, int32_t> stdMap;
+    boost::unordered_map<UUID, int32_t> boostMap;
+
+    for (int32_t index = 0; index < 100; index++)
+    {
+        UUID uuid(0x1000 + index, static_cast<uint64_t>(index) * 7);
+
+        stdMap[uuid] = index;
+        boostMap[uuid] = index;
+    }
+
+    ASSERT_EQ(100u, stdMap.size());
+    ASSERT_EQ(100u, boostMap.size());
+    ASSERT_EQ(42, stdMap[UUID(0x1000 + 42, 42 * 7)]);
+    ASSERT_EQ(42, boostMap[UUID(0x1000 + 42, 42 * 7)]);
+    ASSERT_TRUE(stdMap.find(UUID()) == stdMap.end());
+}